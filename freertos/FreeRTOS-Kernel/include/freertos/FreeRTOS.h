@@ -879,6 +879,68 @@
     #define configUSE_TICKLESS_IDLE    0
 #endif
 
+#ifndef configUSE_DELAYED_TASK_WHEEL
+    #define configUSE_DELAYED_TASK_WHEEL    0
+#endif
+
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+    #ifndef configDELAYED_TASK_WHEEL_SIZE
+        #define configDELAYED_TASK_WHEEL_SIZE    64
+    #endif
+
+    #if ( ( configDELAYED_TASK_WHEEL_SIZE & ( configDELAYED_TASK_WHEEL_SIZE - 1 ) ) != 0 )
+        #error configDELAYED_TASK_WHEEL_SIZE must be a power of two
+    #endif
+
+    #if ( configUSE_TICKLESS_IDLE != 0 )
+        #error configUSE_DELAYED_TASK_WHEEL cannot be used with configUSE_TICKLESS_IDLE as the next unblock time is not tracked
+    #endif
+#endif /* configUSE_DELAYED_TASK_WHEEL */
+
+#ifndef configUSE_EDF_SCHEDULING
+    #define configUSE_EDF_SCHEDULING    0
+#endif
+
+#ifndef configUSE_TASK_BUDGETS
+    #define configUSE_TASK_BUDGETS    0
+#endif
+
+#ifndef configUSE_TASK_DELAY_US
+    #define configUSE_TASK_DELAY_US    0
+#endif
+
+#ifndef configUSE_TICKLESS_KERNEL
+    #define configUSE_TICKLESS_KERNEL    0
+#endif
+
+#if ( configUSE_TICKLESS_KERNEL == 1 )
+    #if ( configUSE_TICKLESS_IDLE != 0 )
+        #error configUSE_TICKLESS_KERNEL and configUSE_TICKLESS_IDLE cannot both be used
+    #endif
+
+    #if ( ( configUSE_DELAYED_TASK_WHEEL == 1 ) || ( configUSE_TASK_BUDGETS == 1 ) )
+        #error configUSE_TICKLESS_KERNEL requires the next unblock time to be tracked, and no per tick processing
+    #endif
+
+    #if ( configNUMBER_OF_CORES > 1 )
+        #error configUSE_TICKLESS_KERNEL is only supported on single core
+    #endif
+#endif /* configUSE_TICKLESS_KERNEL */
+
+/* Called by the kernel before the tick count is read, so that the port can
+ * account for the ticks that have elapsed since the last tick interrupt when
+ * ticks are not processed periodically. */
+#ifndef portTICKLESS_SYNC_TICK_COUNT
+    #define portTICKLESS_SYNC_TICK_COUNT()
+#endif
+
+/* Called by the kernel when the next tick the kernel requires may have changed,
+ * so that the port can reprogram its tick alarm when ticks are not processed
+ * periodically. */
+#ifndef portTICKLESS_UPDATE_ALARM
+    #define portTICKLESS_UPDATE_ALARM()
+#endif
+
 #ifndef configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING
     #define configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING( x )
 #endif
@@ -943,6 +1005,34 @@
     #define configUSE_PORT_OPTIMISED_TASK_SELECTION    0
 #endif
 
+#ifndef configUSE_READY_PRIORITY_BITMAP
+    #define configUSE_READY_PRIORITY_BITMAP    0
+#endif
+
+#if ( ( configUSE_READY_PRIORITY_BITMAP == 1 ) && ( configMAX_PRIORITIES > 1024 ) )
+    #error configUSE_READY_PRIORITY_BITMAP can only be used when configMAX_PRIORITIES is less than or equal to 1024
+#endif
+
+#ifndef configUSE_TASK_REAPER
+    #define configUSE_TASK_REAPER    0
+#endif
+
+#ifndef configTASK_REAPER_PRIORITY
+    #define configTASK_REAPER_PRIORITY    1
+#endif
+
+#ifndef configTASK_REAPER_STACK_SIZE
+    #define configTASK_REAPER_STACK_SIZE    2048
+#endif
+
+#ifndef configTASK_REAPER_BATCH_SIZE
+    #define configTASK_REAPER_BATCH_SIZE    4
+#endif
+
+#if ( ( configUSE_TASK_REAPER == 1 ) && ( INCLUDE_vTaskDelete == 0 ) )
+    #error configUSE_TASK_REAPER requires INCLUDE_vTaskDelete to be set to 1
+#endif
+
 #ifndef configAPPLICATION_ALLOCATED_HEAP
     #define configAPPLICATION_ALLOCATED_HEAP    0
 #endif
@@ -1288,7 +1378,6 @@ typedef struct xSTATIC_TCB
     StaticListItem_t xDummy3[ 2 ];
     UBaseType_t uxDummy5;
     void * pxDummy6;
-    uint8_t ucDummy7[ configMAX_TASK_NAME_LEN ];
     #if ( configNUMBER_OF_CORES > 1 )
         BaseType_t xDummyCoreID;
     #endif /* configNUMBER_OF_CORES > 1 */
@@ -1298,21 +1387,34 @@ typedef struct xSTATIC_TCB
     #if ( portCRITICAL_NESTING_IN_TCB == 1 )
         UBaseType_t uxDummy9;
     #endif
-    #if ( configUSE_TRACE_FACILITY == 1 )
-        UBaseType_t uxDummy10[ 2 ];
-    #endif
     #if ( configUSE_MUTEXES == 1 )
         UBaseType_t uxDummy12[ 2 ];
     #endif
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        configRUN_TIME_COUNTER_TYPE ulDummy16;
+    #endif
+    #if ( configUSE_POSIX_ERRNO == 1 )
+        int iDummy22;
+    #endif
+    #if ( configUSE_EDF_SCHEDULING == 1 )
+        TickType_t xDummy23[ 4 ];
+        UBaseType_t uxDummy24;
+        uint8_t ucDummy29;
+    #endif
+    #if ( configUSE_TASK_BUDGETS == 1 )
+        TickType_t xDummy25[ 4 ];
+        UBaseType_t uxDummy26;
+    #endif
+    uint8_t ucDummy7[ configMAX_TASK_NAME_LEN ];
+    #if ( configUSE_TRACE_FACILITY == 1 )
+        UBaseType_t uxDummy10[ 2 ];
+    #endif
     #if ( configUSE_APPLICATION_TASK_TAG == 1 )
         void * pxDummy14;
     #endif
     #if ( configNUM_THREAD_LOCAL_STORAGE_POINTERS > 0 )
         void * pvDummy15[ configNUM_THREAD_LOCAL_STORAGE_POINTERS ];
     #endif
-    #if ( configGENERATE_RUN_TIME_STATS == 1 )
-        configRUN_TIME_COUNTER_TYPE ulDummy16;
-    #endif
     #if ( ( configUSE_NEWLIB_REENTRANT == 1 ) || ( configUSE_C_RUNTIME_TLS_SUPPORT == 1 ) )
         configTLS_BLOCK_TYPE xDummy17;
     #endif
@@ -1323,12 +1425,12 @@ typedef struct xSTATIC_TCB
     #if ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 )
         uint8_t uxDummy20;
     #endif
-
     #if ( INCLUDE_xTaskAbortDelay == 1 )
         uint8_t ucDummy21;
     #endif
-    #if ( configUSE_POSIX_ERRNO == 1 )
-        int iDummy22;
+    #if ( configUSE_TASK_DELAY_US == 1 )
+        void * pvDummy27;
+        uint8_t ucDummy28;
     #endif
 } StaticTask_t;
 
@@ -1365,7 +1467,8 @@ typedef struct xSTATIC_QUEUE
     #endif
 
     #if ( configUSE_QUEUE_SETS == 1 )
-        void * pvDummy7;
+        void * pvDummy7[ 2 ];
+        UBaseType_t uxDummy7;
     #endif
 
     #if ( configUSE_TRACE_FACILITY == 1 )
@@ -826,6 +826,97 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
                           void * const pvBuffer,
                           TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
 
+/**
+ *
+ * Send a batch of items to the back of a queue.  Items are queued by copy, not
+ * by reference.
+ *
+ * All items that fit in the queue are copied in under a single critical
+ * section.  Up to one task waiting to receive is unblocked per item sent, and
+ * the calling task yields at most once for the whole batch rather than once
+ * per item.  This amortizes the cost of entering the kernel when a task
+ * produces bursts of items.
+ *
+ * If the queue is full the calling task blocks (for at most xTicksToWait) until
+ * there is room for at least one item.  The function then returns after one
+ * pass, so fewer than xItemCount items may be sent.  Callers that must send
+ * the whole batch should call again with the remaining items.
+ *
+ * This function must not be used in an interrupt service routine, and must not
+ * be used on a semaphore or mutex (i.e., the queue's item size must be
+ * non-zero).
+ *
+ * @param xQueue The handle to the queue on which the items are to be posted.
+ *
+ * @param pvItemsToQueue A pointer to an array of xItemCount items, each of the
+ * size defined when the queue was created.
+ *
+ * @param xItemCount The number of items in pvItemsToQueue.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for space to become available on the queue, should it already be
+ * full.  The call will return immediately if this is set to 0 and the queue is
+ * full.
+ *
+ * @return The number of items that were sent to the queue, which is 0 if the
+ * call timed out before any space became available.
+ *
+ * Example usage:
+ * @code{c}
+ * uint32_t ulSamples[ 8 ];
+ * size_t xSent = 0;
+ *
+ * // Keep posting until every sample has been queued.
+ * while( xSent < 8 )
+ * {
+ *  xSent += xQueueSendBatch( xQueue, &( ulSamples[ xSent ] ), 8 - xSent, portMAX_DELAY );
+ * }
+ * @endcode
+ * \ingroup QueueManagement
+ */
+size_t xQueueSendBatch( QueueHandle_t xQueue,
+                        const void * const pvItemsToQueue,
+                        size_t xItemCount,
+                        TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ *
+ * Receive a batch of items from a queue.  Items are received by copy so a
+ * buffer large enough for xMaxItems items must be provided.
+ *
+ * All available items, up to xMaxItems, are copied out under a single critical
+ * section.  Up to one task waiting to send is unblocked per item received, and
+ * the calling task yields at most once for the whole batch.
+ *
+ * If the queue is empty the calling task blocks (for at most xTicksToWait)
+ * until at least one item is available.  The function does not wait for
+ * further items once it has received at least one.
+ *
+ * This function must not be used in an interrupt service routine, and must not
+ * be used on a semaphore or mutex.
+ *
+ * @param xQueue The handle to the queue from which the items are to be
+ * received.
+ *
+ * @param pvBuffer Pointer to the buffer into which the received items will be
+ * copied.  The buffer must be able to hold xMaxItems items.
+ *
+ * @param xMaxItems The maximum number of items to receive.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for an item to receive should the queue be empty at the time of the
+ * call.
+ *
+ * @return The number of items that were received, which is 0 if the call timed
+ * out before any item became available.
+ *
+ * \ingroup QueueManagement
+ */
+size_t xQueueReceiveBatch( QueueHandle_t xQueue,
+                           void * const pvBuffer,
+                           size_t xMaxItems,
+                           TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
 /**
  *
  * Return the number of messages stored in a queue.
@@ -1492,17 +1583,18 @@ BaseType_t xQueueGiveMutexRecursive( QueueHandle_t xMutex ) PRIVILEGED_FUNCTION;
  * Note 2:  Blocking on a queue set that contains a mutex will not cause the
  * mutex holder to inherit the priority of the blocked task.
  *
- * Note 3:  An additional 4 bytes of RAM is required for each space in a every
- * queue added to a queue set.  Therefore counting semaphores that have a high
- * maximum count value should not be added to a queue set.
+ * Note 3:  A queue set does not store a copy of a member's handle for every
+ * event.  Instead each member owns a slot in a ready bitmap along with a count
+ * of its pending events, so no additional RAM is required per event.  As the
+ * bitmap is one 32-bit word, a queue set can hold at most 32 members at a time.
  *
  * Note 4:  A receive (in the case of a queue) or take (in the case of a
  * semaphore) operation must not be performed on a member of a queue set unless
  * a call to xQueueSelectFromSet() has first returned a handle to that set member.
  *
- * @param uxEventQueueLength Queue sets store events that occur on
+ * @param uxEventQueueLength Queue sets count events that occur on
  * the queues and semaphores contained in the set.  uxEventQueueLength specifies
- * the maximum number of events that can be queued at once.  To be absolutely
+ * the maximum number of events that can be pending at once.  To be absolutely
  * certain that events are not lost uxEventQueueLength should be set to the
  * total sum of the length of the queues added to the set, where binary
  * semaphores and mutexes have a length of 1, and counting semaphores have a
@@ -1532,6 +1624,9 @@ QueueSetHandle_t xQueueCreateSet( const UBaseType_t uxEventQueueLength ) PRIVILE
  * semaphore) operation must not be performed on a member of a queue set unless
  * a call to xQueueSelectFromSet() has first returned a handle to that set member.
  *
+ * Note 2:  A queue set can hold at most 32 members at a time.  Adding a 33rd
+ * member fails until another member is removed with xQueueRemoveFromSet().
+ *
  * @param xQueueOrSemaphore The handle of the queue or semaphore being added to
  * the queue set (cast to an QueueSetMemberHandle_t type).
  *
@@ -1540,8 +1635,9 @@ QueueSetHandle_t xQueueCreateSet( const UBaseType_t uxEventQueueLength ) PRIVILE
  *
  * @return If the queue or semaphore was successfully added to the queue set
  * then pdPASS is returned.  If the queue could not be successfully added to the
- * queue set because it is already a member of a different queue set then pdFAIL
- * is returned.
+ * queue set because it is already a member of a different queue set, or because
+ * the queue set already holds the maximum number of members, then pdFAIL is
+ * returned.
  */
 BaseType_t xQueueAddToSet( QueueSetMemberHandle_t xQueueOrSemaphore,
                            QueueSetHandle_t xQueueSet ) PRIVILEGED_FUNCTION;
@@ -1587,6 +1683,10 @@ BaseType_t xQueueRemoveFromSet( QueueSetMemberHandle_t xQueueOrSemaphore,
  * semaphore) operation must not be performed on a member of a queue set unless
  * a call to xQueueSelectFromSet() has first returned a handle to that set member.
  *
+ * Note 4:  If several members are ready, the member that was added to the set
+ * first (i.e., the member occupying the lowest slot of the set) is returned.
+ * The slot freed by xQueueRemoveFromSet() is reused by the next member added.
+ *
  * @param xQueueSet The queue set on which the task will (potentially) block.
  *
  * @param xTicksToWait The maximum time, in ticks, that the calling task will
@@ -179,6 +179,11 @@ typedef struct xTASK_STATUS
     #if ( configTASKLIST_INCLUDE_COREID == 1 )
         BaseType_t xCoreID;                       /**< Core this task is pinned to (0, 1, or tskNO_AFFINITY). If configNUMBER_OF_CORES == 1, this will always be 0. */
     #endif
+    #if ( configUSE_TASK_BUDGETS == 1 )
+        TickType_t xBudget;                       /**< The number of ticks the task may run for in each budget period.  Only valid when configUSE_TASK_BUDGETS is defined as 1. */
+        TickType_t xBudgetPeriod;                 /**< The replenishment period of the task's CPU budget, or 0 if the task has no budget.  Only valid when configUSE_TASK_BUDGETS is defined as 1. */
+        UBaseType_t uxThrottleCount;              /**< The number of times the task was throttled for exhausting its CPU budget.  Only valid when configUSE_TASK_BUDGETS is defined as 1. */
+    #endif
 } TaskStatus_t;
 
 /** Possible return values for eTaskConfirmSleepModeStatus(). */
@@ -64,7 +64,12 @@ typedef unsigned portBASE_TYPE UBaseType_t;
 typedef unsigned long TickType_t;
 #define portMAX_DELAY ( TickType_t ) ULONG_MAX
 
+#if CONFIG_FREERTOS_LINUX_RECORD_REPLAY
+/* Reading the tick count is a preemption point of the schedule recordings, so it takes a critical section */
+#define portTICK_TYPE_IS_ATOMIC 0
+#else
 #define portTICK_TYPE_IS_ATOMIC 1
+#endif /* CONFIG_FREERTOS_LINUX_RECORD_REPLAY */
 
 /*-----------------------------------------------------------*/
 
@@ -83,6 +88,12 @@ extern void vPortYield( void );
 
 #define portEND_SWITCHING_ISR( xSwitchRequired ) if( (xSwitchRequired) != pdFALSE ) vPortYield()
 #define portYIELD_FROM_ISR( x ) portEND_SWITCHING_ISR( x )
+
+#if ( configNUMBER_OF_CORES > 1 )
+    #define portGET_CORE_ID()               xPortGetCoreID()
+    #define portYIELD_CORE( xCoreID )       vPortYieldOtherCore( xCoreID )
+    #define portCHECK_IF_IN_ISR()           xPortInIsrContext()
+#endif /* configNUMBER_OF_CORES > 1 */
 /*-----------------------------------------------------------*/
 
 /* Critical section management. */
@@ -100,10 +111,19 @@ void vPortExitCritical( void );
 #define portCLEAR_INTERRUPT_MASK_FROM_ISR(x)    vPortClearInterruptMask(x)
 #define portDISABLE_INTERRUPTS()                portSET_INTERRUPT_MASK()
 #define portENABLE_INTERRUPTS()                 portCLEAR_INTERRUPT_MASK()
-#define portENTER_CRITICAL(mux)                 {(void)mux;  vPortEnterCritical();}
-#define portEXIT_CRITICAL(mux)                  {(void)mux;  vPortExitCritical();}
-#define portENTER_CRITICAL_SAFE(mux)            {(void)mux;  vPortEnterCritical();}
-#define portEXIT_CRITICAL_SAFE(mux)             {(void)mux;  vPortExitCritical();}
+#if ( configNUMBER_OF_CORES > 1 )
+/* Tasks on other cores run in parallel, so the spinlock must be taken too */
+#define portENTER_CRITICAL(mux)                 vPortEnterCriticalMux(mux)
+#define portEXIT_CRITICAL(mux)                  vPortExitCriticalMux(mux)
+#define portENTER_CRITICAL_SAFE(mux)            vPortEnterCriticalMux(mux)
+#define portEXIT_CRITICAL_SAFE(mux)             vPortExitCriticalMux(mux)
+#else
+/* mux is empty in the critical sections reading the tick count (see portTICK_TYPE_IS_ATOMIC) */
+#define portENTER_CRITICAL(mux)                 {(void)(mux + 0);  vPortEnterCritical();}
+#define portEXIT_CRITICAL(mux)                  {(void)(mux + 0);  vPortExitCritical();}
+#define portENTER_CRITICAL_SAFE(mux)            {(void)(mux + 0);  vPortEnterCritical();}
+#define portEXIT_CRITICAL_SAFE(mux)             {(void)(mux + 0);  vPortExitCritical();}
+#endif /* configNUMBER_OF_CORES > 1 */
 #define portENTER_CRITICAL_ISR(mux)             portENTER_CRITICAL(mux)
 #define portEXIT_CRITICAL_ISR(mux)              portEXIT_CRITICAL(mux)
 
@@ -127,7 +147,16 @@ extern void vPortCancelThread( void *pxTaskToDelete );
  * Thus, only a compiler barrier is needed to prevent the compiler
  * reordering.
  */
+#if CONFIG_FREERTOS_LINUX_RECORD_REPLAY
+/* vTaskSuspendAll() is a preemption point of the schedule recordings, which
+ * masks the tick from the first barrier to the second one */
+void vPortSoftwareBarrier( void );
+void vPortMemoryBarrier( void );
+#define portSOFTWARE_BARRIER() vPortSoftwareBarrier()
+#define portMEMORY_BARRIER() vPortMemoryBarrier()
+#else
 #define portMEMORY_BARRIER() __asm volatile( "" ::: "memory" )
+#endif /* CONFIG_FREERTOS_LINUX_RECORD_REPLAY */
 
 extern unsigned long ulPortGetRunTime( void );
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() /* no-op */
@@ -37,6 +37,34 @@ void vPortYieldOtherCore(BaseType_t coreid);
 
 #define portMUX_INITIALIZE(mux)             spinlock_initialize(mux)    /*< Initialize a spinlock to its unlocked state */
 
+#if ( configNUMBER_OF_CORES > 1 )
+/**
+ * @brief Get the current core's ID
+ *
+ * - Each emulated core runs one task thread at a time. This is the core that the calling thread was last resumed on.
+ * - Returns 0 for host threads that are not task threads.
+ *
+ * @return BaseType_t Core ID of the calling task
+ */
+BaseType_t xPortGetCoreID(void);
+
+/**
+ * @brief Enter a critical section
+ *
+ * - Masks interrupts up to configMAX_SYSCALL_INTERRUPT_PRIORITY on the current core, then takes the spinlock
+ * - Yields requested while in the critical section are deferred until it is exited, as on the chips
+ *
+ * @param mux Spinlock
+ */
+void vPortEnterCriticalMux(portMUX_TYPE *mux);
+
+/**
+ * @brief Exit a critical section
+ *
+ * @param mux Spinlock
+ */
+void vPortExitCriticalMux(portMUX_TYPE *mux);
+#else
 /**
  * @brief Get the current core's ID
  *
@@ -47,6 +75,7 @@ static inline BaseType_t IRAM_ATTR xPortGetCoreID(void)
 {
     return (BaseType_t) 0;
 }
+#endif /* configNUMBER_OF_CORES > 1 */
 
 /**
  * @brief Checks if a given piece of memory can be used to store a FreeRTOS list
@@ -115,6 +144,194 @@ static inline void vPortAssertIfInISR(void)
  */
 #define portASSERT_IF_IN_ISR() vPortAssertIfInISR()
 
+#if CONFIG_FREERTOS_LINUX_COROUTINE_PORT
+/**
+ * @brief Step the virtual clock of the coroutine port
+ *
+ * Called on each kernel entry. Every CONFIG_FREERTOS_LINUX_COROUTINE_STEPS_PER_TICK steps, a tick is handled, which may
+ * switch to another task.
+ */
+void vPortCoroutineStep(void);
+
+/**
+ * @brief Advance the virtual clock of the coroutine port to the next tick
+ *
+ * - Called from the idle hook, as nothing can happen before the next tick when the idle task runs.
+ */
+void vPortCoroutineIdle(void);
+
+/**
+ * @brief Get the virtual time of the coroutine port
+ *
+ * @return Virtual time elapsed since the scheduler was started, in microseconds
+ */
+uint64_t ullPortGetVirtualTimeUs(void);
+
+/* The tick count is only advanced by the virtual clock, so reading it counts as a step */
+#define portTICKLESS_SYNC_TICK_COUNT()      vPortCoroutineStep()
+#endif /* CONFIG_FREERTOS_LINUX_COROUTINE_PORT */
+
+#if CONFIG_FREERTOS_LINUX_VIRTUAL_TIME
+/**
+ * @brief Skip the idle time until the next delayed task expiry
+ *
+ * - Called by the idle task with the scheduler suspended, when no task is ready for the next xExpectedIdleTime ticks.
+ * - Steps the tick count by xExpectedIdleTime instead of waiting for the host timer.
+ *
+ * @param xExpectedIdleTime Number of ticks until the next delayed task expiry
+ */
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime);
+
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )     vPortSuppressTicksAndSleep( xExpectedIdleTime )
+#endif /* CONFIG_FREERTOS_LINUX_VIRTUAL_TIME */
+
+#if CONFIG_FREERTOS_LINUX_RECORD_REPLAY
+/**
+ * @brief Pass a preemption point of the schedule recordings
+ *
+ * - Called from the idle hook. Raising the interrupt level from 0 (e.g., entering a critical section) also passes one.
+ * - During a replay, the interrupts recorded before this point are taken, which may switch to another task.
+ */
+void vPortPreemptionPoint(void);
+
+/**
+ * @brief Check whether the Linux simulator is replaying a recording
+ *
+ * @return pdTRUE until all recorded events were replayed, pdFALSE otherwise
+ */
+BaseType_t xPortIsReplaying(void);
+#endif /* CONFIG_FREERTOS_LINUX_RECORD_REPLAY */
+
+#if !CONFIG_FREERTOS_LINUX_COROUTINE_PORT
+/**
+ * @brief Tick statistics of the Linux simulator
+ *
+ * Ticks are due at absolute deadlines of the host's monotonic clock. Tick signals that are not handled in time are
+ * merged by the host, so the ticks missed are caught up by the next tick interrupt, at most
+ * CONFIG_FREERTOS_LINUX_TICK_MAX_CATCH_UP at a time.
+ */
+typedef struct {
+    uint64_t ullInterrupts;             /**< Tick interrupts that handled at least one tick */
+    uint64_t ullTicks;                  /**< Ticks handled, including the ones caught up */
+    uint64_t ullLostTicks;              /**< Ticks whose signal was merged with a later one, and were caught up */
+    uint64_t ullMaxJitterNs;            /**< Maximum delay between the deadline of a tick and its handling */
+    uint64_t ullTotalJitterNs;          /**< Sum of these delays, for each tick interrupt's first tick */
+    uint32_t ulMaxTicksPerInterrupt;    /**< Largest number of ticks handled by a single tick interrupt */
+    uint32_t ulBacklog;                 /**< Ticks currently due but not handled yet */
+} PortTickStats_t;
+
+/**
+ * @brief Get the tick statistics of the Linux simulator
+ *
+ * - The mean tick jitter is ullTotalJitterNs / ullInterrupts.
+ * - Statistics are not counted for the ticks skipped by CONFIG_FREERTOS_LINUX_VIRTUAL_TIME.
+ *
+ * @param[out] pxStats Statistics since the scheduler was started, or since the last vPortResetTickStats()
+ */
+void vPortGetTickStats(PortTickStats_t *pxStats);
+
+/**
+ * @brief Reset the tick statistics of the Linux simulator
+ */
+void vPortResetTickStats(void);
+
+#define portNUM_SIMULATED_INTERRUPTS                32  /**< Number of simulated interrupt lines */
+#define portMAX_SIMULATED_INTERRUPT_PRIORITY        7   /**< Highest priority of a simulated interrupt line */
+
+/**
+ * @brief ISR of a simulated interrupt line
+ *
+ * Runs on the thread of a running task. Only FromISR functions may be called, and only if the line's priority is not
+ * above configMAX_SYSCALL_INTERRUPT_PRIORITY.
+ *
+ * @param pvArg Argument given to xPortAllocateSimulatedInterrupt()
+ * @return pdTRUE if a context switch is required (e.g., a higher priority task was woken), pdFALSE otherwise
+ */
+typedef BaseType_t (*PortSimulatedIsr_t)(void *pvArg);
+
+/**
+ * @brief Statistics of a simulated interrupt line
+ */
+typedef struct {
+    uint64_t ullTriggers;           /**< Triggers of the line, including the ones merged while it was pending */
+    uint64_t ullRuns;               /**< Runs of its ISR */
+    uint64_t ullMaxLatencyNs;       /**< Maximum delay between the trigger of the line and the entry of its ISR */
+    uint64_t ullTotalLatencyNs;     /**< Sum of these delays */
+} PortSimulatedInterruptStats_t;
+
+/**
+ * @brief Allocate a simulated interrupt line of the Linux simulator
+ *
+ * Simulated interrupts are prioritized and nest as on the chips:
+ *
+ * - The ISR of a line preempts the ISRs of lower priority lines, and is deferred while a higher or equal priority ISR
+ *   runs. The tick has the lowest priority (1), and masks the lines up to configMAX_SYSCALL_INTERRUPT_PRIORITY while
+ *   it runs, as a critical section would.
+ * - Critical sections and portSET_INTERRUPT_MASK_FROM_ISR() mask the lines up to configMAX_SYSCALL_INTERRUPT_PRIORITY.
+ *   Lines of a higher priority are never masked, so their ISRs must not call FreeRTOS functions.
+ * - Lines cannot be freed.
+ * - Lines are raised with SIGIO, whose handler is installed by the first call. Until then, SIGIO is left to the
+ *   application.
+ *
+ * @param uxPriority Priority of the line, from 1 to portMAX_SIMULATED_INTERRUPT_PRIORITY
+ * @param pxIsr ISR run when the line is triggered
+ * @param pvArg Argument passed to the ISR
+ * @return Line number, or -1 if all portNUM_SIMULATED_INTERRUPTS lines are allocated
+ */
+BaseType_t xPortAllocateSimulatedInterrupt(UBaseType_t uxPriority, PortSimulatedIsr_t pxIsr, void *pvArg);
+
+/**
+ * @brief Trigger a simulated interrupt
+ *
+ * - Can be called from any host thread, including threads that are not FreeRTOS tasks, and from ISRs.
+ * - The ISR runs as soon as a task runs with the line unmasked. Triggers of the same line are merged until then.
+ *
+ * @param xLine Line number returned by xPortAllocateSimulatedInterrupt()
+ */
+void vPortTriggerSimulatedInterrupt(BaseType_t xLine);
+
+/**
+ * @brief Inject an interrupt storm on a simulated interrupt line
+ *
+ * A host thread triggers the line ulCount times, every ulPeriodUs microseconds (or back to back if 0), then exits.
+ *
+ * @param xLine Line number returned by xPortAllocateSimulatedInterrupt()
+ * @param ulCount Number of triggers
+ * @param ulPeriodUs Period of the triggers in microseconds
+ * @return pdPASS if the storm was started, pdFAIL if a storm is still running on this line
+ */
+BaseType_t xPortInjectInterruptStorm(BaseType_t xLine, uint32_t ulCount, uint32_t ulPeriodUs);
+
+/**
+ * @brief Get the statistics of a simulated interrupt line
+ *
+ * - The number of triggers merged is ullTriggers - ullRuns, minus the ones still pending.
+ * - The mean latency is ullTotalLatencyNs / ullRuns. Merged triggers are not counted.
+ *
+ * @param xLine Line number returned by xPortAllocateSimulatedInterrupt()
+ * @param[out] pxStats Statistics since the line was allocated
+ */
+void vPortGetSimulatedInterruptStats(BaseType_t xLine, PortSimulatedInterruptStats_t *pxStats);
+
+/**
+ * @brief Get the interrupt level of the caller
+ *
+ * @return 0 in a task with interrupts enabled, the priority of the ISR running, or the priority interrupts are masked
+ *         up to (i.e., configMAX_SYSCALL_INTERRUPT_PRIORITY in a critical section)
+ */
+UBaseType_t uxPortGetInterruptLevel(void);
+
+/* FreeRTOS functions may only be called from simulated interrupts that can be masked */
+#define portASSERT_IF_INTERRUPT_PRIORITY_INVALID()      configASSERT(uxPortGetInterruptLevel() <= configMAX_SYSCALL_INTERRUPT_PRIORITY)
+
+/**
+ * @brief Check if the calling host thread is the thread of a FreeRTOS task
+ *
+ * @return pdTRUE if called from a task (or from an ISR interrupting it), pdFALSE if called from another host thread
+ */
+BaseType_t xPortIsTaskThread(void);
+#endif /* !CONFIG_FREERTOS_LINUX_COROUTINE_PORT */
+
 #if CONFIG_FREERTOS_ENABLE_STATIC_TASK_CLEAN_UP
 /* If enabled, users must provide an implementation of vPortCleanUpTCB() */
 extern void vPortCleanUpTCB ( void *pxTCB );
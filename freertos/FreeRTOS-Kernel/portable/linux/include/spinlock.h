@@ -6,11 +6,18 @@
 
 /*
  * This file provides only very simple stubs to build IDF-based FreeRTOSes which use spinlocks on Linux.
+ *
+ * If FreeRTOS runs on more than one (emulated) core, tasks on different cores run in parallel host threads, so real
+ * spinlocks are provided instead.
  */
 #pragma once
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "sdkconfig.h"
+#if CONFIG_FREERTOS_NUMBER_OF_CORES > 1
+#include <sched.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,7 +40,7 @@ extern "C" {
  *  - 0 if unlocked
  *  - Recursive count if locked
  *
- * @note Not a true spinlock as single core RISC-V does not have atomic compare and set instruction
+ * @note Not a true spinlock on a single core, as only one task runs at a time
  * @note Keep portMUX_INITIALIZER_UNLOCKED in sync with this struct
  */
 typedef struct {
@@ -41,6 +48,73 @@ typedef struct {
     uint32_t count;
 }spinlock_t;
 
+#if CONFIG_FREERTOS_NUMBER_OF_CORES > 1
+
+/* Defined by the port, returns the emulated core the calling thread runs on (BaseType_t is long on Linux) */
+long xPortGetCoreID(void);
+
+/* Same owner values as on the chips, i.e., CORE_ID_REGVAL_PRO on core 0 and CORE_ID_REGVAL_APP on core 1 */
+static inline uint32_t __attribute__((always_inline)) spinlock_get_owner_id(void)
+{
+    return 0xCDCD ^ ((uint32_t) xPortGetCoreID() * CORE_ID_REGVAL_XOR_SWAP);
+}
+
+static inline void __attribute__((always_inline)) spinlock_initialize(spinlock_t *lock)
+{
+    lock->count = 0;
+    __atomic_store_n(&lock->owner, SPINLOCK_FREE, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Top level spinlock acquire function, spins until get the lock
+ *
+ * @note A core cannot be switched out while it holds a spinlock (interrupts are disabled and yields are deferred), so
+ *       the core owning the lock can take it recursively.
+ *
+ * @param lock Pointer to spinlock object
+ * @param timeout Number of attempts to take the lock before giving up, or SPINLOCK_WAIT_FOREVER
+ * @return True if the lock was taken, false on timeout
+ */
+static inline bool __attribute__((always_inline)) spinlock_acquire(spinlock_t *lock, int32_t timeout)
+{
+    const uint32_t owner_id = spinlock_get_owner_id();
+    uint32_t expected;
+
+    if (__atomic_load_n(&lock->owner, __ATOMIC_RELAXED) == owner_id) {
+        lock->count++;
+        return true;
+    }
+
+    for (;;) {
+        expected = SPINLOCK_FREE;
+        if (__atomic_compare_exchange_n(&lock->owner, &expected, owner_id, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            break;
+        }
+        if (timeout != SPINLOCK_WAIT_FOREVER && timeout-- <= 0) {
+            return false;
+        }
+        /* The owner may be waiting for this host CPU */
+        sched_yield();
+    }
+
+    lock->count = 1;
+    return true;
+}
+
+/**
+ * @brief Top level spinlock unlock function, unlocks a previously locked spinlock
+ *
+ * @param lock Pointer to spinlock object
+ */
+static inline void __attribute__((always_inline)) spinlock_release(spinlock_t *lock)
+{
+    if (--lock->count == 0) {
+        __atomic_store_n(&lock->owner, SPINLOCK_FREE, __ATOMIC_RELEASE);
+    }
+}
+
+#else /* CONFIG_FREERTOS_NUMBER_OF_CORES > 1 */
+
 static inline void __attribute__((always_inline)) spinlock_initialize(spinlock_t *lock)
 {
 }
@@ -54,6 +128,8 @@ static inline void __attribute__((always_inline)) spinlock_release(spinlock_t *l
 {
 }
 
+#endif /* CONFIG_FREERTOS_NUMBER_OF_CORES > 1 */
+
 #ifdef __cplusplus
 }
 #endif
@@ -38,11 +38,57 @@
  * running are blocked in sigwait().
  *
  * Task switch is done by resuming the thread for the next task by
- * signaling the condition variable and then waiting on a condition variable
- * with the current thread.
+ * signaling its event and then waiting on the event of the current thread.
+ * On Linux, events are futex words, so that a switch only takes a
+ * FUTEX_WAKE and a FUTEX_WAIT system call (see utils/wait_for_event.c).
  *
  * The timer interrupt uses SIGALRM and care is taken to ensure that
  * the signal handler runs only on the thread for the current task.
+ * On Linux, SIGALRM is sent by a timer thread sleeping until absolute
+ * deadlines (clock_nanosleep(TIMER_ABSTIME)). The handler catches up the
+ * ticks whose signal was merged with a later one, so that the tick count
+ * does not drift from the host clock (see prvGetTicksDue()).
+ * With CONFIG_FREERTOS_LINUX_VIRTUAL_TIME, the idle task steps the tick
+ * count over the ticks during which all tasks are blocked instead (see
+ * vPortSuppressTicksAndSleep()).
+ *
+ * With configNUMBER_OF_CORES > 1, one task thread runs per emulated core,
+ * in parallel. A thread runs on the core of the thread that resumed it.
+ * Critical sections take real spinlocks. Interrupts to another core (the
+ * tick on cores other than the one that received SIGALRM, and yields) are
+ * flagged for that core and signalled to its current thread with SIG_IPI.
+ * As on the chips, a yield requested in a critical section is an interrupt
+ * to the current core, taken once the critical section is exited.
+ *
+ * Other host threads (e.g., the I/O bridge of the simulator wrappers) raise
+ * simulated interrupts by flagging a line and sending SIG_IRQ, whose handler
+ * runs the ISR of each flagged line on the thread of a running task (see
+ * vPortTriggerSimulatedInterrupt()).
+ *
+ * Each thread has an interrupt level, as the cores of the chips: 0 in a task,
+ * the priority of the ISR it runs, or configMAX_SYSCALL_INTERRUPT_PRIORITY in
+ * critical sections. The tick and the other kernel signals are blocked above
+ * level 0. SIG_IRQ is only blocked by the other signal handlers (but while
+ * the tick is counted) and while the thread is suspended, so that simulated
+ * ISRs above the level preempt critical sections, the tick and lower priority
+ * ISRs. The lines at or below the level are left pending until the level is
+ * lowered (see prvRestoreInterruptLevel()).
+ *
+ * With CONFIG_FREERTOS_LINUX_RECORD_REPLAY, the interrupts taken by a task
+ * are counted in preemption points: the times a task raises its interrupt
+ * level from 0, and the iterations of the idle task. A recording lists each
+ * interrupt and context switch with the number of points passed before it.
+ * A replay does not start the timer, but takes each recorded interrupt right
+ * before the next point, from the task itself (see prvReplayInterrupts()).
+ *
+ * With CONFIG_FREERTOS_LINUX_THREAD_SANITIZER, ThreadSanitizer does not see
+ * the handoff between task threads, as it orders every task after the one
+ * it preempted. Instead, the critical sections and simulated ISRs of all
+ * threads are ordered on a single address, as the kernel lock orders them on
+ * the chips. Tasks only accessing shared data between kernel calls are thus
+ * reported, whether or not the tick preempted them while doing so. The task
+ * threads then run on stacks allocated by the host, so the stack diagnostics
+ * of the kernel are invalid.
  *
  * Use of part of the standard C library requires care as some
  * functions can take pthread mutexes internally which can result in
@@ -55,6 +101,8 @@
  *----------------------------------------------------------*/
 
 #include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
 #include <pthread.h>
 #include <signal.h>
 #include <stdio.h>
@@ -63,15 +111,30 @@
 #include <sys/time.h>
 #include <sys/times.h>
 #include <time.h>
+#include <unistd.h>
 
 /* Scheduler includes. */
 #include "FreeRTOS.h"
 #include "task.h"
 #include "timers.h"
 #include "utils/wait_for_event.h"
+#if ( configNUMBER_OF_CORES > 1 )
+#ifndef __linux__
+#error "Multi-core emulation requires a Linux host (thread-directed signals)"
+#endif
+#include <sys/syscall.h>
+#include "esp_private/freertos_idf_additions_priv.h"
+#endif /* configNUMBER_OF_CORES > 1 */
+#if CONFIG_FREERTOS_LINUX_THREAD_SANITIZER
+#include <sanitizer/tsan_interface.h>
+#endif /* CONFIG_FREERTOS_LINUX_THREAD_SANITIZER */
 /*-----------------------------------------------------------*/
 
 #define SIG_RESUME SIGUSR1
+#define SIG_IRQ SIGIO
+#if ( configNUMBER_OF_CORES > 1 )
+#define SIG_IPI SIGUSR2
+#endif /* configNUMBER_OF_CORES > 1 */
 
 typedef struct THREAD
 {
@@ -80,6 +143,10 @@ typedef struct THREAD
     void *pvParams;
     BaseType_t xDying;
     struct event *ev;
+#if ( configNUMBER_OF_CORES > 1 )
+    BaseType_t xCoreID; /* Core to run on, set by the thread resuming it */
+    pid_t xTid;         /* Host thread ID, for signalling the thread */
+#endif /* configNUMBER_OF_CORES > 1 */
 } Thread_t;
 
 /*
@@ -96,16 +163,119 @@ static inline Thread_t *prvGetThreadFromTask(TaskHandle_t xTask)
 /*-----------------------------------------------------------*/
 
 static pthread_once_t hSigSetupThread = PTHREAD_ONCE_INIT;
+static pthread_once_t hSigIrqSetupThread = PTHREAD_ONCE_INIT;
 static sigset_t xAllSignals;
+static sigset_t xKernelSignals;        /* All signals but SIG_IRQ */
+static sigset_t xIrqSignal;
 static sigset_t xSchedulerOriginalSignalMask;
 static pthread_t hMainThread = ( pthread_t )NULL;
+#if ( configNUMBER_OF_CORES > 1 )
+/* A thread takes its critical nesting with it when it moves to another core */
+static __thread BaseType_t uxCriticalNesting;
+static __thread BaseType_t xThreadCoreID;
+/* Host thread ID of the thread running on each core */
+static pid_t xCoreThreadTid[ configNUMBER_OF_CORES ];
+/* Interrupts pending on each core */
+static UBaseType_t uxCorePendingTicks[ configNUMBER_OF_CORES ];
+static BaseType_t xCoreYieldPending[ configNUMBER_OF_CORES ];
+#else
 static volatile BaseType_t uxCriticalNesting;
+#endif /* configNUMBER_OF_CORES > 1 */
+/* The interrupt level is kept by each thread, as the critical nesting */
+static __thread UBaseType_t uxInterruptLevel;
+/* Critical nesting at which a critical section raised the interrupt level, and the level it raised it from */
+static __thread BaseType_t xMaskedAtNesting = -1;
+static __thread UBaseType_t uxLevelBeforeMask;
+/* Simulated ISRs running on this thread */
+static __thread UBaseType_t uxIsrNesting;
+#if ( configNUMBER_OF_CORES == 1 )
+/* A simulated ISR requested a context switch, taken once back at level 0 */
+static __thread BaseType_t xIsrSwitchPending;
+#endif /* configNUMBER_OF_CORES == 1 */
 /*-----------------------------------------------------------*/
 
 static BaseType_t xSchedulerEnd = pdFALSE;
 /*-----------------------------------------------------------*/
 
+/* Maximum number of ticks caught up by a single tick interrupt */
+#define portMAX_TICKS_PER_INTERRUPT    ( ( UBaseType_t ) CONFIG_FREERTOS_LINUX_TICK_MAX_CATCH_UP )
+#define portTICK_PERIOD_NS             ( ( uint64_t ) portTICK_RATE_MICROSECONDS * 1000ULL )
+
+static portMUX_TYPE xTickLock = portMUX_INITIALIZER_UNLOCKED;
+static uint64_t prvStartTimeNs;        /* Deadlines are counted from this time */
+static uint64_t prvTickCount;          /* Ticks handled since prvStartTimeNs */
+static uint64_t prvTicksSignalled;     /* Deadlines passed at the last tick interrupt */
+static PortTickStats_t xTickStats;
+#if defined( __linux__ )
+static pthread_t hTimerThread;
+static BaseType_t xTimerThreadStarted = pdFALSE;
+#endif /* defined( __linux__ ) */
+/*-----------------------------------------------------------*/
+
+static PortSimulatedIsr_t pxSimulatedIsrs[ portNUM_SIMULATED_INTERRUPTS ];
+static void *pvSimulatedIsrArgs[ portNUM_SIMULATED_INTERRUPTS ];
+static UBaseType_t uxSimulatedIsrPriorities[ portNUM_SIMULATED_INTERRUPTS ];
+static BaseType_t xSimulatedInterruptsAllocated = 0;
+static uint32_t ulSimulatedInterruptsPending = 0;   /* One bit per line, set by any host thread */
+/* Lines whose priority is above each interrupt level */
+static uint32_t ulLinesAboveLevel[ portMAX_SIMULATED_INTERRUPT_PRIORITY + 1 ];
+static uint64_t ullPendingSinceNs[ portNUM_SIMULATED_INTERRUPTS ];
+static PortSimulatedInterruptStats_t xSimulatedInterruptStats[ portNUM_SIMULATED_INTERRUPTS ];
+static pthread_mutex_t xSimulatedInterruptsLock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t ulStormCounts[ portNUM_SIMULATED_INTERRUPTS ];
+static uint32_t ulStormPeriodsUs[ portNUM_SIMULATED_INTERRUPTS ];
+static BaseType_t xStormRunning[ portNUM_SIMULATED_INTERRUPTS ];
+/*-----------------------------------------------------------*/
+
+#if CONFIG_FREERTOS_LINUX_RECORD_REPLAY
+typedef struct
+{
+    char cType;                                 /* 'T' tick interrupt, 'I' simulated interrupt, 'S' context switch */
+    uint64_t ullPoint;                          /* Preemption points passed before the event */
+    uint64_t ullValue;                          /* Ticks handled, line, or tick count at the switch */
+    char acTaskName[ configMAX_TASK_NAME_LEN ]; /* Task switched in */
+} ReplayEvent_t;
+
+static uint64_t ullPreemptionPoints;    /* Passed by the tasks since the scheduler started */
+static int iRecordFd = -1;
+static ReplayEvent_t *pxReplayEvents;
+static size_t uxReplayEventCount;
+static size_t uxReplayNextEvent;
+static BaseType_t xReplaying = pdFALSE;
+/* vPortSoftwareBarrier() raised the interrupt level for vPortMemoryBarrier() to restore */
+static __thread BaseType_t xBarrierMasked;
+#endif /* CONFIG_FREERTOS_LINUX_RECORD_REPLAY */
+
+#if CONFIG_FREERTOS_LINUX_THREAD_SANITIZER
+/* Dynamic annotations of ThreadSanitizer, not declared by its interface header */
+void AnnotateIgnoreSyncBegin( const char *pcFile, int iLine );
+void AnnotateIgnoreSyncEnd( const char *pcFile, int iLine );
+
+/* Address the critical sections and ISRs are ordered on */
+static char cKernelSync;
+
+#define portTSAN_ACQUIRE_KERNEL()     __tsan_acquire( &cKernelSync )
+#define portTSAN_RELEASE_KERNEL()     __tsan_release( &cKernelSync )
+/* Also ended if the thread is cancelled while it waits (see vPortCancelThread()) */
+#define portTSAN_IGNORE_SYNC_BEGIN()  AnnotateIgnoreSyncBegin( __FILE__, __LINE__ ); \
+                                      pthread_cleanup_push( prvTsanIgnoreSyncEnd, NULL )
+#define portTSAN_IGNORE_SYNC_END()    pthread_cleanup_pop( 1 )
+
+static void prvTsanIgnoreSyncEnd( void *pvUnused )
+{
+    (void)pvUnused;
+    AnnotateIgnoreSyncEnd( __FILE__, __LINE__ );
+}
+#else
+#define portTSAN_ACQUIRE_KERNEL()
+#define portTSAN_RELEASE_KERNEL()
+#define portTSAN_IGNORE_SYNC_BEGIN()
+#define portTSAN_IGNORE_SYNC_END()
+#endif /* CONFIG_FREERTOS_LINUX_THREAD_SANITIZER */
+/*-----------------------------------------------------------*/
+
 static void prvSetupSignalsAndSchedulerPolicy( void );
+static void prvInstallSimulatedInterruptHandler( void );
 static void prvSetupTimerInterrupt( void );
 static void *prvWaitForStart( void * pvParams );
 static void prvSwitchThread( Thread_t * xThreadToResume,
@@ -113,7 +283,21 @@ static void prvSwitchThread( Thread_t * xThreadToResume,
 static void prvSuspendSelf( Thread_t * thread);
 static void prvResumeThread( Thread_t * xThreadId );
 static void vPortSystemTickHandler( int sig );
+static void prvSimulatedInterruptHandler( int sig );
 static void vPortStartFirstTask( void );
+static void prvSwitchContext( void );
+static BaseType_t prvRunSimulatedIsr( BaseType_t xLine, UBaseType_t uxLevel );
+#if CONFIG_FREERTOS_LINUX_RECORD_REPLAY
+static void prvStartRecordReplay( void );
+static void prvRecordEvent( char cType, uint64_t ullValue, const char *pcTaskName );
+static void prvRecordSwitch( void );
+static void prvReplayInterrupts( void );
+#endif /* CONFIG_FREERTOS_LINUX_RECORD_REPLAY */
+#if ( configNUMBER_OF_CORES > 1 )
+static void prvCoreInterruptHandler( int sig );
+static void prvHandleCoreInterrupts( void );
+static void prvRunOnCore( Thread_t *pxThread );
+#endif /* configNUMBER_OF_CORES > 1 */
 /*-----------------------------------------------------------*/
 
 static void prvFatalError( const char *pcCall, int iErrno )
@@ -133,6 +317,7 @@ StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack,
     Thread_t *thread;
     pthread_attr_t xThreadAttributes;
     size_t ulStackSize;
+    sigset_t xSavedMask;
     int iRet;
 
     (void)pthread_once( &hSigSetupThread, prvSetupSignalsAndSchedulerPolicy );
@@ -149,12 +334,25 @@ StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack,
     thread->xDying = pdFALSE;
 
     pthread_attr_init( &xThreadAttributes );
+#if CONFIG_FREERTOS_LINUX_THREAD_SANITIZER
+    /* ThreadSanitizer keeps its thread state in the thread's TLS, which takes
+     * more than the task stacks, so the host allocates the stack instead.
+     * The stack allocated by the kernel then only holds the thread data, so
+     * uxTaskGetStackHighWaterMark() and configCHECK_FOR_STACK_OVERFLOW do not
+     * reflect the stack used by the task. */
+    (void)ulStackSize;
+#else
     pthread_attr_setstack( &xThreadAttributes, pxEndOfStack, ulStackSize );
+#endif /* CONFIG_FREERTOS_LINUX_THREAD_SANITIZER */
 
     thread->ev = event_create();
 
     vPortEnterCritical();
 
+    /* The new thread inherits this mask. Critical sections do not block
+     * SIG_IRQ, which the thread must not handle before it first runs. */
+    (void)pthread_sigmask( SIG_BLOCK, &xAllSignals, &xSavedMask );
+
     iRet = pthread_create( &thread->pthread, &xThreadAttributes,
                            prvWaitForStart, thread );
     if ( iRet )
@@ -162,6 +360,8 @@ StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack,
         prvFatalError( "pthread_create", iRet );
     }
 
+    (void)pthread_sigmask( SIG_SETMASK, &xSavedMask, NULL );
+
     vPortExitCritical();
 
     return pxTopOfStack;
@@ -170,10 +370,23 @@ StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack,
 
 void vPortStartFirstTask( void )
 {
+#if ( configNUMBER_OF_CORES > 1 )
+    BaseType_t xCoreID;
+    Thread_t *pxFirstThread;
+
+    /* Start the first task of each core. */
+    for ( xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++ )
+    {
+        pxFirstThread = prvGetThreadFromTask( xTaskGetCurrentTaskHandleForCore( xCoreID ) );
+        pxFirstThread->xCoreID = xCoreID;
+        prvResumeThread( pxFirstThread );
+    }
+#else
     Thread_t *pxFirstThread = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
 
     /* Start the first task. */
     prvResumeThread( pxFirstThread );
+#endif /* configNUMBER_OF_CORES > 1 */
 }
 /*-----------------------------------------------------------*/
 
@@ -187,9 +400,22 @@ BaseType_t xPortStartScheduler( void )
 
     hMainThread = pthread_self();
 
-    /* Start the timer that generates the tick ISR(SIGALRM).
-       Interrupts are disabled here already. */
-    prvSetupTimerInterrupt();
+    /* This thread never runs tasks, so it must not handle any interrupt.
+       On SMP, the kernel's critical sections re-enabled interrupts after
+       vTaskStartScheduler() disabled them. */
+    (void)pthread_sigmask( SIG_BLOCK, &xAllSignals, NULL );
+
+#if CONFIG_FREERTOS_LINUX_RECORD_REPLAY
+    prvStartRecordReplay();
+
+    /* A replay takes the recorded ticks instead */
+    if ( xReplaying == pdFALSE )
+#endif /* CONFIG_FREERTOS_LINUX_RECORD_REPLAY */
+    {
+        /* Start the timer that generates the tick ISR(SIGALRM).
+           Interrupts are disabled here already. */
+        prvSetupTimerInterrupt();
+    }
 
     /* Start the first task. */
     vPortStartFirstTask();
@@ -222,23 +448,39 @@ BaseType_t xPortStartScheduler( void )
 
 void vPortEndScheduler( void )
 {
+#if !defined( __linux__ )
     struct itimerval itimer;
+#endif /* !defined( __linux__ ) */
     struct sigaction sigtick;
     Thread_t *xCurrentThread;
 
     /* Stop the timer and ignore any pending SIGALRMs that would end
      * up running on the main thread when it is resumed. */
+#if defined( __linux__ )
+    /* The timer thread is cancelled while sleeping until the next deadline */
+    if ( xTimerThreadStarted != pdFALSE )
+    {
+        (void)pthread_cancel( hTimerThread );
+        (void)pthread_join( hTimerThread, NULL );
+        xTimerThreadStarted = pdFALSE;
+    }
+#else
     itimer.it_value.tv_sec = 0;
     itimer.it_value.tv_usec = 0;
 
     itimer.it_interval.tv_sec = 0;
     itimer.it_interval.tv_usec = 0;
     (void)setitimer( ITIMER_REAL, &itimer, NULL );
+#endif /* defined( __linux__ ) */
 
     sigtick.sa_flags = 0;
     sigtick.sa_handler = SIG_IGN;
     sigemptyset( &sigtick.sa_mask );
     sigaction( SIGALRM, &sigtick, NULL );
+    if ( __atomic_load_n( &xSimulatedInterruptsAllocated, __ATOMIC_ACQUIRE ) != 0 )
+    {
+        sigaction( SIG_IRQ, &sigtick, NULL );
+    }
 
     /* Signal the scheduler to exit its loop. */
     xSchedulerEnd = pdTRUE;
@@ -249,11 +491,105 @@ void vPortEndScheduler( void )
 }
 /*-----------------------------------------------------------*/
 
+/*
+ * Raises the interrupt level of the calling thread to uxLevel, unless it is
+ * higher already. Returns the previous level.
+ */
+static UBaseType_t prvRaiseInterruptLevel( UBaseType_t uxLevel )
+{
+    UBaseType_t uxPreviousLevel = uxInterruptLevel;
+#if CONFIG_FREERTOS_LINUX_RECORD_REPLAY
+    BaseType_t xPreemptionPoint;
+#endif /* CONFIG_FREERTOS_LINUX_RECORD_REPLAY */
+
+    if ( uxPreviousLevel == 0 )
+    {
+#if CONFIG_FREERTOS_LINUX_RECORD_REPLAY
+        xPreemptionPoint = xPortIsTaskThread();
+        if ( xPreemptionPoint != pdFALSE )
+        {
+            prvReplayInterrupts();
+        }
+#endif /* CONFIG_FREERTOS_LINUX_RECORD_REPLAY */
+
+        /* The tick is below any simulated interrupt line */
+        (void)pthread_sigmask( SIG_BLOCK, &xKernelSignals, NULL );
+
+#if CONFIG_FREERTOS_LINUX_RECORD_REPLAY
+        /* Counted once the tick is masked, so that it is recorded either
+         * before or after this critical section. */
+        if ( xPreemptionPoint != pdFALSE )
+        {
+            ullPreemptionPoints++;
+        }
+#endif /* CONFIG_FREERTOS_LINUX_RECORD_REPLAY */
+    }
+    if ( uxLevel > uxPreviousLevel )
+    {
+        uxInterruptLevel = uxLevel;
+    }
+    portTSAN_ACQUIRE_KERNEL();
+
+    return uxPreviousLevel;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Lowers the interrupt level of the calling thread to uxLevel, and takes the
+ * interrupts that it no longer masks.
+ */
+/*
+ * Returns whether triggered lines are signalled to the running tasks, which
+ * is not the case during a replay (see prvReplayInterrupt()).
+ */
+static inline BaseType_t prvSignalSimulatedInterrupts( void )
+{
+#if CONFIG_FREERTOS_LINUX_RECORD_REPLAY
+    return ( __atomic_load_n( &xReplaying, __ATOMIC_SEQ_CST ) == pdFALSE ) ? pdTRUE : pdFALSE;
+#else
+    return pdTRUE;
+#endif /* CONFIG_FREERTOS_LINUX_RECORD_REPLAY */
+}
+/*-----------------------------------------------------------*/
+
+static void prvRestoreInterruptLevel( UBaseType_t uxLevel )
+{
+    portTSAN_RELEASE_KERNEL();
+    uxInterruptLevel = uxLevel;
+
+    if ( uxLevel == 0 )
+    {
+        (void)pthread_sigmask( SIG_UNBLOCK, &xKernelSignals, NULL );
+    }
+
+    /* SIG_IRQ may have been handled while the lines were masked, so signal
+     * them again. SIG_IRQ is not blocked here, so it is handled right away. */
+    if ( ( ( __atomic_load_n( &ulSimulatedInterruptsPending, __ATOMIC_SEQ_CST ) & ulLinesAboveLevel[ uxLevel ] ) != 0 ) &&
+         ( prvSignalSimulatedInterrupts() != pdFALSE ) )
+    {
+        (void)pthread_kill( pthread_self(), SIG_IRQ );
+    }
+
+#if ( configNUMBER_OF_CORES == 1 )
+    if ( ( uxLevel == 0 ) && ( xIsrSwitchPending != pdFALSE ) )
+    {
+        xIsrSwitchPending = pdFALSE;
+        vPortYield();
+    }
+#endif /* configNUMBER_OF_CORES == 1 */
+}
+/*-----------------------------------------------------------*/
+
 void vPortEnterCritical( void )
 {
-    if ( uxCriticalNesting == 0 )
+    UBaseType_t uxPreviousLevel = prvRaiseInterruptLevel( configMAX_SYSCALL_INTERRUPT_PRIORITY );
+
+    if ( uxPreviousLevel < configMAX_SYSCALL_INTERRUPT_PRIORITY )
     {
-        vPortDisableInterrupts();
+        /* Only lines above configMAX_SYSCALL_INTERRUPT_PRIORITY can nest until
+         * the matching exit, and they do not enter critical sections. */
+        xMaskedAtNesting = uxCriticalNesting;
+        uxLevelBeforeMask = uxPreviousLevel;
     }
     uxCriticalNesting++;
 }
@@ -269,14 +605,58 @@ void vPortExitCritical( void )
     /* Critical section nesting count must always be >= 0. */
     configASSERT( uxCriticalNesting >= 0 );
 
-    /* If we have reached 0 then re-enable the interrupts. */
-    if( uxCriticalNesting == 0 )
+    /* If we have reached the critical section that masked interrupts, unmask them. */
+    if( uxCriticalNesting == xMaskedAtNesting )
+    {
+        xMaskedAtNesting = -1;
+        prvRestoreInterruptLevel( uxLevelBeforeMask );
+    }
+}
+/*-----------------------------------------------------------*/
+
+#if ( configNUMBER_OF_CORES > 1 )
+void vPortEnterCriticalMux( portMUX_TYPE *mux )
+{
+    vPortEnterCritical();
+    spinlock_acquire( mux, SPINLOCK_WAIT_FOREVER );
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCriticalMux( portMUX_TYPE *mux )
+{
+    spinlock_release( mux );
+    vPortExitCritical();
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortGetCoreID( void )
+{
+    return xThreadCoreID;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInterruptCore( BaseType_t xCoreID )
+{
+    /* If the core has just switched threads, this may signal the previous
+     * thread, which ignores it. The new thread checks for pending interrupts
+     * once it has published its ID (see prvRunOnCore()). */
+    pid_t xTid = __atomic_load_n( &xCoreThreadTid[ xCoreID ], __ATOMIC_SEQ_CST );
+
+    if ( xTid != 0 )
     {
-        vPortEnableInterrupts();
+        (void)syscall( SYS_tgkill, getpid(), xTid, SIG_IPI );
     }
 }
 /*-----------------------------------------------------------*/
 
+void vPortYieldOtherCore( BaseType_t xCoreID )
+{
+    __atomic_store_n( &xCoreYieldPending[ xCoreID ], pdTRUE, __ATOMIC_SEQ_CST );
+    prvInterruptCore( xCoreID );
+}
+/*-----------------------------------------------------------*/
+#endif /* configNUMBER_OF_CORES > 1 */
+
 void vPortYieldFromISR( void )
 {
     Thread_t *xThreadToSuspend;
@@ -284,7 +664,7 @@ void vPortYieldFromISR( void )
 
     xThreadToSuspend = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
 
-    vTaskSwitchContext();
+    prvSwitchContext();
 
     xThreadToResume = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
 
@@ -292,11 +672,53 @@ void vPortYieldFromISR( void )
 }
 /*-----------------------------------------------------------*/
 
+/*
+ * Selects the task to run, and records or checks the switch in a recording.
+ */
+static void prvSwitchContext( void )
+{
+    vTaskSwitchContext();
+
+#if CONFIG_FREERTOS_LINUX_RECORD_REPLAY
+    prvRecordSwitch();
+#endif /* CONFIG_FREERTOS_LINUX_RECORD_REPLAY */
+}
+/*-----------------------------------------------------------*/
+
 void vPortYield( void )
 {
+    sigset_t xSavedMask;
+
+#if ( configNUMBER_OF_CORES > 1 )
+    if ( uxCriticalNesting > 0 )
+    {
+        /* This thread may hold a spinlock, so it must not be switched out.
+         * The interrupt is taken when the critical section is exited. */
+        vPortYieldOtherCore( xThreadCoreID );
+        return;
+    }
+#else
+    if ( uxIsrNesting > 0 )
+    {
+        /* Called from a simulated ISR, which must return first */
+        xIsrSwitchPending = pdTRUE;
+        return;
+    }
+#endif /* configNUMBER_OF_CORES > 1 */
+
     vPortEnterCritical();
 
+    /* Critical sections do not mask all simulated interrupts, but this
+     * thread must not take any of them while suspended. */
+    (void)pthread_sigmask( SIG_BLOCK, &xIrqSignal, &xSavedMask );
+
+    /* The kernel call yielding is ordered before the task switched in, but
+     * the tick preempting a task is not (see the handoff annotations). */
+    portTSAN_RELEASE_KERNEL();
     vPortYieldFromISR();
+    portTSAN_ACQUIRE_KERNEL();
+
+    (void)pthread_sigmask( SIG_SETMASK, &xSavedMask, NULL );
 
     vPortExitCritical();
 }
@@ -304,26 +726,38 @@ void vPortYield( void )
 
 void vPortDisableInterrupts( void )
 {
-    pthread_sigmask( SIG_BLOCK, &xAllSignals, NULL );
+    (void)prvRaiseInterruptLevel( configMAX_SYSCALL_INTERRUPT_PRIORITY );
 }
 /*-----------------------------------------------------------*/
 
 void vPortEnableInterrupts( void )
 {
-    pthread_sigmask( SIG_UNBLOCK, &xAllSignals, NULL );
+    /* Also unblocks SIG_IRQ, for threads that start with all signals blocked */
+    (void)pthread_sigmask( SIG_UNBLOCK, &xAllSignals, NULL );
+    prvRestoreInterruptLevel( 0 );
 }
 /*-----------------------------------------------------------*/
 
 BaseType_t xPortSetInterruptMask( void )
 {
-    /* Interrupts are always disabled inside ISRs (signals
-       handlers). */
-    return pdTRUE;
+    /* Also called by tasks on SMP, so that they are not moved to
+       another core in between. Returns the previous level. */
+    return ( BaseType_t ) prvRaiseInterruptLevel( configMAX_SYSCALL_INTERRUPT_PRIORITY );
 }
 /*-----------------------------------------------------------*/
 
 void vPortClearInterruptMask( BaseType_t xMask )
 {
+    if ( ( UBaseType_t ) xMask < uxInterruptLevel )
+    {
+        prvRestoreInterruptLevel( ( UBaseType_t ) xMask );
+    }
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxPortGetInterruptLevel( void )
+{
+    return uxInterruptLevel;
 }
 /*-----------------------------------------------------------*/
 
@@ -336,17 +770,66 @@ static uint64_t prvGetTimeNs(void)
     return t.tv_sec * 1000000000ull + t.tv_nsec;
 }
 
-static uint64_t prvStartTimeNs;
-/* commented as part of the code below in vPortSystemTickHandler,
- * to adjust timing according to full demo requirements */
-/* static uint64_t prvTickCount; */
+#if defined( __linux__ )
+static void *prvTimerThread( void *pvParams )
+{
+    uint64_t ullStartNs;
+    uint64_t ullDeadlineNs;
+    struct timespec xDeadline;
+
+    /* Signals are blocked in this thread, as in the thread that created it */
+    for ( ; ; )
+    {
+        /* Sleep until the next deadline. Deadlines are absolute, so the time
+         * taken by this loop does not add up. */
+        ullStartNs = __atomic_load_n( &prvStartTimeNs, __ATOMIC_ACQUIRE );
+        ullDeadlineNs = ullStartNs + ( ( prvGetTimeNs() - ullStartNs ) / portTICK_PERIOD_NS + 1 ) * portTICK_PERIOD_NS;
+        xDeadline.tv_sec = ullDeadlineNs / 1000000000ULL;
+        xDeadline.tv_nsec = ullDeadlineNs % 1000000000ULL;
+
+        while ( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xDeadline, NULL ) == EINTR )
+        {
+        }
+
+        /* The deadlines were restarted in the meantime (see
+         * prvSetupTimerInterrupt()), so this one is gone. */
+        if ( __atomic_load_n( &prvStartTimeNs, __ATOMIC_ACQUIRE ) != ullStartNs )
+        {
+            continue;
+        }
+
+        /* Handled by the thread of a task running with interrupts enabled */
+        (void)kill( getpid(), SIGALRM );
+    }
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+#endif /* defined( __linux__ ) */
 
 /*
  * Setup the systick timer to generate the tick interrupts at the required
- * frequency.
+ * frequency. Called again to restart the tick deadlines from now.
  */
 void prvSetupTimerInterrupt( void )
 {
+#if defined( __linux__ )
+    int iRet;
+
+    prvTickCount = 0;
+    prvTicksSignalled = 0;
+    __atomic_store_n( &prvStartTimeNs, prvGetTimeNs(), __ATOMIC_RELEASE );
+
+    if ( xTimerThreadStarted == pdFALSE )
+    {
+        iRet = pthread_create( &hTimerThread, NULL, prvTimerThread, NULL );
+        if ( iRet )
+        {
+            prvFatalError( "pthread_create", iRet );
+        }
+        xTimerThreadStarted = pdTRUE;
+    }
+#else
     struct itimerval itimer;
     int iRet;
 
@@ -372,113 +855,1021 @@ void prvSetupTimerInterrupt( void )
         prvFatalError( "setitimer", errno );
     }
 
+    prvTickCount = 0;
+    prvTicksSignalled = 0;
     prvStartTimeNs = prvGetTimeNs();
+#endif /* defined( __linux__ ) */
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the number of ticks to handle on this tick interrupt, i.e., the
+ * ticks whose deadline has passed but were not handled yet, up to
+ * portMAX_TICKS_PER_INTERRUPT. Called from the tick interrupt.
+ */
+static UBaseType_t prvGetTicksDue( void )
+{
+    uint64_t ullNowNs;
+    uint64_t ullTicksPassed;
+    uint64_t ullJitterNs;
+    UBaseType_t uxTicks = 0;
+
+    portENTER_CRITICAL_ISR( &xTickLock );
+
+    ullNowNs = prvGetTimeNs();
+    ullTicksPassed = ( ullNowNs - prvStartTimeNs ) / portTICK_PERIOD_NS;
+
+    if ( ullTicksPassed > prvTickCount )
+    {
+        /* Signals are merged while pending, so of the deadlines passed since
+         * the last tick interrupt, all but one lost their signal. */
+        if ( ullTicksPassed > prvTicksSignalled )
+        {
+            xTickStats.ullLostTicks += ullTicksPassed - prvTicksSignalled - 1;
+            prvTicksSignalled = ullTicksPassed;
+        }
+
+        /* Delay since the deadline of the first tick handled */
+        ullJitterNs = ullNowNs - ( prvStartTimeNs + ( prvTickCount + 1 ) * portTICK_PERIOD_NS );
+        xTickStats.ullTotalJitterNs += ullJitterNs;
+        if ( ullJitterNs > xTickStats.ullMaxJitterNs )
+        {
+            xTickStats.ullMaxJitterNs = ullJitterNs;
+        }
+
+        uxTicks = ( UBaseType_t ) ( ullTicksPassed - prvTickCount );
+        if ( uxTicks > portMAX_TICKS_PER_INTERRUPT )
+        {
+            uxTicks = portMAX_TICKS_PER_INTERRUPT;
+        }
+        if ( uxTicks > xTickStats.ulMaxTicksPerInterrupt )
+        {
+            xTickStats.ulMaxTicksPerInterrupt = ( uint32_t ) uxTicks;
+        }
+
+        prvTickCount += uxTicks;
+        xTickStats.ullInterrupts++;
+        xTickStats.ullTicks += uxTicks;
+    }
+
+    portEXIT_CRITICAL_ISR( &xTickLock );
+
+    return uxTicks;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetTickStats( PortTickStats_t *pxStats )
+{
+    uint64_t ullTicksPassed;
+
+    portENTER_CRITICAL( &xTickLock );
+
+    *pxStats = xTickStats;
+    pxStats->ulBacklog = 0;
+
+    if ( prvStartTimeNs != 0 )
+    {
+        ullTicksPassed = ( prvGetTimeNs() - prvStartTimeNs ) / portTICK_PERIOD_NS;
+        if ( ullTicksPassed > prvTickCount )
+        {
+            pxStats->ulBacklog = ( uint32_t ) ( ullTicksPassed - prvTickCount );
+        }
+    }
+
+    portEXIT_CRITICAL( &xTickLock );
+}
+/*-----------------------------------------------------------*/
+
+void vPortResetTickStats( void )
+{
+    portENTER_CRITICAL( &xTickLock );
+
+    memset( &xTickStats, 0, sizeof( xTickStats ) );
+
+    portEXIT_CRITICAL( &xTickLock );
 }
 /*-----------------------------------------------------------*/
 
 static void vPortSystemTickHandler( int sig )
 {
+#if ( configNUMBER_OF_CORES > 1 )
+    BaseType_t xCoreID;
+    UBaseType_t uxTicks;
+
+    uxCriticalNesting++; /* Signals are blocked in this signal handler. */
+    uxInterruptLevel = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+
+    uxTicks = prvGetTicksDue();
+
+    /* A single host timer ticks all cores. The other cores are interrupted
+     * to handle their ticks. */
+    for ( xCoreID = 0; ( xCoreID < configNUMBER_OF_CORES ) && ( uxTicks > 0 ); xCoreID++ )
+    {
+        __atomic_add_fetch( &uxCorePendingTicks[ xCoreID ], uxTicks, __ATOMIC_SEQ_CST );
+
+        if ( xCoreID != xThreadCoreID )
+        {
+            prvInterruptCore( xCoreID );
+        }
+    }
+
+    uxInterruptLevel = 0;
+    uxCriticalNesting--;
+
+    prvHandleCoreInterrupts();
+#else
     Thread_t *pxThreadToSuspend;
     Thread_t *pxThreadToResume;
-    /* uint64_t xExpectedTicks; */
+    UBaseType_t uxTicks;
 
     uxCriticalNesting++; /* Signals are blocked in this signal handler. */
+    /* The tick only interrupts level 0, and masks the lines up to
+     * configMAX_SYSCALL_INTERRUPT_PRIORITY as a critical section would.
+     * The lines above preempt it, so SIG_IRQ is unblocked until the tick
+     * is handled. */
+    uxInterruptLevel = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+    (void)pthread_sigmask( SIG_UNBLOCK, &xIrqSignal, NULL );
+
+    /* Tick Increment, accounting for any lost signals. */
+    uxTicks = prvGetTicksDue();
+    if ( uxTicks == 0 )
+    {
+        /* Signal sent for a deadline that was restarted */
+        (void)pthread_sigmask( SIG_BLOCK, &xIrqSignal, NULL );
+        uxInterruptLevel = 0;
+        uxCriticalNesting--;
+        return;
+    }
+
+#if CONFIG_FREERTOS_LINUX_RECORD_REPLAY
+    if ( iRecordFd >= 0 )
+    {
+        prvRecordEvent( 'T', uxTicks, NULL );
+    }
+#endif /* CONFIG_FREERTOS_LINUX_RECORD_REPLAY */
 
 #if ( configUSE_PREEMPTION == 1 )
     pxThreadToSuspend = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
 #endif
 
-    /* Tick Increment, accounting for any lost signals or drift in
-     * the timer. */
-/*
- *      Comment code to adjust timing according to full demo requirements
- *      xExpectedTicks = (prvGetTimeNs() - prvStartTimeNs)
- *        / (portTICK_RATE_MICROSECONDS * 1000);
- * do { */
+    for ( ; uxTicks > 0; uxTicks-- )
+    {
         xTaskIncrementTick();
-/*        prvTickCount++;
- *    } while (prvTickCount < xExpectedTicks);
-*/
+    }
+
+    /* Blocked in signal handlers, and while the thread is suspended */
+    (void)pthread_sigmask( SIG_BLOCK, &xIrqSignal, NULL );
 
 #if ( configUSE_PREEMPTION == 1 )
     /* Select Next Task. */
-    vTaskSwitchContext();
+    prvSwitchContext();
 
     pxThreadToResume = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
 
     prvSwitchThread(pxThreadToResume, pxThreadToSuspend);
 #endif
 
+    uxInterruptLevel = 0;
     uxCriticalNesting--;
+#endif /* configNUMBER_OF_CORES > 1 */
 }
 /*-----------------------------------------------------------*/
 
-void vPortThreadDying( void *pxTaskToDelete, volatile BaseType_t *pxPendYield )
+BaseType_t xPortAllocateSimulatedInterrupt( UBaseType_t uxPriority, PortSimulatedIsr_t pxIsr, void *pvArg )
 {
-    Thread_t *pxThread = prvGetThreadFromTask( pxTaskToDelete );
+    BaseType_t xLine = -1;
+    UBaseType_t uxLevel;
+    sigset_t xSavedMask;
 
-    pxThread->xDying = pdTRUE;
-}
+    configASSERT( ( uxPriority >= 1 ) && ( uxPriority <= portMAX_SIMULATED_INTERRUPT_PRIORITY ) );
 
-void vPortCancelThread( void *pxTaskToDelete )
-{
-    Thread_t *pxThreadToCancel = prvGetThreadFromTask( pxTaskToDelete );
+    /* The handler must be installed before the first trigger, which may
+     * happen before any task is created. */
+    (void)pthread_once( &hSigSetupThread, prvSetupSignalsAndSchedulerPolicy );
+    (void)pthread_once( &hSigIrqSetupThread, prvInstallSimulatedInterruptHandler );
 
-    /*
-     * The thread has already been suspended so it can be safely cancelled.
-     */
-    pthread_cancel( pxThreadToCancel->pthread );
-    pthread_join( pxThreadToCancel->pthread, NULL );
-    event_delete( pxThreadToCancel->ev );
+    /* Also called from host threads that are not tasks, which must not touch
+     * the critical nesting. Signals are blocked so that a task cannot be
+     * switched out while holding the lock. */
+    (void)pthread_sigmask( SIG_BLOCK, &xAllSignals, &xSavedMask );
+    (void)pthread_mutex_lock( &xSimulatedInterruptsLock );
+
+    if ( xSimulatedInterruptsAllocated < portNUM_SIMULATED_INTERRUPTS )
+    {
+        xLine = xSimulatedInterruptsAllocated;
+        pxSimulatedIsrs[ xLine ] = pxIsr;
+        pvSimulatedIsrArgs[ xLine ] = pvArg;
+        uxSimulatedIsrPriorities[ xLine ] = uxPriority;
+        for ( uxLevel = 0; uxLevel < uxPriority; uxLevel++ )
+        {
+            __atomic_or_fetch( &ulLinesAboveLevel[ uxLevel ], 1UL << xLine, __ATOMIC_SEQ_CST );
+        }
+        /* Published after the ISR, for the handler running on another thread */
+        __atomic_store_n( &xSimulatedInterruptsAllocated, xLine + 1, __ATOMIC_RELEASE );
+    }
+
+    (void)pthread_mutex_unlock( &xSimulatedInterruptsLock );
+    (void)pthread_sigmask( SIG_SETMASK, &xSavedMask, NULL );
+
+    return xLine;
 }
 /*-----------------------------------------------------------*/
 
-static void *prvWaitForStart( void * pvParams )
+void vPortTriggerSimulatedInterrupt( BaseType_t xLine )
 {
-    Thread_t *pxThread = pvParams;
-
-    prvSuspendSelf(pxThread);
+    uint64_t ullNoTimeNs = 0;
 
-    /* Resumed for the first time, unblocks all signals. */
-    uxCriticalNesting = 0;
-    vPortEnableInterrupts();
+    configASSERT( ( xLine >= 0 ) && ( xLine < __atomic_load_n( &xSimulatedInterruptsAllocated, __ATOMIC_ACQUIRE ) ) );
 
-    /* Call the task's entry point. */
-    pxThread->pxCode( pxThread->pvParams );
+    __atomic_add_fetch( &xSimulatedInterruptStats[ xLine ].ullTriggers, 1, __ATOMIC_RELAXED );
 
-    /* A function that implements a task must not exit or attempt to return to
-    * its caller as there is nothing to return to. If a task wants to exit it
-    * should instead call vTaskDelete( NULL ). Artificially force an assert()
-    * to be triggered if configASSERT() is defined, so application writers can
-        * catch the error. */
-    configASSERT( pdFALSE );
+    /* The latency is counted from the first of the merged triggers */
+    (void)__atomic_compare_exchange_n( &ullPendingSinceNs[ xLine ], &ullNoTimeNs, prvGetTimeNs(), pdFALSE,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST );
 
-    return NULL;
+    /* Signals are merged while pending, so the lines to service are flagged
+     * separately. A single signal then services all of them. */
+    __atomic_or_fetch( &ulSimulatedInterruptsPending, 1UL << xLine, __ATOMIC_SEQ_CST );
+    if ( prvSignalSimulatedInterrupts() != pdFALSE )
+    {
+        (void)kill( getpid(), SIG_IRQ );
+    }
 }
 /*-----------------------------------------------------------*/
 
-static void prvSwitchThread( Thread_t *pxThreadToResume,
-                             Thread_t *pxThreadToSuspend )
+/*
+ * Takes the highest priority line pending above uxLevel, so that no other
+ * thread runs its ISR for the same trigger. Returns -1 if there is none.
+ */
+static BaseType_t prvTakePendingLine( UBaseType_t uxLevel )
 {
-    BaseType_t uxSavedCriticalNesting;
+    uint32_t ulPending;
+    BaseType_t xLine;
+    BaseType_t xBestLine;
 
-    if ( pxThreadToSuspend != pxThreadToResume )
+    for ( ; ; )
     {
-        /*
-         * Switch tasks.
-         *
-         * The critical section nesting is per-task, so save it on the
-         * stack of the current (suspending thread), restoring it when
+        ulPending = __atomic_load_n( &ulSimulatedInterruptsPending, __ATOMIC_SEQ_CST ) &
+                    __atomic_load_n( &ulLinesAboveLevel[ uxLevel ], __ATOMIC_SEQ_CST );
+        if ( ulPending == 0 )
+        {
+            return -1;
+        }
+
+        xBestLine = -1;
+        for ( xLine = 0; ulPending != 0; xLine++, ulPending >>= 1 )
+        {
+            if ( ( ( ulPending & 1UL ) != 0 ) &&
+                 ( ( xBestLine < 0 ) || ( uxSimulatedIsrPriorities[ xLine ] > uxSimulatedIsrPriorities[ xBestLine ] ) ) )
+            {
+                xBestLine = xLine;
+            }
+        }
+
+        if ( ( __atomic_fetch_and( &ulSimulatedInterruptsPending, ~( 1UL << xBestLine ), __ATOMIC_SEQ_CST ) &
+               ( 1UL << xBestLine ) ) != 0 )
+        {
+            return xBestLine;
+        }
+        /* Taken by another thread in the meantime */
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Runs the ISR of a line taken at uxLevel, with all signals blocked. Returns
+ * whether the ISR requires a context switch.
+ */
+static BaseType_t prvRunSimulatedIsr( BaseType_t xLine, UBaseType_t uxLevel )
+{
+    BaseType_t xSwitchRequired;
+    uint64_t ullSinceNs;
+    uint64_t ullLatencyNs;
+    uint64_t ullMaxLatencyNs;
+    PortSimulatedInterruptStats_t *pxStats = &xSimulatedInterruptStats[ xLine ];
+
+#if CONFIG_FREERTOS_LINUX_RECORD_REPLAY
+    if ( iRecordFd >= 0 )
+    {
+        prvRecordEvent( 'I', ( uint64_t ) xLine, NULL );
+    }
+#endif /* CONFIG_FREERTOS_LINUX_RECORD_REPLAY */
+
+    __atomic_add_fetch( &pxStats->ullRuns, 1, __ATOMIC_RELAXED );
+
+    /* Zero if triggered again while it was being taken, the latency of
+     * that trigger is then not counted. */
+    ullSinceNs = __atomic_exchange_n( &ullPendingSinceNs[ xLine ], 0, __ATOMIC_SEQ_CST );
+    if ( ullSinceNs != 0 )
+    {
+        ullLatencyNs = prvGetTimeNs() - ullSinceNs;
+        __atomic_add_fetch( &pxStats->ullTotalLatencyNs, ullLatencyNs, __ATOMIC_RELAXED );
+        ullMaxLatencyNs = __atomic_load_n( &pxStats->ullMaxLatencyNs, __ATOMIC_RELAXED );
+        while ( ( ullLatencyNs > ullMaxLatencyNs ) &&
+                !__atomic_compare_exchange_n( &pxStats->ullMaxLatencyNs, &ullMaxLatencyNs, ullLatencyNs, pdFALSE,
+                                              __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )
+        {
+        }
+    }
+
+    /* Higher priority lines preempt the ISR. The other signals stay
+     * blocked until the handler returns. */
+    uxInterruptLevel = uxSimulatedIsrPriorities[ xLine ];
+    uxIsrNesting++;
+    (void)pthread_sigmask( SIG_UNBLOCK, &xIrqSignal, NULL );
+
+    portTSAN_ACQUIRE_KERNEL();
+    xSwitchRequired = pxSimulatedIsrs[ xLine ]( pvSimulatedIsrArgs[ xLine ] );
+    portTSAN_RELEASE_KERNEL();
+
+    (void)pthread_sigmask( SIG_BLOCK, &xIrqSignal, NULL );
+    uxIsrNesting--;
+    uxInterruptLevel = uxLevel;
+
+    return xSwitchRequired;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Runs the ISRs of the lines pending above uxLevel, the highest priority
+ * first. Called from the SIG_IRQ handler, with all signals blocked. Returns
+ * whether one of the ISRs requires a context switch.
+ */
+static BaseType_t prvDispatchSimulatedInterrupts( UBaseType_t uxLevel )
+{
+    BaseType_t xLine;
+    BaseType_t xSwitchRequired = pdFALSE;
+
+    while ( ( xLine = prvTakePendingLine( uxLevel ) ) >= 0 )
+    {
+        if ( prvRunSimulatedIsr( xLine, uxLevel ) != pdFALSE )
+        {
+            xSwitchRequired = pdTRUE;
+        }
+    }
+
+    return xSwitchRequired;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSimulatedInterruptHandler( int sig )
+{
+    /* Level of the code interrupted: a task, a critical section, or an ISR */
+    UBaseType_t uxSavedLevel = uxInterruptLevel;
+#if ( configNUMBER_OF_CORES > 1 )
+    BaseType_t xSwitchRequired;
+
+    uxCriticalNesting++; /* Signals are blocked in this signal handler. */
+
+    xSwitchRequired = prvDispatchSimulatedInterrupts( uxSavedLevel );
+
+    uxCriticalNesting--;
+
+    if ( xSwitchRequired != pdFALSE )
+    {
+        /* Taken with the other interrupts of this core, once it is back to level 0 */
+        vPortYieldOtherCore( xThreadCoreID );
+    }
+
+    if ( uxSavedLevel == 0 )
+    {
+        prvHandleCoreInterrupts();
+    }
+#else
+    Thread_t *pxThreadToSuspend;
+    Thread_t *pxThreadToResume;
+
+    uxCriticalNesting++; /* Signals are blocked in this signal handler. */
+
+    if ( prvDispatchSimulatedInterrupts( uxSavedLevel ) != pdFALSE )
+    {
+        xIsrSwitchPending = pdTRUE;
+    }
+
+    /* A nested ISR leaves the switch to the ISR it interrupted, and a
+     * critical section to prvRestoreInterruptLevel(). */
+    if ( ( uxSavedLevel == 0 ) && ( xIsrSwitchPending != pdFALSE ) )
+    {
+        xIsrSwitchPending = pdFALSE;
+        uxInterruptLevel = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+
+        pxThreadToSuspend = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+        prvSwitchContext();
+
+        pxThreadToResume = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+        prvSwitchThread( pxThreadToResume, pxThreadToSuspend );
+
+        uxInterruptLevel = 0;
+    }
+
+    uxCriticalNesting--;
+#endif /* configNUMBER_OF_CORES > 1 */
+}
+/*-----------------------------------------------------------*/
+
+static void *prvStormThread( void *pvParams )
+{
+    BaseType_t xLine = ( BaseType_t )( intptr_t )pvParams;
+    uint32_t ulCount = ulStormCounts[ xLine ];
+    uint32_t ulPeriodUs = ulStormPeriodsUs[ xLine ];
+#if defined( __linux__ )
+    uint64_t ullDeadlineNs = prvGetTimeNs();
+    struct timespec xDeadline;
+#endif /* defined( __linux__ ) */
+
+    /* Signals are blocked in this thread, as in the thread that created it */
+    for ( ; ulCount > 0; ulCount-- )
+    {
+        vPortTriggerSimulatedInterrupt( xLine );
+
+        if ( ulPeriodUs != 0 )
+        {
+#if defined( __linux__ )
+            /* Deadlines are absolute, as the tick's */
+            ullDeadlineNs += ulPeriodUs * 1000ULL;
+            xDeadline.tv_sec = ullDeadlineNs / 1000000000ULL;
+            xDeadline.tv_nsec = ullDeadlineNs % 1000000000ULL;
+
+            while ( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xDeadline, NULL ) == EINTR )
+            {
+            }
+#else
+            usleep( ulPeriodUs );
+#endif /* defined( __linux__ ) */
+        }
+    }
+
+    __atomic_store_n( &xStormRunning[ xLine ], pdFALSE, __ATOMIC_RELEASE );
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortInjectInterruptStorm( BaseType_t xLine, uint32_t ulCount, uint32_t ulPeriodUs )
+{
+    BaseType_t xNotRunning = pdFALSE;
+    pthread_t hStormThread;
+    pthread_attr_t xAttr;
+    sigset_t xSavedMask;
+    int iRet;
+
+    configASSERT( ( xLine >= 0 ) && ( xLine < __atomic_load_n( &xSimulatedInterruptsAllocated, __ATOMIC_ACQUIRE ) ) );
+
+    if ( !__atomic_compare_exchange_n( &xStormRunning[ xLine ], &xNotRunning, pdTRUE, pdFALSE,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ) )
+    {
+        return pdFAIL;
+    }
+
+    ulStormCounts[ xLine ] = ulCount;
+    ulStormPeriodsUs[ xLine ] = ulPeriodUs;
+
+    /* The storm thread must not handle any signal, as the timer thread */
+    (void)pthread_sigmask( SIG_BLOCK, &xAllSignals, &xSavedMask );
+
+    pthread_attr_init( &xAttr );
+    pthread_attr_setdetachstate( &xAttr, PTHREAD_CREATE_DETACHED );
+    iRet = pthread_create( &hStormThread, &xAttr, prvStormThread, ( void * )( intptr_t )xLine );
+    pthread_attr_destroy( &xAttr );
+
+    (void)pthread_sigmask( SIG_SETMASK, &xSavedMask, NULL );
+
+    if ( iRet )
+    {
+        prvFatalError( "pthread_create", iRet );
+    }
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetSimulatedInterruptStats( BaseType_t xLine, PortSimulatedInterruptStats_t *pxStats )
+{
+    PortSimulatedInterruptStats_t *pxLineStats;
+
+    configASSERT( ( xLine >= 0 ) && ( xLine < __atomic_load_n( &xSimulatedInterruptsAllocated, __ATOMIC_ACQUIRE ) ) );
+
+    pxLineStats = &xSimulatedInterruptStats[ xLine ];
+    pxStats->ullTriggers = __atomic_load_n( &pxLineStats->ullTriggers, __ATOMIC_RELAXED );
+    pxStats->ullRuns = __atomic_load_n( &pxLineStats->ullRuns, __ATOMIC_RELAXED );
+    pxStats->ullMaxLatencyNs = __atomic_load_n( &pxLineStats->ullMaxLatencyNs, __ATOMIC_RELAXED );
+    pxStats->ullTotalLatencyNs = __atomic_load_n( &pxLineStats->ullTotalLatencyNs, __ATOMIC_RELAXED );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortIsTaskThread( void )
+{
+    /* A task thread only runs while its task is the current task of its
+     * core, whereas another host thread is never the current task. */
+    TaskHandle_t xCurrentTask = xTaskGetCurrentTaskHandle();
+
+    return ( ( xCurrentTask != NULL ) &&
+             pthread_equal( prvGetThreadFromTask( xCurrentTask )->pthread, pthread_self() ) ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configNUMBER_OF_CORES > 1 )
+static void prvCoreInterruptHandler( int sig )
+{
+    prvHandleCoreInterrupts();
+}
+/*-----------------------------------------------------------*/
+
+static void prvHandleCoreInterrupts( void )
+{
+    Thread_t *pxThreadToSuspend;
+    Thread_t *pxThreadToResume;
+    BaseType_t xCoreID;
+    UBaseType_t uxTicks;
+    BaseType_t xYieldPending;
+    UBaseType_t uxSavedLevel = uxInterruptLevel;
+    sigset_t xSavedMask;
+
+    uxCriticalNesting++; /* Signals are blocked in this signal handler. */
+    uxInterruptLevel = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+
+    for ( ; ; )
+    {
+        /* Checked again after each switch, as this thread may be resumed on
+         * another core. */
+        xCoreID = xThreadCoreID;
+        uxTicks = __atomic_exchange_n( &uxCorePendingTicks[ xCoreID ], 0, __ATOMIC_SEQ_CST );
+        xYieldPending = __atomic_exchange_n( &xCoreYieldPending[ xCoreID ], pdFALSE, __ATOMIC_SEQ_CST );
+
+        if ( ( uxTicks == 0 ) && ( xYieldPending == pdFALSE ) )
+        {
+            break;
+        }
+
+        /* Simulated interrupts above the tick's level preempt it, as on the
+         * chips. SIG_IRQ is blocked again before the thread is switched. */
+        (void)pthread_sigmask( SIG_UNBLOCK, &xIrqSignal, &xSavedMask );
+        for ( ; uxTicks > 0; uxTicks-- )
+        {
+            if ( xCoreID == 0 )
+            {
+                xTaskIncrementTick();
+            }
+            else
+            {
+                xTaskIncrementTickOtherCores();
+            }
+        }
+        (void)pthread_sigmask( SIG_SETMASK, &xSavedMask, NULL );
+
+        pxThreadToSuspend = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+        vTaskSwitchContext();
+        pxThreadToResume = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+        prvSwitchThread( pxThreadToResume, pxThreadToSuspend );
+    }
+
+    uxInterruptLevel = uxSavedLevel;
+    uxCriticalNesting--;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunOnCore( Thread_t *pxThread )
+{
+    xThreadCoreID = pxThread->xCoreID;
+    __atomic_store_n( &xCoreThreadTid[ xThreadCoreID ], pxThread->xTid, __ATOMIC_SEQ_CST );
+
+    /* Interrupts signalled to the previous thread of this core are taken by
+     * this one, as soon as it enables interrupts. */
+    if ( ( __atomic_load_n( &uxCorePendingTicks[ xThreadCoreID ], __ATOMIC_SEQ_CST ) != 0 ) ||
+         ( __atomic_load_n( &xCoreYieldPending[ xThreadCoreID ], __ATOMIC_SEQ_CST ) != pdFALSE ) )
+    {
+        (void)pthread_kill( pthread_self(), SIG_IPI );
+    }
+}
+/*-----------------------------------------------------------*/
+#endif /* configNUMBER_OF_CORES > 1 */
+
+#if CONFIG_FREERTOS_LINUX_VIRTUAL_TIME
+void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+{
+    eSleepModeStatus eSleepStatus;
+
+    /* Block the tick signal, so that the tick count cannot change between
+     * confirming that all tasks are blocked and stepping it. */
+    vPortEnterCritical();
+
+    eSleepStatus = eTaskConfirmSleepModeStatus();
+
+    if ( eSleepStatus == eStandardSleep )
+    {
+        /* Nothing can happen before the next delayed task expiry, other than
+         * an interrupt from another host thread, so skip to it. The last tick
+         * is pended and unblocks the task once the scheduler resumes. */
+        vTaskStepTick( xExpectedIdleTime );
+
+        /* Give the unblocked task a full tick period before the next tick */
+        prvSetupTimerInterrupt();
+    }
+
+    vPortExitCritical();
+
+    if ( eSleepStatus == eNoTasksWaitingTimeout )
+    {
+        /* All tasks are blocked without a timeout, so only another host
+         * thread can unblock them. Wait for it in real time. */
+        usleep( portTICK_RATE_MICROSECONDS );
+    }
+}
+/*-----------------------------------------------------------*/
+#endif /* CONFIG_FREERTOS_LINUX_VIRTUAL_TIME */
+
+#if CONFIG_FREERTOS_LINUX_RECORD_REPLAY
+static void prvLoadReplay( const char *pcPath )
+{
+    FILE *pxFile;
+    char cLine[ 64 + configMAX_TASK_NAME_LEN ];
+    ReplayEvent_t xEvent;
+    unsigned long long ullPoint;
+    unsigned long long ullValue;
+    int iNameStart;
+    size_t uxCapacity = 0;
+
+    pxFile = fopen( pcPath, "r" );
+    if ( pxFile == NULL )
+    {
+        prvFatalError( pcPath, errno );
+    }
+
+    while ( fgets( cLine, sizeof( cLine ), pxFile ) != NULL )
+    {
+        memset( &xEvent, 0, sizeof( xEvent ) );
+        iNameStart = 0;
+        if ( ( sscanf( cLine, "%c %llu %llu %n", &xEvent.cType, &ullPoint, &ullValue, &iNameStart ) < 3 ) ||
+             ( strchr( "TIS", xEvent.cType ) == NULL ) ||
+             ( ( xEvent.cType == 'I' ) && ( ullValue >= portNUM_SIMULATED_INTERRUPTS ) ) )
+        {
+            fprintf( stderr, "%s: invalid event: %s", pcPath, cLine );
+            abort();
+        }
+        xEvent.ullPoint = ullPoint;
+        xEvent.ullValue = ullValue;
+        if ( iNameStart > 0 )
+        {
+            strncpy( xEvent.acTaskName, &cLine[ iNameStart ], sizeof( xEvent.acTaskName ) - 1 );
+            xEvent.acTaskName[ strcspn( xEvent.acTaskName, "\n" ) ] = '\0';
+        }
+
+        if ( uxReplayEventCount == uxCapacity )
+        {
+            uxCapacity = ( uxCapacity == 0 ) ? 1024 : uxCapacity * 2;
+            pxReplayEvents = realloc( pxReplayEvents, uxCapacity * sizeof( ReplayEvent_t ) );
+            if ( pxReplayEvents == NULL )
+            {
+                prvFatalError( "realloc", ENOMEM );
+            }
+        }
+        pxReplayEvents[ uxReplayEventCount++ ] = xEvent;
+    }
+
+    fclose( pxFile );
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Opens the recording or loads the replay named by the environment. Called
+ * before the first task starts.
+ */
+static void prvStartRecordReplay( void )
+{
+    const char *pcPath;
+
+    pcPath = getenv( "FREERTOS_LINUX_REPLAY" );
+    if ( pcPath != NULL )
+    {
+        prvLoadReplay( pcPath );
+        xReplaying = ( uxReplayEventCount > 0 ) ? pdTRUE : pdFALSE;
+        return;
+    }
+
+    pcPath = getenv( "FREERTOS_LINUX_RECORD" );
+    if ( pcPath != NULL )
+    {
+        iRecordFd = open( pcPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+        if ( iRecordFd < 0 )
+        {
+            prvFatalError( pcPath, errno );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Writes an event to the recording, with the preemption points passed before
+ * it. Also called from signal handlers, so each event is a single write().
+ */
+static void prvRecordEvent( char cType, uint64_t ullValue, const char *pcTaskName )
+{
+    char cLine[ 64 + configMAX_TASK_NAME_LEN ];
+    int iLength;
+
+    iLength = snprintf( cLine, sizeof( cLine ), "%c %llu %llu%s%s\n", cType,
+                        ( unsigned long long ) ullPreemptionPoints, ( unsigned long long ) ullValue,
+                        ( pcTaskName != NULL ) ? " " : "", ( pcTaskName != NULL ) ? pcTaskName : "" );
+
+    if ( write( iRecordFd, cLine, ( size_t ) iLength ) != iLength )
+    {
+        prvFatalError( "write", errno );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvReplayDiverged( const char *pcActual )
+{
+    const ReplayEvent_t *pxEvent = &pxReplayEvents[ uxReplayNextEvent ];
+
+    fprintf( stderr, "Replay diverged at preemption point %llu: %s, recorded event %zu is %c %llu %llu %s\n",
+             ( unsigned long long ) ullPreemptionPoints, pcActual, uxReplayNextEvent, pxEvent->cType,
+             ( unsigned long long ) pxEvent->ullPoint, ( unsigned long long ) pxEvent->ullValue, pxEvent->acTaskName );
+    abort();
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Records the task switched in by vTaskSwitchContext(), or checks it against
+ * the replay.
+ */
+static void prvRecordSwitch( void )
+{
+    const char *pcTaskName = pcTaskGetName( NULL );
+    TickType_t xTicks = xTaskGetTickCountFromISR();
+    const ReplayEvent_t *pxEvent;
+    char cActual[ 64 + configMAX_TASK_NAME_LEN ];
+
+    if ( iRecordFd >= 0 )
+    {
+        prvRecordEvent( 'S', xTicks, pcTaskName );
+    }
+    else if ( ( xReplaying != pdFALSE ) && ( uxReplayNextEvent < uxReplayEventCount ) )
+    {
+        pxEvent = &pxReplayEvents[ uxReplayNextEvent ];
+        if ( ( pxEvent->cType != 'S' ) || ( pxEvent->ullPoint != ullPreemptionPoints ) ||
+             ( pxEvent->ullValue != xTicks ) || ( strncmp( pxEvent->acTaskName, pcTaskName, configMAX_TASK_NAME_LEN ) != 0 ) )
+        {
+            snprintf( cActual, sizeof( cActual ), "switched to %s at tick %llu", pcTaskName, ( unsigned long long ) xTicks );
+            prvReplayDiverged( cActual );
+        }
+        uxReplayNextEvent++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Takes a recorded interrupt as the handler of its signal would. The running
+ * task may be switched out.
+ */
+static void prvReplayInterrupt( const ReplayEvent_t *pxEvent )
+{
+    Thread_t *pxThreadToSuspend;
+    Thread_t *pxThreadToResume;
+    BaseType_t xSwitchRequired = pdFALSE;
+    BaseType_t xLine;
+    uint64_t ullTicks;
+    sigset_t xSavedMask;
+
+    /* Signals are blocked in their handlers, and while a thread is suspended */
+    (void)pthread_sigmask( SIG_BLOCK, &xAllSignals, &xSavedMask );
+    uxCriticalNesting++;
+
+    if ( pxEvent->cType == 'T' )
+    {
+        uxInterruptLevel = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+        for ( ullTicks = pxEvent->ullValue; ullTicks > 0; ullTicks-- )
+        {
+            xTaskIncrementTick();
+        }
+#if ( configUSE_PREEMPTION == 1 )
+        xSwitchRequired = pdTRUE;
+#endif
+    }
+    else
+    {
+        /* The host thread raising the line may not have triggered it yet */
+        xLine = ( BaseType_t ) pxEvent->ullValue;
+        while ( ( __atomic_fetch_and( &ulSimulatedInterruptsPending, ~( 1UL << xLine ), __ATOMIC_SEQ_CST ) &
+                  ( 1UL << xLine ) ) == 0 )
+        {
+            usleep( 100 );
+        }
+
+        xSwitchRequired = prvRunSimulatedIsr( xLine, 0 );
+    }
+
+    if ( xSwitchRequired != pdFALSE )
+    {
+        uxInterruptLevel = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+
+        pxThreadToSuspend = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+        prvSwitchContext();
+
+        pxThreadToResume = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+        prvSwitchThread( pxThreadToResume, pxThreadToSuspend );
+    }
+
+    uxInterruptLevel = 0;
+    uxCriticalNesting--;
+    (void)pthread_sigmask( SIG_SETMASK, &xSavedMask, NULL );
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Ends the replay once all recorded events were taken. The simulator then
+ * continues in real time.
+ */
+static void prvEndReplay( void )
+{
+    sigset_t xSavedMask;
+
+    __atomic_store_n( &xReplaying, pdFALSE, __ATOMIC_SEQ_CST );
+
+    fprintf( stderr, "Replay finished at preemption point %llu\n", ( unsigned long long ) ullPreemptionPoints );
+
+    /* The timer thread must not handle any signal */
+    (void)pthread_sigmask( SIG_BLOCK, &xAllSignals, &xSavedMask );
+    prvSetupTimerInterrupt();
+    (void)pthread_sigmask( SIG_SETMASK, &xSavedMask, NULL );
+
+    /* Lines triggered since the last recorded one are taken now */
+    if ( __atomic_load_n( &ulSimulatedInterruptsPending, __ATOMIC_SEQ_CST ) != 0 )
+    {
+        (void)kill( getpid(), SIG_IRQ );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Takes the interrupts recorded before the preemption point the calling task
+ * is about to pass. Called at level 0 from a task.
+ */
+static void prvReplayInterrupts( void )
+{
+    const ReplayEvent_t *pxEvent;
+
+    while ( xReplaying != pdFALSE )
+    {
+        if ( uxReplayNextEvent == uxReplayEventCount )
+        {
+            prvEndReplay();
+            break;
+        }
+
+        pxEvent = &pxReplayEvents[ uxReplayNextEvent ];
+        if ( pxEvent->ullPoint > ullPreemptionPoints )
+        {
+            break;
+        }
+        if ( ( pxEvent->ullPoint < ullPreemptionPoints ) || ( pxEvent->cType == 'S' ) )
+        {
+            prvReplayDiverged( "not taken" );
+        }
+
+        /* Consumed first, as the context switches of the interrupt follow it */
+        uxReplayNextEvent++;
+        prvReplayInterrupt( pxEvent );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortPreemptionPoint( void )
+{
+    if ( ( uxInterruptLevel == 0 ) && ( xPortIsTaskThread() != pdFALSE ) )
+    {
+        prvReplayInterrupts();
+        ullPreemptionPoints++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortIsReplaying( void )
+{
+    return __atomic_load_n( &xReplaying, __ATOMIC_SEQ_CST );
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * The scheduler is suspended without a critical section on a single core, so
+ * the increment is masked here to be recorded either before or after the tick.
+ */
+void vPortSoftwareBarrier( void )
+{
+    if ( uxInterruptLevel == 0 )
+    {
+        (void)prvRaiseInterruptLevel( configMAX_SYSCALL_INTERRUPT_PRIORITY );
+        xBarrierMasked = pdTRUE;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortMemoryBarrier( void )
+{
+    __asm volatile( "" ::: "memory" );
+
+    if ( xBarrierMasked != pdFALSE )
+    {
+        xBarrierMasked = pdFALSE;
+        prvRestoreInterruptLevel( 0 );
+    }
+}
+/*-----------------------------------------------------------*/
+#endif /* CONFIG_FREERTOS_LINUX_RECORD_REPLAY */
+
+void vPortThreadDying( void *pxTaskToDelete, volatile BaseType_t *pxPendYield )
+{
+    Thread_t *pxThread = prvGetThreadFromTask( pxTaskToDelete );
+
+    pxThread->xDying = pdTRUE;
+}
+
+void vPortCancelThread( void *pxTaskToDelete )
+{
+    Thread_t *pxThreadToCancel = prvGetThreadFromTask( pxTaskToDelete );
+
+    /*
+     * The thread has already been suspended so it can be safely cancelled.
+     * The cancellation is deferred, and the thread only acts on it once its
+     * event wakes it up (see event_wait()).
+     */
+    pthread_cancel( pxThreadToCancel->pthread );
+    event_signal( pxThreadToCancel->ev );
+    pthread_join( pxThreadToCancel->pthread, NULL );
+    event_delete( pxThreadToCancel->ev );
+}
+/*-----------------------------------------------------------*/
+
+static void *prvWaitForStart( void * pvParams )
+{
+    Thread_t *pxThread = pvParams;
+
+#if ( configNUMBER_OF_CORES > 1 )
+    pxThread->xTid = (pid_t)syscall( SYS_gettid );
+#endif /* configNUMBER_OF_CORES > 1 */
+
+    prvSuspendSelf(pxThread);
+
+#if ( configNUMBER_OF_CORES > 1 )
+    prvRunOnCore(pxThread);
+#endif /* configNUMBER_OF_CORES > 1 */
+
+    /* Resumed for the first time, unblocks all signals. */
+    uxCriticalNesting = 0;
+    vPortEnableInterrupts();
+
+    /* As a task returning from the kernel call that switched it out, the task
+     * is ordered after the kernel call that switched it in. */
+    portTSAN_ACQUIRE_KERNEL();
+
+    /* Call the task's entry point. */
+    pxThread->pxCode( pxThread->pvParams );
+
+    /* A function that implements a task must not exit or attempt to return to
+    * its caller as there is nothing to return to. If a task wants to exit it
+    * should instead call vTaskDelete( NULL ). Artificially force an assert()
+    * to be triggered if configASSERT() is defined, so application writers can
+        * catch the error. */
+    configASSERT( pdFALSE );
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSwitchThread( Thread_t *pxThreadToResume,
+                             Thread_t *pxThreadToSuspend )
+{
+    BaseType_t uxSavedCriticalNesting;
+
+    if ( pxThreadToSuspend != pxThreadToResume )
+    {
+        /*
+         * Switch tasks.
+         *
+         * The critical section nesting is per-task, so save it on the
+         * stack of the current (suspending thread), restoring it when
          * we switch back to this task.
          */
         uxSavedCriticalNesting = uxCriticalNesting;
 
+#if ( configNUMBER_OF_CORES > 1 )
+        /* The resumed thread takes over the core of this one */
+        pxThreadToResume->xCoreID = xThreadCoreID;
+#endif /* configNUMBER_OF_CORES > 1 */
         prvResumeThread( pxThreadToResume );
         if ( pxThreadToSuspend->xDying )
         {
             pthread_exit( NULL );
         }
         prvSuspendSelf( pxThreadToSuspend );
+#if ( configNUMBER_OF_CORES > 1 )
+        prvRunOnCore( pxThreadToSuspend );
+#endif /* configNUMBER_OF_CORES > 1 */
 
         uxCriticalNesting = uxSavedCriticalNesting;
     }
@@ -488,19 +1879,21 @@ static void prvSwitchThread( Thread_t *pxThreadToResume,
 static void prvSuspendSelf( Thread_t *thread )
 {
     /*
-     * Suspend this thread by waiting for a pthread_cond_signal event.
+     * Suspend this thread by waiting for its event to be signaled.
      *
      * A suspended thread must not handle signals (interrupts) so
      * all signals must be blocked by calling this from:
      *
      * - Inside a critical section (vPortEnterCritical() /
-     *   vPortExitCritical()).
+     *   vPortExitCritical()), with SIG_IRQ blocked (see vPortYield()).
      *
      * - From a signal handler that has all signals masked.
      *
      * - A thread with all signals blocked with pthread_sigmask().
         */
+    portTSAN_IGNORE_SYNC_BEGIN();
     event_wait(thread->ev);
+    portTSAN_IGNORE_SYNC_END();
 }
 
 /*-----------------------------------------------------------*/
@@ -509,7 +1902,26 @@ static void prvResumeThread( Thread_t *xThreadId )
 {
     if ( pthread_self() != xThreadId->pthread )
     {
+        portTSAN_IGNORE_SYNC_BEGIN();
         event_signal(xThreadId->ev);
+        portTSAN_IGNORE_SYNC_END();
+    }
+}
+/*-----------------------------------------------------------*/
+
+/* SIG_IRQ is left to the application until a simulated interrupt line is
+ * allocated, as it is also the host's SIGIO. */
+static void prvInstallSimulatedInterruptHandler( void )
+{
+    struct sigaction sigirq;
+
+    sigirq.sa_flags = 0;
+    sigirq.sa_handler = prvSimulatedInterruptHandler;
+    sigfillset( &sigirq.sa_mask );
+
+    if ( sigaction( SIG_IRQ, &sigirq, NULL ) )
+    {
+        prvFatalError( "sigaction", errno );
     }
 }
 /*-----------------------------------------------------------*/
@@ -526,6 +1938,10 @@ static void prvSetupSignalsAndSchedulerPolicy( void )
     /* Don't block SIGINT so this can be used to break into GDB while
      * in a critical section. */
     sigdelset( &xAllSignals, SIGINT );
+    xKernelSignals = xAllSignals;
+    sigdelset( &xKernelSignals, SIG_IRQ );
+    sigemptyset( &xIrqSignal );
+    sigaddset( &xIrqSignal, SIG_IRQ );
 
     /*
      * Block all signals in this thread so all new threads
@@ -558,6 +1974,22 @@ static void prvSetupSignalsAndSchedulerPolicy( void )
     {
         prvFatalError( "sigaction", errno );
     }
+
+#if ( configNUMBER_OF_CORES > 1 )
+    {
+        struct sigaction sigipi;
+
+        sigipi.sa_flags = 0;
+        sigipi.sa_handler = prvCoreInterruptHandler;
+        sigfillset( &sigipi.sa_mask );
+
+        iRet = sigaction( SIG_IPI, &sigipi, NULL );
+        if ( iRet )
+        {
+            prvFatalError( "sigaction", errno );
+        }
+    }
+#endif /* configNUMBER_OF_CORES > 1 */
 }
 /*-----------------------------------------------------------*/
 
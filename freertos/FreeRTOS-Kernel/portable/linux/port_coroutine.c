@@ -0,0 +1,493 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------
+ * Implementation of functions defined in portable.h for the Linux
+ * simulator, running all tasks as coroutines on a single host thread
+ * (CONFIG_FREERTOS_LINUX_COROUTINE_PORT). This replaces port.c.
+ *
+ * Each task has a ucontext_t, stored at the top of the task's stack
+ * like the thread data of port.c. A task switch is a swapcontext() to
+ * the context of the next task, so it does not involve the host
+ * scheduler, and only one task is ever executing.
+ *
+ * There is no asynchronous tick interrupt. Instead, the tick is driven
+ * by a virtual clock, which advances by one tick:
+ *
+ * - Each time the idle task runs, as nothing else can happen until the
+ *   next tick.
+ *
+ * - Every CONFIG_FREERTOS_LINUX_COROUTINE_STEPS_PER_TICK kernel entries
+ *   (exits from the outermost critical section and reads of the tick
+ *   count) while tasks are busy, so that tasks polling the tick count
+ *   see it advance and tasks of equal priority are time sliced.
+ *
+ * A tick is then handled like a tick interrupt taken at that point:
+ * the tick count is incremented and, if preemption is enabled, the
+ * scheduler may switch to another task. As ticks only occur at these
+ * points, the interleaving of tasks only depends on the code being run
+ * and is identical from one run to the next.
+ *
+ * A task that busy-waits without entering the kernel (e.g., polling a
+ * variable written by another task) would never let the clock advance.
+ * A watchdog, driven by the host CPU time consumed by the process
+ * (SIGVTALRM), therefore takes a tick from the signal handler when the
+ * running task has not entered the kernel for a whole watchdog period.
+ * Deferring the tick to the next kernel entry would not help here, as
+ * the task never makes one, so the switch to another task is done by
+ * swapcontext() from within the signal handler. The handler's frame
+ * stays on the stack of the preempted task, and returns when that task
+ * is resumed. Where such a task gets preempted depends on the host, so
+ * only runs without busy-waiting are reproducible.
+ *
+ * Limitations:
+ *
+ * - A blocking host call (e.g., sleep() or read()) blocks all tasks.
+ *
+ * - Host clocks (e.g., gettimeofday()) are unrelated to the virtual
+ *   clock. ullPortGetVirtualTimeUs() returns the virtual time.
+ *
+ * - A task preempted by the watchdog may be anywhere, including inside a
+ *   C library function that is not async-signal-safe (e.g., malloc() or
+ *   printf()). Until it is resumed, the other tasks run as if called
+ *   from a signal handler, and calling such a function from one of them
+ *   may deadlock or corrupt the state of the C library.
+ *
+ * As all tasks run on the same host thread, and a task is otherwise
+ * only switched out inside the kernel, the standard C library, including
+ * stdio, can be used from any task as long as no task busy-waits.
+ *----------------------------------------------------------*/
+
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <ucontext.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+/*-----------------------------------------------------------*/
+
+#define portCOROUTINE_STEPS_PER_TICK    ( ( uint32_t ) CONFIG_FREERTOS_LINUX_COROUTINE_STEPS_PER_TICK )
+
+/* ucontext_t holds the FPU state, so keep it suitably aligned */
+#define portCOROUTINE_CONTEXT_ALIGNMENT 16
+
+/* Host CPU time after which a task that has not entered the kernel is
+ * preempted by the watchdog. */
+#define portCOROUTINE_WATCHDOG_PERIOD_US    10000
+
+typedef struct THREAD
+{
+    ucontext_t xContext;
+    TaskFunction_t pxCode;
+    void *pvParams;
+} Thread_t;
+
+/*
+ * The additional per-task data is stored at the beginning of the
+ * task's stack.
+ */
+static inline Thread_t *prvGetThreadFromTask(TaskHandle_t xTask)
+{
+    StackType_t *pxTopOfStack = *(StackType_t **)xTask;
+
+    return (Thread_t *)(pxTopOfStack + 1);
+}
+
+/*-----------------------------------------------------------*/
+
+static ucontext_t xSchedulerContext;            /* Context of xPortStartScheduler(), resumed by vPortEndScheduler() */
+static BaseType_t xSchedulerRunning = pdFALSE;
+static volatile BaseType_t uxCriticalNesting;
+static BaseType_t xInterruptsEnabled = pdFALSE;
+static uint32_t ulStepCount = 0;                /* Kernel entries since the last virtual tick */
+static uint64_t ullVirtualTicks = 0;            /* Virtual ticks since the scheduler was started */
+static volatile uint32_t ulKernelEntries = 0;   /* Incremented on each step, checked by the watchdog */
+static uint32_t ulWatchdogKernelEntries = 0;    /* Value of ulKernelEntries at the last watchdog signal */
+/*-----------------------------------------------------------*/
+
+static void prvCoroutineEntry( void );
+static void prvSwitchThread( Thread_t * pxThreadToResume,
+                             Thread_t * pxThreadToSuspend );
+static void prvDeliverPendingTick( void );
+static void vPortSystemTickHandler( void );
+static void prvWatchdogHandler( int sig );
+static void prvSetupWatchdog( BaseType_t xEnable );
+/*-----------------------------------------------------------*/
+
+static void prvFatalError( const char *pcCall, int iErrno )
+{
+    fprintf( stderr, "%s: %s\n", pcCall, strerror( iErrno ) );
+    abort();
+}
+
+/*
+ * See header file for description.
+ */
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack,
+                                    StackType_t *pxEndOfStack,
+                                    TaskFunction_t pxCode,
+                                    void *pvParameters )
+{
+    Thread_t *thread;
+    size_t ulStackSize;
+
+    /*
+     * Store the additional task data at the start of the stack, and run
+     * the coroutine on the rest of it.
+     */
+    thread = (Thread_t *)( ( ( portPOINTER_SIZE_TYPE )( pxTopOfStack + 1 ) - sizeof( Thread_t ) )
+                           & ~( ( portPOINTER_SIZE_TYPE ) portCOROUTINE_CONTEXT_ALIGNMENT - 1 ) );
+    pxTopOfStack = (StackType_t *)thread - 1;
+    ulStackSize = (pxTopOfStack + 1 - pxEndOfStack) * sizeof(*pxTopOfStack);
+
+    thread->pxCode = pxCode;
+    thread->pvParams = pvParameters;
+
+    if ( getcontext( &thread->xContext ) )
+    {
+        prvFatalError( "getcontext", errno );
+    }
+
+    thread->xContext.uc_stack.ss_sp = pxEndOfStack;
+    thread->xContext.uc_stack.ss_size = ulStackSize;
+    thread->xContext.uc_link = NULL;
+    makecontext( &thread->xContext, prvCoroutineEntry, 0 );
+
+    return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * See header file for description.
+ */
+BaseType_t xPortStartScheduler( void )
+{
+    Thread_t *pxFirstThread = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+    prvSetupWatchdog( pdTRUE );
+
+    /* Start the first task. Interrupts are disabled here already, and
+     * are enabled when the first task starts. */
+    xSchedulerRunning = pdTRUE;
+
+    if ( swapcontext( &xSchedulerContext, &pxFirstThread->xContext ) )
+    {
+        prvFatalError( "swapcontext", errno );
+    }
+
+    /* Resumed by vPortEndScheduler(). Tasks have no host resources, so
+     * there is nothing to clean up. */
+    return 0;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+    xSchedulerRunning = pdFALSE;
+    xInterruptsEnabled = pdFALSE;
+    prvSetupWatchdog( pdFALSE );
+
+    setcontext( &xSchedulerContext );
+    prvFatalError( "setcontext", errno );
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+    if ( uxCriticalNesting == 0 )
+    {
+        vPortDisableInterrupts();
+    }
+    uxCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+    if ( uxCriticalNesting > 0 )
+    {
+        uxCriticalNesting--;
+    }
+
+    /* Critical section nesting count must always be >= 0. */
+    configASSERT( uxCriticalNesting >= 0 );
+
+    /* If we have reached 0 then re-enable the interrupts, and count the
+     * exit as a step of the virtual clock. */
+    if( uxCriticalNesting == 0 )
+    {
+        vPortEnableInterrupts();
+        vPortCoroutineStep();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortYieldFromISR( void )
+{
+    Thread_t *xThreadToSuspend;
+    Thread_t *xThreadToResume;
+
+    xThreadToSuspend = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+    vTaskSwitchContext();
+
+    xThreadToResume = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+    prvSwitchThread( xThreadToResume, xThreadToSuspend );
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+    vPortEnterCritical();
+
+    vPortYieldFromISR();
+
+    vPortExitCritical();
+}
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts( void )
+{
+    xInterruptsEnabled = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts( void )
+{
+    xInterruptsEnabled = pdTRUE;
+
+    /* Take a tick that became due while interrupts were disabled */
+    prvDeliverPendingTick();
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortSetInterruptMask( void )
+{
+    /* The tick handler is the only ISR and cannot be nested. */
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortClearInterruptMask( BaseType_t xMask )
+{
+}
+/*-----------------------------------------------------------*/
+
+void vPortCoroutineStep( void )
+{
+    ulKernelEntries++;
+
+    if ( ulStepCount < portCOROUTINE_STEPS_PER_TICK )
+    {
+        ulStepCount++;
+    }
+
+    prvDeliverPendingTick();
+}
+/*-----------------------------------------------------------*/
+
+void vPortCoroutineIdle( void )
+{
+    /* No other task is ready to run, so nothing can happen before the
+     * next tick. Skip straight to it. */
+    ulKernelEntries++;
+    ulStepCount = portCOROUTINE_STEPS_PER_TICK;
+    prvDeliverPendingTick();
+}
+/*-----------------------------------------------------------*/
+
+uint64_t ullPortGetVirtualTimeUs( void )
+{
+    return ( ullVirtualTicks * portTICK_RATE_MICROSECONDS ) +
+           ( ( ( uint64_t ) ulStepCount * portTICK_RATE_MICROSECONDS ) / portCOROUTINE_STEPS_PER_TICK );
+}
+/*-----------------------------------------------------------*/
+
+static void prvDeliverPendingTick( void )
+{
+    /* A tick is only taken where a tick interrupt could be, i.e., when
+     * the scheduler is running and interrupts are enabled. Otherwise,
+     * it stays pending until interrupts are enabled again. */
+    if ( ( ulStepCount >= portCOROUTINE_STEPS_PER_TICK ) &&
+         ( xSchedulerRunning != pdFALSE ) &&
+         ( xInterruptsEnabled != pdFALSE ) &&
+         ( uxCriticalNesting == 0 ) )
+    {
+        ulStepCount = 0;
+        vPortSystemTickHandler();
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void vPortSystemTickHandler( void )
+{
+    Thread_t *pxThreadToSuspend;
+    Thread_t *pxThreadToResume;
+
+    /* Interrupts are masked in the tick handler. */
+    xInterruptsEnabled = pdFALSE;
+    uxCriticalNesting++;
+
+#if ( configUSE_PREEMPTION == 1 )
+    pxThreadToSuspend = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+#endif
+
+    ulKernelEntries++;
+    ullVirtualTicks++;
+    xTaskIncrementTick();
+
+#if ( configUSE_PREEMPTION == 1 )
+    /* Select Next Task. */
+    vTaskSwitchContext();
+
+    pxThreadToResume = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+    prvSwitchThread(pxThreadToResume, pxThreadToSuspend);
+#endif
+
+    uxCriticalNesting--;
+    xInterruptsEnabled = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWatchdogHandler( int sig )
+{
+    (void) sig;
+
+    if ( ulKernelEntries != ulWatchdogKernelEntries )
+    {
+        ulWatchdogKernelEntries = ulKernelEntries;
+        return;
+    }
+
+    /* The running task has not entered the kernel for a whole period,
+     * so it is busy-waiting. Take a tick here, like a tick interrupt
+     * would. If this switches to another task, the handler returns when
+     * this task is resumed. The switch is not async-signal-safe (see the
+     * limitations at the top of this file). */
+    if ( ( xSchedulerRunning != pdFALSE ) &&
+         ( xInterruptsEnabled != pdFALSE ) &&
+         ( uxCriticalNesting == 0 ) )
+    {
+        ulStepCount = 0;
+        vPortSystemTickHandler();
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvSetupWatchdog( BaseType_t xEnable )
+{
+    struct sigaction sigwatchdog;
+    struct itimerval itimer;
+
+    memset( &itimer, 0, sizeof( itimer ) );
+
+    if ( xEnable != pdFALSE )
+    {
+        sigwatchdog.sa_flags = SA_RESTART;
+        sigwatchdog.sa_handler = prvWatchdogHandler;
+        sigfillset( &sigwatchdog.sa_mask );
+
+        if ( sigaction( SIGVTALRM, &sigwatchdog, NULL ) )
+        {
+            prvFatalError( "sigaction", errno );
+        }
+
+        itimer.it_interval.tv_usec = portCOROUTINE_WATCHDOG_PERIOD_US;
+        itimer.it_value.tv_usec = portCOROUTINE_WATCHDOG_PERIOD_US;
+    }
+
+    if ( setitimer( ITIMER_VIRTUAL, &itimer, NULL ) )
+    {
+        prvFatalError( "setitimer", errno );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortThreadDying( void *pxTaskToDelete, volatile BaseType_t *pxPendYield )
+{
+    /* A coroutine has no host resources, and a task deleting itself is
+     * switched out by the yield that follows and never resumed. */
+    (void) pxTaskToDelete;
+    (void) pxPendYield;
+}
+
+void vPortCancelThread( void *pxTaskToDelete )
+{
+    /* The context is part of the task's stack, which is freed by the
+     * kernel. */
+    (void) pxTaskToDelete;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCoroutineEntry( void )
+{
+    Thread_t *pxThread = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+    /* Resumed for the first time, enables interrupts. */
+    uxCriticalNesting = 0;
+    vPortEnableInterrupts();
+
+    /* Call the task's entry point. */
+    pxThread->pxCode( pxThread->pvParams );
+
+    /* A function that implements a task must not exit or attempt to return to
+     * its caller as there is nothing to return to. If a task wants to exit it
+     * should instead call vTaskDelete( NULL ). Artificially force an assert()
+     * to be triggered if configASSERT() is defined, so application writers can
+     * catch the error. */
+    configASSERT( pdFALSE );
+    abort();
+}
+/*-----------------------------------------------------------*/
+
+static void prvSwitchThread( Thread_t *pxThreadToResume,
+                             Thread_t *pxThreadToSuspend )
+{
+    BaseType_t uxSavedCriticalNesting;
+    BaseType_t xSavedInterruptsEnabled;
+
+    if ( pxThreadToSuspend != pxThreadToResume )
+    {
+        /*
+         * Switch tasks.
+         *
+         * The critical section nesting and interrupt state are per-task,
+         * so save them on the stack of the current task, restoring them
+         * when we switch back to this task.
+         */
+        uxSavedCriticalNesting = uxCriticalNesting;
+        xSavedInterruptsEnabled = xInterruptsEnabled;
+
+        if ( swapcontext( &pxThreadToSuspend->xContext, &pxThreadToResume->xContext ) )
+        {
+            prvFatalError( "swapcontext", errno );
+        }
+
+        uxCriticalNesting = uxSavedCriticalNesting;
+        xInterruptsEnabled = xSavedInterruptsEnabled;
+    }
+}
+/*-----------------------------------------------------------*/
+
+unsigned long ulPortGetRunTime( void )
+{
+    return ( unsigned long ) ullPortGetVirtualTimeUs();
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetStackWatchpoint( void *pxStackStart )
+{
+    (void) pxStackStart;
+}
+/*-----------------------------------------------------------*/
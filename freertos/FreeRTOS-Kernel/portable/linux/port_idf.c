@@ -151,8 +151,20 @@ void esp_vApplicationIdleHook(void)
      * because it is the responsibility of the idle task to clean up memory
      * allocated by the kernel to any task that has since deleted itself. */
 
-
+#if CONFIG_FREERTOS_LINUX_COROUTINE_PORT
+    /* Time is virtual, so don't wait for the next tick but skip to it. */
+    vPortCoroutineIdle();
+#elif CONFIG_FREERTOS_LINUX_VIRTUAL_TIME
+    /* Idle time is skipped by vPortSuppressTicksAndSleep() right after this hook, don't wait for it in real time. */
+#elif CONFIG_FREERTOS_LINUX_RECORD_REPLAY
+    /* Each iteration is a preemption point, so that a replay takes the recorded ticks without waiting for them. */
+    vPortPreemptionPoint();
+    if (xPortIsReplaying() == pdFALSE) {
+        usleep( 15000 );
+    }
+#else
     usleep( 15000 );
+#endif
 }
 
 void esp_vApplicationTickHook( void ) { }
@@ -164,7 +176,9 @@ void vApplicationTickHook( void )
 }
 #endif
 
+#if ( configNUMBER_OF_CORES == 1 )
 void vPortYieldOtherCore( BaseType_t coreid ) { } // trying to skip for now
+#endif
 
 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
 /* configUSE_STATIC_ALLOCATION is set to 1, so the application must provide an
@@ -177,15 +191,20 @@ void vApplicationGetIdleTaskMemory( StaticTask_t ** ppxIdleTaskTCBBuffer,
 /* If the buffers to be provided to the Idle task are declared inside this
  * function then they must be declared static - otherwise they will be allocated on
  * the stack and so not exists after this function exits. */
-    static StaticTask_t xIdleTaskTCB;
-    static StackType_t uxIdleTaskStack[ configMINIMAL_STACK_SIZE ];
+    static StaticTask_t xIdleTaskTCB[ configNUMBER_OF_CORES ];
+    static StackType_t uxIdleTaskStack[ configNUMBER_OF_CORES ][ configMINIMAL_STACK_SIZE ];
+    /* Called once for each core's idle task, in core order */
+    static BaseType_t xNextCoreID = 0;
+
+    configASSERT( xNextCoreID < configNUMBER_OF_CORES );
 
     /* Pass out a pointer to the StaticTask_t structure in which the Idle task's
      * state will be stored. */
-    *ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+    *ppxIdleTaskTCBBuffer = &xIdleTaskTCB[ xNextCoreID ];
 
     /* Pass out the array that will be used as the Idle task's stack. */
-    *ppxIdleTaskStackBuffer = uxIdleTaskStack;
+    *ppxIdleTaskStackBuffer = uxIdleTaskStack[ xNextCoreID ];
+    xNextCoreID++;
 
     /* Pass out the size of the array pointed to by *ppxIdleTaskStackBuffer.
      * Note that, as the array is necessarily of type StackType_t,
@@ -38,6 +38,162 @@
 
 #include "wait_for_event.h"
 
+#if defined( __linux__ )
+
+/*
+ * On Linux, an event is a single futex word, so that a task switch (i.e., the
+ * resuming thread signalling the event of the next thread, then waiting on its
+ * own) only takes a FUTEX_WAKE and a FUTEX_WAIT system call, instead of
+ * locking, signalling and unlocking a mutex and condition variable on each
+ * side.
+ *
+ * The futex word is EVENT_CLEAR, EVENT_TRIGGERED (signalled, not yet
+ * consumed) or EVENT_WAITING (a thread is, or is about to be, blocked in
+ * FUTEX_WAIT). event_signal() only enters the kernel if the waiter is blocked.
+ */
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#define EVENT_CLEAR        0U
+#define EVENT_TRIGGERED    1U
+#define EVENT_WAITING      2U
+
+struct event
+{
+    _Atomic uint32_t state;
+};
+
+/*
+ * Unlike pthread_cond_wait(), a raw syscall is not a cancellation point, and a
+ * deferred cancellation does not interrupt it. The port cancels task threads
+ * while they wait for their event, and then signals the event (see
+ * vPortCancelThread()), so event_wait() acts on the cancellation once woken.
+ */
+static int futex_wait( _Atomic uint32_t * addr,
+                       uint32_t val,
+                       const struct timespec * timeout )
+{
+    return ( int ) syscall( SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, timeout, NULL, 0 );
+}
+
+static void futex_wake( _Atomic uint32_t * addr )
+{
+    ( void ) syscall( SYS_futex, addr, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0 );
+}
+
+/* Consumes the event if triggered, otherwise registers the caller as waiting */
+static bool event_try_consume( struct event * ev )
+{
+    uint32_t state = atomic_load_explicit( &ev->state, memory_order_relaxed );
+
+    for( ; ; )
+    {
+        if( state == EVENT_TRIGGERED )
+        {
+            if( atomic_compare_exchange_weak_explicit( &ev->state, &state, EVENT_CLEAR, memory_order_acquire, memory_order_relaxed ) )
+            {
+                return true;
+            }
+        }
+        else if( state == EVENT_CLEAR )
+        {
+            ( void ) atomic_compare_exchange_weak_explicit( &ev->state, &state, EVENT_WAITING, memory_order_relaxed, memory_order_relaxed );
+        }
+        else
+        {
+            return false;
+        }
+    }
+}
+
+struct event * event_create(void)
+{
+    struct event * ev = malloc( sizeof( struct event ) );
+    assert(ev != NULL);
+    atomic_init( &ev->state, EVENT_CLEAR );
+    return ev;
+}
+
+void event_delete( struct event * ev )
+{
+    free( ev );
+}
+
+bool event_wait( struct event * ev )
+{
+    while( event_try_consume( ev ) == false )
+    {
+        /* Returns straight away if the event was triggered in the meantime.
+         * EINTR and spurious wake ups are handled by checking again. */
+        ( void ) futex_wait( &ev->state, EVENT_WAITING, NULL );
+    }
+
+    /* The event may have been signalled to end a cancelled thread */
+    pthread_testcancel();
+
+    return true;
+}
+
+bool event_wait_timed( struct event * ev,
+                       time_t ms )
+{
+    struct timespec deadline;
+    struct timespec now;
+    struct timespec timeout;
+
+    clock_gettime( CLOCK_MONOTONIC, &deadline );
+    deadline.tv_sec += ms / 1000;
+    deadline.tv_nsec += ((ms % 1000) * 1000000);
+
+    if( deadline.tv_nsec >= 1000000000 )
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+
+    while( event_try_consume( ev ) == false )
+    {
+        /* FUTEX_WAIT takes a relative timeout */
+        clock_gettime( CLOCK_MONOTONIC, &now );
+        timeout.tv_sec = deadline.tv_sec - now.tv_sec;
+        timeout.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+
+        if( timeout.tv_nsec < 0 )
+        {
+            timeout.tv_sec--;
+            timeout.tv_nsec += 1000000000;
+        }
+
+        if( ( timeout.tv_sec < 0 ) ||
+            ( ( futex_wait( &ev->state, EVENT_WAITING, &timeout ) == -1 ) && ( errno == ETIMEDOUT ) ) )
+        {
+            /* Withdraw from waiting, unless the event was triggered since */
+            uint32_t state = EVENT_WAITING;
+
+            if( atomic_compare_exchange_strong_explicit( &ev->state, &state, EVENT_CLEAR, memory_order_relaxed, memory_order_relaxed ) )
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void event_signal( struct event * ev )
+{
+    if( atomic_exchange_explicit( &ev->state, EVENT_TRIGGERED, memory_order_release ) == EVENT_WAITING )
+    {
+        futex_wake( &ev->state );
+    }
+}
+
+#else /* defined( __linux__ ) */
+
 struct event
 {
     pthread_mutex_t mutex;
@@ -86,12 +242,20 @@ bool event_wait_timed( struct event * ev,
     ts.tv_nsec += ((ms % 1000) * 1000000);
     pthread_mutex_lock( &ev->mutex );
 
-    while( (ev->event_triggered == false) && (ret == 0) )
+    if( ts.tv_nsec >= 1000000000 )
     {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+
+    while( ev->event_triggered == false )
+    {
+        /* pthread_cond_timedwait() returns the error number */
         ret = pthread_cond_timedwait( &ev->cond, &ev->mutex, &ts );
 
-        if( ( ret == -1 ) && ( errno == ETIMEDOUT ) )
+        if( ret == ETIMEDOUT )
         {
+            pthread_mutex_unlock( &ev->mutex );
             return false;
         }
     }
@@ -108,3 +272,5 @@ void event_signal( struct event * ev )
     pthread_cond_signal( &ev->cond );
     pthread_mutex_unlock( &ev->mutex );
 }
+
+#endif /* defined( __linux__ ) */
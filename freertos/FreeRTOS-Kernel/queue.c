@@ -142,6 +142,8 @@ typedef struct QueueDefinition /* The old naming convention is used to prevent b
 
     #if ( configUSE_QUEUE_SETS == 1 )
         struct QueueDefinition * pxQueueSetContainer;
+        struct QueueSetState * pxQueueSetState; /*< Only used by queue sets. Tracks which members have pending events. */
+        UBaseType_t uxQueueSetIndex;            /*< Slot of this queue in its container's ready bitmap. */
     #endif
 
     #if ( configUSE_TRACE_FACILITY == 1 )
@@ -158,6 +160,35 @@ typedef xQUEUE Queue_t;
 
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_SETS == 1 )
+
+/* Maximum number of members a queue set can hold. This is the width of the
+ * set's ready bitmap. */
+    #define queueSET_MAX_MEMBERS    ( ( UBaseType_t ) 32U )
+
+/*
+ * Bookkeeping for a queue set. Rather than copying the handle of a member into
+ * the set every time the member receives an item, each member owns a slot in
+ * a ready bitmap along with a count of its pending events. The set's own queue
+ * has an item size of zero and so only counts events (for blocking purposes)
+ * without storing or copying anything.
+ *
+ * The slot index is the member's priority within the set (slot 0 is the
+ * highest), and slots are allocated lowest free first as members are added.
+ * The highest priority ready member can therefore be found in O(1) by counting
+ * the trailing zeros of the bitmap.
+ */
+    typedef struct QueueSetState
+    {
+        uint32_t ulReadyBitmap;                                /*< Bit n is set if the member in slot n has pending events. */
+        uint32_t ulUsedBitmap;                                 /*< Bit n is set if slot n is occupied by a member. */
+        Queue_t * pxMembers[ queueSET_MAX_MEMBERS ];           /*< The member occupying each slot. */
+        UBaseType_t uxPendingEvents[ queueSET_MAX_MEMBERS ];   /*< The number of unselected events of each member. */
+    } QueueSetState_t;
+
+#endif /* configUSE_QUEUE_SETS */
+/*-----------------------------------------------------------*/
+
 /*
  * The queue registry is just a means for kernel aware debuggers to locate
  * queue structures.  It has no other purpose so is an optional component.
@@ -238,6 +269,13 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue,
  * the queue set that the queue contains data.
  */
     static BaseType_t prvNotifyQueueSetContainer( const Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the highest priority member of a queue set with a pending event,
+ * and consumes that event.  Must be called from the critical section in which
+ * the event is removed from the set's queue.
+ */
+    static QueueSetMemberHandle_t prvSelectReadyMember( Queue_t * const pxQueueSet ) PRIVILEGED_FUNCTION;
 #endif
 
 /*
@@ -619,6 +657,8 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
     #if ( configUSE_QUEUE_SETS == 1 )
     {
         pxNewQueue->pxQueueSetContainer = NULL;
+        pxNewQueue->pxQueueSetState = NULL;
+        pxNewQueue->uxQueueSetIndex = 0;
     }
     #endif /* configUSE_QUEUE_SETS */
 
@@ -1168,6 +1208,191 @@ BaseType_t xQueueGenericSend( QueueHandle_t xQueue,
 }
 /*-----------------------------------------------------------*/
 
+size_t xQueueSendBatch( QueueHandle_t xQueue,
+                        const void * const pvItemsToQueue,
+                        size_t xItemCount,
+                        TickType_t xTicksToWait )
+{
+    BaseType_t xEntryTimeSet = pdFALSE, xYieldRequired;
+    TimeOut_t xTimeOut;
+    Queue_t * const pxQueue = xQueue;
+    const int8_t * pcItemToQueue = ( const int8_t * ) pvItemsToQueue;
+    size_t xItemsSent, xWoken;
+
+    configASSERT( pxQueue );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    configASSERT( !( ( pvItemsToQueue == NULL ) && ( xItemCount != ( size_t ) 0U ) ) );
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+    {
+        configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+    }
+    #endif
+
+    if( xItemCount == ( size_t ) 0U )
+    {
+        return ( size_t ) 0U;
+    }
+
+    /*lint -save -e904 This function relaxes the coding standard somewhat to
+     * allow return statements within the function itself.  This is done in the
+     * interest of execution time efficiency. */
+    for( ; ; )
+    {
+        taskENTER_CRITICAL( &( pxQueue->xQueueLock ) );
+        {
+            /* Is there room for at least one item?  If so, copy in as many
+             * items as fit without leaving the critical section. */
+            if( pxQueue->uxMessagesWaiting < pxQueue->uxLength )
+            {
+                xItemsSent = ( size_t ) 0U;
+                xYieldRequired = pdFALSE;
+
+                while( ( xItemsSent < xItemCount ) && ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) )
+                {
+                    traceQUEUE_SEND( pxQueue );
+
+                    /* The item size is non-zero so this can never be a mutex
+                     * give, and the returned disinherit flag is always false. */
+                    ( void ) prvCopyDataToQueue( pxQueue, pcItemToQueue, queueSEND_TO_BACK );
+                    pcItemToQueue += pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok. */
+                    xItemsSent++;
+
+                    #if ( configUSE_QUEUE_SETS == 1 )
+                        if( pxQueue->pxQueueSetContainer != NULL )
+                        {
+                            /* The queue set holds one handle per item, so it
+                             * must still be notified for every item sent. */
+                            if( prvNotifyQueueSetContainer( pxQueue ) != pdFALSE )
+                            {
+                                xYieldRequired = pdTRUE;
+                            }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
+                            }
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    #endif /* configUSE_QUEUE_SETS */
+                }
+
+                /* Unblock one waiting receiver per item sent, so that no
+                 * receiver stays blocked while items it could take remain.
+                 * The yield (if any) is deferred until the batch has been
+                 * copied in, so the batch costs a single context switch. */
+                for( xWoken = ( size_t ) 0U; ( xWoken < xItemsSent ) && ( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE ); xWoken++ )
+                {
+                    if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                    {
+                        xYieldRequired = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+
+                if( xYieldRequired != pdFALSE )
+                {
+                    queueYIELD_IF_USING_PREEMPTION();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                taskEXIT_CRITICAL( &( pxQueue->xQueueLock ) );
+                return xItemsSent;
+            }
+            else
+            {
+                if( xTicksToWait == ( TickType_t ) 0 )
+                {
+                    /* The queue was full and no block time is specified (or
+                     * the block time has expired) so leave now. */
+                    taskEXIT_CRITICAL( &( pxQueue->xQueueLock ) );
+                    traceQUEUE_SEND_FAILED( pxQueue );
+                    return ( size_t ) 0U;
+                }
+                else if( xEntryTimeSet == pdFALSE )
+                {
+                    /* The queue was full and a block time was specified so
+                     * configure the timeout structure. */
+                    vTaskInternalSetTimeOutState( &xTimeOut );
+                    xEntryTimeSet = pdTRUE;
+                }
+                else
+                {
+                    /* Entry time was already set. */
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+
+            #if ( queueUSE_LOCKS == 0 )
+            {
+                /* Update the timeout state to see if it has expired yet. */
+                if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+                {
+                    /* Not timed out yet. Block the current task. */
+                    traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+                    vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+                    portYIELD_WITHIN_API();
+                }
+                else
+                {
+                    /* We have timed out. Return an error. */
+                    taskEXIT_CRITICAL( &( pxQueue->xQueueLock ) );
+                    traceQUEUE_SEND_FAILED( pxQueue );
+                    return ( size_t ) 0U;
+                }
+            }
+            #endif /* queueUSE_LOCKS == 0 */
+        }
+        taskEXIT_CRITICAL( &( pxQueue->xQueueLock ) );
+
+        #if ( queueUSE_LOCKS == 1 )
+        {
+            vTaskSuspendAll();
+            prvLockQueue( pxQueue );
+
+            /* Update the timeout state to see if it has expired yet. */
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+            {
+                if( prvIsQueueFull( pxQueue ) != pdFALSE )
+                {
+                    traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+                    vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+                    prvUnlockQueue( pxQueue );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        portYIELD_WITHIN_API();
+                    }
+                }
+                else
+                {
+                    /* Try again. */
+                    prvUnlockQueue( pxQueue );
+                    ( void ) xTaskResumeAll();
+                }
+            }
+            else
+            {
+                /* The timeout has expired. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+
+                traceQUEUE_SEND_FAILED( pxQueue );
+                return ( size_t ) 0U;
+            }
+        }
+        #endif /* queueUSE_LOCKS == 1 */
+    } /*lint -restore */
+}
+/*-----------------------------------------------------------*/
+
 BaseType_t xQueueGenericSendFromISR( QueueHandle_t xQueue,
                                      const void * const pvItemToQueue,
                                      BaseType_t * const pxHigherPriorityTaskWoken,
@@ -1556,6 +1781,31 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
             {
                 /* Data available, remove one item. */
                 prvCopyDataFromQueue( pxQueue, pvBuffer );
+
+                #if ( configUSE_QUEUE_SETS == 1 )
+                {
+                    if( pxQueue->pxQueueSetState != NULL )
+                    {
+                        /* The queue is a queue set, so the event is consumed and
+                         * its member selected under the same lock. */
+                        const QueueSetMemberHandle_t xMember = prvSelectReadyMember( pxQueue );
+
+                        if( pvBuffer != NULL )
+                        {
+                            *( ( QueueSetMemberHandle_t * ) pvBuffer ) = xMember;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #endif /* configUSE_QUEUE_SETS */
+
                 traceQUEUE_RECEIVE( pxQueue );
                 pxQueue->uxMessagesWaiting = uxMessagesWaiting - ( UBaseType_t ) 1;
 
@@ -1694,6 +1944,183 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
 }
 /*-----------------------------------------------------------*/
 
+size_t xQueueReceiveBatch( QueueHandle_t xQueue,
+                           void * const pvBuffer,
+                           size_t xMaxItems,
+                           TickType_t xTicksToWait )
+{
+    BaseType_t xEntryTimeSet = pdFALSE, xYieldRequired;
+    TimeOut_t xTimeOut;
+    Queue_t * const pxQueue = xQueue;
+    int8_t * pcBuffer = ( int8_t * ) pvBuffer;
+    size_t xItemsReceived, xWoken;
+
+    configASSERT( ( pxQueue ) );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    configASSERT( !( ( pvBuffer == NULL ) && ( xMaxItems != ( size_t ) 0U ) ) );
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+    {
+        configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+    }
+    #endif
+
+    if( xMaxItems == ( size_t ) 0U )
+    {
+        return ( size_t ) 0U;
+    }
+
+    /*lint -save -e904  This function relaxes the coding standard somewhat to
+     * allow return statements within the function itself.  This is done in the
+     * interest of execution time efficiency. */
+    for( ; ; )
+    {
+        taskENTER_CRITICAL( &( pxQueue->xQueueLock ) );
+        {
+            /* Is there data in the queue now?  If so, drain as many items as
+             * the caller's buffer can hold without leaving the critical
+             * section. */
+            if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+            {
+                xItemsReceived = ( size_t ) 0U;
+                xYieldRequired = pdFALSE;
+
+                while( ( xItemsReceived < xMaxItems ) && ( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 ) )
+                {
+                    prvCopyDataFromQueue( pxQueue, pcBuffer );
+                    traceQUEUE_RECEIVE( pxQueue );
+                    pxQueue->uxMessagesWaiting--;
+                    pcBuffer += pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok. */
+                    xItemsReceived++;
+                }
+
+                /* Slots were freed, so unblock one waiting sender per item
+                 * received.  The yield (if any) is deferred until the batch
+                 * has been copied out, so the batch costs a single context
+                 * switch. */
+                for( xWoken = ( size_t ) 0U; ( xWoken < xItemsReceived ) && ( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE ); xWoken++ )
+                {
+                    if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+                    {
+                        xYieldRequired = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+
+                if( xYieldRequired != pdFALSE )
+                {
+                    queueYIELD_IF_USING_PREEMPTION();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                taskEXIT_CRITICAL( &( pxQueue->xQueueLock ) );
+                return xItemsReceived;
+            }
+            else
+            {
+                if( xTicksToWait == ( TickType_t ) 0 )
+                {
+                    /* The queue was empty and no block time is specified (or
+                     * the block time has expired) so leave now. */
+                    taskEXIT_CRITICAL( &( pxQueue->xQueueLock ) );
+                    traceQUEUE_RECEIVE_FAILED( pxQueue );
+                    return ( size_t ) 0U;
+                }
+                else if( xEntryTimeSet == pdFALSE )
+                {
+                    /* The queue was empty and a block time was specified so
+                     * configure the timeout structure. */
+                    vTaskInternalSetTimeOutState( &xTimeOut );
+                    xEntryTimeSet = pdTRUE;
+                }
+                else
+                {
+                    /* Entry time was already set. */
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+
+            #if ( queueUSE_LOCKS == 0 )
+            {
+                /* Update the timeout state to see if it has expired yet. */
+                if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+                {
+                    /* Not timed out yet. Block the current task. */
+                    traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+                    vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+                    portYIELD_WITHIN_API();
+                }
+                else
+                {
+                    /* We have timed out. Return an error. */
+                    taskEXIT_CRITICAL( &( pxQueue->xQueueLock ) );
+                    traceQUEUE_RECEIVE_FAILED( pxQueue );
+                    return ( size_t ) 0U;
+                }
+            }
+            #endif /* queueUSE_LOCKS == 0 */
+        }
+        taskEXIT_CRITICAL( &( pxQueue->xQueueLock ) );
+
+        #if ( queueUSE_LOCKS == 1 )
+        {
+            vTaskSuspendAll();
+            prvLockQueue( pxQueue );
+
+            /* Update the timeout state to see if it has expired yet. */
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+            {
+                if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+                {
+                    traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+                    vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+                    prvUnlockQueue( pxQueue );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        portYIELD_WITHIN_API();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    /* The queue contains data again.  Loop back to try and read
+                     * the data. */
+                    prvUnlockQueue( pxQueue );
+                    ( void ) xTaskResumeAll();
+                }
+            }
+            else
+            {
+                /* Timed out.  If there is no data in the queue exit, otherwise
+                 * loop back and attempt to read the data. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+
+                if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+                {
+                    traceQUEUE_RECEIVE_FAILED( pxQueue );
+                    return ( size_t ) 0U;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+        #endif /* queueUSE_LOCKS == 1 */
+    } /*lint -restore */
+}
+/*-----------------------------------------------------------*/
+
 BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                                 TickType_t xTicksToWait )
 {
@@ -2190,6 +2617,29 @@ BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
             traceQUEUE_RECEIVE_FROM_ISR( pxQueue );
 
             prvCopyDataFromQueue( pxQueue, pvBuffer );
+
+            #if ( configUSE_QUEUE_SETS == 1 )
+            {
+                if( pxQueue->pxQueueSetState != NULL )
+                {
+                    const QueueSetMemberHandle_t xMember = prvSelectReadyMember( pxQueue );
+
+                    if( pvBuffer != NULL )
+                    {
+                        *( ( QueueSetMemberHandle_t * ) pvBuffer ) = xMember;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configUSE_QUEUE_SETS */
+
             pxQueue->uxMessagesWaiting = uxMessagesWaiting - ( UBaseType_t ) 1;
 
             /* If the queue is locked the event list will not be modified.
@@ -2361,6 +2811,20 @@ void vQueueDelete( QueueHandle_t xQueue )
     }
     #endif
 
+    #if ( ( configUSE_QUEUE_SETS == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+    {
+        /* Queue sets keep their bookkeeping in a separate allocation. */
+        if( pxQueue->pxQueueSetState != NULL )
+        {
+            vPortFree( pxQueue->pxQueueSetState );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif
+
     #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
     {
         /* The queue can only have been allocated dynamically - free it
@@ -3238,11 +3702,33 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
 
     QueueSetHandle_t xQueueCreateSet( const UBaseType_t uxEventQueueLength )
     {
-        QueueSetHandle_t pxQueue;
+        Queue_t * pxQueue;
+        QueueSetState_t * pxState;
 
-        pxQueue = xQueueGenericCreate( uxEventQueueLength, ( UBaseType_t ) sizeof( Queue_t * ), queueQUEUE_TYPE_SET );
+        /* The set's queue only counts events, so it does not need any storage. */
+        pxQueue = xQueueGenericCreate( uxEventQueueLength, ( UBaseType_t ) 0, queueQUEUE_TYPE_SET );
 
-        return pxQueue;
+        if( pxQueue != NULL )
+        {
+            pxState = pvPortMalloc( sizeof( QueueSetState_t ) );
+
+            if( pxState != NULL )
+            {
+                ( void ) memset( pxState, 0x00, sizeof( QueueSetState_t ) );
+                pxQueue->pxQueueSetState = pxState;
+            }
+            else
+            {
+                vQueueDelete( pxQueue );
+                pxQueue = NULL;
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return ( QueueSetHandle_t ) pxQueue;
     }
 
 #endif /* configUSE_QUEUE_SETS */
@@ -3254,27 +3740,49 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
                                QueueSetHandle_t xQueueSet )
     {
         BaseType_t xReturn;
+        Queue_t * const pxQueueOrSemaphore = ( Queue_t * ) xQueueOrSemaphore;
+        Queue_t * const pxQueueSet = ( Queue_t * ) xQueueSet;
+        QueueSetState_t * const pxState = pxQueueSet->pxQueueSetState;
+
+        configASSERT( pxState );
 
-        taskENTER_CRITICAL( &( ( ( Queue_t * ) xQueueOrSemaphore )->xQueueLock ) );
+        taskENTER_CRITICAL( &( pxQueueOrSemaphore->xQueueLock ) );
         {
-            if( ( ( Queue_t * ) xQueueOrSemaphore )->pxQueueSetContainer != NULL )
-            {
-                /* Cannot add a queue/semaphore to more than one queue set. */
-                xReturn = pdFAIL;
-            }
-            else if( ( ( Queue_t * ) xQueueOrSemaphore )->uxMessagesWaiting != ( UBaseType_t ) 0 )
+            /* Lock order is member then set, as in prvNotifyQueueSetContainer(). */
+            prvENTER_CRITICAL_SMP_ONLY( &( pxQueueSet->xQueueLock ) );
             {
-                /* Cannot add a queue/semaphore to a queue set if there are already
-                 * items in the queue/semaphore. */
-                xReturn = pdFAIL;
-            }
-            else
-            {
-                ( ( Queue_t * ) xQueueOrSemaphore )->pxQueueSetContainer = xQueueSet;
-                xReturn = pdPASS;
+                if( pxQueueOrSemaphore->pxQueueSetContainer != NULL )
+                {
+                    /* Cannot add a queue/semaphore to more than one queue set. */
+                    xReturn = pdFAIL;
+                }
+                else if( pxQueueOrSemaphore->uxMessagesWaiting != ( UBaseType_t ) 0 )
+                {
+                    /* Cannot add a queue/semaphore to a queue set if there are already
+                     * items in the queue/semaphore. */
+                    xReturn = pdFAIL;
+                }
+                else if( pxState->ulUsedBitmap == UINT32_MAX )
+                {
+                    /* Every slot of the set's ready bitmap is in use. */
+                    xReturn = pdFAIL;
+                }
+                else
+                {
+                    /* Take the lowest free slot. */
+                    const UBaseType_t uxIndex = ( UBaseType_t ) __builtin_ctz( ~( pxState->ulUsedBitmap ) );
+
+                    pxState->ulUsedBitmap |= ( 1UL << uxIndex );
+                    pxState->pxMembers[ uxIndex ] = pxQueueOrSemaphore;
+                    pxState->uxPendingEvents[ uxIndex ] = 0;
+                    pxQueueOrSemaphore->uxQueueSetIndex = uxIndex;
+                    pxQueueOrSemaphore->pxQueueSetContainer = pxQueueSet;
+                    xReturn = pdPASS;
+                }
             }
+            prvEXIT_CRITICAL_SMP_ONLY( &( pxQueueSet->xQueueLock ) );
         }
-        taskEXIT_CRITICAL( &( ( ( Queue_t * ) xQueueOrSemaphore )->xQueueLock ) );
+        taskEXIT_CRITICAL( &( pxQueueOrSemaphore->xQueueLock ) );
 
         return xReturn;
     }
@@ -3289,29 +3797,49 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
     {
         BaseType_t xReturn;
         Queue_t * const pxQueueOrSemaphore = ( Queue_t * ) xQueueOrSemaphore;
+        Queue_t * const pxQueueSet = ( Queue_t * ) xQueueSet;
 
-        if( pxQueueOrSemaphore->pxQueueSetContainer != xQueueSet )
-        {
-            /* The queue was not a member of the set. */
-            xReturn = pdFAIL;
-        }
-        else if( pxQueueOrSemaphore->uxMessagesWaiting != ( UBaseType_t ) 0 )
+        taskENTER_CRITICAL( &( pxQueueOrSemaphore->xQueueLock ) );
         {
-            /* It is dangerous to remove a queue from a set when the queue is
-             * not empty because the queue set will still hold pending events for
-             * the queue. */
-            xReturn = pdFAIL;
-        }
-        else
-        {
-            taskENTER_CRITICAL( &( ( ( Queue_t * ) pxQueueOrSemaphore )->xQueueLock ) );
+            if( pxQueueOrSemaphore->pxQueueSetContainer != pxQueueSet )
+            {
+                /* The queue was not a member of the set. */
+                xReturn = pdFAIL;
+            }
+            else if( pxQueueOrSemaphore->uxMessagesWaiting != ( UBaseType_t ) 0 )
             {
+                /* It is dangerous to remove a queue from a set when the queue is
+                 * not empty because the queue set will still hold pending events for
+                 * the queue. */
+                xReturn = pdFAIL;
+            }
+            else
+            {
+                QueueSetState_t * const pxState = pxQueueSet->pxQueueSetState;
+                const UBaseType_t uxIndex = pxQueueOrSemaphore->uxQueueSetIndex;
+
+                /* Lock order is member then set, as in xQueueAddToSet(). */
+                prvENTER_CRITICAL_SMP_ONLY( &( pxQueueSet->xQueueLock ) );
+                {
+                    /* Discard any events of the member that were never selected so
+                     * that the set does not report a member it no longer holds.
+                     * Events are consumed and selected under the set's lock, so
+                     * the set holds at least this many. */
+                    configASSERT( pxQueueSet->uxMessagesWaiting >= pxState->uxPendingEvents[ uxIndex ] );
+                    pxQueueSet->uxMessagesWaiting -= pxState->uxPendingEvents[ uxIndex ];
+                    pxState->uxPendingEvents[ uxIndex ] = 0;
+                    pxState->pxMembers[ uxIndex ] = NULL;
+                    pxState->ulReadyBitmap &= ~( 1UL << uxIndex );
+                    pxState->ulUsedBitmap &= ~( 1UL << uxIndex );
+                }
+                prvEXIT_CRITICAL_SMP_ONLY( &( pxQueueSet->xQueueLock ) );
+
                 /* The queue is no longer contained in the set. */
                 pxQueueOrSemaphore->pxQueueSetContainer = NULL;
+                xReturn = pdPASS;
             }
-            taskEXIT_CRITICAL( &( ( ( Queue_t * ) pxQueueOrSemaphore )->xQueueLock ) );
-            xReturn = pdPASS;
         }
+        taskEXIT_CRITICAL( &( pxQueueOrSemaphore->xQueueLock ) );
 
         return xReturn;
     } /*lint !e818 xQueueSet could not be declared as pointing to const as it is a typedef. */
@@ -3326,7 +3854,12 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
     {
         QueueSetMemberHandle_t xReturn = NULL;
 
+        /* The set's queue has an item size of zero, so receiving from it only
+         * consumes one event (blocking if there are none). The receive looks up
+         * the member the event belongs to in the ready bitmap and returns it in
+         * xReturn. */
         ( void ) xQueueReceive( ( QueueHandle_t ) xQueueSet, &xReturn, xTicksToWait ); /*lint !e961 Casting from one typedef to another is not redundant. */
+
         return xReturn;
     }
 
@@ -3340,6 +3873,43 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
         QueueSetMemberHandle_t xReturn = NULL;
 
         ( void ) xQueueReceiveFromISR( ( QueueHandle_t ) xQueueSet, &xReturn, NULL ); /*lint !e961 Casting from one typedef to another is not redundant. */
+
+        return xReturn;
+    }
+
+#endif /* configUSE_QUEUE_SETS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SETS == 1 )
+
+    static QueueSetMemberHandle_t prvSelectReadyMember( Queue_t * const pxQueueSet )
+    {
+        QueueSetState_t * const pxState = pxQueueSet->pxQueueSetState;
+        QueueSetMemberHandle_t xReturn = NULL;
+
+        /* Called from the set's receive critical section, in task or ISR
+         * context, as an event is consumed from the set's queue. */
+        if( pxState->ulReadyBitmap != 0U )
+        {
+            /* The lowest set bit is the highest priority ready member. */
+            const UBaseType_t uxIndex = ( UBaseType_t ) __builtin_ctz( pxState->ulReadyBitmap );
+
+            xReturn = ( QueueSetMemberHandle_t ) pxState->pxMembers[ uxIndex ];
+
+            if( --( pxState->uxPendingEvents[ uxIndex ] ) == ( UBaseType_t ) 0 )
+            {
+                pxState->ulReadyBitmap &= ~( 1UL << uxIndex );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
         return xReturn;
     }
 
@@ -3374,10 +3944,16 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
                     const int8_t cTxLock = queueUNLOCKED;
                 #endif /* queueUSE_LOCKS == 1 */
 
+                QueueSetState_t * const pxState = pxQueueSetContainer->pxQueueSetState;
+                const UBaseType_t uxIndex = pxQueue->uxQueueSetIndex;
+
                 traceQUEUE_SET_SEND( pxQueueSetContainer );
 
-                /* The data copied is the handle of the queue that contains data. */
-                xReturn = prvCopyDataToQueue( pxQueueSetContainer, &pxQueue, queueSEND_TO_BACK );
+                /* Mark the member as ready. Nothing is copied into the set, whose
+                 * queue has an item size of zero and only counts the event. */
+                pxState->uxPendingEvents[ uxIndex ]++;
+                pxState->ulReadyBitmap |= ( 1UL << uxIndex );
+                xReturn = prvCopyDataToQueue( pxQueueSetContainer, NULL, queueSEND_TO_BACK );
 
                 if( cTxLock == queueUNLOCKED )
                 {
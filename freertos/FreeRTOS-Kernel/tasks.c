@@ -267,16 +267,93 @@
 #endif /* configNUMBER_OF_CORES > 1 */
 /*-----------------------------------------------------------*/
 
+/* Macros used to insert a task into, and pick the next task from, the ready
+ * list of a particular priority.
+ *
+ * With configUSE_EDF_SCHEDULING, each ready list is kept sorted by the absolute
+ * deadline of its tasks, and tasks without a deadline are placed at the end.
+ * The next task to run is always taken from the head of the list, and is then
+ * re-inserted after any tasks sharing the same deadline so that such tasks are
+ * still scheduled round robin.
+ *
+ * Absolute deadlines wrap around with the tick count, so they are not compared
+ * directly.  The list item value is instead the deadline relative to
+ * xDeadlineKeyBase, offset by taskDEADLINE_KEY_OFFSET so that deadlines up to
+ * that many ticks before the base still sort first.  xTaskIncrementTick()
+ * moves the base forward every taskDEADLINE_KEY_OFFSET ticks, so deadlines from
+ * up to taskDEADLINE_KEY_OFFSET ticks in the past to twice that many ticks in
+ * the future are ordered correctly.  portMAX_DELAY is reserved for tasks
+ * without a deadline.
+ *
+ * Otherwise, tasks are appended to the end of the list and picked in round
+ * robin order using the list's index. */
+#if ( configUSE_EDF_SCHEDULING == 1 )
+    #define taskDEADLINE_KEY_OFFSET    ( ( TickType_t ) ( portMAX_DELAY >> 2 ) + ( TickType_t ) 1 )
+
+    #define taskDEADLINE_KEY( pxTCB ) \
+    ( ( ( pxTCB )->ucHasDeadline != ( uint8_t ) pdFALSE ) ? prvGetDeadlineKey( ( pxTCB )->xAbsoluteDeadline ) : portMAX_DELAY )
+
+    #define taskREADY_LIST_INSERT( pxList, pxTCB )                                                         \
+    {                                                                                                      \
+        listSET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ), taskDEADLINE_KEY( pxTCB ) );              \
+        vListInsert( ( pxList ), &( ( pxTCB )->xStateListItem ) );                                         \
+    }
+
+    #define taskGET_NEXT_READY_TASK( pxTCB, pxList )                                                       \
+    {                                                                                                      \
+        ( pxTCB ) = listGET_OWNER_OF_HEAD_ENTRY( pxList );                                                 \
+        if( listCURRENT_LIST_LENGTH( pxList ) > ( UBaseType_t ) 1 )                                        \
+        {                                                                                                  \
+            listREMOVE_ITEM( &( ( pxTCB )->xStateListItem ) );                                             \
+            vListInsert( ( pxList ), &( ( pxTCB )->xStateListItem ) );                                     \
+        }                                                                                                  \
+    }
+#else /* configUSE_EDF_SCHEDULING */
+    #define taskREADY_LIST_INSERT( pxList, pxTCB )      listINSERT_END( ( pxList ), &( ( pxTCB )->xStateListItem ) )
+    #define taskGET_NEXT_READY_TASK( pxTCB, pxList )    listGET_OWNER_OF_NEXT_ENTRY( ( pxTCB ), ( pxList ) )
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
 
 /* If configUSE_PORT_OPTIMISED_TASK_SELECTION is 0 then task selection is
  * performed in a generic way that is not optimised to any particular
  * microcontroller architecture. */
 
+    #if ( configUSE_READY_PRIORITY_BITMAP == 1 )
+
+/* With configUSE_READY_PRIORITY_BITMAP, the priorities that have ready tasks
+ * are also recorded in a two-level bitmap, so that the highest one can be
+ * found in constant time instead of walking down the ready lists.  Bit
+ * ( uxPriority % 32 ) of ulReadyPriorityBitmap[ uxPriority / 32 ] is set if
+ * the ready list of uxPriority is not empty, and bit n of
+ * ulReadyPriorityGroups is set if ulReadyPriorityBitmap[ n ] is not 0. */
+        #define taskREADY_BITMAP_BITS     ( 32U )
+        #define taskREADY_BITMAP_WORDS    ( ( configMAX_PRIORITIES + taskREADY_BITMAP_BITS - 1U ) / taskREADY_BITMAP_BITS )
+
+        #define taskREADY_BITMAP_SET( uxPriority )                                                                          \
+    {                                                                                                                       \
+        ulReadyPriorityBitmap[ ( uxPriority ) / taskREADY_BITMAP_BITS ] |= ( 1UL << ( ( uxPriority ) % taskREADY_BITMAP_BITS ) ); \
+        ulReadyPriorityGroups |= ( 1UL << ( ( uxPriority ) / taskREADY_BITMAP_BITS ) );                                     \
+    }
+
+        #define taskREADY_BITMAP_CLEAR( uxPriority )                                                                         \
+    {                                                                                                                        \
+        ulReadyPriorityBitmap[ ( uxPriority ) / taskREADY_BITMAP_BITS ] &= ~( 1UL << ( ( uxPriority ) % taskREADY_BITMAP_BITS ) ); \
+        if( ulReadyPriorityBitmap[ ( uxPriority ) / taskREADY_BITMAP_BITS ] == 0UL )                                         \
+        {                                                                                                                    \
+            ulReadyPriorityGroups &= ~( 1UL << ( ( uxPriority ) / taskREADY_BITMAP_BITS ) );                                 \
+        }                                                                                                                    \
+    }
+    #else /* configUSE_READY_PRIORITY_BITMAP */
+        #define taskREADY_BITMAP_SET( uxPriority )
+    #endif /* configUSE_READY_PRIORITY_BITMAP */
+
 /* uxTopReadyPriority holds the priority of the highest priority ready
  * state task. */
     #define taskRECORD_READY_PRIORITY( uxPriority ) \
     {                                               \
+        taskREADY_BITMAP_SET( uxPriority );         \
         if( ( uxPriority ) > uxTopReadyPriority )   \
         {                                           \
             uxTopReadyPriority = ( uxPriority );    \
@@ -287,6 +364,17 @@
 
     #if ( configNUMBER_OF_CORES > 1 )
         #define taskSELECT_HIGHEST_PRIORITY_TASK()    prvSelectHighestPriorityTaskSMP()
+    #elif ( configUSE_READY_PRIORITY_BITMAP == 1 )
+        #define taskSELECT_HIGHEST_PRIORITY_TASK()                                                  \
+    {                                                                                               \
+        UBaseType_t uxTopPriority;                                                                  \
+                                                                                                    \
+        /* Find the highest priority list that contains ready tasks. */                             \
+        uxTopPriority = ( UBaseType_t ) prvGetHighestReadyPriority( configMAX_PRIORITIES );         \
+        configASSERT( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ uxTopPriority ] ) ) > 0 );     \
+        taskGET_NEXT_READY_TASK( pxCurrentTCBs[ 0 ], &( pxReadyTasksLists[ uxTopPriority ] ) );     \
+        uxTopReadyPriority = uxTopPriority;                                                         \
+    } /* taskSELECT_HIGHEST_PRIORITY_TASK */
     #else /* if ( configNUMBER_OF_CORES > 1 ) */
         #define taskSELECT_HIGHEST_PRIORITY_TASK()                            \
     {                                                                         \
@@ -299,20 +387,38 @@
             --uxTopPriority;                                                  \
         }                                                                     \
                                                                               \
-        /* listGET_OWNER_OF_NEXT_ENTRY indexes through the list, so the tasks of \
-         * the  same priority get an equal share of the processor time. */                          \
-        listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCBs[ 0 ], &( pxReadyTasksLists[ uxTopPriority ] ) ); \
-        uxTopReadyPriority = uxTopPriority;                                                         \
+        /* taskGET_NEXT_READY_TASK indexes through the list, so the tasks of  \
+         * the  same priority get an equal share of the processor time. */                      \
+        taskGET_NEXT_READY_TASK( pxCurrentTCBs[ 0 ], &( pxReadyTasksLists[ uxTopPriority ] ) ); \
+        uxTopReadyPriority = uxTopPriority;                                                     \
     } /* taskSELECT_HIGHEST_PRIORITY_TASK */
     #endif /* if ( configNUMBER_OF_CORES > 1 ) */
 
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_READY_PRIORITY_BITMAP == 1 )
+
+/* Clear the priority from the ready priority bitmap if its ready list is now
+ * empty.  The task being reset may be referenced from a delayed or suspended
+ * list instead of its ready list, hence the check. */
+        #define taskRESET_READY_PRIORITY( uxPriority )                                                     \
+    {                                                                                                      \
+        if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ ( uxPriority ) ] ) ) == ( UBaseType_t ) 0 )     \
+        {                                                                                                  \
+            taskREADY_BITMAP_CLEAR( uxPriority );                                                          \
+        }                                                                                                  \
+    }
+        #define portRESET_READY_PRIORITY( uxPriority, uxTopReadyPriority )    taskREADY_BITMAP_CLEAR( uxPriority )
+
+    #else /* configUSE_READY_PRIORITY_BITMAP */
+
 /* Define away taskRESET_READY_PRIORITY() and portRESET_READY_PRIORITY() as
  * they are only required when a port optimised method of task selection is
  * being used. */
-    #define taskRESET_READY_PRIORITY( uxPriority )
-    #define portRESET_READY_PRIORITY( uxPriority, uxTopReadyPriority )
+        #define taskRESET_READY_PRIORITY( uxPriority )
+        #define portRESET_READY_PRIORITY( uxPriority, uxTopReadyPriority )
+
+    #endif /* configUSE_READY_PRIORITY_BITMAP */
 
 #else /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
 
@@ -332,7 +438,7 @@
         /* Find the highest priority list that contains ready tasks. */                             \
         portGET_HIGHEST_PRIORITY( uxTopPriority, uxTopReadyPriority );                              \
         configASSERT( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ uxTopPriority ] ) ) > 0 );     \
-        listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCBs[ 0 ], &( pxReadyTasksLists[ uxTopPriority ] ) ); \
+        taskGET_NEXT_READY_TASK( pxCurrentTCBs[ 0 ], &( pxReadyTasksLists[ uxTopPriority ] ) );     \
     } /* taskSELECT_HIGHEST_PRIORITY_TASK() */
 
 /*-----------------------------------------------------------*/
@@ -352,6 +458,34 @@
 
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+/* The wheel has two levels of configDELAYED_TASK_WHEEL_SIZE unsorted slots.
+ * Tasks that are due within one lap of the wheel are placed in the tick slot
+ * selected by the low bits of their wake time, so every task in the tick slot
+ * of the current tick is due now.  Tasks that are due later are placed in the
+ * lap slot selected by the next bits of their wake time.  At the start of each
+ * lap, the tasks of its lap slot that are due within the lap are moved to their
+ * tick slot.  The others are due on a later round of the lap slots, and stay
+ * where they are. */
+    #define taskDELAYED_WHEEL_LISTS    ( 2U * ( UBaseType_t ) configDELAYED_TASK_WHEEL_SIZE )
+
+    #define taskDELAYED_WHEEL_SLOT( xTime )    ( &( xDelayedTaskWheel[ ( xTime ) & ( ( TickType_t ) configDELAYED_TASK_WHEEL_SIZE - 1U ) ] ) )
+
+    #define taskDELAYED_WHEEL_LAP_SLOT( xTime ) \
+    ( &( xDelayedTaskWheel[ configDELAYED_TASK_WHEEL_SIZE + ( ( ( xTime ) / ( TickType_t ) configDELAYED_TASK_WHEEL_SIZE ) & ( ( TickType_t ) configDELAYED_TASK_WHEEL_SIZE - 1U ) ) ] ) )
+
+    #define taskLIST_IS_DELAYED_TASK_LIST( pxList )                                         \
+    ( ( ( pxList ) == pxDelayedTaskList ) || ( ( pxList ) == pxOverflowDelayedTaskList ) || \
+      ( ( ( pxList ) >= &( xDelayedTaskWheel[ 0 ] ) ) && ( ( pxList ) < &( xDelayedTaskWheel[ taskDELAYED_WHEEL_LISTS ] ) ) ) )
+
+#else /* configUSE_DELAYED_TASK_WHEEL */
+
+    #define taskLIST_IS_DELAYED_TASK_LIST( pxList ) \
+    ( ( ( pxList ) == pxDelayedTaskList ) || ( ( pxList ) == pxOverflowDelayedTaskList ) )
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
+
 /* pxDelayedTaskList and pxOverflowDelayedTaskList are switched when the tick
  * count overflows. */
 #define taskSWITCH_DELAYED_LISTS()                                                \
@@ -370,14 +504,35 @@
 
 /*-----------------------------------------------------------*/
 
+/*
+ * When ticks are not processed periodically, a task made ready only changes
+ * the next tick the kernel requires if it has to be time sliced with the
+ * running task.  A task of higher priority causes a context switch, which
+ * updates the alarm in vTaskSwitchContext(), and a task of lower priority does
+ * not run before the next kernel event anyway.
+ */
+#if ( configUSE_TICKLESS_KERNEL == 1 )
+    #define taskTICKLESS_UPDATE_ALARM_FOR_READY_TASK( pxTCB )                                               \
+    do {                                                                                                    \
+        if( ( pxCurrentTCBs[ 0 ] != NULL ) && ( ( pxTCB )->uxPriority == pxCurrentTCBs[ 0 ]->uxPriority ) ) \
+        {                                                                                                   \
+            portTICKLESS_UPDATE_ALARM();                                                                    \
+        }                                                                                                   \
+    } while( 0 )
+#else
+    #define taskTICKLESS_UPDATE_ALARM_FOR_READY_TASK( pxTCB )
+#endif /* configUSE_TICKLESS_KERNEL */
+
 /*
  * Place the task represented by pxTCB into the appropriate ready list for
- * the task.  It is inserted at the end of the list.
+ * the task.  It is inserted at the end of the list, or in deadline order if
+ * configUSE_EDF_SCHEDULING is enabled.
  */
-#define prvAddTaskToReadyList( pxTCB )                                                                 \
-    traceMOVED_TASK_TO_READY_STATE( pxTCB );                                                           \
-    taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );                                                \
-    listINSERT_END( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) ); \
+#define prvAddTaskToReadyList( pxTCB )                                               \
+    traceMOVED_TASK_TO_READY_STATE( pxTCB );                                         \
+    taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );                              \
+    taskREADY_LIST_INSERT( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), pxTCB ); \
+    taskTICKLESS_UPDATE_ALARM_FOR_READY_TASK( pxTCB );                               \
     tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB )
 /*-----------------------------------------------------------*/
 
@@ -422,11 +577,14 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
         xMPU_SETTINGS xMPUSettings; /*< The MPU settings are defined as part of the port layer.  THIS MUST BE THE SECOND MEMBER OF THE TCB STRUCT. */
     #endif
 
-    ListItem_t xStateListItem;                  /*< The list that the state list item of a task is reference from denotes the state of that task (Ready, Blocked, Suspended ). */
-    ListItem_t xEventListItem;                  /*< Used to reference a task from an event list. */
-    UBaseType_t uxPriority;                     /*< The priority of the task.  0 is the lowest priority. */
-    StackType_t * pxStack;                      /*< Points to the start of the stack. */
-    char pcTaskName[ configMAX_TASK_NAME_LEN ]; /*< Descriptive name given to the task when created.  Facilitates debugging only. */ /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+    /* The members up to pcTaskName are accessed on every context switch or
+     * tick, and are grouped together so that they span as few cache lines as
+     * possible.  The members after it are only accessed by the APIs that use
+     * them and by debug utilities. */
+    ListItem_t xStateListItem; /*< The list that the state list item of a task is reference from denotes the state of that task (Ready, Blocked, Suspended ). */
+    ListItem_t xEventListItem; /*< Used to reference a task from an event list. */
+    UBaseType_t uxPriority;    /*< The priority of the task.  0 is the lowest priority. */
+    StackType_t * pxStack;     /*< Points to the start of the stack. */
 
     #if ( configNUMBER_OF_CORES > 1 )
         BaseType_t xCoreID; /*< The core that this task is pinned to */
@@ -440,16 +598,43 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
         UBaseType_t uxCriticalNesting; /*< Holds the critical section nesting depth for ports that do not maintain their own count in the port layer. */
     #endif
 
-    #if ( configUSE_TRACE_FACILITY == 1 )
-        UBaseType_t uxTCBNumber;  /*< Stores a number that increments each time a TCB is created.  It allows debuggers to determine when a task has been deleted and then recreated. */
-        UBaseType_t uxTaskNumber; /*< Stores a number specifically for use by third party trace code. */
-    #endif
-
     #if ( configUSE_MUTEXES == 1 )
         UBaseType_t uxBasePriority; /*< The priority last assigned to the task - used by the priority inheritance mechanism. */
         UBaseType_t uxMutexesHeld;
     #endif
 
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        configRUN_TIME_COUNTER_TYPE ulRunTimeCounter; /*< Stores the amount of time the task has spent in the Running state. */
+    #endif
+
+    #if ( configUSE_POSIX_ERRNO == 1 )
+        int iTaskErrno;
+    #endif
+
+    #if ( configUSE_EDF_SCHEDULING == 1 )
+        TickType_t xPeriod;           /*< The release period of the task. 0 if the task has no deadline. */
+        TickType_t xRelativeDeadline; /*< The deadline of each job of the task, relative to its release time. */
+        TickType_t xLastReleaseTime;  /*< The release time of the task's current job. */
+        TickType_t xAbsoluteDeadline; /*< The deadline of the task's current job. Used to order the ready lists. Only valid if ucHasDeadline is set. */
+        UBaseType_t uxDeadlineMisses; /*< The number of jobs that completed after their deadline. */
+        uint8_t ucHasDeadline;        /*< pdTRUE if the task has a deadline, in which case it runs before the ready tasks of its priority without one. */
+    #endif
+
+    #if ( configUSE_TASK_BUDGETS == 1 )
+        TickType_t xBudget;            /*< The number of ticks the task may run for in each budget period. */
+        TickType_t xBudgetPeriod;      /*< The replenishment period of the budget. 0 if the task has no budget. */
+        TickType_t xBudgetPeriodStart; /*< The tick at which the current budget period started. */
+        TickType_t xBudgetRemaining;   /*< The number of ticks left in the current budget period. */
+        UBaseType_t uxThrottleCount;   /*< The number of times the task was throttled for exhausting its budget. */
+    #endif
+
+    char pcTaskName[ configMAX_TASK_NAME_LEN ]; /*< Descriptive name given to the task when created.  Facilitates debugging only. */ /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+
+    #if ( configUSE_TRACE_FACILITY == 1 )
+        UBaseType_t uxTCBNumber;  /*< Stores a number that increments each time a TCB is created.  It allows debuggers to determine when a task has been deleted and then recreated. */
+        UBaseType_t uxTaskNumber; /*< Stores a number specifically for use by third party trace code. */
+    #endif
+
     #if ( configUSE_APPLICATION_TASK_TAG == 1 )
         TaskHookFunction_t pxTaskTag;
     #endif
@@ -458,10 +643,6 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
         void * pvThreadLocalStoragePointers[ configNUM_THREAD_LOCAL_STORAGE_POINTERS ];
     #endif
 
-    #if ( configGENERATE_RUN_TIME_STATS == 1 )
-        configRUN_TIME_COUNTER_TYPE ulRunTimeCounter; /*< Stores the amount of time the task has spent in the Running state. */
-    #endif
-
     #if ( ( configUSE_NEWLIB_REENTRANT == 1 ) || ( configUSE_C_RUNTIME_TLS_SUPPORT == 1 ) )
         configTLS_BLOCK_TYPE xTLSBlock; /*< Memory block used as Thread Local Storage (TLS) Block for the task. */
     #endif
@@ -481,8 +662,9 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
         uint8_t ucDelayAborted;
     #endif
 
-    #if ( configUSE_POSIX_ERRNO == 1 )
-        int iTaskErrno;
+    #if ( configUSE_TASK_DELAY_US == 1 )
+        void * pvDelayUsTimer;    /*< The timer used to wake the task from vTaskDelayUs() and xTaskDelayUntilUs(). Created on first use. */
+        uint8_t ucDelayUsPending; /*< Set to pdTRUE while the task is blocked waiting for its timer to fire. */
     #endif
 } tskTCB;
 
@@ -499,10 +681,13 @@ portDONT_DISCARD PRIVILEGED_DATA TCB_t * volatile pxCurrentTCBs[ configNUMBER_OF
  * doing so breaks some kernel aware debuggers and debuggers that rely on removing
  * the static qualifier. */
 PRIVILEGED_DATA static List_t pxReadyTasksLists[ configMAX_PRIORITIES ];  /*< Prioritised ready tasks. */
-PRIVILEGED_DATA static List_t xDelayedTaskList1;                          /*< Delayed tasks. */
-PRIVILEGED_DATA static List_t xDelayedTaskList2;                          /*< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
-PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;               /*< Points to the delayed task list currently being used. */
-PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;       /*< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
+PRIVILEGED_DATA static List_t xDelayedTaskList1;                         /*< Delayed tasks. */
+PRIVILEGED_DATA static List_t xDelayedTaskList2;                         /*< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
+PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;              /*< Points to the delayed task list currently being used. */
+PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;      /*< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+    PRIVILEGED_DATA static List_t xDelayedTaskWheel[ taskDELAYED_WHEEL_LISTS ]; /*< Delayed tasks hashed by wake time: tick slots, then lap slots. Each slot is unordered. */
+#endif /* configUSE_DELAYED_TASK_WHEEL */
 PRIVILEGED_DATA static List_t xPendingReadyList[ configNUMBER_OF_CORES ]; /*< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
 
 #if ( INCLUDE_vTaskDelete == 1 )
@@ -510,6 +695,13 @@ PRIVILEGED_DATA static List_t xPendingReadyList[ configNUMBER_OF_CORES ]; /*< Ta
     PRIVILEGED_DATA static List_t xTasksWaitingTermination; /*< Tasks that have been deleted - but their memory not yet freed. */
     PRIVILEGED_DATA static volatile UBaseType_t uxDeletedTasksWaitingCleanUp = ( UBaseType_t ) 0U;
 
+    #if ( configUSE_TASK_REAPER == 1 )
+        PRIVILEGED_DATA static TaskHandle_t xTaskReaperHandle = NULL;                 /*< Task that frees the TCB and stack of deleted tasks in place of the idle task. */
+        PRIVILEGED_DATA static TaskMemoryReclaimHook_t pxTaskMemoryReclaimHook = NULL; /*< Optional hook that takes back a deleted task's TCB and stack instead of freeing them. */
+        PRIVILEGED_DATA static TaskMemoryReclaimHook_t pxTaskPoolReclaimHook = NULL;   /*< Hook of the task pools, called before pxTaskMemoryReclaimHook. */
+        PRIVILEGED_DATA static TaskReaperStats_t xTaskReaperStats = { 0 };            /*< Reclaim statistics, updated by the reaper task. */
+    #endif /* configUSE_TASK_REAPER */
+
 #endif
 
 #if ( INCLUDE_vTaskSuspend == 1 )
@@ -528,12 +720,19 @@ PRIVILEGED_DATA static List_t xPendingReadyList[ configNUMBER_OF_CORES ]; /*< Ta
 PRIVILEGED_DATA static volatile UBaseType_t uxCurrentNumberOfTasks = ( UBaseType_t ) 0U;
 PRIVILEGED_DATA static volatile TickType_t xTickCount = ( TickType_t ) configINITIAL_TICK_COUNT;
 PRIVILEGED_DATA static volatile UBaseType_t uxTopReadyPriority = tskIDLE_PRIORITY;
+#if ( ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 ) && ( configUSE_READY_PRIORITY_BITMAP == 1 ) )
+    PRIVILEGED_DATA static uint32_t ulReadyPriorityBitmap[ taskREADY_BITMAP_WORDS ] = { 0UL };
+    PRIVILEGED_DATA static uint32_t ulReadyPriorityGroups = 0UL;
+#endif
 PRIVILEGED_DATA static volatile BaseType_t xSchedulerRunning = pdFALSE;
 PRIVILEGED_DATA static volatile TickType_t xPendedTicks = ( TickType_t ) 0U;
 PRIVILEGED_DATA static volatile BaseType_t xYieldPending[ configNUMBER_OF_CORES ] = { pdFALSE };
 PRIVILEGED_DATA static volatile BaseType_t xNumOfOverflows = ( BaseType_t ) 0;
 PRIVILEGED_DATA static UBaseType_t uxTaskNumber = ( UBaseType_t ) 0U;
 PRIVILEGED_DATA static volatile TickType_t xNextTaskUnblockTime = ( TickType_t ) 0U;     /* Initialised to portMAX_DELAY before the scheduler starts. */
+#if ( configUSE_EDF_SCHEDULING == 1 )
+    PRIVILEGED_DATA static TickType_t xDeadlineKeyBase = ( TickType_t ) configINITIAL_TICK_COUNT; /*< The tick count that ready list deadlines are ordered relative to. */
+#endif
 PRIVILEGED_DATA static TaskHandle_t xIdleTaskHandle[ configNUMBER_OF_CORES ] = { NULL }; /*< Holds the handle of the idle task.  The idle task is created automatically when the scheduler is started. */
 
 /* Improve support for OpenOCD. The kernel tracks Ready tasks via priority lists.
@@ -650,6 +849,16 @@ static BaseType_t prvCreateIdleTasks( void );
 
 #endif /* configNUMBER_OF_CORES > 1 */
 
+#if ( ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 ) && ( configUSE_READY_PRIORITY_BITMAP == 1 ) )
+
+/*
+ * Returns the highest priority below uxBelowPriority that has ready tasks,
+ * according to the ready priority bitmap, or -1 if there is none.
+ */
+    static BaseType_t prvGetHighestReadyPriority( UBaseType_t uxBelowPriority ) PRIVILEGED_FUNCTION;
+
+#endif /* ( ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 ) && ( configUSE_READY_PRIORITY_BITMAP == 1 ) ) */
+
 /**
  * Utility task that simply returns pdTRUE if the task referenced by xTask is
  * currently in the Suspended state, or pdFALSE if the task referenced by xTask
@@ -698,7 +907,25 @@ static portTASK_FUNCTION_PROTO( prvIdleTask, pvParameters ) PRIVILEGED_FUNCTION;
  * in the list of tasks waiting to be deleted.  If so the task is cleaned up
  * and its TCB deleted.
  */
-static void prvCheckTasksWaitingTermination( void ) PRIVILEGED_FUNCTION;
+#if ( configUSE_TASK_REAPER == 0 )
+    static void prvCheckTasksWaitingTermination( void ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_TASK_REAPER == 1 )
+
+/*
+ * Creates the task reaper during scheduler start.  The reaper replaces the
+ * idle task's polling of xTasksWaitingTermination.
+ */
+    static BaseType_t prvCreateTaskReaper( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Wakes the task reaper after a running task has been placed in
+ * xTasksWaitingTermination.
+ */
+    static void prvNotifyTaskReaper( void ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TASK_REAPER */
 
 /*
  * The currently executing task is entering the Blocked state.  Add the task to
@@ -707,6 +934,15 @@ static void prvCheckTasksWaitingTermination( void ) PRIVILEGED_FUNCTION;
 static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
                                             const BaseType_t xCanBlockIndefinitely ) PRIVILEGED_FUNCTION;
 
+/*
+ * Inserts pxTCB, which must not be in any state list, into the delayed task
+ * list (or wheel slot) for a wake time xTicksToWait ticks after
+ * xConstTickCount.
+ */
+static void prvAddTaskToDelayedList( TCB_t * pxTCB,
+                                     TickType_t xTicksToWait,
+                                     TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
 /*
  * Fills an TaskStatus_t structure with information on each task that is
  * referenced from the pxList list (which may be a ready list, a delayed list,
@@ -766,6 +1002,74 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
  */
 static void prvResetNextTaskUnblockTime( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * Called from xTaskIncrementTick() to move a task whose block time has expired
+ * from the Blocked state to the Ready state.  Returns pdTRUE if a context
+ * switch is required on core 0.
+ */
+static BaseType_t prvUnblockTimedOutTask( TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+/*
+ * Returns the ready list item value of a task with the absolute deadline
+ * xDeadline.
+ */
+    static TickType_t prvGetDeadlineKey( TickType_t xDeadline ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called from xTaskIncrementTick() to move the base that ready list deadlines
+ * are ordered relative to forward to xNewBase, and adjust the item values of
+ * the ready tasks to match.
+ */
+    static void prvRebaseDeadlineKeys( TickType_t xNewBase ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if ( configUSE_TASK_BUDGETS == 1 )
+
+/*
+ * Called on each tick interrupt to charge xChargedTick, the tick that has just
+ * ended, to the CPU budget of the task that was running during it.  Ticks that
+ * are replayed from xPendedTicks when the scheduler is resumed are not charged
+ * again.
+ */
+    static void prvChargeTaskBudget( TCB_t * pxTCB,
+                                     TickType_t xChargedTick ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called on each tick interrupt while the scheduler is running.  If the task
+ * running on core xCoreID has exhausted its budget, it is moved to the Blocked
+ * state until its budget is replenished at the start of its next budget
+ * period.  Returns pdTRUE if the task was throttled, in which case a context
+ * switch is required on that core.
+ */
+    static BaseType_t prvThrottleTaskIfExhausted( BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TASK_BUDGETS */
+
+#if ( configUSE_TASK_DELAY_US == 1 )
+
+/*
+ * Called with the kernel lock held when a task leaves the Blocked state other
+ * than by the timer of vTaskDelayUs() or xTaskDelayUntilUs() (i.e., when it is
+ * deleted, suspended or its delay is aborted), so that the timer can no longer
+ * unblock it.
+ */
+    static void prvCancelDelayUs( TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TASK_DELAY_US */
+
+#if ( ( INCLUDE_vTaskDelete == 1 ) && ( configUSE_TASK_DELAY_US == 1 ) )
+
+/*
+ * Deletes the timer used by vTaskDelayUs() and xTaskDelayUntilUs() to wake
+ * the task, if it was ever created.  Called when the task's TCB is freed.
+ */
+    static void prvDeleteDelayUsTimer( TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif /* ( ( INCLUDE_vTaskDelete == 1 ) && ( configUSE_TASK_DELAY_US == 1 ) ) */
+
 #if ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 )
 
 /*
@@ -1147,6 +1451,13 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
     listSET_LIST_ITEM_VALUE( &( pxNewTCB->xEventListItem ), ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxPriority ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
     listSET_LIST_ITEM_OWNER( &( pxNewTCB->xEventListItem ), pxNewTCB );
 
+    #if ( configUSE_EDF_SCHEDULING == 1 )
+    {
+        /* Tasks have no deadline until one is set with xTaskSetDeadline(). */
+        pxNewTCB->ucHasDeadline = ( uint8_t ) pdFALSE;
+    }
+    #endif /* configUSE_EDF_SCHEDULING */
+
     #if ( portUSING_MPU_WRAPPERS == 1 )
     {
         vPortStoreTaskMPUSettings( &( pxNewTCB->xMPUSettings ), xRegions, pxNewTCB->pxStack, ulStackDepth );
@@ -1364,6 +1675,12 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                 mtCOVERAGE_TEST_MARKER();
             }
 
+            #if ( configUSE_TASK_DELAY_US == 1 )
+            {
+                prvCancelDelayUs( pxTCB );
+            }
+            #endif /* configUSE_TASK_DELAY_US */
+
             /* Is the task waiting on an event also? */
             if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
             {
@@ -1416,6 +1733,14 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                  * check the xTasksWaitingTermination list. */
                 ++uxDeletedTasksWaitingCleanUp;
 
+                #if ( configUSE_TASK_REAPER == 1 )
+                {
+                    /* The item value is unused while on the termination list,
+                     * so record the deletion tick for reclaim latency. */
+                    listSET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ), xTickCount );
+                }
+                #endif /* configUSE_TASK_REAPER */
+
                 /* Call the delete hook before portPRE_TASK_DELETE_HOOK() as
                  * portPRE_TASK_DELETE_HOOK() does not return in the Win32 port. */
                 traceTASK_DELETE( pxTCB );
@@ -1461,6 +1786,16 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
             prvDeleteTCB( pxTCB );
         }
 
+        #if ( configUSE_TASK_REAPER == 1 )
+        {
+            /* The TCB is freed by the task reaper instead of the idle task. */
+            if( xIsCurRunning == pdTRUE )
+            {
+                prvNotifyTaskReaper();
+            }
+        }
+        #endif /* configUSE_TASK_REAPER */
+
         /* For SMP, we need to take the kernel lock here as we are about to
          * access kernel data structures. */
         prvENTER_CRITICAL_SMP_ONLY( &xKernelLock );
@@ -1499,6 +1834,10 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
         configASSERT( ( xTimeIncrement > 0U ) );
         configASSERT( taskIS_SCHEDULER_SUSPENDED() == pdFALSE );
 
+        /* Bring the tick count up to date if ticks are not processed
+         * periodically. */
+        portTICKLESS_SYNC_TICK_COUNT();
+
         prvENTER_CRITICAL_OR_SUSPEND_ALL( &xKernelLock );
         {
             /* Minor optimisation.  The tick count cannot change in this
@@ -1625,8 +1964,6 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
     {
         eTaskState eReturn;
         List_t const * pxStateList;
-        List_t const * pxDelayedList;
-        List_t const * pxOverflowedDelayedList;
         const TCB_t * const pxTCB = xTask;
 
         configASSERT( pxTCB );
@@ -1641,10 +1978,8 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
             else
             {
                 pxStateList = listLIST_ITEM_CONTAINER( &( pxTCB->xStateListItem ) );
-                pxDelayedList = pxDelayedTaskList;
-                pxOverflowedDelayedList = pxOverflowDelayedTaskList;
 
-                if( ( pxStateList == pxDelayedList ) || ( pxStateList == pxOverflowedDelayedList ) )
+                if( taskLIST_IS_DELAYED_TASK_LIST( pxStateList ) )
                 {
                     /* The task being queried is referenced from one of the Blocked
                      * lists. */
@@ -1987,6 +2322,12 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                 mtCOVERAGE_TEST_MARKER();
             }
 
+            #if ( configUSE_TASK_DELAY_US == 1 )
+            {
+                prvCancelDelayUs( pxTCB );
+            }
+            #endif /* configUSE_TASK_DELAY_US */
+
             /* Is the task waiting on an event also? */
             if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
             {
@@ -2401,6 +2742,19 @@ void vTaskStartScheduler( void )
     }
     #endif /* configUSE_TIMERS */
 
+    #if ( configUSE_TASK_REAPER == 1 )
+    {
+        if( xReturn == pdPASS )
+        {
+            xReturn = prvCreateTaskReaper();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* configUSE_TASK_REAPER */
+
     if( xReturn == pdPASS )
     {
         /* freertos_tasks_c_additions_init() should only be called if the user
@@ -2713,6 +3067,10 @@ TickType_t xTaskGetTickCount( void )
 {
     TickType_t xTicks;
 
+    /* Bring the tick count up to date if ticks are not processed
+     * periodically. */
+    portTICKLESS_SYNC_TICK_COUNT();
+
     /* Critical section required if running on a 16 bit processor. */
     portTICK_TYPE_ENTER_CRITICAL();
     {
@@ -2745,6 +3103,10 @@ TickType_t xTaskGetTickCountFromISR( void )
      * link: https://www.FreeRTOS.org/RTOS-Cortex-M3-M4.html */
     portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
 
+    /* Bring the tick count up to date if ticks are not processed
+     * periodically. */
+    portTICKLESS_SYNC_TICK_COUNT();
+
     /* For SMP, we need to take the kernel lock here as we are about to access
      * kernel data structures. */
     prvENTER_CRITICAL_ISR_SMP_ONLY( &xKernelLock );
@@ -2889,6 +3251,15 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char
                 pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
             }
 
+            #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+            {
+                for( UBaseType_t uxSlot = 0; ( uxSlot < taskDELAYED_WHEEL_LISTS ) && ( pxTCB == NULL ); uxSlot++ )
+                {
+                    pxTCB = prvSearchForNameWithinSingleList( &( xDelayedTaskWheel[ uxSlot ] ), pcNameToQuery );
+                }
+            }
+            #endif /* configUSE_DELAYED_TASK_WHEEL */
+
             #if ( INCLUDE_vTaskSuspend == 1 )
             {
                 if( pxTCB == NULL )
@@ -2991,6 +3362,15 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char
                 uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked );
                 uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked );
 
+                #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+                {
+                    for( UBaseType_t uxSlot = 0; uxSlot < taskDELAYED_WHEEL_LISTS; uxSlot++ )
+                    {
+                        uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( xDelayedTaskWheel[ uxSlot ] ), eBlocked );
+                    }
+                }
+                #endif /* configUSE_DELAYED_TASK_WHEEL */
+
                 #if ( INCLUDE_vTaskDelete == 1 )
                 {
                     /* Fill in an TaskStatus_t structure with information on
@@ -3158,6 +3538,12 @@ BaseType_t xTaskCatchUpTicks( TickType_t xTicksToCatchUp )
                     {
                         mtCOVERAGE_TEST_MARKER();
                     }
+
+                    #if ( configUSE_TASK_DELAY_US == 1 )
+                    {
+                        prvCancelDelayUs( pxTCB );
+                    }
+                    #endif /* configUSE_TASK_DELAY_US */
                 }
                 prvEXIT_CRITICAL_SC_ONLY( &xKernelLock );
 
@@ -3189,16 +3575,243 @@ BaseType_t xTaskCatchUpTicks( TickType_t xTicksToCatchUp )
             }
             else
             {
-                xReturn = pdFAIL;
+                xReturn = pdFAIL;
+            }
+        }
+        ( void ) prvEXIT_CRITICAL_OR_RESUME_ALL( &xKernelLock );
+
+        return xReturn;
+    }
+
+#endif /* INCLUDE_xTaskAbortDelay */
+/*----------------------------------------------------------*/
+
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+    static TickType_t prvGetDeadlineKey( TickType_t xDeadline )
+    {
+        TickType_t xKey = ( TickType_t ) ( xDeadline - xDeadlineKeyBase + taskDEADLINE_KEY_OFFSET );
+
+        /* portMAX_DELAY is reserved for tasks without a deadline. */
+        if( xKey == portMAX_DELAY )
+        {
+            xKey--;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xKey;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvRebaseDeadlineKeys( TickType_t xNewBase )
+    {
+        const TickType_t xDelta = xNewBase - xDeadlineKeyBase;
+        UBaseType_t uxPriority;
+        ListItem_t * pxIterator;
+        TickType_t xItemValue;
+
+        /* Every key is lowered by the same amount, and keys that would drop
+         * below zero (deadlines missed long ago) are clamped to zero, so the
+         * ready lists stay sorted and do not need to be rebuilt.  This happens
+         * once every taskDEADLINE_KEY_OFFSET ticks. */
+        for( uxPriority = ( UBaseType_t ) 0U; uxPriority < ( UBaseType_t ) configMAX_PRIORITIES; uxPriority++ )
+        {
+            for( pxIterator = listGET_HEAD_ENTRY( &( pxReadyTasksLists[ uxPriority ] ) );
+                 pxIterator != listGET_END_MARKER( &( pxReadyTasksLists[ uxPriority ] ) );
+                 pxIterator = listGET_NEXT( pxIterator ) )
+            {
+                xItemValue = listGET_LIST_ITEM_VALUE( pxIterator );
+
+                if( xItemValue == portMAX_DELAY )
+                {
+                    /* Tasks without a deadline are at the end of the list. */
+                    break;
+                }
+                else if( xItemValue < xDelta )
+                {
+                    listSET_LIST_ITEM_VALUE( pxIterator, ( TickType_t ) 0U );
+                }
+                else
+                {
+                    listSET_LIST_ITEM_VALUE( pxIterator, xItemValue - xDelta );
+                }
+            }
+        }
+
+        xDeadlineKeyBase = xNewBase;
+    }
+
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvUnblockTimedOutTask( TCB_t * pxTCB )
+{
+    BaseType_t xSwitchRequired = pdFALSE;
+
+    /* It is time to remove the item from the Blocked state. */
+    listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+
+    /* Is the task waiting on an event also?  If so remove
+     * it from the event list. */
+    if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+    {
+        listREMOVE_ITEM( &( pxTCB->xEventListItem ) );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    /* Place the unblocked task into the appropriate ready
+     * list. */
+    prvAddTaskToReadyList( pxTCB );
+
+    /* A task being unblocked cannot cause an immediate
+     * context switch if preemption is turned off. */
+    #if ( configUSE_PREEMPTION == 1 )
+    {
+        /* Preemption is on, but a context switch should
+         * only be performed if the unblocked task has a
+         * priority that is equal to or higher than the
+         * currently executing task.
+         *
+         * For SMP, since this function is only run on core
+         * 0, we only need to context switch if the unblocked
+         * task can run on core 0 and has a higher priority
+         * than the current task.
+         *
+         * If the unblocked task has affinity to the other
+         * core or no affinity then we need to set xYieldPending
+         * for the other core if the unblocked task has a priority
+         * higher than the priority of the currently running task
+         * on the other core. */
+        if( taskIS_AFFINITY_COMPATIBLE( 0, pxTCB ) == pdTRUE )
+        {
+            if( pxTCB->uxPriority > pxCurrentTCBs[ 0 ]->uxPriority )
+            {
+                xSwitchRequired = pdTRUE;
+            }
+
+            #if ( configNUMBER_OF_CORES > 1 )
+                else if( pxTCB->xCoreID == tskNO_AFFINITY )
+                {
+                    if( pxTCB->uxPriority > pxCurrentTCBs[ 1 ]->uxPriority )
+                    {
+                        xYieldPending[ 1 ] = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            #endif /* if ( configNUMBER_OF_CORES > 1 ) */
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        #if ( configNUMBER_OF_CORES > 1 )
+            else
+            {
+                if( pxTCB->uxPriority > pxCurrentTCBs[ 1 ]->uxPriority )
+                {
+                    xYieldPending[ 1 ] = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        #endif /* if ( configNUMBER_OF_CORES > 1 ) */
+    }
+    #endif /* configUSE_PREEMPTION */
+
+    return xSwitchRequired;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TASK_BUDGETS == 1 )
+
+    static void prvChargeTaskBudget( TCB_t * pxTCB,
+                                     TickType_t xChargedTick )
+    {
+        if( pxTCB->xBudgetPeriod > ( TickType_t ) 0 )
+        {
+            /* The budget is replenished lazily, on the first tick charged in a
+             * new budget period.  Periods stay aligned to the original start
+             * even if the task did not run for several periods. */
+            if( ( TickType_t ) ( xChargedTick - pxTCB->xBudgetPeriodStart ) >= pxTCB->xBudgetPeriod )
+            {
+                pxTCB->xBudgetPeriodStart = xChargedTick - ( ( TickType_t ) ( xChargedTick - pxTCB->xBudgetPeriodStart ) % pxTCB->xBudgetPeriod );
+                pxTCB->xBudgetRemaining = pxTCB->xBudget;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( pxTCB->xBudgetRemaining > ( TickType_t ) 0 )
+            {
+                pxTCB->xBudgetRemaining--;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvThrottleTaskIfExhausted( BaseType_t xCoreID )
+    {
+        TCB_t * const pxTCB = pxCurrentTCBs[ xCoreID ];
+        const TickType_t xConstTickCount = xTickCount;
+        BaseType_t xThrottled = pdFALSE;
+
+        /* Only throttle the task if it is still in its ready list (i.e., it
+         * is not in the middle of being blocked, suspended or deleted) and
+         * its budget is not about to be replenished anyway. */
+        if( ( pxTCB->xBudgetPeriod > ( TickType_t ) 0 ) &&
+            ( pxTCB->xBudgetRemaining == ( TickType_t ) 0 ) &&
+            ( ( TickType_t ) ( xConstTickCount - pxTCB->xBudgetPeriodStart ) < pxTCB->xBudgetPeriod ) &&
+            ( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xStateListItem ) ) != pdFALSE ) )
+        {
+            pxTCB->uxThrottleCount++;
+
+            /* The task is not blocking itself, so it is moved to the delayed
+             * task list directly rather than with
+             * prvAddCurrentTaskToDelayedList(), which would also clear a pending
+             * delay abort and resynchronise the tick count. */
+            if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+            {
+                portRESET_READY_PRIORITY( pxTCB->uxPriority, uxTopReadyPriority );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
             }
+
+            prvAddTaskToDelayedList( pxTCB, pxTCB->xBudgetPeriodStart + pxTCB->xBudgetPeriod - xConstTickCount, xConstTickCount );
+            xThrottled = pdTRUE;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
         }
-        ( void ) prvEXIT_CRITICAL_OR_RESUME_ALL( &xKernelLock );
 
-        return xReturn;
+        return xThrottled;
     }
 
-#endif /* INCLUDE_xTaskAbortDelay */
-/*----------------------------------------------------------*/
+#endif /* configUSE_TASK_BUDGETS */
+/*-----------------------------------------------------------*/
 
 BaseType_t xTaskIncrementTick( void )
 {
@@ -3243,129 +3856,131 @@ BaseType_t xTaskIncrementTick( void )
                 mtCOVERAGE_TEST_MARKER();
             }
 
-            /* See if this tick has made a timeout expire.  Tasks are stored in
-             * the  queue in the order of their wake time - meaning once one task
-             * has been found whose block time has not expired there is no need to
-             * look any further down the list. */
-            if( xConstTickCount >= xNextTaskUnblockTime )
+            #if ( configUSE_EDF_SCHEDULING == 1 )
             {
-                for( ; ; )
+                if( ( TickType_t ) ( xConstTickCount - xDeadlineKeyBase ) >= taskDEADLINE_KEY_OFFSET )
                 {
-                    if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
-                    {
-                        /* The delayed list is empty.  Set xNextTaskUnblockTime
-                         * to the maximum possible value so it is extremely
-                         * unlikely that the
-                         * if( xTickCount >= xNextTaskUnblockTime ) test will pass
-                         * next time through. */
-                        xNextTaskUnblockTime = portMAX_DELAY; /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
-                        break;
-                    }
-                    else
+                    prvRebaseDeadlineKeys( xConstTickCount );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configUSE_EDF_SCHEDULING */
+
+            #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+            {
+                List_t * const pxSlot = taskDELAYED_WHEEL_SLOT( xConstTickCount );
+
+                /* At the start of a lap, move the tasks of its lap slot that are
+                 * due within the lap to their tick slot.  The lap slot is only
+                 * visited once per lap, and a task is only skipped once per
+                 * round of the lap slots. */
+                if( ( xConstTickCount & ( ( TickType_t ) configDELAYED_TASK_WHEEL_SIZE - 1U ) ) == ( TickType_t ) 0U )
+                {
+                    List_t * const pxLapSlot = taskDELAYED_WHEEL_LAP_SLOT( xConstTickCount );
+                    const ListItem_t * const pxLapSlotEnd = listGET_END_MARKER( pxLapSlot );
+                    ListItem_t * pxItem = listGET_HEAD_ENTRY( pxLapSlot );
+                    ListItem_t * pxNextItem;
+
+                    while( pxItem != pxLapSlotEnd )
                     {
-                        /* The delayed list is not empty, get the value of the
-                         * item at the head of the delayed list.  This is the time
-                         * at which the task at the head of the delayed list must
-                         * be removed from the Blocked state. */
-                        pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-                        xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
-
-                        if( xConstTickCount < xItemValue )
+                        pxNextItem = listGET_NEXT( pxItem );
+                        xItemValue = listGET_LIST_ITEM_VALUE( pxItem );
+
+                        if( ( TickType_t ) ( xItemValue - xConstTickCount ) < ( TickType_t ) configDELAYED_TASK_WHEEL_SIZE )
                         {
-                            /* It is not time to unblock this item yet, but the
-                             * item value is the time at which the task at the head
-                             * of the blocked list must be removed from the Blocked
-                             * state -  so record the item value in
-                             * xNextTaskUnblockTime. */
-                            xNextTaskUnblockTime = xItemValue;
-                            break; /*lint !e9011 Code structure here is deemed easier to understand with multiple breaks. */
+                            listREMOVE_ITEM( pxItem );
+                            listINSERT_END( taskDELAYED_WHEEL_SLOT( xItemValue ), pxItem );
                         }
                         else
                         {
                             mtCOVERAGE_TEST_MARKER();
                         }
 
-                        /* It is time to remove the item from the Blocked state. */
-                        listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+                        pxItem = pxNextItem;
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* See if this tick has made a timeout expire.  Every task in the
+                 * wheel slot of this tick is due now. */
+                while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+                {
+                    pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxSlot ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+                    configASSERT( listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) ) == xConstTickCount );
 
-                        /* Is the task waiting on an event also?  If so remove
-                         * it from the event list. */
-                        if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+                    if( prvUnblockTimedOutTask( pxTCB ) != pdFALSE )
+                    {
+                        xSwitchRequired = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            #else /* configUSE_DELAYED_TASK_WHEEL */
+            {
+                /* See if this tick has made a timeout expire.  Tasks are stored in
+                 * the  queue in the order of their wake time - meaning once one task
+                 * has been found whose block time has not expired there is no need to
+                 * look any further down the list. */
+                if( xConstTickCount >= xNextTaskUnblockTime )
+                {
+                    for( ; ; )
+                    {
+                        if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
                         {
-                            listREMOVE_ITEM( &( pxTCB->xEventListItem ) );
+                            /* The delayed list is empty.  Set xNextTaskUnblockTime
+                             * to the maximum possible value so it is extremely
+                             * unlikely that the
+                             * if( xTickCount >= xNextTaskUnblockTime ) test will pass
+                             * next time through. */
+                            xNextTaskUnblockTime = portMAX_DELAY; /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+                            break;
                         }
                         else
                         {
-                            mtCOVERAGE_TEST_MARKER();
-                        }
-
-                        /* Place the unblocked task into the appropriate ready
-                         * list. */
-                        prvAddTaskToReadyList( pxTCB );
-
-                        /* A task being unblocked cannot cause an immediate
-                         * context switch if preemption is turned off. */
-                        #if ( configUSE_PREEMPTION == 1 )
-                        {
-                            /* Preemption is on, but a context switch should
-                             * only be performed if the unblocked task has a
-                             * priority that is equal to or higher than the
-                             * currently executing task.
-                             *
-                             * For SMP, since this function is only run on core
-                             * 0, we only need to context switch if the unblocked
-                             * task can run on core 0 and has a higher priority
-                             * than the current task.
-                             *
-                             * If the unblocked task has affinity to the other
-                             * core or no affinity then we need to set xYieldPending
-                             * for the other core if the unblocked task has a priority
-                             * higher than the priority of the currently running task
-                             * on the other core. */
-                            if( taskIS_AFFINITY_COMPATIBLE( 0, pxTCB ) == pdTRUE )
+                            /* The delayed list is not empty, get the value of the
+                             * item at the head of the delayed list.  This is the time
+                             * at which the task at the head of the delayed list must
+                             * be removed from the Blocked state. */
+                            pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+                            xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
+
+                            if( xConstTickCount < xItemValue )
                             {
-                                if( pxTCB->uxPriority > pxCurrentTCBs[ 0 ]->uxPriority )
-                                {
-                                    xSwitchRequired = pdTRUE;
-                                }
-
-                                #if ( configNUMBER_OF_CORES > 1 )
-                                    else if( pxTCB->xCoreID == tskNO_AFFINITY )
-                                    {
-                                        if( pxTCB->uxPriority > pxCurrentTCBs[ 1 ]->uxPriority )
-                                        {
-                                            xYieldPending[ 1 ] = pdTRUE;
-                                        }
-                                        else
-                                        {
-                                            mtCOVERAGE_TEST_MARKER();
-                                        }
-                                    }
-                                #endif /* if ( configNUMBER_OF_CORES > 1 ) */
-                                else
-                                {
-                                    mtCOVERAGE_TEST_MARKER();
-                                }
+                                /* It is not time to unblock this item yet, but the
+                                 * item value is the time at which the task at the head
+                                 * of the blocked list must be removed from the Blocked
+                                 * state -  so record the item value in
+                                 * xNextTaskUnblockTime. */
+                                xNextTaskUnblockTime = xItemValue;
+                                break; /*lint !e9011 Code structure here is deemed easier to understand with multiple breaks. */
+                            }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
                             }
 
-                            #if ( configNUMBER_OF_CORES > 1 )
-                                else
-                                {
-                                    if( pxTCB->uxPriority > pxCurrentTCBs[ 1 ]->uxPriority )
-                                    {
-                                        xYieldPending[ 1 ] = pdTRUE;
-                                    }
-                                    else
-                                    {
-                                        mtCOVERAGE_TEST_MARKER();
-                                    }
-                                }
-                            #endif /* if ( configNUMBER_OF_CORES > 1 ) */
+                            if( prvUnblockTimedOutTask( pxTCB ) != pdFALSE )
+                            {
+                                xSwitchRequired = pdTRUE;
+                            }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
+                            }
                         }
-                        #endif /* configUSE_PREEMPTION */
                     }
                 }
             }
+            #endif /* configUSE_DELAYED_TASK_WHEEL */
 
             /* Tasks of equal priority to the currently running task will share
              * processing time (time slice) if preemption is on, and the application
@@ -3383,6 +3998,31 @@ BaseType_t xTaskIncrementTick( void )
             }
             #endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) ) */
 
+            #if ( configUSE_TASK_BUDGETS == 1 )
+            {
+                /* Charge the tick to the budget of the task that was running,
+                 * which is throttled if it has exhausted its budget.  Pended
+                 * ticks were charged when they occurred. */
+                if( xPendedTicks == ( TickType_t ) 0 )
+                {
+                    prvChargeTaskBudget( pxCurrentTCBs[ 0 ], xConstTickCount - ( TickType_t ) 1 );
+
+                    if( prvThrottleTaskIfExhausted( 0 ) != pdFALSE )
+                    {
+                        xSwitchRequired = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configUSE_TASK_BUDGETS */
+
             #if ( configUSE_TICK_HOOK == 1 )
             {
                 /* Guard against the tick hook being called when the pended tick
@@ -3413,6 +4053,15 @@ BaseType_t xTaskIncrementTick( void )
         }
         else
         {
+            #if ( configUSE_TASK_BUDGETS == 1 )
+            {
+                /* The task that suspended the scheduler keeps running, so the
+                 * tick is charged to it now.  It can only be throttled once the
+                 * scheduler is resumed. */
+                prvChargeTaskBudget( pxCurrentTCBs[ 0 ], xTickCount + xPendedTicks );
+            }
+            #endif /* configUSE_TASK_BUDGETS */
+
             ++xPendedTicks;
 
             /* The tick hook gets called at regular intervals, even if the
@@ -3567,7 +4216,12 @@ BaseType_t xTaskIncrementTick( void )
         /* Search for tasks, starting form the highest ready priority. If nothing is
          * found, we eventually default to the IDLE tasks at priority 0 */
 
-        for( uxCurPriority = uxTopReadyPriority; uxCurPriority >= 0 && xTaskScheduled == pdFALSE; uxCurPriority-- )
+        #if ( configUSE_READY_PRIORITY_BITMAP == 1 )
+            /* Only visit the priorities that have ready tasks. */
+            for( uxCurPriority = prvGetHighestReadyPriority( configMAX_PRIORITIES ); uxCurPriority >= 0 && xTaskScheduled == pdFALSE; uxCurPriority = prvGetHighestReadyPriority( uxCurPriority ) )
+        #else
+            for( uxCurPriority = uxTopReadyPriority; uxCurPriority >= 0 && xTaskScheduled == pdFALSE; uxCurPriority-- )
+        #endif /* configUSE_READY_PRIORITY_BITMAP */
         {
             /* Check if current priority has one or more ready tasks. Skip if none */
             if( listLIST_IS_EMPTY( &( pxReadyTasksLists[ uxCurPriority ] ) ) )
@@ -3625,12 +4279,13 @@ BaseType_t xTaskIncrementTick( void )
                 pxCurrentTCBs[ xCurCoreID ] = pxTCBCur;
                 xTaskScheduled = pdTRUE;
 
-                /* Move the current tasks list item to the back of the list in order
-                 * to implement best effort round robin. To do this, we need to reset
-                 * the pxIndex to point to the tail again. */
+                /* Move the current tasks list item to the back of the list (or
+                 * behind the tasks sharing its deadline if EDF scheduling is used)
+                 * in order to implement best effort round robin. To do this, we need
+                 * to reset the pxIndex to point to the tail again. */
                 pxReadyTasksLists[ uxCurPriority ].pxIndex = ( ListItem_t * ) &( pxReadyTasksLists[ uxCurPriority ].xListEnd );
                 listREMOVE_ITEM( &( pxTCBCur->xStateListItem ) );
-                listINSERT_END( &( pxReadyTasksLists[ uxCurPriority ] ), &( pxTCBCur->xStateListItem ) );
+                taskREADY_LIST_INSERT( &( pxReadyTasksLists[ uxCurPriority ] ), pxTCBCur );
                 break;
 
 get_next_task:
@@ -3645,6 +4300,60 @@ get_next_task:
 #endif /* configNUMBER_OF_CORES > 1 */
 /*-----------------------------------------------------------*/
 
+#if ( ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 ) && ( configUSE_READY_PRIORITY_BITMAP == 1 ) )
+
+    static BaseType_t prvGetHighestReadyPriority( UBaseType_t uxBelowPriority )
+    {
+        BaseType_t xReturn = -1;
+        UBaseType_t uxWord;
+        uint32_t ulBits;
+
+        if( uxBelowPriority > ( UBaseType_t ) 0U )
+        {
+            /* Look for a ready priority below uxBelowPriority in the same word
+             * first, then in the highest lower word that has any. */
+            uxWord = ( uxBelowPriority - 1U ) / taskREADY_BITMAP_BITS;
+            ulBits = ulReadyPriorityBitmap[ uxWord ] & ( 0xFFFFFFFFUL >> ( ( taskREADY_BITMAP_BITS - 1U ) - ( ( uxBelowPriority - 1U ) % taskREADY_BITMAP_BITS ) ) );
+
+            if( ulBits == 0UL )
+            {
+                const uint32_t ulGroups = ulReadyPriorityGroups & ( ( 1UL << uxWord ) - 1UL );
+
+                if( ulGroups != 0UL )
+                {
+                    uxWord = ( taskREADY_BITMAP_BITS - 1U ) - ( UBaseType_t ) __builtin_clz( ulGroups );
+                    ulBits = ulReadyPriorityBitmap[ uxWord ];
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( ulBits != 0UL )
+            {
+                xReturn = ( BaseType_t ) ( ( uxWord * taskREADY_BITMAP_BITS ) + ( ( taskREADY_BITMAP_BITS - 1U ) - ( UBaseType_t ) __builtin_clz( ulBits ) ) );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+
+#endif /* ( ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 ) && ( configUSE_READY_PRIORITY_BITMAP == 1 ) ) */
+/*-----------------------------------------------------------*/
+
 void vTaskSwitchContext( void )
 {
     /* For SMP, we need to take the kernel lock here as we are about to access
@@ -3716,6 +4425,10 @@ void vTaskSwitchContext( void )
             }
             #endif
 
+            /* The task switched in may need a different next tick (e.g., to
+             * be time sliced) if ticks are not processed periodically. */
+            portTICKLESS_UPDATE_ALARM();
+
             /* Wrap this call in a macro. IDF-8434 */
             #if CONFIG_FREERTOS_WATCHPOINT_END_OF_STACK
             {
@@ -4141,6 +4854,7 @@ void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
 void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
 {
     configASSERT( pxTimeOut );
+    portTICKLESS_SYNC_TICK_COUNT();
     taskENTER_CRITICAL( &xKernelLock );
     {
         pxTimeOut->xOverflowCount = xNumOfOverflows;
@@ -4153,6 +4867,7 @@ void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
 void vTaskInternalSetTimeOutState( TimeOut_t * const pxTimeOut )
 {
     /* For internal use only as it does not use a critical section. */
+    portTICKLESS_SYNC_TICK_COUNT();
     pxTimeOut->xOverflowCount = xNumOfOverflows;
     pxTimeOut->xTimeOnEntering = xTickCount;
 }
@@ -4166,6 +4881,7 @@ BaseType_t xTaskCheckForTimeOut( TimeOut_t * const pxTimeOut,
     configASSERT( pxTimeOut );
     configASSERT( pxTicksToWait );
 
+    portTICKLESS_SYNC_TICK_COUNT();
     taskENTER_CRITICAL( &xKernelLock );
     {
         /* Minor optimisation.  The tick count cannot change in this block. */
@@ -4296,9 +5012,13 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
 
     for( ; ; )
     {
-        /* See if any tasks have deleted themselves - if so then the idle task
-         * is responsible for freeing the deleted task's TCB and stack. */
-        prvCheckTasksWaitingTermination();
+        #if ( configUSE_TASK_REAPER == 0 )
+        {
+            /* See if any tasks have deleted themselves - if so then the idle task
+             * is responsible for freeing the deleted task's TCB and stack. */
+            prvCheckTasksWaitingTermination();
+        }
+        #endif /* configUSE_TASK_REAPER */
 
         #if ( configUSE_PREEMPTION == 0 )
         {
@@ -4539,6 +5259,15 @@ static void prvInitialiseTaskLists( void )
     vListInitialise( &xDelayedTaskList1 );
     vListInitialise( &xDelayedTaskList2 );
 
+    #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+    {
+        for( x = 0; x < taskDELAYED_WHEEL_LISTS; x++ )
+        {
+            vListInitialise( &( xDelayedTaskWheel[ x ] ) );
+        }
+    }
+    #endif /* configUSE_DELAYED_TASK_WHEEL */
+
     for( x = 0; x < configNUMBER_OF_CORES; x++ )
     {
         vListInitialise( &xPendingReadyList[ x ] );
@@ -4563,6 +5292,8 @@ static void prvInitialiseTaskLists( void )
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TASK_REAPER == 0 )
+
 static void prvCheckTasksWaitingTermination( void )
 {
     /** THIS FUNCTION IS CALLED FROM THE RTOS IDLE TASK **/
@@ -4631,6 +5362,8 @@ static void prvCheckTasksWaitingTermination( void )
     }
     #endif /* INCLUDE_vTaskDelete */
 }
+
+#endif /* configUSE_TASK_REAPER */
 /*-----------------------------------------------------------*/
 
 #if ( configUSE_TRACE_FACILITY == 1 )
@@ -4672,6 +5405,14 @@ static void prvCheckTasksWaitingTermination( void )
             }
             #endif /* configTASKLIST_INCLUDE_COREID == 1 */
 
+            #if ( configUSE_TASK_BUDGETS == 1 )
+            {
+                pxTaskStatus->xBudget = pxTCB->xBudget;
+                pxTaskStatus->xBudgetPeriod = pxTCB->xBudgetPeriod;
+                pxTaskStatus->uxThrottleCount = pxTCB->uxThrottleCount;
+            }
+            #endif /* configUSE_TASK_BUDGETS == 1 */
+
             #if ( configUSE_MUTEXES == 1 )
             {
                 pxTaskStatus->uxBasePriority = pxTCB->uxBasePriority;
@@ -4899,6 +5640,12 @@ static void prvCheckTasksWaitingTermination( void )
          * want to allocate and clean RAM statically. */
         portCLEAN_UP_TCB( pxTCB );
 
+        #if ( configUSE_TASK_DELAY_US == 1 )
+        {
+            prvDeleteDelayUsTimer( pxTCB );
+        }
+        #endif
+
         #if ( ( configUSE_NEWLIB_REENTRANT == 1 ) || ( configUSE_C_RUNTIME_TLS_SUPPORT == 1 ) )
         {
             /* Free up the memory allocated for the task's TLS Block. */
@@ -4907,6 +5654,32 @@ static void prvCheckTasksWaitingTermination( void )
         }
         #endif
 
+        #if ( configUSE_TASK_REAPER == 1 )
+        {
+            /* Give the memory reclaim hook the chance to take back the TCB
+             * and stack (e.g., into a pool) before they are freed.  Only a
+             * task whose TCB and stack would both be freed is offered to the
+             * hook, as any statically allocated memory belongs to the
+             * application. */
+            #if ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 )
+                if( pxTCB->ucStaticallyAllocated == tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB )
+            #endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
+            {
+                /* The task pools have their own hook, so that they do not
+                 * replace the application's. */
+                if( ( pxTaskPoolReclaimHook != NULL ) && ( pxTaskPoolReclaimHook( ( TaskHandle_t ) pxTCB, pxTCB->pxStack ) != pdFALSE ) )
+                {
+                    return;
+                }
+
+                if( ( pxTaskMemoryReclaimHook != NULL ) && ( pxTaskMemoryReclaimHook( ( TaskHandle_t ) pxTCB, pxTCB->pxStack ) != pdFALSE ) )
+                {
+                    return;
+                }
+            }
+        }
+        #endif /* configUSE_TASK_REAPER */
+
         #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( portUSING_MPU_WRAPPERS == 0 ) )
         {
             /* The task can only have been allocated dynamically - free both
@@ -5620,13 +6393,13 @@ static void prvResetNextTaskUnblockTime( void )
                     {
                         #ifdef portLU_PRINTF_SPECIFIER_REQUIRED
                         {
-                            sprintf( pcWriteBuffer, "\t%lu\t\t%lu%%\r\n", pxTaskStatusArray[ x ].ulRunTimeCounter, ulStatsAsPercentage );
+                            sprintf( pcWriteBuffer, "\t%lu\t\t%lu%%", pxTaskStatusArray[ x ].ulRunTimeCounter, ulStatsAsPercentage );
                         }
                         #else
                         {
                             /* sizeof( int ) == sizeof( long ) so a smaller
                              * printf() library can be used. */
-                            sprintf( pcWriteBuffer, "\t%u\t\t%u%%\r\n", ( unsigned int ) pxTaskStatusArray[ x ].ulRunTimeCounter, ( unsigned int ) ulStatsAsPercentage ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+                            sprintf( pcWriteBuffer, "\t%u\t\t%u%%", ( unsigned int ) pxTaskStatusArray[ x ].ulRunTimeCounter, ( unsigned int ) ulStatsAsPercentage ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
                         }
                         #endif
                     }
@@ -5636,18 +6409,39 @@ static void prvResetNextTaskUnblockTime( void )
                          * consumed less than 1% of the total run time. */
                         #ifdef portLU_PRINTF_SPECIFIER_REQUIRED
                         {
-                            sprintf( pcWriteBuffer, "\t%lu\t\t<1%%\r\n", pxTaskStatusArray[ x ].ulRunTimeCounter );
+                            sprintf( pcWriteBuffer, "\t%lu\t\t<1%%", pxTaskStatusArray[ x ].ulRunTimeCounter );
                         }
                         #else
                         {
                             /* sizeof( int ) == sizeof( long ) so a smaller
                              * printf() library can be used. */
-                            sprintf( pcWriteBuffer, "\t%u\t\t<1%%\r\n", ( unsigned int ) pxTaskStatusArray[ x ].ulRunTimeCounter ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+                            sprintf( pcWriteBuffer, "\t%u\t\t<1%%", ( unsigned int ) pxTaskStatusArray[ x ].ulRunTimeCounter ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
                         }
                         #endif
                     }
 
                     pcWriteBuffer += strlen( pcWriteBuffer ); /*lint !e9016 Pointer arithmetic ok on char pointers especially as in this case where it best denotes the intent of the code. */
+
+                    #if ( configUSE_TASK_BUDGETS == 1 )
+                    {
+                        /* Add the CPU budget of the task, as budget/period in
+                         * ticks, and the number of times the task was throttled
+                         * for exhausting it. */
+                        if( pxTaskStatusArray[ x ].xBudgetPeriod > ( TickType_t ) 0 )
+                        {
+                            sprintf( pcWriteBuffer, "\t%u/%u\t%u", ( unsigned int ) pxTaskStatusArray[ x ].xBudget, ( unsigned int ) pxTaskStatusArray[ x ].xBudgetPeriod, ( unsigned int ) pxTaskStatusArray[ x ].uxThrottleCount ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+                        }
+                        else
+                        {
+                            sprintf( pcWriteBuffer, "\t-\t%u", ( unsigned int ) pxTaskStatusArray[ x ].uxThrottleCount ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+                        }
+
+                        pcWriteBuffer += strlen( pcWriteBuffer );
+                    }
+                    #endif /* configUSE_TASK_BUDGETS == 1 */
+
+                    sprintf( pcWriteBuffer, "\r\n" ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+                    pcWriteBuffer += strlen( pcWriteBuffer );
                 }
             }
             else
@@ -6332,10 +7126,81 @@ TickType_t uxTaskResetEventItemValue( void )
 #endif /* if ( ( configGENERATE_RUN_TIME_STATS == 1 ) && ( INCLUDE_xTaskGetIdleTaskHandle == 1 ) ) */
 /*-----------------------------------------------------------*/
 
+static void prvAddTaskToDelayedList( TCB_t * pxTCB,
+                                     TickType_t xTicksToWait,
+                                     TickType_t xConstTickCount )
+{
+    /* Calculate the time at which the task should be woken if the event
+     * does not occur.  This may overflow but this doesn't matter, the kernel
+     * will manage it correctly. */
+    TickType_t xTimeToWake = xConstTickCount + xTicksToWait;
+
+    /* The list item will be inserted in wake time order. */
+    listSET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ), xTimeToWake );
+
+    #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+    {
+        /* A zero block time expires on the next tick, as it does with the
+         * sorted delayed lists. */
+        if( xTimeToWake == xConstTickCount )
+        {
+            xTimeToWake++;
+            listSET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ), xTimeToWake );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* The task is inserted at the end of a wheel slot in O(1), whatever
+         * its delay.  Tasks due within one lap go into the tick slot of their
+         * wake time, and later ones into the lap slot of their wake time, from
+         * which xTaskIncrementTick() moves them at the start of their lap. */
+        if( xTicksToWait < ( TickType_t ) configDELAYED_TASK_WHEEL_SIZE )
+        {
+            listINSERT_END( taskDELAYED_WHEEL_SLOT( xTimeToWake ), &( pxTCB->xStateListItem ) );
+        }
+        else
+        {
+            listINSERT_END( taskDELAYED_WHEEL_LAP_SLOT( xTimeToWake ), &( pxTCB->xStateListItem ) );
+        }
+    }
+    #else /* configUSE_DELAYED_TASK_WHEEL */
+    {
+        if( xTimeToWake < xConstTickCount )
+        {
+            /* Wake time has overflowed.  Place this item in the overflow list. */
+            vListInsert( pxOverflowDelayedTaskList, &( pxTCB->xStateListItem ) );
+        }
+        else
+        {
+            /* The wake time has not overflowed, so the current block list is used. */
+            vListInsert( pxDelayedTaskList, &( pxTCB->xStateListItem ) );
+
+            /* If the task entering the blocked state was placed at the head of the
+             * list of blocked tasks then xNextTaskUnblockTime needs to be updated
+             * too. */
+            if( xTimeToWake < xNextTaskUnblockTime )
+            {
+                xNextTaskUnblockTime = xTimeToWake;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    }
+    #endif /* configUSE_DELAYED_TASK_WHEEL */
+}
+/*-----------------------------------------------------------*/
+
 static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
                                             const BaseType_t xCanBlockIndefinitely )
 {
-    TickType_t xTimeToWake;
+    /* Bring the tick count up to date if ticks are not processed
+     * periodically, as the wake time is relative to it. */
+    portTICKLESS_SYNC_TICK_COUNT();
+
     const TickType_t xConstTickCount = xTickCount;
     /* Get current core ID as we can no longer be preempted. */
     const BaseType_t xCurCoreID = portGET_CORE_ID();
@@ -6387,72 +7252,12 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
         }
         else
         {
-            /* Calculate the time at which the task should be woken if the event
-             * does not occur.  This may overflow but this doesn't matter, the
-             * kernel will manage it correctly. */
-            xTimeToWake = xConstTickCount + xTicksToWait;
-
-            /* The list item will be inserted in wake time order. */
-            listSET_LIST_ITEM_VALUE( &( pxCurrentTCBs[ xCurCoreID ]->xStateListItem ), xTimeToWake );
-
-            if( xTimeToWake < xConstTickCount )
-            {
-                /* Wake time has overflowed.  Place this item in the overflow
-                 * list. */
-                vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCBs[ xCurCoreID ]->xStateListItem ) );
-            }
-            else
-            {
-                /* The wake time has not overflowed, so the current block list
-                 * is used. */
-                vListInsert( pxDelayedTaskList, &( pxCurrentTCBs[ xCurCoreID ]->xStateListItem ) );
-
-                /* If the task entering the blocked state was placed at the
-                 * head of the list of blocked tasks then xNextTaskUnblockTime
-                 * needs to be updated too. */
-                if( xTimeToWake < xNextTaskUnblockTime )
-                {
-                    xNextTaskUnblockTime = xTimeToWake;
-                }
-                else
-                {
-                    mtCOVERAGE_TEST_MARKER();
-                }
-            }
+            prvAddTaskToDelayedList( pxCurrentTCBs[ xCurCoreID ], xTicksToWait, xConstTickCount );
         }
     }
     #else /* INCLUDE_vTaskSuspend */
     {
-        /* Calculate the time at which the task should be woken if the event
-         * does not occur.  This may overflow but this doesn't matter, the kernel
-         * will manage it correctly. */
-        xTimeToWake = xConstTickCount + xTicksToWait;
-
-        /* The list item will be inserted in wake time order. */
-        listSET_LIST_ITEM_VALUE( &( pxCurrentTCBs[ xCurCoreID ]->xStateListItem ), xTimeToWake );
-
-        if( xTimeToWake < xConstTickCount )
-        {
-            /* Wake time has overflowed.  Place this item in the overflow list. */
-            vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCBs[ xCurCoreID ]->xStateListItem ) );
-        }
-        else
-        {
-            /* The wake time has not overflowed, so the current block list is used. */
-            vListInsert( pxDelayedTaskList, &( pxCurrentTCBs[ xCurCoreID ]->xStateListItem ) );
-
-            /* If the task entering the blocked state was placed at the head of the
-             * list of blocked tasks then xNextTaskUnblockTime needs to be updated
-             * too. */
-            if( xTimeToWake < xNextTaskUnblockTime )
-            {
-                xNextTaskUnblockTime = xTimeToWake;
-            }
-            else
-            {
-                mtCOVERAGE_TEST_MARKER();
-            }
-        }
+        prvAddTaskToDelayedList( pxCurrentTCBs[ xCurCoreID ], xTicksToWait, xConstTickCount );
 
         /* Avoid compiler warning when INCLUDE_vTaskSuspend is not 1. */
         ( void ) xCanBlockIndefinitely;
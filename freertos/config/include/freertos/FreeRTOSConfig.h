@@ -86,11 +86,16 @@
 /* ------------------ Scheduler Related -------------------- */
 
 #define configUSE_PREEMPTION 1
+#if CONFIG_FREERTOS_LINUX_VIRTUAL_TIME
+/* The Linux port skips idle time by stepping the tick count */
+#define configUSE_TICKLESS_IDLE 1
+#else
 #define configUSE_TICKLESS_IDLE CONFIG_FREERTOS_USE_TICKLESS_IDLE
-#if configUSE_TICKLESS_IDLE
+#endif /* CONFIG_FREERTOS_LINUX_VIRTUAL_TIME */
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
 #define configEXPECTED_IDLE_TIME_BEFORE_SLEEP                                  \
   CONFIG_FREERTOS_IDLE_TIME_BEFORE_SLEEP
-#endif /* configUSE_TICKLESS_IDLE */
+#endif /* CONFIG_FREERTOS_USE_TICKLESS_IDLE */
 #define configCPU_CLOCK_HZ (CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ * 1000000)
 #define configTICK_RATE_HZ CONFIG_FREERTOS_HZ
 #define configMAX_PRIORITIES (25)
@@ -311,6 +316,37 @@
 #if CONFIG_FREERTOS_CHECK_MUTEX_GIVEN_BY_OWNER
 #define configCHECK_MUTEX_GIVEN_BY_OWNER 1
 #endif /* CONFIG_FREERTOS_CHECK_MUTEX_GIVEN_BY_OWNER */
+#if CONFIG_FREERTOS_USE_DELAYED_TASK_WHEEL
+#define configUSE_DELAYED_TASK_WHEEL 1
+#define configDELAYED_TASK_WHEEL_SIZE CONFIG_FREERTOS_DELAYED_TASK_WHEEL_SIZE
+#endif /* CONFIG_FREERTOS_USE_DELAYED_TASK_WHEEL */
+#if CONFIG_FREERTOS_USE_EDF_SCHEDULING
+#define configUSE_EDF_SCHEDULING 1
+#endif /* CONFIG_FREERTOS_USE_EDF_SCHEDULING */
+#if CONFIG_FREERTOS_USE_TASK_BUDGETS
+#define configUSE_TASK_BUDGETS 1
+#endif /* CONFIG_FREERTOS_USE_TASK_BUDGETS */
+#if CONFIG_FREERTOS_USE_TASK_DELAY_US
+#define configUSE_TASK_DELAY_US 1
+#endif /* CONFIG_FREERTOS_USE_TASK_DELAY_US */
+#if CONFIG_FREERTOS_USE_READY_PRIORITY_BITMAP
+#define configUSE_READY_PRIORITY_BITMAP 1
+#endif /* CONFIG_FREERTOS_USE_READY_PRIORITY_BITMAP */
+#if CONFIG_FREERTOS_USE_TASK_REAPER
+#define configUSE_TASK_REAPER 1
+#define configTASK_REAPER_PRIORITY CONFIG_FREERTOS_TASK_REAPER_PRIORITY
+#define configTASK_REAPER_STACK_SIZE CONFIG_FREERTOS_TASK_REAPER_STACK_SIZE
+#define configTASK_REAPER_BATCH_SIZE CONFIG_FREERTOS_TASK_REAPER_BATCH_SIZE
+#endif /* CONFIG_FREERTOS_USE_TASK_REAPER */
+#if CONFIG_FREERTOS_USE_TICKLESS_KERNEL
+#define configUSE_TICKLESS_KERNEL 1
+#ifndef __ASSEMBLER__
+extern void vPortTicklessSyncTickCount(void);
+extern void vPortTicklessUpdateAlarm(void);
+#endif /* def __ASSEMBLER__ */
+#define portTICKLESS_SYNC_TICK_COUNT() vPortTicklessSyncTickCount()
+#define portTICKLESS_UPDATE_ALARM() vPortTicklessUpdateAlarm()
+#endif /* CONFIG_FREERTOS_USE_TICKLESS_KERNEL */
 #endif /* !CONFIG_FREERTOS_SMP */
 
 /* ------------------------------------------------ ESP-IDF Additions
@@ -7,7 +7,7 @@ char *getAndIncrementCurrentQueueMessageBuffer();
 
 #define traceQUEUE_RECEIVE(xQueue)                                             \
   {                                                                            \
-    typedef struct QueueTraceData {                                            \
+    typedef struct __attribute__((__packed__)) QueueTraceData {                \
       UBaseType_t messageType;                                                 \
       TickType_t c_time;                                                       \
       uint32_t timeStamp;                                                      \
@@ -36,7 +36,7 @@ char *getAndIncrementCurrentQueueMessageBuffer();
 
 #define traceQUEUE_RECEIVE_FAILED(xQueue)                                      \
   {                                                                            \
-    typedef struct QueueTraceData {                                            \
+    typedef struct __attribute__((__packed__)) QueueTraceData {                \
       UBaseType_t messageType;                                                 \
       TickType_t c_time;                                                       \
       uint32_t timeStamp;                                                      \
@@ -65,7 +65,7 @@ char *getAndIncrementCurrentQueueMessageBuffer();
 
 #define traceQUEUE_RECEIVE_FROM_ISR(xQueue)                                    \
   {                                                                            \
-    typedef struct QueueTraceData {                                            \
+    typedef struct __attribute__((__packed__)) QueueTraceData {                \
       UBaseType_t messageType;                                                 \
       TickType_t c_time;                                                       \
       uint32_t timeStamp;                                                      \
@@ -94,7 +94,7 @@ char *getAndIncrementCurrentQueueMessageBuffer();
 
 #define traceQUEUE_RECEIVE_FROM_ISR_FAILED(xQueue)                             \
   {                                                                            \
-    typedef struct QueueTraceData {                                            \
+    typedef struct __attribute__((__packed__)) QueueTraceData {                \
       UBaseType_t messageType;                                                 \
       TickType_t c_time;                                                       \
       uint32_t timeStamp;                                                      \
@@ -123,7 +123,7 @@ char *getAndIncrementCurrentQueueMessageBuffer();
 
 #define traceQUEUE_SEND(xQueue)                                                \
   {                                                                            \
-    typedef struct QueueTraceData {                                            \
+    typedef struct __attribute__((__packed__)) QueueTraceData {                \
       UBaseType_t messageType;                                                 \
       TickType_t c_time;                                                       \
       uint32_t timeStamp;                                                      \
@@ -152,7 +152,7 @@ char *getAndIncrementCurrentQueueMessageBuffer();
 
 #define traceQUEUE_SET_SEND(xQueue)                                            \
   {                                                                            \
-    typedef struct QueueTraceData {                                            \
+    typedef struct __attribute__((__packed__)) QueueTraceData {                \
       UBaseType_t messageType;                                                 \
       TickType_t c_time;                                                       \
       uint32_t timeStamp;                                                      \
@@ -181,7 +181,7 @@ char *getAndIncrementCurrentQueueMessageBuffer();
 
 #define traceQUEUE_SEND_FAILED(xQueue)                                         \
   {                                                                            \
-    typedef struct QueueTraceData {                                            \
+    typedef struct __attribute__((__packed__)) QueueTraceData {                \
       UBaseType_t messageType;                                                 \
       TickType_t c_time;                                                       \
       uint32_t timeStamp;                                                      \
@@ -210,7 +210,7 @@ char *getAndIncrementCurrentQueueMessageBuffer();
 
 #define traceQUEUE_SEND_FROM_ISR(xQueue)                                       \
   {                                                                            \
-    typedef struct QueueTraceData {                                            \
+    typedef struct __attribute__((__packed__)) QueueTraceData {                \
       UBaseType_t messageType;                                                 \
       TickType_t c_time;                                                       \
       uint32_t timeStamp;                                                      \
@@ -239,7 +239,7 @@ char *getAndIncrementCurrentQueueMessageBuffer();
 
 #define traceQUEUE_SEND_FROM_ISR_FAILED(xQueue)                                \
   {                                                                            \
-    typedef struct QueueTraceData {                                            \
+    typedef struct __attribute__((__packed__)) QueueTraceData {                \
       UBaseType_t messageType;                                                 \
       TickType_t c_time;                                                       \
       uint32_t timeStamp;                                                      \
@@ -25,8 +25,10 @@
  * The rest is for additional structures of the POSIX/Linux port.
  * This is a magic number since PTHREAD_STACK_MIN seems to not be a constant. */
 #define configMINIMAL_STACK_SIZE                   ( ( StackType_t ) ( 0x4000 + 40 ) / sizeof( StackType_t ) )
-/* Currently not used in Linux POSIX simulator */
-#define configMAX_API_CALL_INTERRUPT_PRIORITY      0
+/* Simulated interrupts (see xPortAllocateSimulatedInterrupt()) above this priority are not masked by critical
+ * sections, and must not call FreeRTOS functions. Matches XCHAL_EXCM_LEVEL of the Xtensa chips. */
+#define configMAX_API_CALL_INTERRUPT_PRIORITY      3
+#define configMAX_SYSCALL_INTERRUPT_PRIORITY       configMAX_API_CALL_INTERRUPT_PRIORITY
 
 /* ---------------- Amazon SMP FreeRTOS -------------------- */
 
@@ -17,6 +17,546 @@
  */
 typedef int (*select_func_t)(int fd, fd_set *rfds, fd_set *wfds, fd_set *efds, struct timeval *tval);
 
+#if CONFIG_FREERTOS_LINUX_IO_BRIDGE && defined(__linux__)
+
+#include <stdbool.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <freertos/semphr.h>
+
+/**
+ * With the I/O bridge, select, poll, epoll_wait, read, recv and nanosleep park the calling task on a FreeRTOS
+ * semaphore instead, so that it is not scheduled until the host I/O it waits for is ready (or the timeout expires):
+ *
+ * - The fds the task waits for are registered in an epoll instance of its own, which is itself registered (one-shot)
+ *   in the epoll instance of the bridge thread. The bridge thread is a host thread, blocked in epoll_wait.
+ * - When one of the fds becomes ready, the bridge thread flags the waiter and triggers a simulated interrupt, whose
+ *   ISR gives the semaphore of each flagged waiter.
+ * - The woken task then makes the real call with a zero timeout, and waits again if the fds were not ready after all.
+ *
+ * Calls from host threads that are not FreeRTOS tasks, from the idle task, from ISRs or critical sections, or while the
+ * scheduler is not running or suspended are not affected, as the task must not block there. Socket timeouts (e.g.,
+ * SO_RCVTIMEO) are not honored by the wrapped read and recv.
+ *
+ * read and recv only park the task until the fd is readable, then make the real call. If another task (or host thread)
+ * drains the fd in between, the real call still blocks, keeping lower priority tasks from running until data arrives.
+ *
+ * nanosleep delays the task for the whole ticks of the request, and sleeps the rest on the host clock. Where the task
+ * must not block, it sleeps the whole request on the host clock, without being cut short by the simulator's signals.
+ */
+#define IO_BRIDGE_MAX_WAITERS       32      // Tasks waiting for host I/O at the same time, one bit of s_pending each
+#define IO_BRIDGE_MAX_EVENTS        16
+#define IO_BRIDGE_MAX_POLL_TICKS    10      // Polling period if a task cannot wait for host I/O on the bridge
+
+/* The state word of a waiter holds its generation, so that events of a previous wait are ignored */
+#define WAITER_FREE                 0
+#define WAITER_WAITING              1       // Waiting for one of its fds
+#define WAITER_QUEUED               2       // Its semaphore is about to be given by the ISR
+#define WAITER_CANCELLED            3       // Timed out, being freed
+#define WAITER_STATE_MASK           3
+#define WAITER_NEXT_GENERATION      4
+
+typedef struct {
+    SemaphoreHandle_t sem;
+    StaticSemaphore_t sem_buffer;
+    uint32_t state;
+} io_waiter_t;
+
+typedef struct {
+    int index;          // Index of the waiter in s_waiters
+    uint32_t state;     // State word of the waiter while waiting
+    int epfd;           // Epoll instance of the fds to wait for
+} io_wait_t;
+
+typedef int (*poll_func_t)(struct pollfd *fds, nfds_t nfds, int timeout);
+typedef int (*epoll_wait_func_t)(int epfd, struct epoll_event *events, int maxevents, int timeout);
+typedef ssize_t (*read_func_t)(int fd, void *buf, size_t count);
+typedef ssize_t (*recv_func_t)(int sockfd, void *buf, size_t len, int flags);
+typedef int (*nanosleep_func_t)(const struct timespec *req, struct timespec *rem);
+
+/* Makes the real call with a zero timeout. Returns 0 if nothing is ready yet */
+typedef int (*try_func_t)(void *ctx);
+/* Adds the fds the call waits for to the wait */
+typedef bool (*add_fds_func_t)(io_wait_t *wait, void *ctx);
+
+static select_func_t s_real_select = NULL;
+static poll_func_t s_real_poll = NULL;
+static epoll_wait_func_t s_real_epoll_wait = NULL;
+static read_func_t s_real_read = NULL;
+static recv_func_t s_real_recv = NULL;
+static nanosleep_func_t s_real_nanosleep = NULL;
+
+static pthread_once_t s_bridge_once = PTHREAD_ONCE_INIT;
+static bool s_bridge_started = false;
+static int s_bridge_epfd = -1;
+static BaseType_t s_bridge_interrupt = -1;
+static uint32_t s_pending = 0;      // Waiters flagged by the bridge thread, one bit each
+static io_waiter_t s_waiters[IO_BRIDGE_MAX_WAITERS];
+
+static void *lookup_real(void **real, const char *name)
+{
+    // Lookup the real symbol on first use
+    if (*real == NULL) {
+        *real = dlsym(RTLD_NEXT, name);
+        assert(*real);  // abort() if we cannot locate the symbol
+    }
+    return *real;
+}
+
+#define REAL_FUNC(name) ((name##_func_t)lookup_real((void **)&s_real_##name, #name))
+
+static void *io_bridge_thread(void *arg)
+{
+    struct epoll_event events[IO_BRIDGE_MAX_EVENTS];
+
+    while (1) {
+        int count = REAL_FUNC(epoll_wait)(s_bridge_epfd, events, IO_BRIDGE_MAX_EVENTS, -1);
+        bool trigger = false;
+
+        for (int i = 0; i < count; i++) {
+            int index = (int)(events[i].data.u64 & 0xFFFFFFFF);
+            uint32_t expected = (uint32_t)(events[i].data.u64 >> 32);
+            uint32_t queued = (expected & ~WAITER_STATE_MASK) | WAITER_QUEUED;
+
+            // Fails if the waiter has timed out in the meantime, or was woken already
+            if (__atomic_compare_exchange_n(&s_waiters[index].state, &expected, queued, false,
+                                            __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+                __atomic_or_fetch(&s_pending, 1UL << index, __ATOMIC_SEQ_CST);
+                trigger = true;
+            }
+        }
+
+        if (trigger) {
+            vPortTriggerSimulatedInterrupt(s_bridge_interrupt);
+        }
+    }
+
+    return NULL;
+}
+
+static BaseType_t io_bridge_isr(void *arg)
+{
+    uint32_t pending = __atomic_exchange_n(&s_pending, 0, __ATOMIC_SEQ_CST);
+    BaseType_t higher_prio_task_woken = pdFALSE;
+
+    while (pending != 0) {
+        int index = __builtin_ctz(pending);
+
+        pending &= pending - 1;
+        xSemaphoreGiveFromISR(s_waiters[index].sem, &higher_prio_task_woken);
+    }
+
+    return higher_prio_task_woken;
+}
+
+static void io_bridge_start(void)
+{
+    sigset_t all_signals;
+    sigset_t old_mask;
+    pthread_t thread;
+
+    for (int i = 0; i < IO_BRIDGE_MAX_WAITERS; i++) {
+        s_waiters[i].sem = xSemaphoreCreateBinaryStatic(&s_waiters[i].sem_buffer);
+    }
+
+    s_bridge_epfd = epoll_create1(EPOLL_CLOEXEC);
+    // Lowest priority, as the UART and network interrupts of the chips
+    s_bridge_interrupt = xPortAllocateSimulatedInterrupt(1, io_bridge_isr, NULL);
+    if (s_bridge_epfd == -1 || s_bridge_interrupt == -1) {
+        return;
+    }
+
+    // The bridge thread must never handle the simulator's signals (interrupts), which are meant for task threads
+    sigfillset(&all_signals);
+    pthread_sigmask(SIG_BLOCK, &all_signals, &old_mask);
+    s_bridge_started = (pthread_create(&thread, NULL, io_bridge_thread, NULL) == 0);
+    pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+}
+
+/* Whether the calling task can be parked on the bridge while waiting for host I/O */
+static bool io_bridge_usable(void)
+{
+    if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING || xPortIsTaskThread() == pdFALSE) {
+        return false;
+    }
+    // Blocking is not allowed in an ISR or a critical section
+    if (uxPortGetInterruptLevel() != 0) {
+        return false;
+    }
+    // The idle task must never block
+    if (xTaskGetCurrentTaskHandle() == xTaskGetIdleTaskHandle()) {
+        return false;
+    }
+
+    pthread_once(&s_bridge_once, io_bridge_start);
+    return s_bridge_started;
+}
+
+static bool io_wait_begin(io_wait_t *wait)
+{
+    for (int i = 0; i < IO_BRIDGE_MAX_WAITERS; i++) {
+        uint32_t state = __atomic_load_n(&s_waiters[i].state, __ATOMIC_SEQ_CST);
+        uint32_t waiting = (state & ~WAITER_STATE_MASK) | WAITER_WAITING;
+
+        if ((state & WAITER_STATE_MASK) == WAITER_FREE &&
+                __atomic_compare_exchange_n(&s_waiters[i].state, &state, waiting, false,
+                                            __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+            wait->epfd = epoll_create1(EPOLL_CLOEXEC);
+            wait->index = i;
+            wait->state = waiting;
+            if (wait->epfd == -1) {
+                __atomic_store_n(&s_waiters[i].state, state, __ATOMIC_SEQ_CST);
+                return false;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool io_wait_add(io_wait_t *wait, int fd, uint32_t events)
+{
+    struct epoll_event event = {
+        .events = events,
+        .data.fd = fd,
+    };
+
+    return epoll_ctl(wait->epfd, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+static void io_wait_end(io_wait_t *wait)
+{
+    // Closing the epoll instance also removes it from the one of the bridge thread
+    close(wait->epfd);
+    __atomic_store_n(&s_waiters[wait->index].state,
+                     (wait->state & ~WAITER_STATE_MASK) + WAITER_NEXT_GENERATION, __ATOMIC_SEQ_CST);
+}
+
+/*
+ * Parks the calling task until one of the fds of the wait is ready, or the timeout expires.
+ * Returns false if the wait could not be handed to the bridge thread.
+ */
+static bool io_wait(io_wait_t *wait, TickType_t ticks)
+{
+    io_waiter_t *waiter = &s_waiters[wait->index];
+    struct epoll_event event = {
+        .events = EPOLLIN | EPOLLONESHOT,
+        .data.u64 = ((uint64_t)wait->state << 32) | (uint32_t)wait->index,
+    };
+
+    if (epoll_ctl(s_bridge_epfd, EPOLL_CTL_ADD, wait->epfd, &event) != 0) {
+        io_wait_end(wait);
+        return false;
+    }
+
+    if (xSemaphoreTake(waiter->sem, ticks) != pdTRUE) {
+        uint32_t expected = wait->state;
+        uint32_t cancelled = (wait->state & ~WAITER_STATE_MASK) | WAITER_CANCELLED;
+
+        // Timed out, unless the bridge thread has just queued the waiter. Its semaphore must then be taken before
+        // the waiter is reused.
+        if (!__atomic_compare_exchange_n(&waiter->state, &expected, cancelled, false,
+                                         __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+            xSemaphoreTake(waiter->sem, portMAX_DELAY);
+        }
+    }
+
+    io_wait_end(wait);
+    return true;
+}
+
+/* Converts a timeout to ticks, rounding up so that the call never returns early */
+static TickType_t timeout_to_ticks(int64_t timeout_us)
+{
+    const int64_t tick_us = 1000000 / configTICK_RATE_HZ;
+
+    if (timeout_us < 0) {
+        return portMAX_DELAY;
+    }
+    if (timeout_us / tick_us >= portMAX_DELAY - 1) {
+        return portMAX_DELAY - 1;
+    }
+    return (TickType_t)((timeout_us + tick_us - 1) / tick_us);
+}
+
+/*
+ * Makes the real call with a zero timeout until it reports something, parking the task on the bridge in between.
+ * Returns the result of the last call, i.e., 0 if the timeout expired.
+ */
+static int io_wait_until_ready(try_func_t try_call, add_fds_func_t add_fds, void *ctx, TickType_t ticks)
+{
+    TimeOut_t timeout;
+    io_wait_t wait;
+
+    vTaskSetTimeOutState(&timeout);
+
+    while (1) {
+        int ret = try_call(ctx);
+
+        // Return on success, and on any error except EINTR
+        if (ret > 0 || (ret == -1 && errno != EINTR)) {
+            return ret;
+        }
+        if (ticks == 0 || xTaskCheckForTimeOut(&timeout, &ticks) != pdFALSE) {
+            errno = 0;
+            return 0;
+        }
+
+        bool waited = false;
+
+        // Some fds cannot be waited for with epoll (e.g., regular files, which are always ready)
+        if (io_wait_begin(&wait)) {
+            if (add_fds(&wait, ctx)) {
+                waited = io_wait(&wait, ticks);
+            } else {
+                io_wait_end(&wait);
+            }
+        }
+
+        if (!waited) {
+            // Poll instead, e.g., if all waiters are busy
+            vTaskDelay(ticks < IO_BRIDGE_MAX_POLL_TICKS ? ticks : IO_BRIDGE_MAX_POLL_TICKS);
+        }
+    }
+}
+
+typedef struct {
+    int nfds;
+    fd_set *rfds, *wfds, *efds;
+    fd_set o_rfds, o_wfds, o_efds;
+} select_ctx_t;
+
+static int try_select(void *ctx)
+{
+    select_ctx_t *sel = ctx;
+    struct timeval zero_tv = {0, 0};
+
+    // Restore original FD sets before the select call, as it changes them
+    if (sel->rfds) {
+        *sel->rfds = sel->o_rfds;
+    }
+    if (sel->wfds) {
+        *sel->wfds = sel->o_wfds;
+    }
+    if (sel->efds) {
+        *sel->efds = sel->o_efds;
+    }
+
+    return REAL_FUNC(select)(sel->nfds, sel->rfds, sel->wfds, sel->efds, &zero_tv);
+}
+
+static bool add_select_fds(io_wait_t *wait, void *ctx)
+{
+    select_ctx_t *sel = ctx;
+
+    for (int fd = 0; fd < sel->nfds; fd++) {
+        uint32_t events = 0;
+
+        if (sel->rfds && FD_ISSET(fd, &sel->o_rfds)) {
+            events |= EPOLLIN;
+        }
+        if (sel->wfds && FD_ISSET(fd, &sel->o_wfds)) {
+            events |= EPOLLOUT;
+        }
+        if (sel->efds && FD_ISSET(fd, &sel->o_efds)) {
+            events |= EPOLLPRI;
+        }
+        if (events != 0 && !io_wait_add(wait, fd, events)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int select(int fd, fd_set *rfds, fd_set *wfds, fd_set *efds, struct timeval *tval)
+{
+    select_ctx_t sel = {
+        .nfds = fd,
+        .rfds = rfds,
+        .wfds = wfds,
+        .efds = efds,
+    };
+
+    if (!io_bridge_usable()) {
+        return REAL_FUNC(select)(fd, rfds, wfds, efds, tval);
+    }
+
+    // Preserve the original FD sets as select call will change them
+    if (rfds) {
+        sel.o_rfds = *rfds;
+    }
+    if (wfds) {
+        sel.o_wfds = *wfds;
+    }
+    if (efds) {
+        sel.o_efds = *efds;
+    }
+
+    return io_wait_until_ready(try_select, add_select_fds, &sel,
+                               tval ? timeout_to_ticks(tval->tv_sec * 1000000LL + tval->tv_usec) : portMAX_DELAY);
+}
+
+typedef struct {
+    struct pollfd *fds;
+    nfds_t nfds;
+} poll_ctx_t;
+
+static int try_poll(void *ctx)
+{
+    poll_ctx_t *pol = ctx;
+
+    return REAL_FUNC(poll)(pol->fds, pol->nfds, 0);
+}
+
+static bool add_poll_fds(io_wait_t *wait, void *ctx)
+{
+    poll_ctx_t *pol = ctx;
+
+    for (nfds_t i = 0; i < pol->nfds; i++) {
+        // poll() ignores negative fds, and always reports POLLERR and POLLHUP
+        if (pol->fds[i].fd >= 0 && !io_wait_add(wait, pol->fds[i].fd, (uint32_t)pol->fds[i].events)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int poll(struct pollfd *fds, nfds_t nfds, int timeout)
+{
+    poll_ctx_t pol = {
+        .fds = fds,
+        .nfds = nfds,
+    };
+
+    if (!io_bridge_usable()) {
+        return REAL_FUNC(poll)(fds, nfds, timeout);
+    }
+
+    return io_wait_until_ready(try_poll, add_poll_fds, &pol, timeout_to_ticks(timeout * 1000LL));
+}
+
+typedef struct {
+    int epfd;
+    struct epoll_event *events;
+    int maxevents;
+} epoll_ctx_t;
+
+static int try_epoll_wait(void *ctx)
+{
+    epoll_ctx_t *ep = ctx;
+
+    return REAL_FUNC(epoll_wait)(ep->epfd, ep->events, ep->maxevents, 0);
+}
+
+static bool add_epoll_fd(io_wait_t *wait, void *ctx)
+{
+    epoll_ctx_t *ep = ctx;
+
+    // An epoll instance is readable when one of its fds is ready
+    return io_wait_add(wait, ep->epfd, EPOLLIN);
+}
+
+int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout)
+{
+    epoll_ctx_t ep = {
+        .epfd = epfd,
+        .events = events,
+        .maxevents = maxevents,
+    };
+
+    if (!io_bridge_usable()) {
+        return REAL_FUNC(epoll_wait)(epfd, events, maxevents, timeout);
+    }
+
+    return io_wait_until_ready(try_epoll_wait, add_epoll_fd, &ep, timeout_to_ticks(timeout * 1000LL));
+}
+
+/* Parks the calling task until the fd is readable, unless it is a non-blocking fd */
+static void wait_readable(int fd)
+{
+    struct pollfd pfd = {
+        .fd = fd,
+        .events = POLLIN,
+    };
+    poll_ctx_t pol = {
+        .fds = &pfd,
+        .nfds = 1,
+    };
+
+    // Readable already, or an error for the real call to report
+    if (try_poll(&pol) != 0) {
+        return;
+    }
+
+    int flags = fcntl(fd, F_GETFL);
+    if (flags == -1 || (flags & O_NONBLOCK)) {
+        return;
+    }
+
+    io_wait_until_ready(try_poll, add_poll_fds, &pol, portMAX_DELAY);
+}
+
+ssize_t read(int fd, void *buf, size_t count)
+{
+    if (io_bridge_usable()) {
+        wait_readable(fd);
+    }
+
+    return REAL_FUNC(read)(fd, buf, count);
+}
+
+ssize_t recv(int sockfd, void *buf, size_t len, int flags)
+{
+    if (!(flags & MSG_DONTWAIT) && io_bridge_usable()) {
+        wait_readable(sockfd);
+    }
+
+    return REAL_FUNC(recv)(sockfd, buf, len, flags);
+}
+
+int nanosleep(const struct timespec *req, struct timespec *rem)
+{
+    const int64_t tick_ns = 1000000000LL / configTICK_RATE_HZ;
+    struct timespec deadline;
+
+    // Only task threads get the simulator's signals. The real call also reports invalid arguments.
+    if (xPortIsTaskThread() == pdFALSE || req->tv_nsec < 0 || req->tv_nsec >= 1000000000L || req->tv_sec < 0) {
+        return REAL_FUNC(nanosleep)(req, rem);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += req->tv_sec;
+    deadline.tv_nsec += req->tv_nsec;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    // Let other tasks run for the whole ticks of the request. As a delay of n ticks can end anywhere in the n-th tick
+    // period, one tick less is delayed so that the call never returns late.
+    int64_t ticks = (req->tv_sec * 1000000000LL + req->tv_nsec) / tick_ns;
+    if (ticks > 1 && io_bridge_usable()) {
+        vTaskDelay(ticks - 1 < portMAX_DELAY - 1 ? (TickType_t)(ticks - 1) : portMAX_DELAY - 1);
+    }
+
+    // Sleep the rest (or all of it if the task must not block) on the host clock. The simulator's signals interrupt
+    // the sleep, but the request is never cut short, so rem is left untouched as by an uninterrupted nanosleep.
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) {
+    }
+    return 0;
+}
+
+#else
+
 int select(int fd, fd_set *rfds, fd_set *wfds, fd_set *efds, struct timeval *tval)
 {
     static select_func_t s_real_select = NULL;
@@ -93,3 +633,5 @@ int select(int fd, fd_set *rfds, fd_set *wfds, fd_set *efds, struct timeval *tva
         vTaskDelay(sleep_ticks);
     }
 }
+
+#endif /* CONFIG_FREERTOS_LINUX_IO_BRIDGE && defined(__linux__) */
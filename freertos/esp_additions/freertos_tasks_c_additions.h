@@ -13,6 +13,10 @@
     #include "esp_private/freertos_debug.h"
 #endif /* CONFIG_FREERTOS_ENABLE_TASK_SNAPSHOT */
 #include "esp_private/freertos_idf_additions_priv.h"
+#if ( !CONFIG_FREERTOS_SMP && ( configUSE_TASK_DELAY_US == 1 ) )
+    #include "esp_attr.h"
+    #include "esp_timer.h"
+#endif /* ( !CONFIG_FREERTOS_SMP && ( configUSE_TASK_DELAY_US == 1 ) ) */
 
 /**
  * This file will be included in `tasks.c` file, thus, it is treated as a source
@@ -30,8 +34,14 @@
  */
 _Static_assert( offsetof( StaticTask_t, pxDummy6 ) == offsetof( TCB_t, pxStack ) );
 _Static_assert( offsetof( StaticTask_t, pxDummy8 ) == offsetof( TCB_t, pxEndOfStack ) );
+_Static_assert( offsetof( StaticTask_t, ucDummy7 ) == offsetof( TCB_t, pcTaskName ) );
+#if CONFIG_FREERTOS_DEBUG_OCDAWARE
+/* The task name offset is reported to OpenOCD in a uint8_t, see FreeRTOS_openocd_params */
+_Static_assert( offsetof( TCB_t, pcTaskName ) <= UINT8_MAX, "pcTaskName must be within the first 256 bytes of TCB_t" );
+#endif /* CONFIG_FREERTOS_DEBUG_OCDAWARE */
 #if !CONFIG_IDF_TARGET_LINUX    // Disabled for linux builds due to differences in types
 _Static_assert( tskNO_AFFINITY == ( BaseType_t ) CONFIG_FREERTOS_NO_AFFINITY, "CONFIG_FREERTOS_NO_AFFINITY must be the same as tskNO_AFFINITY" );
+_Static_assert( sizeof( StaticTask_t ) == sizeof( TCB_t ) );
 #endif
 
 /* ------------------------------------------------- Kernel Control ------------------------------------------------- */
@@ -116,6 +126,23 @@ _Static_assert( tskNO_AFFINITY == ( BaseType_t ) CONFIG_FREERTOS_NO_AFFINITY, "C
             }
             #endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) ) */
 
+            #if ( configUSE_TASK_BUDGETS == 1 )
+            {
+                /* Charge the tick to the budget of the task that was running,
+                 * which is throttled if it has exhausted its budget. */
+                prvChargeTaskBudget( pxCurrentTCBs[ xCoreID ], xTickCount - ( TickType_t ) 1 );
+
+                if( prvThrottleTaskIfExhausted( xCoreID ) != pdFALSE )
+                {
+                    xSwitchRequired = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configUSE_TASK_BUDGETS */
+
             /* Release the previously taken kernel lock as we have finished
              * accessing the kernel data structures. */
             taskEXIT_CRITICAL_ISR( &xKernelLock );
@@ -134,6 +161,18 @@ _Static_assert( tskNO_AFFINITY == ( BaseType_t ) CONFIG_FREERTOS_NO_AFFINITY, "C
             #endif /* configUSE_PREEMPTION */
         }
 
+        #if ( configUSE_TASK_BUDGETS == 1 )
+            else
+            {
+                /* The task that suspended the scheduler on this core keeps
+                 * running, so the tick is still charged to it. It can only be
+                 * throttled once the scheduler is resumed. */
+                taskENTER_CRITICAL_ISR( &xKernelLock );
+                prvChargeTaskBudget( pxCurrentTCBs[ xCoreID ], xTickCount - ( TickType_t ) 1 );
+                taskEXIT_CRITICAL_ISR( &xKernelLock );
+            }
+        #endif /* configUSE_TASK_BUDGETS */
+
         #if ( configUSE_TICK_HOOK == 1 )
         {
             vApplicationTickHook();
@@ -146,6 +185,128 @@ _Static_assert( tskNO_AFFINITY == ( BaseType_t ) CONFIG_FREERTOS_NO_AFFINITY, "C
 #endif /* ( !CONFIG_FREERTOS_SMP && ( configNUM_CORES > 1 ) ) */
 /*----------------------------------------------------------*/
 
+#if ( !CONFIG_FREERTOS_SMP && ( configUSE_TICKLESS_KERNEL == 1 ) )
+
+    TickType_t xTaskGetTicksToNextEvent( void )
+    {
+        TickType_t xTicks = 1;
+
+        portENTER_CRITICAL_SAFE( &xKernelLock );
+        {
+            /* Ticks that are pended, or tasks of the running priority that
+             * need to be time sliced, require the very next tick. Otherwise,
+             * nothing needs to be done before the next task unblocks. */
+            if( ( xSchedulerRunning != pdFALSE ) && ( xPendedTicks == ( TickType_t ) 0U ) )
+            {
+                #if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
+                    if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCBs[ 0 ]->uxPriority ] ) ) <= ( UBaseType_t ) 1 )
+                #endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) ) */
+                {
+                    /* xNextTaskUnblockTime never lies beyond the tick count
+                     * overflow, as the delayed lists are swapped on overflow. */
+                    if( xNextTaskUnblockTime > xTickCount )
+                    {
+                        xTicks = xNextTaskUnblockTime - xTickCount;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        portEXIT_CRITICAL_SAFE( &xKernelLock );
+
+        return xTicks;
+    }
+
+#endif /* ( !CONFIG_FREERTOS_SMP && ( configUSE_TICKLESS_KERNEL == 1 ) ) */
+/*----------------------------------------------------------*/
+
+#if ( !CONFIG_FREERTOS_SMP && ( configUSE_TICKLESS_KERNEL == 1 ) )
+
+    TickType_t xTaskSkipTicks( TickType_t xTicksToSkip )
+    {
+        TickType_t xTicksToNextEvent;
+
+        portENTER_CRITICAL_SAFE( &xKernelLock );
+        {
+            /* Only the ticks strictly before the next event can be skipped,
+             * as the kernel has work to do on the tick of the event itself.
+             * This also guarantees that the tick count does not overflow. */
+            xTicksToNextEvent = xTaskGetTicksToNextEvent();
+
+            if( xTicksToSkip >= xTicksToNextEvent )
+            {
+                xTicksToSkip = xTicksToNextEvent - ( TickType_t ) 1;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( xTicksToSkip > ( TickType_t ) 0U )
+            {
+                xTickCount += xTicksToSkip;
+                traceINCREASE_TICK_COUNT( xTicksToSkip );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        portEXIT_CRITICAL_SAFE( &xKernelLock );
+
+        return xTicksToSkip;
+    }
+
+#endif /* ( !CONFIG_FREERTOS_SMP && ( configUSE_TICKLESS_KERNEL == 1 ) ) */
+/*----------------------------------------------------------*/
+
+#if ( !CONFIG_FREERTOS_SMP && ( configUSE_TICKLESS_KERNEL == 1 ) )
+
+    BaseType_t xTaskIncrementTicks( TickType_t xTicksToIncrement )
+    {
+        BaseType_t xSwitchRequired = pdFALSE;
+
+        /* Called by the portable layer from the tick interrupt with interrupts
+         * disabled, after xTicksToIncrement ticks have elapsed. */
+        if( uxSchedulerSuspended[ 0 ] != ( UBaseType_t ) 0U )
+        {
+            /* The pended ticks are processed by xTaskResumeAll(). */
+            xPendedTicks += xTicksToIncrement;
+        }
+        else
+        {
+            while( xTicksToIncrement > ( TickType_t ) 0U )
+            {
+                /* Skip the ticks on which the kernel has nothing to do, then
+                 * process the next one normally. */
+                xTicksToIncrement -= xTaskSkipTicks( xTicksToIncrement - ( TickType_t ) 1 );
+
+                if( xTaskIncrementTick() != pdFALSE )
+                {
+                    xSwitchRequired = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                xTicksToIncrement--;
+            }
+        }
+
+        return xSwitchRequired;
+    }
+
+#endif /* ( !CONFIG_FREERTOS_SMP && ( configUSE_TICKLESS_KERNEL == 1 ) ) */
+/*----------------------------------------------------------*/
+
 /* -------------------------------------------------- Task Creation ------------------------------------------------- */
 
 #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
@@ -559,6 +720,537 @@ uint8_t * pxTaskGetStackStart( TaskHandle_t xTask )
 }
 /*----------------------------------------------------------*/
 
+#if ( ( !CONFIG_FREERTOS_SMP ) && ( configUSE_EDF_SCHEDULING == 1 ) )
+
+    static void prvSetAbsoluteDeadline( TCB_t * pxTCB,
+                                        BaseType_t xHasDeadline,
+                                        TickType_t xAbsoluteDeadline )
+    {
+        /* Must be called from a critical section. */
+        pxTCB->ucHasDeadline = ( uint8_t ) xHasDeadline;
+        pxTCB->xAbsoluteDeadline = xAbsoluteDeadline;
+
+        /* If the task is ready, move it to its new position in the ready list.
+         * The list does not become empty as the task is inserted again right
+         * away, so the ready priority does not need to be reset. */
+        if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
+        {
+            listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+            taskREADY_LIST_INSERT( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), pxTCB );
+        }
+    }
+/*----------------------------------------------------------*/
+
+    void vTaskSetDeadline( TaskHandle_t xTask,
+                           TickType_t xPeriod,
+                           TickType_t xRelativeDeadline )
+    {
+        TCB_t * pxTCB;
+
+        configASSERT( ( xPeriod == 0 ) || ( xRelativeDeadline > 0 ) );
+
+        taskENTER_CRITICAL( &xKernelLock );
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+            pxTCB->xPeriod = xPeriod;
+            pxTCB->xRelativeDeadline = xRelativeDeadline;
+            pxTCB->xLastReleaseTime = xTickCount;
+            pxTCB->uxDeadlineMisses = 0;
+
+            if( xPeriod > 0 )
+            {
+                prvSetAbsoluteDeadline( pxTCB, pdTRUE, xTickCount + xRelativeDeadline );
+            }
+            else
+            {
+                /* The task is placed after all tasks with a deadline. */
+                prvSetAbsoluteDeadline( pxTCB, pdFALSE, 0 );
+            }
+        }
+        taskEXIT_CRITICAL( &xKernelLock );
+    }
+/*----------------------------------------------------------*/
+
+    BaseType_t xTaskWaitForNextPeriod( void )
+    {
+        TCB_t * pxTCB;
+        BaseType_t xDeadlineMet;
+
+        taskENTER_CRITICAL( &xKernelLock );
+        {
+            pxTCB = prvGetTCBFromHandle( NULL );
+            configASSERT( pxTCB->xPeriod > 0 );
+
+            /* Compare the time elapsed since the release, so that tick count
+             * overflows are handled. */
+            if( ( TickType_t ) ( xTickCount - pxTCB->xLastReleaseTime ) <= pxTCB->xRelativeDeadline )
+            {
+                xDeadlineMet = pdTRUE;
+            }
+            else
+            {
+                xDeadlineMet = pdFALSE;
+                pxTCB->uxDeadlineMisses++;
+            }
+
+            /* Set the deadline of the next job before blocking, so that the task
+             * is placed correctly in the ready list when it is released. */
+            prvSetAbsoluteDeadline( pxTCB, pdTRUE, pxTCB->xLastReleaseTime + pxTCB->xPeriod + pxTCB->xRelativeDeadline );
+        }
+        taskEXIT_CRITICAL( &xKernelLock );
+
+        /* Only the task itself updates its release time once its deadline is
+         * set, so it can be passed to xTaskDelayUntil() directly. */
+        ( void ) xTaskDelayUntil( &( pxTCB->xLastReleaseTime ), pxTCB->xPeriod );
+
+        return xDeadlineMet;
+    }
+/*----------------------------------------------------------*/
+
+    UBaseType_t uxTaskGetDeadlineMisses( TaskHandle_t xTask )
+    {
+        TCB_t * pxTCB;
+        UBaseType_t uxReturn;
+
+        taskENTER_CRITICAL( &xKernelLock );
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+            uxReturn = pxTCB->uxDeadlineMisses;
+        }
+        taskEXIT_CRITICAL( &xKernelLock );
+
+        return uxReturn;
+    }
+
+#endif /* ( ( !CONFIG_FREERTOS_SMP ) && ( configUSE_EDF_SCHEDULING == 1 ) ) */
+/*----------------------------------------------------------*/
+
+#if ( ( !CONFIG_FREERTOS_SMP ) && ( configUSE_TASK_BUDGETS == 1 ) )
+
+    BaseType_t xTaskSetBudget( TaskHandle_t xTask,
+                               TickType_t xBudget,
+                               TickType_t xPeriod )
+    {
+        TCB_t * pxTCB;
+        BaseType_t xReturn = pdFAIL;
+
+        if( ( xPeriod == ( TickType_t ) 0 ) || ( ( xBudget > ( TickType_t ) 0 ) && ( xBudget <= xPeriod ) ) )
+        {
+            taskENTER_CRITICAL( &xKernelLock );
+            {
+                pxTCB = prvGetTCBFromHandle( xTask );
+
+                /* The idle tasks must always be able to run. */
+                for( BaseType_t xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++ )
+                {
+                    configASSERT( pxTCB != xIdleTaskHandle[ xCoreID ] );
+                }
+
+                /* Start a new budget period now, with the full budget. */
+                pxTCB->xBudget = xBudget;
+                pxTCB->xBudgetPeriod = xPeriod;
+                pxTCB->xBudgetPeriodStart = xTickCount;
+                pxTCB->xBudgetRemaining = xBudget;
+                xReturn = pdPASS;
+            }
+            taskEXIT_CRITICAL( &xKernelLock );
+        }
+
+        return xReturn;
+    }
+
+#endif /* ( ( !CONFIG_FREERTOS_SMP ) && ( configUSE_TASK_BUDGETS == 1 ) ) */
+/*----------------------------------------------------------*/
+
+#if ( ( !CONFIG_FREERTOS_SMP ) && ( configUSE_TASK_DELAY_US == 1 ) )
+
+/* Delays shorter than this are busy-waited, as blocking and unblocking the task
+ * would take longer. */
+    #define taskDELAY_US_MIN_BLOCK_TIME    ( ( int64_t ) 50 )
+
+/*
+ * Called from the esp_timer ISR when the wake time of a task delayed by
+ * vTaskDelayUs() or xTaskDelayUntilUs() is reached.
+ */
+    static void IRAM_ATTR prvDelayUsTimerCallback( void * pvArg )
+    {
+        TCB_t * pxTCB = ( TCB_t * ) pvArg;
+        BaseType_t xYieldRequired = pdFALSE;
+
+        taskENTER_CRITICAL_ISR( &xKernelLock );
+        {
+            /* Get current core ID as we can no longer be preempted. */
+            const BaseType_t xCurCoreID = portGET_CORE_ID();
+
+            /* The timer is stopped when the task is deleted, suspended or its
+             * delay is aborted, but it may have already fired. Only unblock
+             * the task if it is still waiting on the delayed list. */
+            if( ( pxTCB->ucDelayUsPending != pdFALSE ) &&
+                ( taskLIST_IS_DELAYED_TASK_LIST( listLIST_ITEM_CONTAINER( &( pxTCB->xStateListItem ) ) ) ) )
+            {
+                pxTCB->ucDelayUsPending = pdFALSE;
+
+                /* The task is blocked on the delayed list, not on an event. */
+                configASSERT( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) == NULL );
+
+                if( taskCAN_BE_SCHEDULED( pxTCB ) == pdTRUE )
+                {
+                    listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+                    prvAddTaskToReadyList( pxTCB );
+                }
+                else
+                {
+                    /* The delayed and ready lists cannot be accessed, so hold
+                     * this task pending until the scheduler is resumed. */
+                    listINSERT_END( &( xPendingReadyList[ xCurCoreID ] ), &( pxTCB->xEventListItem ) );
+                }
+
+                if( taskIS_YIELD_REQUIRED( pxTCB, pdFALSE ) == pdTRUE )
+                {
+                    xYieldRequired = pdTRUE;
+                    xYieldPending[ xCurCoreID ] = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL_ISR( &xKernelLock );
+
+        /* The esp_timer ISR performs the yield once all its callbacks have
+         * been dispatched. */
+        if( xYieldRequired != pdFALSE )
+        {
+            esp_timer_isr_dispatch_need_yield();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*----------------------------------------------------------*/
+
+    static void prvDelayUntilUs( int64_t xWakeTimeUs )
+    {
+        TCB_t * pxTCB = prvGetTCBFromHandle( NULL );
+        int64_t xRemainingUs = xWakeTimeUs - esp_timer_get_time();
+
+        configASSERT( taskIS_SCHEDULER_SUSPENDED() == pdFALSE );
+
+        if( xRemainingUs > taskDELAY_US_MIN_BLOCK_TIME )
+        {
+            if( pxTCB->pvDelayUsTimer == NULL )
+            {
+                const esp_timer_create_args_t xTimerArgs =
+                {
+                    .callback        = prvDelayUsTimerCallback,
+                    .arg             = pxTCB,
+                    .dispatch_method = ESP_TIMER_ISR,
+                    .name            = "delay_us",
+                };
+
+                ESP_ERROR_CHECK( esp_timer_create( &xTimerArgs, ( esp_timer_handle_t * ) &( pxTCB->pvDelayUsTimer ) ) );
+            }
+
+            vTaskSuspendAll();
+            {
+                taskENTER_CRITICAL( &xKernelLock );
+                {
+                    pxTCB->ucDelayUsPending = pdTRUE;
+
+                    /* The timer can only unblock the task once it is on the
+                     * delayed list, as the scheduler is suspended. The block
+                     * time only serves as a fallback, and is a tick longer than
+                     * the delay so as to never expire before the timer. */
+                    xRemainingUs = xWakeTimeUs - esp_timer_get_time();
+
+                    if( xRemainingUs < 0 )
+                    {
+                        xRemainingUs = 0;
+                    }
+
+                    ESP_ERROR_CHECK( esp_timer_start_once( ( esp_timer_handle_t ) pxTCB->pvDelayUsTimer, ( uint64_t ) xRemainingUs ) );
+                    prvAddCurrentTaskToDelayedList( ( TickType_t ) ( ( xRemainingUs / ( portTICK_PERIOD_MS * 1000 ) ) + 2 ), pdFALSE );
+                }
+                taskEXIT_CRITICAL( &xKernelLock );
+            }
+
+            if( xTaskResumeAll() == pdFALSE )
+            {
+                portYIELD_WITHIN_API();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* If the task was unblocked by its fallback block time, its timer
+             * is still running and must not unblock it later. */
+            taskENTER_CRITICAL( &xKernelLock );
+            {
+                prvCancelDelayUs( pxTCB );
+            }
+            taskEXIT_CRITICAL( &xKernelLock );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* Busy-wait for the remainder of the delay, i.e., the time it took to
+         * switch back to this task. */
+        while( esp_timer_get_time() < xWakeTimeUs )
+        {
+        }
+    }
+/*----------------------------------------------------------*/
+
+    void vTaskDelayUs( uint32_t ulDelayUs )
+    {
+        prvDelayUntilUs( esp_timer_get_time() + ( int64_t ) ulDelayUs );
+    }
+/*----------------------------------------------------------*/
+
+    BaseType_t xTaskDelayUntilUs( int64_t * const pxPreviousWakeTimeUs,
+                                  uint32_t ulTimeIncrementUs )
+    {
+        BaseType_t xShouldDelay = pdFALSE;
+        int64_t xTimeToWake;
+
+        configASSERT( pxPreviousWakeTimeUs );
+
+        /* Generate the time at which the task wants to wake. Unlike tick
+         * counts, microsecond times do not overflow. */
+        xTimeToWake = *pxPreviousWakeTimeUs + ( int64_t ) ulTimeIncrementUs;
+        *pxPreviousWakeTimeUs = xTimeToWake;
+
+        if( xTimeToWake > esp_timer_get_time() )
+        {
+            xShouldDelay = pdTRUE;
+            prvDelayUntilUs( xTimeToWake );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xShouldDelay;
+    }
+/*----------------------------------------------------------*/
+
+    static void prvCancelDelayUs( TCB_t * pxTCB )
+    {
+        if( pxTCB->ucDelayUsPending != pdFALSE )
+        {
+            pxTCB->ucDelayUsPending = pdFALSE;
+            ( void ) esp_timer_stop( ( esp_timer_handle_t ) pxTCB->pvDelayUsTimer );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*----------------------------------------------------------*/
+
+    #if ( INCLUDE_vTaskDelete == 1 )
+
+        static void prvDeleteDelayUsTimer( TCB_t * pxTCB )
+        {
+            if( pxTCB->pvDelayUsTimer != NULL )
+            {
+                ( void ) esp_timer_stop( ( esp_timer_handle_t ) pxTCB->pvDelayUsTimer );
+                ( void ) esp_timer_delete( ( esp_timer_handle_t ) pxTCB->pvDelayUsTimer );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+    #endif /* INCLUDE_vTaskDelete */
+
+#endif /* ( ( !CONFIG_FREERTOS_SMP ) && ( configUSE_TASK_DELAY_US == 1 ) ) */
+/*----------------------------------------------------------*/
+
+#if ( ( !CONFIG_FREERTOS_SMP ) && ( configUSE_TASK_REAPER == 1 ) )
+
+/*
+ * Frees up to configTASK_REAPER_BATCH_SIZE tasks from xTasksWaitingTermination.
+ * Tasks that are still running (i.e., on the other core) are skipped. Returns
+ * the number of tasks freed.
+ */
+    static UBaseType_t prvReapDeletedTasks( void )
+    {
+        TCB_t * pxTCBs[ configTASK_REAPER_BATCH_SIZE ];
+        UBaseType_t uxReaped = 0;
+        UBaseType_t x;
+
+        taskENTER_CRITICAL( &xKernelLock );
+        {
+            const TickType_t xConstTickCount = xTickCount;
+            ListItem_t * pxEntry = listGET_HEAD_ENTRY( &xTasksWaitingTermination );
+
+            while( ( pxEntry != listGET_END_MARKER( &xTasksWaitingTermination ) ) && ( uxReaped < ( UBaseType_t ) configTASK_REAPER_BATCH_SIZE ) )
+            {
+                TCB_t * pxTCB = ( TCB_t * ) listGET_LIST_ITEM_OWNER( pxEntry );
+
+                /* Get the next entry before the current one is removed. */
+                pxEntry = listGET_NEXT( pxEntry );
+
+                if( taskIS_CURRENTLY_RUNNING( pxTCB ) == pdFALSE )
+                {
+                    const TickType_t xLatency = xConstTickCount - listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
+
+                    ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+                    --uxCurrentNumberOfTasks;
+                    --uxDeletedTasksWaitingCleanUp;
+
+                    xTaskReaperStats.uxTasksReclaimed++;
+                    xTaskReaperStats.xLastReclaimLatency = xLatency;
+                    xTaskReaperStats.xTotalReclaimLatency += xLatency;
+
+                    if( xLatency > xTaskReaperStats.xMaxReclaimLatency )
+                    {
+                        xTaskReaperStats.xMaxReclaimLatency = xLatency;
+                    }
+
+                    pxTCBs[ uxReaped++ ] = pxTCB;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+        taskEXIT_CRITICAL( &xKernelLock );
+
+        /* Free the batch outside of the critical section, as the TLSP deletion
+         * callbacks and the memory reclaim hook may take some time. */
+        for( x = 0; x < uxReaped; x++ )
+        {
+            prvDeleteTCB( pxTCBs[ x ] );
+        }
+
+        return uxReaped;
+    }
+/*----------------------------------------------------------*/
+
+    static void prvTaskReaper( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        for( ; ; )
+        {
+            /* If a deleted task could not be freed because it was still running
+             * on the other core, check again on the next tick. */
+            ( void ) ulTaskNotifyTake( pdTRUE, ( uxDeletedTasksWaitingCleanUp > ( UBaseType_t ) 0U ) ? 1 : portMAX_DELAY );
+
+            /* Keep freeing full batches, but yield in between so that tasks of
+             * the same priority are not held up by a burst of deletions. */
+            while( prvReapDeletedTasks() == ( UBaseType_t ) configTASK_REAPER_BATCH_SIZE )
+            {
+                taskYIELD();
+            }
+        }
+    }
+/*----------------------------------------------------------*/
+
+    static BaseType_t prvCreateTaskReaper( void )
+    {
+        return xTaskCreatePinnedToCore( prvTaskReaper, "reaper", configTASK_REAPER_STACK_SIZE, NULL, configTASK_REAPER_PRIORITY, &xTaskReaperHandle, tskNO_AFFINITY );
+    }
+/*----------------------------------------------------------*/
+
+    static void prvNotifyTaskReaper( void )
+    {
+        if( xTaskReaperHandle != NULL )
+        {
+            ( void ) xTaskNotifyGive( xTaskReaperHandle );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*----------------------------------------------------------*/
+
+    #if ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 )
+
+        TaskHandle_t prvTaskCreateReclaimablePinnedToCore( TaskFunction_t pxTaskCode,
+                                                           const char * const pcName,
+                                                           const uint32_t ulStackDepth,
+                                                           void * const pvParameters,
+                                                           UBaseType_t uxPriority,
+                                                           StackType_t * const puxStackBuffer,
+                                                           StaticTask_t * const pxTaskBuffer,
+                                                           const BaseType_t xCoreID )
+        {
+            TCB_t * pxNewTCB;
+            TaskHandle_t xReturn;
+
+            configASSERT( portVALID_STACK_MEM( puxStackBuffer ) );
+            configASSERT( portVALID_TCB_MEM( pxTaskBuffer ) );
+            configASSERT( taskVALID_CORE_ID( xCoreID ) == pdTRUE || xCoreID == tskNO_AFFINITY );
+
+            pxNewTCB = ( TCB_t * ) pxTaskBuffer;
+            memset( ( void * ) pxNewTCB, 0x00, sizeof( TCB_t ) );
+            pxNewTCB->pxStack = ( StackType_t * ) puxStackBuffer;
+
+            /* The memory is marked as dynamically allocated, before the task
+             * can run and delete itself, so that it is offered to the memory
+             * reclaim hook once the task is deleted. */
+            pxNewTCB->ucStaticallyAllocated = tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB;
+
+            prvInitialiseNewTask( pxTaskCode, pcName, ulStackDepth, pvParameters, uxPriority, &xReturn, pxNewTCB, NULL, xCoreID );
+            prvAddNewTaskToReadyList( pxNewTCB );
+
+            return xReturn;
+        }
+
+    #endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
+/*----------------------------------------------------------*/
+
+    void vTaskSetMemoryReclaimHook( TaskMemoryReclaimHook_t pxHook )
+    {
+        taskENTER_CRITICAL( &xKernelLock );
+        {
+            pxTaskMemoryReclaimHook = pxHook;
+        }
+        taskEXIT_CRITICAL( &xKernelLock );
+    }
+/*----------------------------------------------------------*/
+
+    void prvTaskSetPoolReclaimHook( TaskMemoryReclaimHook_t pxHook )
+    {
+        taskENTER_CRITICAL( &xKernelLock );
+        {
+            /* Only one set of task pools can take back memory. */
+            configASSERT( ( pxTaskPoolReclaimHook == NULL ) || ( pxTaskPoolReclaimHook == pxHook ) );
+            pxTaskPoolReclaimHook = pxHook;
+        }
+        taskEXIT_CRITICAL( &xKernelLock );
+    }
+/*----------------------------------------------------------*/
+
+    void vTaskGetReaperStats( TaskReaperStats_t * pxStats )
+    {
+        configASSERT( pxStats != NULL );
+
+        taskENTER_CRITICAL( &xKernelLock );
+        {
+            *pxStats = xTaskReaperStats;
+        }
+        taskEXIT_CRITICAL( &xKernelLock );
+    }
+
+#endif /* ( ( !CONFIG_FREERTOS_SMP ) && ( configUSE_TASK_REAPER == 1 ) ) */
+/*----------------------------------------------------------*/
+
 #if ( INCLUDE_vTaskPrioritySet == 1 )
 
     void prvTaskPriorityRaise( prvTaskSavedPriority_t * pxSavedPriority,
@@ -908,6 +1600,7 @@ static List_t * non_ready_task_lists[] =
  *      - Delayed list 2
  *      - Waiting termination list
  *      - Suspended list
+ *      - Delayed task wheel tick and lap slots (if configUSE_DELAYED_TASK_WHEEL is enabled)
  *
  * @param uxListIndex The index of the desired task list.
  * @return A pointer to the task list at the specified index.
@@ -926,6 +1619,13 @@ static List_t * pxGetTaskListByIndex( UBaseType_t uxListIndex )
     {
         pxTaskList = non_ready_task_lists[ uxListIndex - configMAX_PRIORITIES ];
     }
+
+    #if ( !CONFIG_FREERTOS_SMP && ( configUSE_DELAYED_TASK_WHEEL == 1 ) )
+        else if( uxListIndex < configMAX_PRIORITIES + xNonReadyTaskListsCnt + taskDELAYED_WHEEL_LISTS )
+        {
+            pxTaskList = &xDelayedTaskWheel[ uxListIndex - configMAX_PRIORITIES - xNonReadyTaskListsCnt ];
+        }
+    #endif /* !CONFIG_FREERTOS_SMP && ( configUSE_DELAYED_TASK_WHEEL == 1 ) */
     else
     {
         pxTaskList = NULL;
@@ -954,7 +1654,11 @@ static List_t * pxGetTaskListByIndex( UBaseType_t uxListIndex )
  */
 static inline UBaseType_t pxGetTaskListCount( void )
 {
-    return configMAX_PRIORITIES + ( sizeof( non_ready_task_lists ) / sizeof( List_t * ) );
+    #if ( !CONFIG_FREERTOS_SMP && ( configUSE_DELAYED_TASK_WHEEL == 1 ) )
+        return configMAX_PRIORITIES + ( sizeof( non_ready_task_lists ) / sizeof( List_t * ) ) + taskDELAYED_WHEEL_LISTS;
+    #else
+        return configMAX_PRIORITIES + ( sizeof( non_ready_task_lists ) / sizeof( List_t * ) );
+    #endif
 }
 /*----------------------------------------------------------*/
 
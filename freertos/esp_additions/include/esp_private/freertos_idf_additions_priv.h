@@ -189,6 +189,47 @@
 
 #endif /* ( !CONFIG_FREERTOS_SMP && ( configNUM_CORES > 1 ) ) */
 
+/*
+ * When the tickless kernel is enabled, the portable layer only generates a
+ * tick interrupt on the ticks for which the kernel has work to do. The
+ * following functions are used by the portable layer to find out when the next
+ * tick interrupt is required, and to account for the ticks that have elapsed
+ * in between.
+ */
+#if ( !CONFIG_FREERTOS_SMP && ( configUSE_TICKLESS_KERNEL == 1 ) )
+
+/**
+ * @brief Get the number of ticks until the kernel next has work to do
+ *
+ * @return Number of ticks (at least 1) after the current tick count at which
+ * the next tick must be processed by xTaskIncrementTick()
+ */
+    TickType_t xTaskGetTicksToNextEvent( void );
+
+/**
+ * @brief Advance the tick count without processing the ticks
+ *
+ * The tick count is only advanced up to (but excluding) the tick of the next
+ * event, and only if there are no pended ticks.
+ *
+ * @param xTicksToSkip Number of ticks that have elapsed
+ * @return Number of ticks that were actually skipped
+ */
+    TickType_t xTaskSkipTicks( TickType_t xTicksToSkip );
+
+/**
+ * @brief Account for multiple ticks from the tick interrupt
+ *
+ * Ticks on which the kernel has nothing to do are skipped. The others are
+ * processed by xTaskIncrementTick(). Must be called with interrupts disabled.
+ *
+ * @param xTicksToIncrement Number of ticks that have elapsed
+ * @return pdTRUE if a context switch is required
+ */
+    BaseType_t xTaskIncrementTicks( TickType_t xTicksToIncrement );
+
+#endif /* ( !CONFIG_FREERTOS_SMP && ( configUSE_TICKLESS_KERNEL == 1 ) ) */
+
 /*------------------------------------------------------------------------------
  * TASK UTILITIES (PRIVATE)
  *----------------------------------------------------------------------------*/
@@ -356,6 +397,46 @@
 
 #endif // CONFIG_SPIRAM
 
+#if ( ( !CONFIG_FREERTOS_SMP ) && ( configUSE_TASK_REAPER == 1 ) )
+
+/**
+ * Create a new task using the provided TCB and stack buffers, and add it to the
+ * list of tasks that are ready to run.
+ *
+ * @note: This is an internal function and meant for usage by task pools only.
+ *
+ * This function behaves like xTaskCreateStaticPinnedToCore(), except that the
+ * kernel treats the TCB and stack as if they had been allocated dynamically.
+ * Once the task is deleted, they are offered to the task memory reclaim hook
+ * (see vTaskSetMemoryReclaimHook()), which must take them back, as the kernel
+ * would otherwise free them with vPortFree().
+ *
+ * @return Handle of the created task
+ */
+    TaskHandle_t prvTaskCreateReclaimablePinnedToCore( TaskFunction_t pxTaskCode,
+                                                       const char * const pcName,
+                                                       const uint32_t ulStackDepth,
+                                                       void * const pvParameters,
+                                                       UBaseType_t uxPriority,
+                                                       StackType_t * const puxStackBuffer,
+                                                       StaticTask_t * const pxTaskBuffer,
+                                                       const BaseType_t xCoreID );
+
+/**
+ * Set the task memory reclaim hook of the task pools.
+ *
+ * @note: This is an internal function and meant for usage by task pools only.
+ *
+ * The hook is called for each deleted task before the hook set with
+ * vTaskSetMemoryReclaimHook(), so that the task pools and the application can
+ * both take back memory.
+ *
+ * @param pxHook The hook to call
+ */
+    void prvTaskSetPoolReclaimHook( TaskMemoryReclaimHook_t pxHook );
+
+#endif /* ( ( !CONFIG_FREERTOS_SMP ) && ( configUSE_TASK_REAPER == 1 ) ) */
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     }
@@ -204,6 +204,184 @@ BaseType_t xTaskGetCoreID( TaskHandle_t xTask );
  */
 uint8_t * pxTaskGetStackStart( TaskHandle_t xTask );
 
+#if ( ( !CONFIG_FREERTOS_SMP ) && ( configUSE_EDF_SCHEDULING == 1 ) )
+
+/**
+ * @brief Set the period and relative deadline of a task
+ *
+ * Makes the task a periodic task that is scheduled by Earliest Deadline First
+ * among the ready tasks of its priority. The current job of the task is
+ * considered released now, with an absolute deadline of xRelativeDeadline ticks
+ * from now. The task must call xTaskWaitForNextPeriod() at the end of each job.
+ *
+ * Tasks without a deadline run after the tasks of the same priority that have
+ * one. The new deadline takes effect at the next scheduling decision.
+ *
+ * @note Only available when CONFIG_FREERTOS_USE_EDF_SCHEDULING is enabled
+ * @param xTask The task to configure. Set to NULL to configure the calling task.
+ * @param xPeriod Release period of the task in ticks. Set to 0 to remove the
+ * task's deadline, after which it is scheduled round robin again.
+ * @param xRelativeDeadline Deadline of each job in ticks, relative to its
+ * release. Usually equal to xPeriod.
+ */
+    void vTaskSetDeadline( TaskHandle_t xTask,
+                           TickType_t xPeriod,
+                           TickType_t xRelativeDeadline );
+
+/**
+ * @brief Complete the current job and wait for the next release
+ *
+ * Called by a periodic task at the end of each job. The task blocks until its
+ * next release (one period after the previous release), and the absolute
+ * deadline of the next job is set. If the next release is already in the past,
+ * the task does not block.
+ *
+ * @note The calling task must have a deadline set with vTaskSetDeadline()
+ * @return pdTRUE if the completed job met its deadline, pdFALSE otherwise
+ */
+    BaseType_t xTaskWaitForNextPeriod( void );
+
+/**
+ * @brief Get the number of jobs of a task that missed their deadline
+ *
+ * @param xTask The task to query. Set to NULL to query the calling task.
+ * @return Number of jobs that completed after their deadline since the last
+ * call to vTaskSetDeadline()
+ */
+    UBaseType_t uxTaskGetDeadlineMisses( TaskHandle_t xTask );
+
+#endif /* ( ( !CONFIG_FREERTOS_SMP ) && ( configUSE_EDF_SCHEDULING == 1 ) ) */
+
+#if ( ( !CONFIG_FREERTOS_SMP ) && ( configUSE_TASK_BUDGETS == 1 ) )
+
+/**
+ * @brief Set the CPU budget of a task
+ *
+ * Reserves the task at most xBudget ticks of CPU time in every period of
+ * xPeriod ticks. Each tick interrupt during which the task is running is
+ * charged to its budget, including while the task has the scheduler suspended.
+ * Ticks that are caught up (e.g., with xTaskCatchUpTicks()) are not charged.
+ * Once the budget is exhausted, the task is throttled (i.e., placed in the
+ * Blocked state) until the start of its next period, at which point the budget
+ * is replenished. A task that has the scheduler suspended is only throttled
+ * once it resumes the scheduler. This prevents a task that never blocks from
+ * starving the tasks of equal or lower priority.
+ *
+ * The budget of a task and the number of times it was throttled are reported
+ * in TaskStatus_t and by vTaskGetRunTimeStats().
+ *
+ * @note Only available when CONFIG_FREERTOS_USE_TASK_BUDGETS is enabled
+ * @note A task is throttled regardless of the mutexes it holds, so a budget
+ * should only be set on tasks that do not hold mutexes for long.
+ * @param xTask The task to set the budget of. Set to NULL to set the budget of
+ * the calling task. Must not be an idle task.
+ * @param xBudget Number of ticks the task may run for in each period
+ * @param xPeriod Budget replenishment period in ticks. Set to 0 to remove the
+ * task's budget.
+ * @return pdPASS if the budget was set, pdFAIL if xBudget is 0 or larger than
+ * xPeriod
+ */
+    BaseType_t xTaskSetBudget( TaskHandle_t xTask,
+                               TickType_t xBudget,
+                               TickType_t xPeriod );
+
+#endif /* ( ( !CONFIG_FREERTOS_SMP ) && ( configUSE_TASK_BUDGETS == 1 ) ) */
+
+#if ( ( !CONFIG_FREERTOS_SMP ) && ( configUSE_TASK_DELAY_US == 1 ) )
+
+/**
+ * @brief Delay the calling task for a number of microseconds
+ *
+ * Unlike vTaskDelay(), the delay is not rounded to a number of ticks. The task
+ * is placed in the Blocked state and woken by a one-shot esp_timer alarm, then
+ * busy-waits for the last few microseconds (as do delays shorter than the time
+ * it takes to block and unblock the task).
+ *
+ * @note Only available when CONFIG_FREERTOS_USE_TASK_DELAY_US is enabled
+ * @note Must not be called with the scheduler suspended
+ * @note If the task is unblocked early (e.g., by xTaskAbortDelay()), it
+ * busy-waits for the remainder of the delay once it runs again
+ * @param ulDelayUs Number of microseconds to delay for
+ */
+    void vTaskDelayUs( uint32_t ulDelayUs );
+
+/**
+ * @brief Delay the calling task until a specified time in microseconds
+ *
+ * Microsecond resolution equivalent of xTaskDelayUntil(). The wake time is
+ * *pxPreviousWakeTimeUs + ulTimeIncrementUs, and *pxPreviousWakeTimeUs is
+ * updated to the wake time, so that calling this function repeatedly results
+ * in a fixed execution frequency without drift. Times are in the timebase of
+ * esp_timer_get_time().
+ *
+ * @note Only available when CONFIG_FREERTOS_USE_TASK_DELAY_US is enabled
+ * @note Must not be called with the scheduler suspended
+ * @param pxPreviousWakeTimeUs Pointer to the time at which the task was last
+ * unblocked. Must be initialized with esp_timer_get_time() before first use.
+ * @param ulTimeIncrementUs The cycle time period in microseconds
+ * @return pdTRUE if the task was delayed, pdFALSE if the wake time had
+ * already passed
+ */
+    BaseType_t xTaskDelayUntilUs( int64_t * const pxPreviousWakeTimeUs,
+                                  uint32_t ulTimeIncrementUs );
+
+#endif /* ( ( !CONFIG_FREERTOS_SMP ) && ( configUSE_TASK_DELAY_US == 1 ) ) */
+
+#if ( ( !CONFIG_FREERTOS_SMP ) && ( configUSE_TASK_REAPER == 1 ) )
+
+/**
+ * @brief Prototype of a task memory reclaim hook
+ *
+ * @param xTask The deleted task. Its TCB is no longer used by the kernel.
+ * @param pxStack Start of the deleted task's stack
+ * @return pdTRUE if the hook has taken ownership of the TCB and stack (e.g.,
+ * returned them to a pool), pdFALSE if the kernel should free them as usual
+ */
+    typedef BaseType_t (* TaskMemoryReclaimHook_t)( TaskHandle_t xTask,
+                                                    StackType_t * pxStack );
+
+/**
+ * @brief Task reaper statistics
+ *
+ * Latencies are measured in ticks, from the task's deletion to the reaper
+ * freeing its TCB and stack, and only cover tasks that were freed by the
+ * reaper (i.e., tasks that deleted themselves or were running on the other
+ * core when deleted).
+ */
+    typedef struct xTASK_REAPER_STATS
+    {
+        UBaseType_t uxTasksReclaimed;    /**< Number of deleted tasks freed by the reaper */
+        TickType_t xLastReclaimLatency;  /**< Reclaim latency of the most recently freed task */
+        TickType_t xMaxReclaimLatency;   /**< Largest reclaim latency seen */
+        TickType_t xTotalReclaimLatency; /**< Sum of the reclaim latencies of all freed tasks */
+    } TaskReaperStats_t;
+
+/**
+ * @brief Set the task memory reclaim hook
+ *
+ * The hook is called with each deleted task's TCB and stack, just before they
+ * would be freed, and can take them back instead (e.g., to reuse them for the
+ * next task created from a pool). It is only called for tasks whose TCB and
+ * stack were both allocated dynamically, as the kernel does not free the
+ * memory of statically allocated tasks. It is called from the task reaper, or from
+ * vTaskDelete() when a task that is not running is deleted, so it must not
+ * block.
+ *
+ * @note Only available when CONFIG_FREERTOS_USE_TASK_REAPER is enabled
+ * @param pxHook The hook to call. Set to NULL to remove the hook.
+ */
+    void vTaskSetMemoryReclaimHook( TaskMemoryReclaimHook_t pxHook );
+
+/**
+ * @brief Get the task reaper statistics
+ *
+ * @note Only available when CONFIG_FREERTOS_USE_TASK_REAPER is enabled
+ * @param[out] pxStats Filled with a snapshot of the statistics
+ */
+    void vTaskGetReaperStats( TaskReaperStats_t * pxStats );
+
+#endif /* ( ( !CONFIG_FREERTOS_SMP ) && ( configUSE_TASK_REAPER == 1 ) ) */
+
 /* --------------------------------------------- TLSP Deletion Callbacks -------------------------------------------- */
 
 #if CONFIG_FREERTOS_TLSP_DELETION_CALLBACKS
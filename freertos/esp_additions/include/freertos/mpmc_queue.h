@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+/*
+ * Multi-producer/multi-consumer (MPMC) queue
+ *
+ * An MPMC queue is a bounded FIFO of fixed size items that any number of tasks
+ * (on any core) and ISRs may send to and receive from concurrently. It is based
+ * on Dmitry Vyukov's bounded MPMC queue: each cell carries a sequence number
+ * that tells producers and consumers whether the cell is free or full, so the
+ * non-blocking paths only need a single compare-and-swap on the shared
+ * enqueue/dequeue position. Unlike a regular FreeRTOS queue, no spinlock is
+ * taken, so cores sending to and receiving from the same queue do not
+ * serialize on a critical section.
+ *
+ * When the queue is empty (or full) and the caller wishes to block, the caller
+ * registers itself as a waiter and blocks on an internal counting semaphore.
+ * The other side only gives that semaphore if it observes a registered waiter,
+ * so the kernel is not entered on the fast path.
+ */
+
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * Type by which MPMC queues are referenced.
+ */
+struct MpmcQueueDefinition;
+typedef struct MpmcQueueDefinition * MpmcQueueHandle_t;
+
+/**
+ * @brief Create a multi-producer/multi-consumer queue
+ *
+ * @param uxQueueLength The maximum number of items that the queue can contain.
+ * Must be a power of two and at least 2.
+ * @param uxItemSize The number of bytes each item in the queue will require.
+ * @return Handle to the created queue or NULL on failure.
+ */
+MpmcQueueHandle_t xMpmcQueueCreate( UBaseType_t uxQueueLength,
+                                    UBaseType_t uxItemSize );
+
+/**
+ * @brief Delete an MPMC queue
+ *
+ * @note No task may be blocked on the queue when it is deleted.
+ * @param xQueue The queue to delete.
+ */
+void vMpmcQueueDelete( MpmcQueueHandle_t xQueue );
+
+/**
+ * @brief Send an item to the back of an MPMC queue
+ *
+ * @param xQueue The queue to send to.
+ * @param pvItemToQueue Pointer to the item to copy into the queue.
+ * @param xTicksToWait The maximum time to block waiting for space.
+ * @return pdPASS if the item was sent, errQUEUE_FULL if the queue was full and
+ * the block time expired.
+ */
+BaseType_t xMpmcQueueSend( MpmcQueueHandle_t xQueue,
+                           const void * pvItemToQueue,
+                           TickType_t xTicksToWait );
+
+/**
+ * @brief Receive an item from an MPMC queue
+ *
+ * @param xQueue The queue to receive from.
+ * @param pvBuffer Buffer into which the received item will be copied.
+ * @param xTicksToWait The maximum time to block waiting for an item.
+ * @return pdPASS if an item was received, errQUEUE_EMPTY if the queue was
+ * empty and the block time expired.
+ */
+BaseType_t xMpmcQueueReceive( MpmcQueueHandle_t xQueue,
+                              void * pvBuffer,
+                              TickType_t xTicksToWait );
+
+/**
+ * @brief Send an item to an MPMC queue from an ISR
+ *
+ * @param xQueue The queue to send to.
+ * @param pvItemToQueue Pointer to the item to copy into the queue.
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if sending the item caused a
+ * higher priority task to unblock.
+ * @return pdPASS if the item was sent, otherwise errQUEUE_FULL.
+ */
+BaseType_t xMpmcQueueSendFromISR( MpmcQueueHandle_t xQueue,
+                                  const void * pvItemToQueue,
+                                  BaseType_t * const pxHigherPriorityTaskWoken );
+
+/**
+ * @brief Receive an item from an MPMC queue from an ISR
+ *
+ * @param xQueue The queue to receive from.
+ * @param pvBuffer Buffer into which the received item will be copied.
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if receiving the item caused
+ * a higher priority task to unblock.
+ * @return pdPASS if an item was received, otherwise errQUEUE_EMPTY.
+ */
+BaseType_t xMpmcQueueReceiveFromISR( MpmcQueueHandle_t xQueue,
+                                     void * pvBuffer,
+                                     BaseType_t * const pxHigherPriorityTaskWoken );
+
+/**
+ * @brief Get the approximate number of items stored in an MPMC queue
+ *
+ * @param xQueue The queue to query.
+ * @return The number of items in the queue at some point during the call.
+ */
+UBaseType_t uxMpmcQueueMessagesWaiting( MpmcQueueHandle_t xQueue );
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
@@ -0,0 +1,127 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+/*
+ * Priority-ordered message queue
+ *
+ * A priority queue is a bounded queue of fixed size items where every item is
+ * sent with a priority. Receiving always returns the highest priority item
+ * currently in the queue. Items of equal priority are received in FIFO order.
+ * As with task priorities, a higher numerical value means a higher priority.
+ *
+ * Items are kept in a binary heap, so sending and receiving are O(log n) in
+ * the number of queued items. Blocking behaves as for xQueueSend() and
+ * xQueueReceive(): tasks wait in priority order, and the highest priority
+ * waiting task is unblocked when space or an item becomes available.
+ */
+
+#include "freertos/FreeRTOS.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * Type by which priority queues are referenced.
+ */
+struct PriorityQueueDefinition;
+typedef struct PriorityQueueDefinition * PriorityQueueHandle_t;
+
+/**
+ * @brief Create a priority queue
+ *
+ * @param uxQueueLength The maximum number of items that the queue can contain.
+ * @param uxItemSize The number of bytes each item in the queue will require.
+ * @return Handle to the created queue or NULL on failure.
+ */
+PriorityQueueHandle_t xPriorityQueueCreate( UBaseType_t uxQueueLength,
+                                            UBaseType_t uxItemSize );
+
+/**
+ * @brief Delete a priority queue
+ *
+ * @note No task may be blocked on the queue when it is deleted.
+ * @param xQueue The queue to delete.
+ */
+void vPriorityQueueDelete( PriorityQueueHandle_t xQueue );
+
+/**
+ * @brief Send an item to a priority queue
+ *
+ * @param xQueue The queue to send to.
+ * @param pvItemToQueue Pointer to the item to copy into the queue.
+ * @param uxPriority The priority of the item. Higher values are received first.
+ * @param xTicksToWait The maximum time to block waiting for space.
+ * @return pdPASS if the item was sent, errQUEUE_FULL if the queue was full and
+ * the block time expired.
+ */
+BaseType_t xPriorityQueueSend( PriorityQueueHandle_t xQueue,
+                               const void * pvItemToQueue,
+                               UBaseType_t uxPriority,
+                               TickType_t xTicksToWait );
+
+/**
+ * @brief Receive the highest priority item from a priority queue
+ *
+ * @param xQueue The queue to receive from.
+ * @param pvBuffer Buffer into which the received item will be copied.
+ * @param puxPriority If not NULL, set to the priority the item was sent with.
+ * @param xTicksToWait The maximum time to block waiting for an item.
+ * @return pdPASS if an item was received, errQUEUE_EMPTY if the queue was
+ * empty and the block time expired.
+ */
+BaseType_t xPriorityQueueReceive( PriorityQueueHandle_t xQueue,
+                                  void * pvBuffer,
+                                  UBaseType_t * puxPriority,
+                                  TickType_t xTicksToWait );
+
+/**
+ * @brief Send an item to a priority queue from an ISR
+ *
+ * @param xQueue The queue to send to.
+ * @param pvItemToQueue Pointer to the item to copy into the queue.
+ * @param uxPriority The priority of the item.
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if sending the item caused a
+ * higher priority task to unblock.
+ * @return pdPASS if the item was sent, otherwise errQUEUE_FULL.
+ */
+BaseType_t xPriorityQueueSendFromISR( PriorityQueueHandle_t xQueue,
+                                      const void * pvItemToQueue,
+                                      UBaseType_t uxPriority,
+                                      BaseType_t * const pxHigherPriorityTaskWoken );
+
+/**
+ * @brief Receive the highest priority item from a priority queue from an ISR
+ *
+ * @param xQueue The queue to receive from.
+ * @param pvBuffer Buffer into which the received item will be copied.
+ * @param puxPriority If not NULL, set to the priority the item was sent with.
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if receiving the item caused
+ * a higher priority task to unblock.
+ * @return pdPASS if an item was received, otherwise errQUEUE_EMPTY.
+ */
+BaseType_t xPriorityQueueReceiveFromISR( PriorityQueueHandle_t xQueue,
+                                         void * pvBuffer,
+                                         UBaseType_t * puxPriority,
+                                         BaseType_t * const pxHigherPriorityTaskWoken );
+
+/**
+ * @brief Get the number of items stored in a priority queue
+ *
+ * @param xQueue The queue to query.
+ * @return The number of items in the queue.
+ */
+UBaseType_t uxPriorityQueueMessagesWaiting( PriorityQueueHandle_t xQueue );
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
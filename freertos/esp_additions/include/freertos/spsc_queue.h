@@ -0,0 +1,143 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+/*
+ * Single-producer/single-consumer (SPSC) queue
+ *
+ * An SPSC queue is a bounded FIFO of fixed size items that may only ever be
+ * written by one task (or ISR) and read by one task (or ISR). Under that
+ * restriction, the non-blocking send and receive paths are wait-free. They
+ * only use acquire/release loads and stores on the queue's read and write
+ * indexes and never enter a critical section.
+ *
+ * The kernel is only entered when the queue is empty/full and the caller
+ * wishes to block, or when the other side is blocked and must be woken. Blocked
+ * tasks are woken using a direct to task notification (in the same way as
+ * stream buffers). Thus, tasks using SPSC queues must not use notification
+ * index 0 for any other purpose.
+ *
+ * Sending from more than one task, or receiving from more than one task, is
+ * undefined behavior. Use a regular FreeRTOS queue in that case.
+ */
+
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * Type by which SPSC queues are referenced.
+ */
+struct SpscQueueDefinition;
+typedef struct SpscQueueDefinition * SpscQueueHandle_t;
+
+/**
+ * @brief Create a single-producer/single-consumer queue
+ *
+ * The queue's control structure and its storage area are allocated in a single
+ * block using pvPortMalloc().
+ *
+ * @param uxQueueLength The maximum number of items that the queue can contain.
+ * @param uxItemSize The number of bytes each item in the queue will require.
+ * @return Handle to the created queue or NULL on failure.
+ */
+SpscQueueHandle_t xSpscQueueCreate( UBaseType_t uxQueueLength,
+                                    UBaseType_t uxItemSize );
+
+/**
+ * @brief Delete an SPSC queue
+ *
+ * @note No task may be blocked on the queue when it is deleted.
+ * @param xQueue The queue to delete.
+ */
+void vSpscQueueDelete( SpscQueueHandle_t xQueue );
+
+/**
+ * @brief Send an item to the back of an SPSC queue
+ *
+ * If the queue has space, the item is copied in without entering the kernel.
+ * The kernel is only entered if the consumer is blocked on the queue (to wake
+ * it), or if the queue is full and xTicksToWait is non-zero (to block).
+ *
+ * @note Must only be called by the queue's single producer.
+ * @param xQueue The queue to send to.
+ * @param pvItemToQueue Pointer to the item to copy into the queue.
+ * @param xTicksToWait The maximum time to block waiting for space.
+ * @return pdPASS if the item was sent, errQUEUE_FULL if the queue was full and
+ * the block time expired.
+ */
+BaseType_t xSpscQueueSend( SpscQueueHandle_t xQueue,
+                           const void * pvItemToQueue,
+                           TickType_t xTicksToWait );
+
+/**
+ * @brief Receive an item from an SPSC queue
+ *
+ * If the queue has data, the item is copied out without entering the kernel.
+ * The kernel is only entered if the producer is blocked on the queue (to wake
+ * it), or if the queue is empty and xTicksToWait is non-zero (to block).
+ *
+ * @note Must only be called by the queue's single consumer.
+ * @param xQueue The queue to receive from.
+ * @param pvBuffer Buffer into which the received item will be copied.
+ * @param xTicksToWait The maximum time to block waiting for an item.
+ * @return pdPASS if an item was received, errQUEUE_EMPTY if the queue was
+ * empty and the block time expired.
+ */
+BaseType_t xSpscQueueReceive( SpscQueueHandle_t xQueue,
+                              void * pvBuffer,
+                              TickType_t xTicksToWait );
+
+/**
+ * @brief Send an item to an SPSC queue from an ISR
+ *
+ * @note The ISR must be the queue's single producer.
+ * @param xQueue The queue to send to.
+ * @param pvItemToQueue Pointer to the item to copy into the queue.
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if waking the consumer caused
+ * a higher priority task to unblock.
+ * @return pdPASS if the item was sent, otherwise errQUEUE_FULL.
+ */
+BaseType_t xSpscQueueSendFromISR( SpscQueueHandle_t xQueue,
+                                  const void * pvItemToQueue,
+                                  BaseType_t * const pxHigherPriorityTaskWoken );
+
+/**
+ * @brief Receive an item from an SPSC queue from an ISR
+ *
+ * @note The ISR must be the queue's single consumer.
+ * @param xQueue The queue to receive from.
+ * @param pvBuffer Buffer into which the received item will be copied.
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if waking the producer caused
+ * a higher priority task to unblock.
+ * @return pdPASS if an item was received, otherwise errQUEUE_EMPTY.
+ */
+BaseType_t xSpscQueueReceiveFromISR( SpscQueueHandle_t xQueue,
+                                     void * pvBuffer,
+                                     BaseType_t * const pxHigherPriorityTaskWoken );
+
+/**
+ * @brief Get the number of items stored in an SPSC queue
+ *
+ * The value is a snapshot and may already be stale when returned if the other
+ * side is concurrently accessing the queue.
+ *
+ * @param xQueue The queue to query.
+ * @return The number of items in the queue.
+ */
+UBaseType_t uxSpscQueueMessagesWaiting( SpscQueueHandle_t xQueue );
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
@@ -0,0 +1,118 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+/*
+ * Task pools
+ *
+ * A task pool preallocates the TCBs and stacks of a fixed number of tasks in a
+ * single slab, for one stack size class. Tasks created from the pool with
+ * xTaskCreateFromPool() take a free TCB and stack from the pool in constant
+ * time, and give them back to the pool (instead of to the heap) once deleted.
+ * Applications that frequently create and delete short-lived tasks can thus
+ * avoid the heap fragmentation caused by allocating and freeing TCBs and
+ * stacks. Applications that need several stack sizes create one pool per
+ * stack size class.
+ *
+ * Deleted tasks are given back to their pool by a memory reclaim hook internal
+ * to the task pools, which is called before the application's hook (see
+ * vTaskSetMemoryReclaimHook()). The application can thus install its own hook
+ * as well, which is not called for tasks created from a pool.
+ *
+ * @note Only available when CONFIG_FREERTOS_USE_TASK_POOLS is enabled
+ */
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * Type by which task pools are referenced.
+ */
+struct TaskPoolDefinition;
+typedef struct TaskPoolDefinition * TaskPoolHandle_t;
+
+/**
+ * @brief Task pool statistics
+ */
+typedef struct xTASK_POOL_STATS
+{
+    UBaseType_t uxCapacity;      /**< Number of tasks the pool can hold */
+    UBaseType_t uxInUse;         /**< Number of TCBs and stacks currently taken from the pool */
+    UBaseType_t uxPeakInUse;     /**< Largest value of uxInUse since the pool was created */
+    UBaseType_t uxAllocFailures; /**< Number of calls to xTaskCreateFromPool() that found the pool empty */
+} TaskPoolStats_t;
+
+/**
+ * @brief Create a task pool
+ *
+ * @param uxNumTasks The number of TCBs and stacks to preallocate
+ * @param ulStackDepth The size of each stack in bytes (i.e., the stack size
+ * class of the pool)
+ * @return Handle to the created pool or NULL on failure.
+ */
+TaskPoolHandle_t xTaskPoolCreate( UBaseType_t uxNumTasks,
+                                  const uint32_t ulStackDepth );
+
+/**
+ * @brief Delete a task pool
+ *
+ * @param xPool The pool to delete.
+ * @return pdPASS if the pool was deleted, pdFAIL if some of its TCBs and
+ * stacks are still in use (i.e., tasks created from the pool have not been
+ * deleted, or have not been cleaned up yet).
+ */
+BaseType_t xTaskPoolDelete( TaskPoolHandle_t xPool );
+
+/**
+ * @brief Create a task using a TCB and stack taken from a task pool
+ *
+ * Equivalent to xTaskCreatePinnedToCore(), except that the stack size is that
+ * of the pool. The TCB and stack return to the pool once the task is deleted.
+ *
+ * @param xPool The pool to take the TCB and stack from
+ * @param pxTaskCode Pointer to the task entry function.
+ * @param pcName A descriptive name for the task.
+ * @param pvParameters Pointer that will be used as the parameter for the task
+ * being created.
+ * @param uxPriority The priority at which the task should run.
+ * @param pxCreatedTask Used to pass back a handle by which the created task
+ * can be referenced. Can be NULL.
+ * @param xCoreID If the value is tskNO_AFFINITY, the created task is not
+ * pinned to any CPU, and the scheduler can run it on any core available.
+ * Values 0 or 1 indicate the index number of the CPU which the task should
+ * be pinned to.
+ * @return pdPASS if the task was created, errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY
+ * if the pool is empty.
+ */
+BaseType_t xTaskCreateFromPool( TaskPoolHandle_t xPool,
+                                TaskFunction_t pxTaskCode,
+                                const char * const pcName,
+                                void * const pvParameters,
+                                UBaseType_t uxPriority,
+                                TaskHandle_t * const pxCreatedTask,
+                                const BaseType_t xCoreID );
+
+/**
+ * @brief Get the occupancy statistics of a task pool
+ *
+ * @param xPool The pool to query.
+ * @param[out] pxStats Filled with a snapshot of the statistics
+ */
+void vTaskPoolGetStats( TaskPoolHandle_t xPool,
+                        TaskPoolStats_t * pxStats );
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
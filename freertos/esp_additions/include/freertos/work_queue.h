@@ -0,0 +1,142 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+/*
+ * Work queue
+ *
+ * A work queue runs one-off jobs (i.e., a function and its argument) on a
+ * fixed set of worker tasks, so that running a short job does not require
+ * creating and deleting a task.
+ *
+ * Jobs are submitted with a priority, and are kept in one lock-free MPMC queue
+ * (see mpmc_queue.h) per core and per job priority. A job is submitted to the
+ * queue of the core it is submitted from. Idle workers first look for the
+ * highest priority job in the queues of their own core, then steal from the
+ * queues of the other cores, so that jobs run on the core that submitted them
+ * when possible without leaving workers idle while jobs are pending.
+ *
+ * The task that submits a job can wait for its result through a future, which
+ * is completed with a task notification.
+ */
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * Type by which work queues are referenced.
+ */
+struct WorkQueueDefinition;
+typedef struct WorkQueueDefinition * WorkQueueHandle_t;
+
+/**
+ * @brief Prototype of a job function
+ *
+ * @param pvArg The argument given to xWorkQueueSubmit()
+ * @return The result of the job, passed to the future (if any)
+ */
+typedef void * (* WorkFunction_t)( void * pvArg );
+
+/**
+ * @brief Work queue configuration
+ */
+typedef struct xWORK_QUEUE_CONFIG
+{
+    UBaseType_t uxNumWorkers;       /**< Number of worker tasks */
+    UBaseType_t uxWorkerPriority;   /**< Priority of the worker tasks */
+    uint32_t ulWorkerStackSize;     /**< Stack size of the worker tasks in bytes */
+    BaseType_t xPinWorkers;         /**< If pdTRUE, workers are pinned to each core in turn. Otherwise, workers are not
+                                     *   pinned to any core. */
+    UBaseType_t uxNumJobPriorities; /**< Number of job priorities. Jobs are submitted with a priority from 0 (lowest)
+                                     *   to uxNumJobPriorities - 1 (highest). */
+    UBaseType_t uxQueueLength;      /**< Maximum number of pending jobs per core and job priority. Must be a power of
+                                     *   two and at least 2. */
+    UBaseType_t uxNotifyIndex;      /**< Task notification index used to complete futures. Tasks that wait on a future
+                                     *   must not use this index for anything else. */
+} WorkQueueConfig_t;
+
+/**
+ * @brief Future of a submitted job
+ *
+ * Provided by the caller of xWorkQueueSubmit(), and must remain valid until
+ * xWorkFutureWait() has returned pdPASS. The members are private.
+ */
+typedef struct xWORK_FUTURE
+{
+    TaskHandle_t xWaiter;
+    UBaseType_t uxNotifyIndex;
+    void * volatile pvResult;
+    volatile uint32_t ulDone;
+} WorkFuture_t;
+
+/**
+ * @brief Create a work queue and its worker tasks
+ *
+ * @param pxConfig The configuration of the work queue
+ * @return Handle to the created work queue or NULL on failure.
+ */
+WorkQueueHandle_t xWorkQueueCreate( const WorkQueueConfig_t * pxConfig );
+
+/**
+ * @brief Delete a work queue and its worker tasks
+ *
+ * Waits for the workers to finish their current job and exit.
+ *
+ * @note All submitted jobs must have completed before the work queue is
+ * deleted, and no job may be submitted while it is being deleted.
+ * @param xWorkQueue The work queue to delete.
+ */
+void vWorkQueueDelete( WorkQueueHandle_t xWorkQueue );
+
+/**
+ * @brief Submit a job to a work queue
+ *
+ * @param xWorkQueue The work queue to submit to.
+ * @param pxFunction The job function.
+ * @param pvArg The argument passed to the job function.
+ * @param uxJobPriority The priority of the job, from 0 (lowest) to
+ * uxNumJobPriorities - 1 (highest).
+ * @param pxFuture Future through which the calling task can wait for the
+ * result of the job. Can be NULL.
+ * @param xTicksToWait The maximum time to block waiting for space if the
+ * queues of the job's priority are full.
+ * @return pdPASS if the job was submitted, errQUEUE_FULL if the queues were
+ * full and the block time expired.
+ */
+BaseType_t xWorkQueueSubmit( WorkQueueHandle_t xWorkQueue,
+                             WorkFunction_t pxFunction,
+                             void * pvArg,
+                             UBaseType_t uxJobPriority,
+                             WorkFuture_t * pxFuture,
+                             TickType_t xTicksToWait );
+
+/**
+ * @brief Wait for the result of a submitted job
+ *
+ * @note Must be called by the task that submitted the job.
+ * @param pxFuture The future given to xWorkQueueSubmit().
+ * @param[out] ppvResult Set to the result of the job. Can be NULL.
+ * @param xTicksToWait The maximum time to block waiting for the job to
+ * complete.
+ * @return pdPASS if the job has completed, pdFAIL if the block time expired.
+ */
+BaseType_t xWorkFutureWait( WorkFuture_t * pxFuture,
+                            void ** ppvResult,
+                            TickType_t xTicksToWait );
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
@@ -0,0 +1,414 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * This file contains the implementation of the multi-producer/multi-consumer
+ * queue declared in mpmc_queue.h
+ *
+ * Cell protocol (for cell i, with position counter pos mapping to cell
+ * pos & uxMask):
+ *
+ * - Initially, cell i has sequence i.
+ * - A producer that claimed position pos (by CAS on uxEnqueuePos) may write the
+ *   cell once sequence == pos. It then publishes the item by storing
+ *   sequence = pos + 1 (release).
+ * - A consumer that claimed position pos (by CAS on uxDequeuePos) may read the
+ *   cell once sequence == pos + 1. It then frees the cell for the next lap by
+ *   storing sequence = pos + uxLength (release).
+ *
+ * Blocking is layered on top using an "event count" per side: a waiter first
+ * increments the side's waiter count, issues a full fence and re-checks the
+ * queue before blocking on the side's counting semaphore. The other side
+ * issues a full fence after publishing a cell and, if it observes a non-zero
+ * waiter count, claims one waiter (by CAS) and gives the semaphore. A waiter
+ * that gives up (because it found work on re-check or timed out) withdraws its
+ * count by CAS. If that fails, a give is already on its way and simply results
+ * in a spurious wake-up of a later waiter, which re-checks the queue and goes
+ * back to sleep.
+ */
+
+#include "sdkconfig.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/mpmc_queue.h"
+
+/* Cell payloads are padded so that every sequence number is word aligned */
+#define mpmcCELL_ALIGN    ( sizeof( UBaseType_t ) )
+
+typedef struct MpmcCell
+{
+    _Atomic UBaseType_t uxSequence;
+    uint8_t ucData[];
+} MpmcCell_t;
+
+typedef struct MpmcSide
+{
+    _Atomic UBaseType_t uxWaiters;  /* Number of tasks registered as (about to be) blocked on this side */
+    SemaphoreHandle_t xWakeSem;     /* Counting semaphore the waiters block on */
+} MpmcSide_t;
+
+typedef struct MpmcQueueDefinition
+{
+    _Atomic UBaseType_t uxEnqueuePos;
+    _Atomic UBaseType_t uxDequeuePos;
+    MpmcSide_t xReceivers;          /* Tasks waiting for an item */
+    MpmcSide_t xSenders;            /* Tasks waiting for a free cell */
+    UBaseType_t uxMask;             /* uxLength - 1 */
+    UBaseType_t uxItemSize;
+    size_t xCellStride;
+    uint8_t * pucCells;
+} MpmcQueue_t;
+
+/* ------------------------------------------------- Helpers ------------------------------------------------------ */
+
+static inline MpmcCell_t * prvGetCell( const MpmcQueue_t * pxQueue,
+                                       UBaseType_t uxPos )
+{
+    return ( MpmcCell_t * ) ( pxQueue->pucCells + ( ( uxPos & pxQueue->uxMask ) * pxQueue->xCellStride ) );
+}
+
+static BaseType_t prvTryEnqueue( MpmcQueue_t * pxQueue,
+                                 const void * pvItemToQueue )
+{
+    MpmcCell_t * pxCell;
+    UBaseType_t uxPos = atomic_load_explicit( &pxQueue->uxEnqueuePos, memory_order_relaxed );
+
+    for( ; ; )
+    {
+        pxCell = prvGetCell( pxQueue, uxPos );
+        const UBaseType_t uxSeq = atomic_load_explicit( &pxCell->uxSequence, memory_order_acquire );
+        const BaseType_t xDiff = ( BaseType_t ) ( uxSeq - uxPos );
+
+        if( xDiff == 0 )
+        {
+            /* Cell is free for this lap. Try to claim the position. */
+            if( atomic_compare_exchange_weak_explicit( &pxQueue->uxEnqueuePos, &uxPos, uxPos + 1,
+                                                       memory_order_relaxed, memory_order_relaxed ) )
+            {
+                break;
+            }
+        }
+        else if( xDiff < 0 )
+        {
+            /* Cell still holds an item from the previous lap. Queue is full. */
+            return pdFALSE;
+        }
+        else
+        {
+            /* Another producer claimed this position. Reload and retry. */
+            uxPos = atomic_load_explicit( &pxQueue->uxEnqueuePos, memory_order_relaxed );
+        }
+    }
+
+    memcpy( pxCell->ucData, pvItemToQueue, pxQueue->uxItemSize );
+    atomic_store_explicit( &pxCell->uxSequence, uxPos + 1, memory_order_release );
+
+    return pdTRUE;
+}
+
+static BaseType_t prvTryDequeue( MpmcQueue_t * pxQueue,
+                                 void * pvBuffer )
+{
+    MpmcCell_t * pxCell;
+    UBaseType_t uxPos = atomic_load_explicit( &pxQueue->uxDequeuePos, memory_order_relaxed );
+
+    for( ; ; )
+    {
+        pxCell = prvGetCell( pxQueue, uxPos );
+        const UBaseType_t uxSeq = atomic_load_explicit( &pxCell->uxSequence, memory_order_acquire );
+        const BaseType_t xDiff = ( BaseType_t ) ( uxSeq - ( uxPos + 1 ) );
+
+        if( xDiff == 0 )
+        {
+            /* Cell holds an item for this lap. Try to claim the position. */
+            if( atomic_compare_exchange_weak_explicit( &pxQueue->uxDequeuePos, &uxPos, uxPos + 1,
+                                                       memory_order_relaxed, memory_order_relaxed ) )
+            {
+                break;
+            }
+        }
+        else if( xDiff < 0 )
+        {
+            /* Cell has not been written yet. Queue is empty. */
+            return pdFALSE;
+        }
+        else
+        {
+            /* Another consumer claimed this position. Reload and retry. */
+            uxPos = atomic_load_explicit( &pxQueue->uxDequeuePos, memory_order_relaxed );
+        }
+    }
+
+    memcpy( pvBuffer, pxCell->ucData, pxQueue->uxItemSize );
+    atomic_store_explicit( &pxCell->uxSequence, uxPos + pxQueue->uxMask + 1, memory_order_release );
+
+    return pdTRUE;
+}
+
+/* Atomically decrement a non-zero waiter count. Returns pdFALSE if it was already zero. */
+static inline BaseType_t prvClaimWaiter( MpmcSide_t * pxSide )
+{
+    UBaseType_t uxWaiters = atomic_load_explicit( &pxSide->uxWaiters, memory_order_relaxed );
+
+    while( uxWaiters > 0 )
+    {
+        if( atomic_compare_exchange_weak_explicit( &pxSide->uxWaiters, &uxWaiters, uxWaiters - 1,
+                                                   memory_order_relaxed, memory_order_relaxed ) )
+        {
+            return pdTRUE;
+        }
+    }
+
+    return pdFALSE;
+}
+
+/* Called after publishing a cell. Wakes one task waiting on the opposite side, if any. */
+static inline void prvWakeOne( MpmcSide_t * pxSide,
+                               BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    atomic_thread_fence( memory_order_seq_cst );
+
+    if( prvClaimWaiter( pxSide ) != pdFALSE )
+    {
+        if( pxHigherPriorityTaskWoken == NULL )
+        {
+            ( void ) xSemaphoreGive( pxSide->xWakeSem );
+        }
+        else
+        {
+            ( void ) xSemaphoreGiveFromISR( pxSide->xWakeSem, pxHigherPriorityTaskWoken );
+        }
+    }
+}
+
+/*
+ * Try an operation, blocking on pxSide until it succeeds or xTicksToWait
+ * expires.
+ */
+static BaseType_t prvBlockingOp( MpmcQueue_t * pxQueue,
+                                 BaseType_t ( * xTryOp )( MpmcQueue_t *, void * ),
+                                 void * pvArg,
+                                 MpmcSide_t * pxSide,
+                                 TickType_t xTicksToWait )
+{
+    TimeOut_t xTimeOut;
+
+    if( xTryOp( pxQueue, pvArg ) != pdFALSE )
+    {
+        return pdTRUE;
+    }
+
+    if( xTicksToWait == ( TickType_t ) 0 )
+    {
+        return pdFALSE;
+    }
+
+    vTaskSetTimeOutState( &xTimeOut );
+
+    for( ; ; )
+    {
+        /* Register as a waiter, then re-check to close the race with the other side */
+        atomic_fetch_add_explicit( &pxSide->uxWaiters, 1, memory_order_relaxed );
+        atomic_thread_fence( memory_order_seq_cst );
+
+        if( xTryOp( pxQueue, pvArg ) != pdFALSE )
+        {
+            ( void ) prvClaimWaiter( pxSide );
+            return pdTRUE;
+        }
+
+        if( xSemaphoreTake( pxSide->xWakeSem, xTicksToWait ) == pdFALSE )
+        {
+            /* Timed out. Withdraw our registration and have one last try. */
+            ( void ) prvClaimWaiter( pxSide );
+            return xTryOp( pxQueue, pvArg );
+        }
+
+        if( xTryOp( pxQueue, pvArg ) != pdFALSE )
+        {
+            return pdTRUE;
+        }
+
+        /* Spurious wake-up, or another task got there first */
+        if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+        {
+            return pdFALSE;
+        }
+    }
+}
+
+static BaseType_t prvTryEnqueueOp( MpmcQueue_t * pxQueue,
+                                   void * pvArg )
+{
+    return prvTryEnqueue( pxQueue, ( const void * ) pvArg );
+}
+
+/* ------------------------------------------------ Public API ---------------------------------------------------- */
+
+MpmcQueueHandle_t xMpmcQueueCreate( UBaseType_t uxQueueLength,
+                                    UBaseType_t uxItemSize )
+{
+    MpmcQueue_t * pxQueue;
+    size_t xCellStride;
+
+    /* Length must be a power of two so that positions can be masked */
+    configASSERT( ( uxQueueLength >= 2 ) && ( ( uxQueueLength & ( uxQueueLength - 1 ) ) == 0 ) );
+    configASSERT( uxItemSize > 0 );
+
+    xCellStride = sizeof( MpmcCell_t ) + ( ( uxItemSize + mpmcCELL_ALIGN - 1 ) & ~( mpmcCELL_ALIGN - 1 ) );
+
+    /* Check for multiplication overflow. */
+    if( ( SIZE_MAX - sizeof( MpmcQueue_t ) ) / uxQueueLength < xCellStride )
+    {
+        return NULL;
+    }
+
+    pxQueue = pvPortMalloc( sizeof( MpmcQueue_t ) + ( uxQueueLength * xCellStride ) );
+
+    if( pxQueue == NULL )
+    {
+        return NULL;
+    }
+
+    /* The semaphores can never overflow. Each give is matched by a waiter. */
+    pxQueue->xReceivers.xWakeSem = xSemaphoreCreateCounting( UINT32_MAX, 0 );
+    pxQueue->xSenders.xWakeSem = xSemaphoreCreateCounting( UINT32_MAX, 0 );
+
+    if( ( pxQueue->xReceivers.xWakeSem == NULL ) || ( pxQueue->xSenders.xWakeSem == NULL ) )
+    {
+        if( pxQueue->xReceivers.xWakeSem != NULL )
+        {
+            vSemaphoreDelete( pxQueue->xReceivers.xWakeSem );
+        }
+
+        if( pxQueue->xSenders.xWakeSem != NULL )
+        {
+            vSemaphoreDelete( pxQueue->xSenders.xWakeSem );
+        }
+
+        vPortFree( pxQueue );
+        return NULL;
+    }
+
+    atomic_init( &pxQueue->uxEnqueuePos, 0 );
+    atomic_init( &pxQueue->uxDequeuePos, 0 );
+    atomic_init( &pxQueue->xReceivers.uxWaiters, 0 );
+    atomic_init( &pxQueue->xSenders.uxWaiters, 0 );
+    pxQueue->uxMask = uxQueueLength - 1;
+    pxQueue->uxItemSize = uxItemSize;
+    pxQueue->xCellStride = xCellStride;
+    pxQueue->pucCells = ( uint8_t * ) ( pxQueue + 1 );
+
+    for( UBaseType_t i = 0; i < uxQueueLength; i++ )
+    {
+        atomic_init( &prvGetCell( pxQueue, i )->uxSequence, i );
+    }
+
+    return pxQueue;
+}
+/*----------------------------------------------------------*/
+
+void vMpmcQueueDelete( MpmcQueueHandle_t xQueue )
+{
+    configASSERT( xQueue );
+
+    vSemaphoreDelete( xQueue->xReceivers.xWakeSem );
+    vSemaphoreDelete( xQueue->xSenders.xWakeSem );
+    vPortFree( xQueue );
+}
+/*----------------------------------------------------------*/
+
+BaseType_t xMpmcQueueSend( MpmcQueueHandle_t xQueue,
+                           const void * pvItemToQueue,
+                           TickType_t xTicksToWait )
+{
+    configASSERT( xQueue );
+    configASSERT( pvItemToQueue );
+
+    if( prvBlockingOp( xQueue, prvTryEnqueueOp, ( void * ) pvItemToQueue, &xQueue->xSenders, xTicksToWait ) == pdFALSE )
+    {
+        return errQUEUE_FULL;
+    }
+
+    prvWakeOne( &xQueue->xReceivers, NULL );
+
+    return pdPASS;
+}
+/*----------------------------------------------------------*/
+
+BaseType_t xMpmcQueueReceive( MpmcQueueHandle_t xQueue,
+                              void * pvBuffer,
+                              TickType_t xTicksToWait )
+{
+    configASSERT( xQueue );
+    configASSERT( pvBuffer );
+
+    if( prvBlockingOp( xQueue, prvTryDequeue, pvBuffer, &xQueue->xReceivers, xTicksToWait ) == pdFALSE )
+    {
+        return errQUEUE_EMPTY;
+    }
+
+    prvWakeOne( &xQueue->xSenders, NULL );
+
+    return pdPASS;
+}
+/*----------------------------------------------------------*/
+
+BaseType_t xMpmcQueueSendFromISR( MpmcQueueHandle_t xQueue,
+                                  const void * pvItemToQueue,
+                                  BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    BaseType_t xDummy = pdFALSE;
+
+    configASSERT( xQueue );
+    configASSERT( pvItemToQueue );
+
+    if( prvTryEnqueue( xQueue, pvItemToQueue ) == pdFALSE )
+    {
+        return errQUEUE_FULL;
+    }
+
+    prvWakeOne( &xQueue->xReceivers, ( pxHigherPriorityTaskWoken != NULL ) ? pxHigherPriorityTaskWoken : &xDummy );
+
+    return pdPASS;
+}
+/*----------------------------------------------------------*/
+
+BaseType_t xMpmcQueueReceiveFromISR( MpmcQueueHandle_t xQueue,
+                                     void * pvBuffer,
+                                     BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    BaseType_t xDummy = pdFALSE;
+
+    configASSERT( xQueue );
+    configASSERT( pvBuffer );
+
+    if( prvTryDequeue( xQueue, pvBuffer ) == pdFALSE )
+    {
+        return errQUEUE_EMPTY;
+    }
+
+    prvWakeOne( &xQueue->xSenders, ( pxHigherPriorityTaskWoken != NULL ) ? pxHigherPriorityTaskWoken : &xDummy );
+
+    return pdPASS;
+}
+/*----------------------------------------------------------*/
+
+UBaseType_t uxMpmcQueueMessagesWaiting( MpmcQueueHandle_t xQueue )
+{
+    const UBaseType_t uxDequeuePos = atomic_load_explicit( &xQueue->uxDequeuePos, memory_order_acquire );
+    const UBaseType_t uxEnqueuePos = atomic_load_explicit( &xQueue->uxEnqueuePos, memory_order_acquire );
+    const UBaseType_t uxCount = uxEnqueuePos - uxDequeuePos;
+
+    /* The two positions are not read atomically, so clamp the result */
+    return ( ( BaseType_t ) uxCount < 0 ) ? 0 : ( ( uxCount > xQueue->uxMask + 1 ) ? xQueue->uxMask + 1 : uxCount );
+}
+/*----------------------------------------------------------*/
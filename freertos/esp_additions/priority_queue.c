@@ -0,0 +1,338 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * This file contains the implementation of the priority-ordered message queue
+ * declared in priority_queue.h
+ *
+ * Storage is split in two:
+ *
+ * - A pool of uxLength item slots. Item payloads are copied into a slot once
+ *   on send and out of it once on receive. They never move while queued.
+ * - A binary max-heap of uxLength small entries (priority, sequence number,
+ *   slot index). Only these entries are swapped when sifting. The sequence
+ *   number breaks ties so that items of equal priority stay FIFO.
+ *
+ * Free slots are kept on a stack. The heap and the slot stack are protected by
+ * a spinlock. Blocking is delegated to two counting semaphores that track the
+ * number of items and the number of free slots. A sender takes a free slot
+ * token (blocking if the queue is full) before touching the heap and then
+ * gives an item token. A receiver does the reverse. The semaphores therefore
+ * provide the same priority ordered blocking, timeout and ISR semantics as a
+ * regular queue.
+ */
+
+#include "sdkconfig.h"
+#include <stdint.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/priority_queue.h"
+
+typedef struct PriorityQueueEntry
+{
+    UBaseType_t uxPriority;
+    uint32_t ulSequence;
+    UBaseType_t uxSlot;
+} PriorityQueueEntry_t;
+
+typedef struct PriorityQueueDefinition
+{
+    portMUX_TYPE xLock;
+    SemaphoreHandle_t xItems;           /* Counts queued items */
+    SemaphoreHandle_t xSpaces;          /* Counts free slots */
+    UBaseType_t uxLength;
+    UBaseType_t uxItemSize;
+    UBaseType_t uxCount;                /* Number of entries in the heap */
+    UBaseType_t uxFreeTop;              /* Number of entries on the free slot stack */
+    uint32_t ulNextSequence;
+    PriorityQueueEntry_t * pxHeap;
+    UBaseType_t * puxFreeSlots;
+    uint8_t * pucStorage;
+} PriorityQueue_t;
+
+/* ------------------------------------------------- Helpers ------------------------------------------------------ */
+
+/* Returns pdTRUE if entry A should be received before entry B */
+static inline BaseType_t prvEntryBefore( const PriorityQueueEntry_t * pxA,
+                                         const PriorityQueueEntry_t * pxB )
+{
+    if( pxA->uxPriority != pxB->uxPriority )
+    {
+        return ( pxA->uxPriority > pxB->uxPriority ) ? pdTRUE : pdFALSE;
+    }
+
+    /* Wrap-safe comparison of the sequence numbers */
+    return ( ( int32_t ) ( pxA->ulSequence - pxB->ulSequence ) < 0 ) ? pdTRUE : pdFALSE;
+}
+
+static void prvHeapPush( PriorityQueue_t * pxQueue,
+                         const PriorityQueueEntry_t * pxEntry )
+{
+    PriorityQueueEntry_t * pxHeap = pxQueue->pxHeap;
+    UBaseType_t uxIndex = pxQueue->uxCount++;
+
+    /* Sift the hole up until the parent is received before the new entry */
+    while( uxIndex > 0 )
+    {
+        const UBaseType_t uxParent = ( uxIndex - 1 ) / 2;
+
+        if( prvEntryBefore( &pxHeap[ uxParent ], pxEntry ) != pdFALSE )
+        {
+            break;
+        }
+
+        pxHeap[ uxIndex ] = pxHeap[ uxParent ];
+        uxIndex = uxParent;
+    }
+
+    pxHeap[ uxIndex ] = *pxEntry;
+}
+
+static void prvHeapPop( PriorityQueue_t * pxQueue,
+                        PriorityQueueEntry_t * pxEntry )
+{
+    PriorityQueueEntry_t * pxHeap = pxQueue->pxHeap;
+    const UBaseType_t uxCount = --pxQueue->uxCount;
+    const PriorityQueueEntry_t xLast = pxHeap[ uxCount ];
+    UBaseType_t uxIndex = 0;
+
+    *pxEntry = pxHeap[ 0 ];
+
+    /* Sift the hole at the root down until the last entry fits */
+    for( ; ; )
+    {
+        UBaseType_t uxChild = ( 2 * uxIndex ) + 1;
+
+        if( uxChild >= uxCount )
+        {
+            break;
+        }
+
+        if( ( uxChild + 1 < uxCount ) && ( prvEntryBefore( &pxHeap[ uxChild + 1 ], &pxHeap[ uxChild ] ) != pdFALSE ) )
+        {
+            uxChild++;
+        }
+
+        if( prvEntryBefore( &xLast, &pxHeap[ uxChild ] ) != pdFALSE )
+        {
+            break;
+        }
+
+        pxHeap[ uxIndex ] = pxHeap[ uxChild ];
+        uxIndex = uxChild;
+    }
+
+    pxHeap[ uxIndex ] = xLast;
+}
+
+/* Must be called with a free slot token taken from xSpaces */
+static void prvPush( PriorityQueue_t * pxQueue,
+                     const void * pvItemToQueue,
+                     UBaseType_t uxPriority )
+{
+    PriorityQueueEntry_t xEntry;
+
+    portENTER_CRITICAL_SAFE( &pxQueue->xLock );
+    {
+        configASSERT( pxQueue->uxFreeTop > 0 );
+        xEntry.uxPriority = uxPriority;
+        xEntry.ulSequence = pxQueue->ulNextSequence++;
+        xEntry.uxSlot = pxQueue->puxFreeSlots[ --pxQueue->uxFreeTop ];
+        memcpy( pxQueue->pucStorage + ( xEntry.uxSlot * pxQueue->uxItemSize ), pvItemToQueue, pxQueue->uxItemSize );
+        prvHeapPush( pxQueue, &xEntry );
+    }
+    portEXIT_CRITICAL_SAFE( &pxQueue->xLock );
+}
+
+/* Must be called with an item token taken from xItems */
+static void prvPop( PriorityQueue_t * pxQueue,
+                    void * pvBuffer,
+                    UBaseType_t * puxPriority )
+{
+    PriorityQueueEntry_t xEntry;
+
+    portENTER_CRITICAL_SAFE( &pxQueue->xLock );
+    {
+        configASSERT( pxQueue->uxCount > 0 );
+        prvHeapPop( pxQueue, &xEntry );
+        memcpy( pvBuffer, pxQueue->pucStorage + ( xEntry.uxSlot * pxQueue->uxItemSize ), pxQueue->uxItemSize );
+        pxQueue->puxFreeSlots[ pxQueue->uxFreeTop++ ] = xEntry.uxSlot;
+    }
+    portEXIT_CRITICAL_SAFE( &pxQueue->xLock );
+
+    if( puxPriority != NULL )
+    {
+        *puxPriority = xEntry.uxPriority;
+    }
+}
+
+/* ------------------------------------------------ Public API ---------------------------------------------------- */
+
+PriorityQueueHandle_t xPriorityQueueCreate( UBaseType_t uxQueueLength,
+                                            UBaseType_t uxItemSize )
+{
+    PriorityQueue_t * pxQueue;
+    size_t xPerItemSize;
+
+    configASSERT( uxQueueLength > 0 );
+    configASSERT( uxItemSize > 0 );
+
+    xPerItemSize = sizeof( PriorityQueueEntry_t ) + sizeof( UBaseType_t ) + uxItemSize;
+
+    /* Check for multiplication overflow. */
+    if( ( SIZE_MAX - sizeof( PriorityQueue_t ) ) / uxQueueLength < xPerItemSize )
+    {
+        return NULL;
+    }
+
+    /* Allocate the queue structure, heap, free slot stack and item storage in one go. The heap and the free slot
+     * stack come first so that they remain aligned. */
+    pxQueue = pvPortMalloc( sizeof( PriorityQueue_t ) + ( uxQueueLength * xPerItemSize ) );
+
+    if( pxQueue == NULL )
+    {
+        return NULL;
+    }
+
+    pxQueue->xItems = xSemaphoreCreateCounting( uxQueueLength, 0 );
+    pxQueue->xSpaces = xSemaphoreCreateCounting( uxQueueLength, uxQueueLength );
+
+    if( ( pxQueue->xItems == NULL ) || ( pxQueue->xSpaces == NULL ) )
+    {
+        if( pxQueue->xItems != NULL )
+        {
+            vSemaphoreDelete( pxQueue->xItems );
+        }
+
+        if( pxQueue->xSpaces != NULL )
+        {
+            vSemaphoreDelete( pxQueue->xSpaces );
+        }
+
+        vPortFree( pxQueue );
+        return NULL;
+    }
+
+    portMUX_INITIALIZE( &pxQueue->xLock );
+    pxQueue->uxLength = uxQueueLength;
+    pxQueue->uxItemSize = uxItemSize;
+    pxQueue->uxCount = 0;
+    pxQueue->ulNextSequence = 0;
+    pxQueue->pxHeap = ( PriorityQueueEntry_t * ) ( pxQueue + 1 );
+    pxQueue->puxFreeSlots = ( UBaseType_t * ) ( pxQueue->pxHeap + uxQueueLength );
+    pxQueue->pucStorage = ( uint8_t * ) ( pxQueue->puxFreeSlots + uxQueueLength );
+
+    /* Every slot starts out free */
+    for( UBaseType_t i = 0; i < uxQueueLength; i++ )
+    {
+        pxQueue->puxFreeSlots[ i ] = i;
+    }
+
+    pxQueue->uxFreeTop = uxQueueLength;
+
+    return pxQueue;
+}
+/*----------------------------------------------------------*/
+
+void vPriorityQueueDelete( PriorityQueueHandle_t xQueue )
+{
+    configASSERT( xQueue );
+
+    vSemaphoreDelete( xQueue->xItems );
+    vSemaphoreDelete( xQueue->xSpaces );
+    vPortFree( xQueue );
+}
+/*----------------------------------------------------------*/
+
+BaseType_t xPriorityQueueSend( PriorityQueueHandle_t xQueue,
+                               const void * pvItemToQueue,
+                               UBaseType_t uxPriority,
+                               TickType_t xTicksToWait )
+{
+    configASSERT( xQueue );
+    configASSERT( pvItemToQueue );
+
+    if( xSemaphoreTake( xQueue->xSpaces, xTicksToWait ) == pdFALSE )
+    {
+        return errQUEUE_FULL;
+    }
+
+    prvPush( xQueue, pvItemToQueue, uxPriority );
+    ( void ) xSemaphoreGive( xQueue->xItems );
+
+    return pdPASS;
+}
+/*----------------------------------------------------------*/
+
+BaseType_t xPriorityQueueReceive( PriorityQueueHandle_t xQueue,
+                                  void * pvBuffer,
+                                  UBaseType_t * puxPriority,
+                                  TickType_t xTicksToWait )
+{
+    configASSERT( xQueue );
+    configASSERT( pvBuffer );
+
+    if( xSemaphoreTake( xQueue->xItems, xTicksToWait ) == pdFALSE )
+    {
+        return errQUEUE_EMPTY;
+    }
+
+    prvPop( xQueue, pvBuffer, puxPriority );
+    ( void ) xSemaphoreGive( xQueue->xSpaces );
+
+    return pdPASS;
+}
+/*----------------------------------------------------------*/
+
+BaseType_t xPriorityQueueSendFromISR( PriorityQueueHandle_t xQueue,
+                                      const void * pvItemToQueue,
+                                      UBaseType_t uxPriority,
+                                      BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    configASSERT( xQueue );
+    configASSERT( pvItemToQueue );
+
+    if( xSemaphoreTakeFromISR( xQueue->xSpaces, NULL ) == pdFALSE )
+    {
+        return errQUEUE_FULL;
+    }
+
+    prvPush( xQueue, pvItemToQueue, uxPriority );
+    ( void ) xSemaphoreGiveFromISR( xQueue->xItems, pxHigherPriorityTaskWoken );
+
+    return pdPASS;
+}
+/*----------------------------------------------------------*/
+
+BaseType_t xPriorityQueueReceiveFromISR( PriorityQueueHandle_t xQueue,
+                                         void * pvBuffer,
+                                         UBaseType_t * puxPriority,
+                                         BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    configASSERT( xQueue );
+    configASSERT( pvBuffer );
+
+    if( xSemaphoreTakeFromISR( xQueue->xItems, NULL ) == pdFALSE )
+    {
+        return errQUEUE_EMPTY;
+    }
+
+    prvPop( xQueue, pvBuffer, puxPriority );
+    ( void ) xSemaphoreGiveFromISR( xQueue->xSpaces, pxHigherPriorityTaskWoken );
+
+    return pdPASS;
+}
+/*----------------------------------------------------------*/
+
+UBaseType_t uxPriorityQueueMessagesWaiting( PriorityQueueHandle_t xQueue )
+{
+    configASSERT( xQueue );
+
+    return uxSemaphoreGetCount( xQueue->xItems );
+}
+/*----------------------------------------------------------*/
@@ -0,0 +1,341 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * This file contains the implementation of the single-producer/single-consumer
+ * queue declared in spsc_queue.h
+ *
+ * The queue is a ring buffer of uxLength + 1 slots (one slot is always left
+ * empty to tell a full queue from an empty one).
+ *
+ * - uxRead is only ever written by the consumer
+ * - uxWrite is only ever written by the producer
+ *
+ * Each side publishes its index with a release store after copying an item, and
+ * reads the other side's index with an acquire load before copying an item. This
+ * makes the non-blocking paths wait-free.
+ *
+ * Blocking uses the same Dekker-style handshake on both sides: the waiting task
+ * first publishes its handle in pxWaitingReceiver/pxWaitingSender, then issues a
+ * full fence and re-checks the queue. The other side issues a full fence after
+ * publishing its index and then checks for a waiting task. Either the waiter
+ * sees the new item/space, or the other side sees the waiter, so a wake-up can
+ * never be lost.
+ */
+
+#include "sdkconfig.h"
+#include <stdatomic.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/spsc_queue.h"
+
+typedef struct SpscQueueDefinition
+{
+    _Atomic UBaseType_t uxRead;                 /* Index of the next slot to read. Written by the consumer only. */
+    _Atomic UBaseType_t uxWrite;                /* Index of the next slot to write. Written by the producer only. */
+    _Atomic( TaskHandle_t ) xWaitingReceiver;   /* Consumer blocked waiting for an item, or NULL. */
+    _Atomic( TaskHandle_t ) xWaitingSender;     /* Producer blocked waiting for space, or NULL. */
+    UBaseType_t uxSlots;                        /* Number of slots in pucStorage (i.e., queue length + 1). */
+    UBaseType_t uxItemSize;
+    uint8_t * pucStorage;
+} SpscQueue_t;
+
+/* ------------------------------------------------- Helpers ------------------------------------------------------ */
+
+static inline UBaseType_t prvNextIndex( const SpscQueue_t * pxQueue,
+                                        UBaseType_t uxIndex )
+{
+    uxIndex++;
+    return ( uxIndex == pxQueue->uxSlots ) ? 0 : uxIndex;
+}
+
+static inline BaseType_t prvTrySend( SpscQueue_t * pxQueue,
+                                     const void * pvItemToQueue )
+{
+    const UBaseType_t uxWrite = atomic_load_explicit( &pxQueue->uxWrite, memory_order_relaxed );
+    const UBaseType_t uxNext = prvNextIndex( pxQueue, uxWrite );
+
+    if( uxNext == atomic_load_explicit( &pxQueue->uxRead, memory_order_acquire ) )
+    {
+        return pdFALSE;
+    }
+
+    memcpy( &pxQueue->pucStorage[ uxWrite * pxQueue->uxItemSize ], pvItemToQueue, pxQueue->uxItemSize );
+    atomic_store_explicit( &pxQueue->uxWrite, uxNext, memory_order_release );
+
+    return pdTRUE;
+}
+
+static inline BaseType_t prvTryReceive( SpscQueue_t * pxQueue,
+                                        void * pvBuffer )
+{
+    const UBaseType_t uxRead = atomic_load_explicit( &pxQueue->uxRead, memory_order_relaxed );
+
+    if( uxRead == atomic_load_explicit( &pxQueue->uxWrite, memory_order_acquire ) )
+    {
+        return pdFALSE;
+    }
+
+    memcpy( pvBuffer, &pxQueue->pucStorage[ uxRead * pxQueue->uxItemSize ], pxQueue->uxItemSize );
+    atomic_store_explicit( &pxQueue->uxRead, prvNextIndex( pxQueue, uxRead ), memory_order_release );
+
+    return pdTRUE;
+}
+
+/*
+ * Claim the task (if any) waiting on the other side of the queue. The fence
+ * pairs with the fence in prvBlockOn() and must follow the release store of
+ * our index. The exchange guarantees that a waiter is notified exactly once,
+ * even if it concurrently times out and clears the slot itself.
+ */
+static inline TaskHandle_t prvClaimWaiter( _Atomic( TaskHandle_t ) * pxWaiter )
+{
+    atomic_thread_fence( memory_order_seq_cst );
+
+    if( atomic_load_explicit( pxWaiter, memory_order_relaxed ) == NULL )
+    {
+        return NULL;
+    }
+
+    return atomic_exchange_explicit( pxWaiter, NULL, memory_order_relaxed );
+}
+
+/*
+ * Block the calling task until notified by the other side of the queue or until
+ * xTicksToWait expires. xIsReady() is re-evaluated after publishing the waiter
+ * to close the race with the other side.
+ */
+static void prvBlockOn( SpscQueue_t * pxQueue,
+                        _Atomic( TaskHandle_t ) * pxWaiter,
+                        BaseType_t ( * xIsReady )( const SpscQueue_t * ),
+                        TickType_t xTicksToWait )
+{
+    ( void ) xTaskNotifyStateClear( NULL );
+    atomic_store_explicit( pxWaiter, xTaskGetCurrentTaskHandle(), memory_order_relaxed );
+    atomic_thread_fence( memory_order_seq_cst );
+
+    if( xIsReady( pxQueue ) == pdFALSE )
+    {
+        ( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+    }
+
+    /* Withdraw from the waiter slot in case we timed out (or never blocked). */
+    atomic_store_explicit( pxWaiter, NULL, memory_order_relaxed );
+}
+
+static BaseType_t prvHasData( const SpscQueue_t * pxQueue )
+{
+    return ( atomic_load_explicit( &pxQueue->uxRead, memory_order_relaxed ) !=
+             atomic_load_explicit( &pxQueue->uxWrite, memory_order_relaxed ) ) ? pdTRUE : pdFALSE;
+}
+
+static BaseType_t prvHasSpace( const SpscQueue_t * pxQueue )
+{
+    return ( prvNextIndex( pxQueue, atomic_load_explicit( &pxQueue->uxWrite, memory_order_relaxed ) ) !=
+             atomic_load_explicit( &pxQueue->uxRead, memory_order_relaxed ) ) ? pdTRUE : pdFALSE;
+}
+
+/* ------------------------------------------------ Public API ---------------------------------------------------- */
+
+SpscQueueHandle_t xSpscQueueCreate( UBaseType_t uxQueueLength,
+                                    UBaseType_t uxItemSize )
+{
+    SpscQueue_t * pxQueue;
+    size_t xStorageSize;
+
+    configASSERT( uxQueueLength > 0 );
+    configASSERT( uxItemSize > 0 );
+
+    /* Check for multiplication overflow. */
+    if( ( SIZE_MAX / ( uxQueueLength + 1 ) ) < uxItemSize )
+    {
+        return NULL;
+    }
+
+    xStorageSize = ( size_t ) ( uxQueueLength + 1 ) * uxItemSize;
+    pxQueue = pvPortMalloc( sizeof( SpscQueue_t ) + xStorageSize );
+
+    if( pxQueue != NULL )
+    {
+        atomic_init( &pxQueue->uxRead, 0 );
+        atomic_init( &pxQueue->uxWrite, 0 );
+        atomic_init( &pxQueue->xWaitingReceiver, NULL );
+        atomic_init( &pxQueue->xWaitingSender, NULL );
+        pxQueue->uxSlots = uxQueueLength + 1;
+        pxQueue->uxItemSize = uxItemSize;
+        pxQueue->pucStorage = ( uint8_t * ) ( pxQueue + 1 );
+    }
+
+    return pxQueue;
+}
+/*----------------------------------------------------------*/
+
+void vSpscQueueDelete( SpscQueueHandle_t xQueue )
+{
+    configASSERT( xQueue );
+    configASSERT( atomic_load( &xQueue->xWaitingReceiver ) == NULL );
+    configASSERT( atomic_load( &xQueue->xWaitingSender ) == NULL );
+
+    vPortFree( xQueue );
+}
+/*----------------------------------------------------------*/
+
+BaseType_t xSpscQueueSend( SpscQueueHandle_t xQueue,
+                           const void * pvItemToQueue,
+                           TickType_t xTicksToWait )
+{
+    SpscQueue_t * const pxQueue = xQueue;
+    TimeOut_t xTimeOut;
+    TaskHandle_t xReceiver;
+
+    configASSERT( pxQueue );
+    configASSERT( pvItemToQueue );
+
+    if( prvTrySend( pxQueue, pvItemToQueue ) == pdFALSE )
+    {
+        if( xTicksToWait == ( TickType_t ) 0 )
+        {
+            return errQUEUE_FULL;
+        }
+
+        vTaskSetTimeOutState( &xTimeOut );
+
+        do
+        {
+            prvBlockOn( pxQueue, &pxQueue->xWaitingSender, prvHasSpace, xTicksToWait );
+
+            if( prvTrySend( pxQueue, pvItemToQueue ) != pdFALSE )
+            {
+                break;
+            }
+
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+            {
+                return errQUEUE_FULL;
+            }
+        } while( pdTRUE );
+    }
+
+    xReceiver = prvClaimWaiter( &pxQueue->xWaitingReceiver );
+
+    if( xReceiver != NULL )
+    {
+        ( void ) xTaskNotify( xReceiver, ( uint32_t ) 0, eNoAction );
+    }
+
+    return pdPASS;
+}
+/*----------------------------------------------------------*/
+
+BaseType_t xSpscQueueReceive( SpscQueueHandle_t xQueue,
+                              void * pvBuffer,
+                              TickType_t xTicksToWait )
+{
+    SpscQueue_t * const pxQueue = xQueue;
+    TimeOut_t xTimeOut;
+    TaskHandle_t xSender;
+
+    configASSERT( pxQueue );
+    configASSERT( pvBuffer );
+
+    if( prvTryReceive( pxQueue, pvBuffer ) == pdFALSE )
+    {
+        if( xTicksToWait == ( TickType_t ) 0 )
+        {
+            return errQUEUE_EMPTY;
+        }
+
+        vTaskSetTimeOutState( &xTimeOut );
+
+        do
+        {
+            prvBlockOn( pxQueue, &pxQueue->xWaitingReceiver, prvHasData, xTicksToWait );
+
+            if( prvTryReceive( pxQueue, pvBuffer ) != pdFALSE )
+            {
+                break;
+            }
+
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+            {
+                return errQUEUE_EMPTY;
+            }
+        } while( pdTRUE );
+    }
+
+    xSender = prvClaimWaiter( &pxQueue->xWaitingSender );
+
+    if( xSender != NULL )
+    {
+        ( void ) xTaskNotify( xSender, ( uint32_t ) 0, eNoAction );
+    }
+
+    return pdPASS;
+}
+/*----------------------------------------------------------*/
+
+BaseType_t xSpscQueueSendFromISR( SpscQueueHandle_t xQueue,
+                                  const void * pvItemToQueue,
+                                  BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    SpscQueue_t * const pxQueue = xQueue;
+    TaskHandle_t xReceiver;
+
+    configASSERT( pxQueue );
+    configASSERT( pvItemToQueue );
+
+    if( prvTrySend( pxQueue, pvItemToQueue ) == pdFALSE )
+    {
+        return errQUEUE_FULL;
+    }
+
+    xReceiver = prvClaimWaiter( &pxQueue->xWaitingReceiver );
+
+    if( xReceiver != NULL )
+    {
+        ( void ) xTaskNotifyFromISR( xReceiver, ( uint32_t ) 0, eNoAction, pxHigherPriorityTaskWoken );
+    }
+
+    return pdPASS;
+}
+/*----------------------------------------------------------*/
+
+BaseType_t xSpscQueueReceiveFromISR( SpscQueueHandle_t xQueue,
+                                     void * pvBuffer,
+                                     BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    SpscQueue_t * const pxQueue = xQueue;
+    TaskHandle_t xSender;
+
+    configASSERT( pxQueue );
+    configASSERT( pvBuffer );
+
+    if( prvTryReceive( pxQueue, pvBuffer ) == pdFALSE )
+    {
+        return errQUEUE_EMPTY;
+    }
+
+    xSender = prvClaimWaiter( &pxQueue->xWaitingSender );
+
+    if( xSender != NULL )
+    {
+        ( void ) xTaskNotifyFromISR( xSender, ( uint32_t ) 0, eNoAction, pxHigherPriorityTaskWoken );
+    }
+
+    return pdPASS;
+}
+/*----------------------------------------------------------*/
+
+UBaseType_t uxSpscQueueMessagesWaiting( SpscQueueHandle_t xQueue )
+{
+    const UBaseType_t uxRead = atomic_load_explicit( &xQueue->uxRead, memory_order_acquire );
+    const UBaseType_t uxWrite = atomic_load_explicit( &xQueue->uxWrite, memory_order_acquire );
+
+    return ( uxWrite >= uxRead ) ? ( uxWrite - uxRead ) : ( xQueue->uxSlots - uxRead + uxWrite );
+}
+/*----------------------------------------------------------*/
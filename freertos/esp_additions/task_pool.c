@@ -0,0 +1,258 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * This file contains the implementation of the task pools declared in
+ * task_pool.h
+ *
+ * Each pool is a single allocation holding the pool structure, the TCBs, a
+ * stack of free slot indexes and the stacks. Taking a slot pops an index from
+ * the free stack, and giving it back pushes the index again, so both are
+ * constant time. Tasks are created with prvTaskCreateReclaimablePinnedToCore()
+ * using the slot's TCB and stack, so that the kernel offers them to the reclaim
+ * hook once the task is deleted (which it does not for statically allocated
+ * tasks).
+ *
+ * Slots are given back by the task pools' own memory reclaim hook, which is
+ * called by the kernel once it no longer uses a deleted task's TCB and stack,
+ * before the application's hook (if any). The hook finds
+ * the pool owning the TCB by checking the address range of each pool's TCBs,
+ * as there is typically only one pool per stack size class.
+ */
+
+#include "sdkconfig.h"
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/idf_additions.h"
+#include "freertos/task_pool.h"
+#include "esp_private/freertos_idf_additions_priv.h"
+
+/* Each stack is rounded up so that every slot's stack starts aligned */
+#define taskpoolSTACK_ALIGN    ( ( size_t ) portBYTE_ALIGNMENT )
+
+typedef struct TaskPoolDefinition
+{
+    struct TaskPoolDefinition * pxNext; /* Next pool in the list of pools checked by the reclaim hook */
+    StaticTask_t * pxTCBs;
+    UBaseType_t * puxFreeSlots;         /* Stack of the indexes of the free slots */
+    uint8_t * pucStacks;
+    size_t xStackStride;
+    uint32_t ulStackDepth;
+    UBaseType_t uxFreeTop;              /* Number of free slots */
+    TaskPoolStats_t xStats;
+} TaskPool_t;
+
+/* List of all pools. Also protects the free slots and statistics of every pool. */
+static TaskPool_t * pxTaskPools = NULL;
+static portMUX_TYPE xTaskPoolsLock = portMUX_INITIALIZER_UNLOCKED;
+
+/* ------------------------------------------------- Helpers ------------------------------------------------------ */
+
+static BaseType_t prvTaskPoolReclaimHook( TaskHandle_t xTask,
+                                          StackType_t * pxStack )
+{
+    const StaticTask_t * pxTCB = ( const StaticTask_t * ) xTask;
+    BaseType_t xReclaimed = pdFALSE;
+    TaskPool_t * pxPool;
+
+    taskENTER_CRITICAL( &xTaskPoolsLock );
+    {
+        for( pxPool = pxTaskPools; pxPool != NULL; pxPool = pxPool->pxNext )
+        {
+            if( ( pxTCB >= pxPool->pxTCBs ) && ( pxTCB < pxPool->pxTCBs + pxPool->xStats.uxCapacity ) )
+            {
+                const UBaseType_t uxSlot = ( UBaseType_t ) ( pxTCB - pxPool->pxTCBs );
+
+                configASSERT( ( uint8_t * ) pxStack == pxPool->pucStacks + ( uxSlot * pxPool->xStackStride ) );
+                configASSERT( pxPool->uxFreeTop < pxPool->xStats.uxCapacity );
+
+                pxPool->puxFreeSlots[ pxPool->uxFreeTop++ ] = uxSlot;
+                pxPool->xStats.uxInUse--;
+                xReclaimed = pdTRUE;
+                break;
+            }
+        }
+    }
+    taskEXIT_CRITICAL( &xTaskPoolsLock );
+
+    return xReclaimed;
+}
+
+/* ------------------------------------------------ Public API ---------------------------------------------------- */
+
+TaskPoolHandle_t xTaskPoolCreate( UBaseType_t uxNumTasks,
+                                  const uint32_t ulStackDepth )
+{
+    TaskPool_t * pxPool;
+    size_t xHeaderSize;
+    size_t xStackStride;
+    UBaseType_t uxSlot;
+    BaseType_t xFirstPool;
+
+    configASSERT( uxNumTasks > 0 );
+    configASSERT( ulStackDepth > 0 );
+
+    /* The kernel uses ulStackDepth elements of StackType_t (which is a byte on the chip ports) */
+    xStackStride = ( ( ( size_t ) ulStackDepth * sizeof( StackType_t ) ) + taskpoolSTACK_ALIGN - 1 ) & ~( taskpoolSTACK_ALIGN - 1 );
+    xHeaderSize = sizeof( TaskPool_t ) + ( uxNumTasks * ( sizeof( StaticTask_t ) + sizeof( UBaseType_t ) ) );
+    xHeaderSize = ( xHeaderSize + taskpoolSTACK_ALIGN - 1 ) & ~( taskpoolSTACK_ALIGN - 1 );
+
+    /* Check for multiplication overflow. */
+    if( ( SIZE_MAX - xHeaderSize ) / uxNumTasks < xStackStride )
+    {
+        return NULL;
+    }
+
+    /* Allocate the pool structure, TCBs, free slot stack and stacks in one go. The TCBs come first so that they
+     * remain aligned. The stacks start at an aligned offset (the allocation itself may be less aligned, in which case
+     * the kernel aligns the top of each stack). */
+    pxPool = pvPortMalloc( xHeaderSize + ( uxNumTasks * xStackStride ) );
+
+    if( pxPool == NULL )
+    {
+        return NULL;
+    }
+
+    pxPool->pxTCBs = ( StaticTask_t * ) ( pxPool + 1 );
+    pxPool->puxFreeSlots = ( UBaseType_t * ) ( pxPool->pxTCBs + uxNumTasks );
+    pxPool->pucStacks = ( uint8_t * ) pxPool + xHeaderSize;
+    pxPool->xStackStride = xStackStride;
+    pxPool->ulStackDepth = ulStackDepth;
+    pxPool->uxFreeTop = uxNumTasks;
+    pxPool->xStats.uxCapacity = uxNumTasks;
+    pxPool->xStats.uxInUse = 0;
+    pxPool->xStats.uxPeakInUse = 0;
+    pxPool->xStats.uxAllocFailures = 0;
+
+    /* Hand out the lowest slots first */
+    for( uxSlot = 0; uxSlot < uxNumTasks; uxSlot++ )
+    {
+        pxPool->puxFreeSlots[ uxSlot ] = uxNumTasks - 1 - uxSlot;
+    }
+
+    taskENTER_CRITICAL( &xTaskPoolsLock );
+    {
+        xFirstPool = ( pxTaskPools == NULL ) ? pdTRUE : pdFALSE;
+        pxPool->pxNext = pxTaskPools;
+        pxTaskPools = pxPool;
+    }
+    taskEXIT_CRITICAL( &xTaskPoolsLock );
+
+    if( xFirstPool != pdFALSE )
+    {
+        prvTaskSetPoolReclaimHook( prvTaskPoolReclaimHook );
+    }
+
+    return pxPool;
+}
+/*----------------------------------------------------------*/
+
+BaseType_t xTaskPoolDelete( TaskPoolHandle_t xPool )
+{
+    TaskPool_t * pxPool = xPool;
+    TaskPool_t ** ppxLink;
+    BaseType_t xReturn = pdFAIL;
+
+    configASSERT( pxPool );
+
+    taskENTER_CRITICAL( &xTaskPoolsLock );
+    {
+        if( pxPool->xStats.uxInUse == 0 )
+        {
+            for( ppxLink = &pxTaskPools; *ppxLink != NULL; ppxLink = &( *ppxLink )->pxNext )
+            {
+                if( *ppxLink == pxPool )
+                {
+                    *ppxLink = pxPool->pxNext;
+                    break;
+                }
+            }
+
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL( &xTaskPoolsLock );
+
+    if( xReturn == pdPASS )
+    {
+        vPortFree( pxPool );
+    }
+
+    return xReturn;
+}
+/*----------------------------------------------------------*/
+
+BaseType_t xTaskCreateFromPool( TaskPoolHandle_t xPool,
+                                TaskFunction_t pxTaskCode,
+                                const char * const pcName,
+                                void * const pvParameters,
+                                UBaseType_t uxPriority,
+                                TaskHandle_t * const pxCreatedTask,
+                                const BaseType_t xCoreID )
+{
+    TaskPool_t * pxPool = xPool;
+    TaskHandle_t xTask;
+    UBaseType_t uxSlot = 0;
+    BaseType_t xTaken = pdFALSE;
+
+    configASSERT( pxPool );
+
+    taskENTER_CRITICAL( &xTaskPoolsLock );
+    {
+        if( pxPool->uxFreeTop > 0 )
+        {
+            uxSlot = pxPool->puxFreeSlots[ --pxPool->uxFreeTop ];
+            pxPool->xStats.uxInUse++;
+
+            if( pxPool->xStats.uxInUse > pxPool->xStats.uxPeakInUse )
+            {
+                pxPool->xStats.uxPeakInUse = pxPool->xStats.uxInUse;
+            }
+
+            xTaken = pdTRUE;
+        }
+        else
+        {
+            pxPool->xStats.uxAllocFailures++;
+        }
+    }
+    taskEXIT_CRITICAL( &xTaskPoolsLock );
+
+    if( xTaken == pdFALSE )
+    {
+        return errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+    }
+
+    /* With both buffers provided, task creation cannot fail */
+    xTask = prvTaskCreateReclaimablePinnedToCore( pxTaskCode, pcName, pxPool->ulStackDepth, pvParameters, uxPriority,
+                                                  ( StackType_t * ) ( pxPool->pucStacks + ( uxSlot * pxPool->xStackStride ) ),
+                                                  &pxPool->pxTCBs[ uxSlot ], xCoreID );
+    configASSERT( xTask != NULL );
+
+    if( pxCreatedTask != NULL )
+    {
+        *pxCreatedTask = xTask;
+    }
+
+    return pdPASS;
+}
+/*----------------------------------------------------------*/
+
+void vTaskPoolGetStats( TaskPoolHandle_t xPool,
+                        TaskPoolStats_t * pxStats )
+{
+    TaskPool_t * pxPool = xPool;
+
+    configASSERT( pxPool );
+    configASSERT( pxStats );
+
+    taskENTER_CRITICAL( &xTaskPoolsLock );
+    {
+        *pxStats = pxPool->xStats;
+    }
+    taskEXIT_CRITICAL( &xTaskPoolsLock );
+}
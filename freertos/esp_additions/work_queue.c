@@ -0,0 +1,327 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * This file contains the implementation of the work queue declared in
+ * work_queue.h
+ *
+ * Pending jobs are kept in portNUM_PROCESSORS * uxNumJobPriorities MPMC
+ * queues. Every submitted job is matched by one give of the xPending counting
+ * semaphore, which idle workers block on. A worker that takes the semaphore is
+ * thus owed exactly one job, which it looks for by scanning the queues of its
+ * own core from the highest job priority down, then those of the other cores
+ * (i.e., stealing). As jobs are sent before the semaphore is given, the number
+ * of workers owed a job never exceeds the number of jobs in the queues. A scan
+ * can still come up empty though: an MPMC queue only hands out its items in
+ * order, so a job sent after the cell of a preempted submitter was reserved
+ * stays hidden until that submitter has written its cell. The worker then
+ * sleeps for a tick and scans again, which lets the submitter run even if it
+ * has a lower priority than the worker.
+ *
+ * To delete the work queue, the xStopping flag is set and the semaphore given
+ * once per worker. A worker that is owed a job but finds none while stopping
+ * exits.
+ */
+
+#include "sdkconfig.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/mpmc_queue.h"
+#include "freertos/work_queue.h"
+
+typedef struct WorkJob
+{
+    WorkFunction_t pxFunction;
+    void * pvArg;
+    WorkFuture_t * pxFuture;
+} WorkJob_t;
+
+typedef struct WorkQueueDefinition
+{
+    SemaphoreHandle_t xPending;  /* Counts the jobs not yet claimed by a worker */
+    SemaphoreHandle_t xExited;   /* Given by each worker as it exits */
+    _Atomic BaseType_t xStopping;
+    UBaseType_t uxNumWorkers;
+    UBaseType_t uxNumJobPriorities;
+    UBaseType_t uxNotifyIndex;
+    MpmcQueueHandle_t * pxQueues; /* Indexed by ( core * uxNumJobPriorities ) + job priority */
+} WorkQueue_t;
+
+/* ------------------------------------------------- Helpers ------------------------------------------------------ */
+
+static inline MpmcQueueHandle_t prvGetQueue( const WorkQueue_t * pxWorkQueue,
+                                             BaseType_t xCoreID,
+                                             UBaseType_t uxJobPriority )
+{
+    return pxWorkQueue->pxQueues[ ( ( UBaseType_t ) xCoreID * pxWorkQueue->uxNumJobPriorities ) + uxJobPriority ];
+}
+
+static BaseType_t prvTakeJob( const WorkQueue_t * pxWorkQueue,
+                              WorkJob_t * pxJob )
+{
+    const BaseType_t xHomeCore = ( BaseType_t ) xPortGetCoreID();
+
+    for( BaseType_t i = 0; i < portNUM_PROCESSORS; i++ )
+    {
+        /* Start with the current core, then steal from the others */
+        const BaseType_t xCoreID = ( xHomeCore + i ) % portNUM_PROCESSORS;
+
+        for( UBaseType_t uxJobPriority = pxWorkQueue->uxNumJobPriorities; uxJobPriority > 0; uxJobPriority-- )
+        {
+            if( xMpmcQueueReceive( prvGetQueue( pxWorkQueue, xCoreID, uxJobPriority - 1 ), pxJob, 0 ) == pdPASS )
+            {
+                return pdPASS;
+            }
+        }
+    }
+
+    return pdFAIL;
+}
+
+static void prvWorkerTask( void * pvParameters )
+{
+    WorkQueue_t * pxWorkQueue = ( WorkQueue_t * ) pvParameters;
+    WorkJob_t xJob;
+
+    for( ; ; )
+    {
+        ( void ) xSemaphoreTake( pxWorkQueue->xPending, portMAX_DELAY );
+
+        while( prvTakeJob( pxWorkQueue, &xJob ) == pdFAIL )
+        {
+            if( atomic_load( &pxWorkQueue->xStopping ) != pdFALSE )
+            {
+                xSemaphoreGive( pxWorkQueue->xExited );
+                vTaskDelete( NULL );
+            }
+
+            /* The job this worker is owed is hidden behind a cell that a
+             * preempted submitter has yet to write. Yielding would never let a
+             * lower priority submitter run, so block instead. */
+            vTaskDelay( 1 );
+        }
+
+        void * pvResult = xJob.pxFunction( xJob.pvArg );
+
+        if( xJob.pxFuture != NULL )
+        {
+            WorkFuture_t * pxFuture = xJob.pxFuture;
+            TaskHandle_t xWaiter = pxFuture->xWaiter;
+            UBaseType_t uxNotifyIndex = pxFuture->uxNotifyIndex;
+
+            /* The future may go out of scope as soon as it is marked done, so
+             * read everything needed to notify the waiter beforehand. */
+            pxFuture->pvResult = pvResult;
+            atomic_thread_fence( memory_order_release );
+            pxFuture->ulDone = 1;
+            ( void ) xTaskNotifyGiveIndexed( xWaiter, uxNotifyIndex );
+        }
+    }
+}
+
+static void prvDeleteQueues( WorkQueue_t * pxWorkQueue )
+{
+    for( UBaseType_t i = 0; i < portNUM_PROCESSORS * pxWorkQueue->uxNumJobPriorities; i++ )
+    {
+        if( pxWorkQueue->pxQueues[ i ] != NULL )
+        {
+            vMpmcQueueDelete( pxWorkQueue->pxQueues[ i ] );
+        }
+    }
+
+    if( pxWorkQueue->xPending != NULL )
+    {
+        vSemaphoreDelete( pxWorkQueue->xPending );
+    }
+
+    if( pxWorkQueue->xExited != NULL )
+    {
+        vSemaphoreDelete( pxWorkQueue->xExited );
+    }
+
+    vPortFree( pxWorkQueue );
+}
+
+/* ------------------------------------------------ Public API ---------------------------------------------------- */
+
+WorkQueueHandle_t xWorkQueueCreate( const WorkQueueConfig_t * pxConfig )
+{
+    WorkQueue_t * pxWorkQueue;
+    UBaseType_t uxNumQueues;
+
+    configASSERT( pxConfig );
+    configASSERT( pxConfig->uxNumWorkers > 0 );
+    configASSERT( pxConfig->uxNumJobPriorities > 0 );
+    configASSERT( pxConfig->uxNotifyIndex < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
+    uxNumQueues = portNUM_PROCESSORS * pxConfig->uxNumJobPriorities;
+
+    /* Allocate the work queue structure and the queue handles in one go */
+    pxWorkQueue = pvPortMalloc( sizeof( WorkQueue_t ) + ( uxNumQueues * sizeof( MpmcQueueHandle_t ) ) );
+
+    if( pxWorkQueue == NULL )
+    {
+        return NULL;
+    }
+
+    atomic_init( &pxWorkQueue->xStopping, pdFALSE );
+    pxWorkQueue->uxNumWorkers = 0;
+    pxWorkQueue->uxNumJobPriorities = pxConfig->uxNumJobPriorities;
+    pxWorkQueue->uxNotifyIndex = pxConfig->uxNotifyIndex;
+    pxWorkQueue->pxQueues = ( MpmcQueueHandle_t * ) ( pxWorkQueue + 1 );
+
+    /* The pending semaphore can never overflow, as each give is matched by a
+     * job or a worker. */
+    pxWorkQueue->xPending = xSemaphoreCreateCounting( UINT32_MAX, 0 );
+    pxWorkQueue->xExited = xSemaphoreCreateCounting( pxConfig->uxNumWorkers, 0 );
+
+    BaseType_t xAllocated = ( ( pxWorkQueue->xPending != NULL ) && ( pxWorkQueue->xExited != NULL ) ) ? pdTRUE : pdFALSE;
+
+    for( UBaseType_t i = 0; i < uxNumQueues; i++ )
+    {
+        pxWorkQueue->pxQueues[ i ] = xMpmcQueueCreate( pxConfig->uxQueueLength, sizeof( WorkJob_t ) );
+
+        if( pxWorkQueue->pxQueues[ i ] == NULL )
+        {
+            xAllocated = pdFALSE;
+        }
+    }
+
+    if( xAllocated == pdFALSE )
+    {
+        prvDeleteQueues( pxWorkQueue );
+        return NULL;
+    }
+
+    for( UBaseType_t i = 0; i < pxConfig->uxNumWorkers; i++ )
+    {
+        const BaseType_t xCoreID = ( pxConfig->xPinWorkers != pdFALSE ) ? ( BaseType_t ) ( i % portNUM_PROCESSORS ) : tskNO_AFFINITY;
+
+        if( xTaskCreatePinnedToCore( prvWorkerTask, "worker", pxConfig->ulWorkerStackSize, pxWorkQueue, pxConfig->uxWorkerPriority, NULL, xCoreID ) != pdPASS )
+        {
+            break;
+        }
+
+        pxWorkQueue->uxNumWorkers++;
+    }
+
+    if( pxWorkQueue->uxNumWorkers != pxConfig->uxNumWorkers )
+    {
+        /* Stop the workers created so far */
+        vWorkQueueDelete( pxWorkQueue );
+        return NULL;
+    }
+
+    return pxWorkQueue;
+}
+/*----------------------------------------------------------*/
+
+void vWorkQueueDelete( WorkQueueHandle_t xWorkQueue )
+{
+    WorkQueue_t * pxWorkQueue = xWorkQueue;
+
+    configASSERT( pxWorkQueue );
+
+    atomic_store( &pxWorkQueue->xStopping, pdTRUE );
+
+    for( UBaseType_t i = 0; i < pxWorkQueue->uxNumWorkers; i++ )
+    {
+        xSemaphoreGive( pxWorkQueue->xPending );
+    }
+
+    for( UBaseType_t i = 0; i < pxWorkQueue->uxNumWorkers; i++ )
+    {
+        ( void ) xSemaphoreTake( pxWorkQueue->xExited, portMAX_DELAY );
+    }
+
+    prvDeleteQueues( pxWorkQueue );
+}
+/*----------------------------------------------------------*/
+
+BaseType_t xWorkQueueSubmit( WorkQueueHandle_t xWorkQueue,
+                             WorkFunction_t pxFunction,
+                             void * pvArg,
+                             UBaseType_t uxJobPriority,
+                             WorkFuture_t * pxFuture,
+                             TickType_t xTicksToWait )
+{
+    WorkQueue_t * pxWorkQueue = xWorkQueue;
+    const BaseType_t xHomeCore = ( BaseType_t ) xPortGetCoreID();
+    BaseType_t xReturn = errQUEUE_FULL;
+    WorkJob_t xJob;
+
+    configASSERT( pxWorkQueue );
+    configASSERT( pxFunction );
+    configASSERT( uxJobPriority < pxWorkQueue->uxNumJobPriorities );
+
+    if( pxFuture != NULL )
+    {
+        pxFuture->xWaiter = xTaskGetCurrentTaskHandle();
+        pxFuture->uxNotifyIndex = pxWorkQueue->uxNotifyIndex;
+        pxFuture->pvResult = NULL;
+        pxFuture->ulDone = 0;
+    }
+
+    xJob.pxFunction = pxFunction;
+    xJob.pvArg = pvArg;
+    xJob.pxFuture = pxFuture;
+
+    /* Prefer the queue of the current core, but use any core's queue with
+     * space rather than block */
+    for( BaseType_t i = 0; ( i < portNUM_PROCESSORS ) && ( xReturn != pdPASS ); i++ )
+    {
+        xReturn = xMpmcQueueSend( prvGetQueue( pxWorkQueue, ( xHomeCore + i ) % portNUM_PROCESSORS, uxJobPriority ), &xJob, 0 );
+    }
+
+    if( ( xReturn != pdPASS ) && ( xTicksToWait > 0 ) )
+    {
+        xReturn = xMpmcQueueSend( prvGetQueue( pxWorkQueue, xHomeCore, uxJobPriority ), &xJob, xTicksToWait );
+    }
+
+    if( xReturn == pdPASS )
+    {
+        xSemaphoreGive( pxWorkQueue->xPending );
+    }
+
+    return xReturn;
+}
+/*----------------------------------------------------------*/
+
+BaseType_t xWorkFutureWait( WorkFuture_t * pxFuture,
+                            void ** ppvResult,
+                            TickType_t xTicksToWait )
+{
+    TimeOut_t xTimeOut;
+
+    configASSERT( pxFuture );
+    configASSERT( pxFuture->xWaiter == xTaskGetCurrentTaskHandle() );
+
+    vTaskSetTimeOutState( &xTimeOut );
+
+    /* The notification count may also have been given by other futures of the
+     * calling task, so the future's own flag is checked after each wake up. */
+    while( pxFuture->ulDone == 0 )
+    {
+        if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+        {
+            return pdFAIL;
+        }
+
+        ( void ) ulTaskNotifyTakeIndexed( pxFuture->uxNotifyIndex, pdFALSE, xTicksToWait );
+    }
+
+    atomic_thread_fence( memory_order_acquire );
+
+    if( ppvResult != NULL )
+    {
+        *ppvResult = pxFuture->pvResult;
+    }
+
+    return pdPASS;
+}
@@ -6,13 +6,14 @@
 
 #include "sdkconfig.h"
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include "FreeRTOS.h"
 #include "task.h"
-#if ( !CONFIG_FREERTOS_SMP && ( configNUM_CORES > 1 ) )
-/* Required for xTaskIncrementTickOtherCores() */
+#if ( !CONFIG_FREERTOS_SMP && ( ( configNUM_CORES > 1 ) || ( configUSE_TICKLESS_KERNEL == 1 ) ) )
+/* Required for xTaskIncrementTickOtherCores() and xTaskIncrementTicks() */
 #include "esp_private/freertos_idf_additions_priv.h"
-#endif /* ( !CONFIG_FREERTOS_SMP && ( configNUM_CORES > 1 ) ) */
+#endif /* ( !CONFIG_FREERTOS_SMP && ( ( configNUM_CORES > 1 ) || ( configUSE_TICKLESS_KERNEL == 1 ) ) ) */
 
 #if CONFIG_FREERTOS_SYSTICK_USES_CCOUNT
 #if CONFIG_FREERTOS_CORETIMER_0
@@ -48,7 +49,21 @@ _Static_assert(SOC_CPU_CORES_NUM <= SOC_SYSTIMER_ALARM_NUM - 1, "the number of c
 
 void SysTickIsrHandler(void *arg);
 
+#if CONFIG_FREERTOS_USE_TICKLESS_KERNEL
+/* Systimer HAL layer object, required to reprogram the alarm outside of the ISR */
+static systimer_hal_context_t *s_systimer_hal = NULL;
+/* Counter value of the tick that the kernel's tick count currently corresponds to */
+static uint64_t s_last_tick_count = 0;
+/* Counter value the alarm is currently programmed to */
+static uint64_t s_alarm_count = 0;
+/* Length of a tick in counter ticks */
+static uint64_t s_tick_period = 0;
+/* Set while the tick interrupt processes ticks, as it reprograms the alarm once it is done */
+static bool s_in_tick_isr = false;
+static portMUX_TYPE s_tickless_lock = portMUX_INITIALIZER_UNLOCKED;
+#else
 static uint32_t s_handled_systicks[configNUM_CORES] = { 0 };
+#endif /* CONFIG_FREERTOS_USE_TICKLESS_KERNEL */
 
 /**
  * @brief Set up the systimer peripheral to generate the tick interrupt
@@ -56,6 +71,9 @@ static uint32_t s_handled_systicks[configNUM_CORES] = { 0 };
  * Both timer alarms are configured in periodic mode.
  * It is done at the same time so SysTicks for both CPUs occur at the same time or very close.
  * Shifts a time of triggering interrupts for core 0 and core 1.
+ *
+ * If CONFIG_FREERTOS_USE_TICKLESS_KERNEL is enabled, the alarm is instead configured in one-shot mode and is
+ * reprogrammed to the next tick the kernel requires (see vPortTicklessUpdateAlarm()).
  */
 void vSystimerSetup(void)
 {
@@ -99,8 +117,17 @@ void vSystimerSetup(void)
 
             /* configure the timer */
             systimer_hal_connect_alarm_counter(&systimer_hal, alarm_id, SYSTIMER_COUNTER_OS_TICK);
+#if CONFIG_FREERTOS_USE_TICKLESS_KERNEL
+            s_systimer_hal = &systimer_hal;
+            s_tick_period = systimer_hal.us_to_ticks(1000000UL / CONFIG_FREERTOS_HZ);
+            s_alarm_count = s_tick_period;
+            systimer_ll_set_alarm_target(systimer_hal.dev, alarm_id, s_alarm_count);
+            systimer_ll_apply_alarm_value(systimer_hal.dev, alarm_id);
+            systimer_ll_enable_alarm(systimer_hal.dev, alarm_id, true);
+#else
             systimer_hal_set_alarm_period(&systimer_hal, alarm_id, 1000000UL / CONFIG_FREERTOS_HZ);
             systimer_hal_select_alarm_mode(&systimer_hal, alarm_id, SYSTIMER_ALARM_MODE_PERIOD);
+#endif /* CONFIG_FREERTOS_USE_TICKLESS_KERNEL */
             systimer_hal_counter_can_stall_by_cpu(&systimer_hal, SYSTIMER_COUNTER_OS_TICK, cpuid, true);
             if (cpuid == 0) {
                 systimer_hal_enable_alarm_int(&systimer_hal, alarm_id);
@@ -117,6 +144,117 @@ void vSystimerSetup(void)
     }
 }
 
+#if CONFIG_FREERTOS_USE_TICKLESS_KERNEL
+
+/**
+ * @brief Bring the kernel's tick count up to date
+ *
+ * Called by the kernel before the tick count is read. The ticks that have elapsed since the last processed tick are
+ * skipped, up to the tick of the next kernel event which is left for the tick interrupt to process.
+ */
+void vPortTicklessSyncTickCount(void)
+{
+    if (s_systimer_hal == NULL) {
+        /* The tick count does not advance before the scheduler is started */
+        return;
+    }
+
+    portENTER_CRITICAL_SAFE(&s_tickless_lock);
+    uint64_t now = systimer_hal_get_counter_value(s_systimer_hal, SYSTIMER_COUNTER_OS_TICK);
+    if (now >= s_last_tick_count + s_tick_period) {
+        TickType_t elapsed = (TickType_t)((now - s_last_tick_count) / s_tick_period);
+        s_last_tick_count += xTaskSkipTicks(elapsed) * s_tick_period;
+    }
+    portEXIT_CRITICAL_SAFE(&s_tickless_lock);
+}
+
+/**
+ * @brief Reprogram the alarm to the next tick the kernel requires
+ *
+ * Called by the kernel whenever the next tick it requires may have changed. Calls made while the tick interrupt
+ * processes ticks are deferred to the end of the interrupt, so the alarm is reprogrammed at most once per interrupt.
+ */
+void vPortTicklessUpdateAlarm(void)
+{
+    if (s_systimer_hal == NULL || s_in_tick_isr) {
+        return;
+    }
+
+    portENTER_CRITICAL_SAFE(&s_tickless_lock);
+    uint64_t target = s_last_tick_count + (uint64_t)xTaskGetTicksToNextEvent() * s_tick_period;
+    if (target != s_alarm_count) {
+        const uint32_t alarm_id = SYSTIMER_ALARM_OS_TICK_CORE0;
+        s_alarm_count = target;
+        /* If the target has already passed, set the alarm a little later, as it only fires on a future counter value */
+        while (1) {
+            systimer_ll_enable_alarm(s_systimer_hal->dev, alarm_id, false);
+            systimer_ll_set_alarm_target(s_systimer_hal->dev, alarm_id, target);
+            systimer_ll_apply_alarm_value(s_systimer_hal->dev, alarm_id);
+            systimer_ll_enable_alarm(s_systimer_hal->dev, alarm_id, true);
+            uint64_t now = systimer_hal_get_counter_value(s_systimer_hal, SYSTIMER_COUNTER_OS_TICK);
+            if ((int64_t)(target - now) > 0 || systimer_ll_is_alarm_int_fired(s_systimer_hal->dev, alarm_id)) {
+                break;
+            }
+            target = now + s_systimer_hal->us_to_ticks(2);
+        }
+    }
+    portEXIT_CRITICAL_SAFE(&s_tickless_lock);
+}
+
+/**
+ * @brief Systimer interrupt handler.
+ *
+ * The Systimer interrupt for SysTick works in one-shot mode. All ticks that have elapsed since the last processed tick
+ * are accounted for at once, then the alarm is reprogrammed to the next tick the kernel requires.
+ */
+void SysTickIsrHandler(void *arg)
+{
+    systimer_hal_context_t *systimer_hal = (systimer_hal_context_t *)arg;
+#ifdef CONFIG_PM_TRACE
+    ESP_PM_TRACE_ENTER(TICK, 0);
+#endif
+#if configBENCHMARK
+    portbenchmarkIntLatency();
+#endif //configBENCHMARK
+    traceISR_ENTER(SYSTICK_INTR_ID);
+
+    systimer_ll_clear_alarm_int(systimer_hal->dev, SYSTIMER_ALARM_OS_TICK_CORE0);
+
+    // Call IDF Tick Hook
+    extern void esp_vApplicationTickHook(void);
+    esp_vApplicationTickHook();
+
+    BaseType_t xSwitchRequired = pdFALSE;
+    UBaseType_t uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    portENTER_CRITICAL_SAFE(&s_tickless_lock);
+    uint64_t now = systimer_hal_get_counter_value(systimer_hal, SYSTIMER_COUNTER_OS_TICK);
+    if (now >= s_last_tick_count + s_tick_period) {
+        TickType_t elapsed = (TickType_t)((now - s_last_tick_count) / s_tick_period);
+        s_last_tick_count += (uint64_t)elapsed * s_tick_period;
+        s_in_tick_isr = true;
+        xSwitchRequired = xTaskIncrementTicks(elapsed);
+        s_in_tick_isr = false;
+    }
+    /* Force the alarm to be reprogrammed, as it has fired */
+    s_alarm_count = 0;
+    vPortTicklessUpdateAlarm();
+    portEXIT_CRITICAL_SAFE(&s_tickless_lock);
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedInterruptStatus);
+
+    // Check if yield is required
+    if (xSwitchRequired != pdFALSE) {
+        portYIELD_FROM_ISR();
+    } else {
+        traceISR_EXIT();
+    }
+
+#ifdef CONFIG_PM_TRACE
+    ESP_PM_TRACE_EXIT(TICK, 0);
+#endif
+}
+
+#else /* CONFIG_FREERTOS_USE_TICKLESS_KERNEL */
+
 /**
  * @brief Systimer interrupt handler.
  *
@@ -154,6 +292,7 @@ void SysTickIsrHandler(void *arg)
     ESP_PM_TRACE_EXIT(TICK, cpuid);
 #endif
 }
+#endif /* CONFIG_FREERTOS_USE_TICKLESS_KERNEL */
 #endif /* CONFIG_FREERTOS_SYSTICK_USES_SYSTIMER */
 
 /* ------------------------------------------------ Common Port Tick ---------------------------------------------------
@@ -0,0 +1,5 @@
+# Linux simulator: the whole application is built with ThreadSanitizer (see CONFIG_FREERTOS_LINUX_THREAD_SANITIZER)
+if(CONFIG_FREERTOS_LINUX_THREAD_SANITIZER)
+    idf_build_set_property(COMPILE_OPTIONS "-fsanitize=thread" APPEND)
+    idf_build_set_property(LINK_OPTIONS "-fsanitize=thread" APPEND)
+endif()
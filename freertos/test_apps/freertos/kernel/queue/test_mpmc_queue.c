@@ -0,0 +1,175 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sdkconfig.h"
+#include <stdint.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/mpmc_queue.h"
+#include "unity.h"
+#include "test_utils.h"
+
+#define QUEUE_LEN               4
+#define NUM_PRODUCERS           2
+#define NUM_CONSUMERS           2
+#define ITEMS_PER_PRODUCER      5000
+
+/*
+Test MPMC queue non-blocking behavior
+
+Purpose:
+    - Test that an MPMC queue is FIFO and reports full/empty without blocking, across multiple laps of the ring
+
+Procedure:
+    - Repeatedly fill the queue, then send one more item
+    - Drain the queue, then receive one more item
+
+Expected:
+    - The extra send fails with errQUEUE_FULL, the extra receive fails with errQUEUE_EMPTY
+    - Items are received in the order they were sent
+*/
+
+TEST_CASE("MPMC queue: non-blocking send and receive", "[freertos]")
+{
+    MpmcQueueHandle_t queue = xMpmcQueueCreate(QUEUE_LEN, sizeof(uint32_t));
+    TEST_ASSERT_NOT_EQUAL(NULL, queue);
+
+    for (int lap = 0; lap < 3; lap++) {
+        for (uint32_t i = 0; i < QUEUE_LEN; i++) {
+            TEST_ASSERT_EQUAL(pdPASS, xMpmcQueueSend(queue, &i, 0));
+        }
+        uint32_t item = 0xFF;
+        TEST_ASSERT_EQUAL(errQUEUE_FULL, xMpmcQueueSend(queue, &item, 0));
+        TEST_ASSERT_EQUAL(QUEUE_LEN, uxMpmcQueueMessagesWaiting(queue));
+
+        for (uint32_t i = 0; i < QUEUE_LEN; i++) {
+            TEST_ASSERT_EQUAL(pdPASS, xMpmcQueueReceive(queue, &item, 0));
+            TEST_ASSERT_EQUAL(i, item);
+        }
+        TEST_ASSERT_EQUAL(errQUEUE_EMPTY, xMpmcQueueReceive(queue, &item, 0));
+        TEST_ASSERT_EQUAL(0, uxMpmcQueueMessagesWaiting(queue));
+    }
+
+    vMpmcQueueDelete(queue);
+}
+
+/*
+Test MPMC queue blocking behavior with multiple producers and consumers
+
+Purpose:
+    - Test that concurrent producers and consumers on all cores neither lose nor duplicate items, and that blocked
+      tasks are always woken
+
+Procedure:
+    - Create a short queue, NUM_PRODUCERS producer tasks and NUM_CONSUMERS consumer tasks spread over all cores
+    - Each producer sends ITEMS_PER_PRODUCER values tagged with its producer ID, using portMAX_DELAY
+    - Consumers receive with portMAX_DELAY until the total number of items has been received
+
+Expected:
+    - All tasks complete (i.e., no lost wake-ups)
+    - Every value from every producer is received exactly once, and the values of each producer arrive in order
+*/
+
+typedef struct {
+    MpmcQueueHandle_t queue;
+    SemaphoreHandle_t done;
+    uint32_t received[NUM_PRODUCERS];
+    uint32_t errors;
+} mpmc_consumer_ctx_t;
+
+typedef struct {
+    MpmcQueueHandle_t queue;
+    SemaphoreHandle_t done;
+    uint32_t producer_id;
+} mpmc_producer_ctx_t;
+
+static volatile int32_t items_remaining;
+/* One bit per value of each producer, set by the consumer that received it */
+static uint8_t items_seen[NUM_PRODUCERS][(ITEMS_PER_PRODUCER + 7) / 8];
+
+static void mpmc_producer(void *arg)
+{
+    mpmc_producer_ctx_t *ctx = (mpmc_producer_ctx_t *)arg;
+
+    for (uint32_t i = 0; i < ITEMS_PER_PRODUCER; i++) {
+        uint32_t item = (ctx->producer_id << 24) | i;
+        TEST_ASSERT_EQUAL(pdPASS, xMpmcQueueSend(ctx->queue, &item, portMAX_DELAY));
+    }
+    xSemaphoreGive(ctx->done);
+    vTaskDelete(NULL);
+}
+
+static void mpmc_consumer(void *arg)
+{
+    mpmc_consumer_ctx_t *ctx = (mpmc_consumer_ctx_t *)arg;
+    uint32_t item;
+
+    while (__atomic_fetch_sub(&items_remaining, 1, __ATOMIC_RELAXED) > 0) {
+        TEST_ASSERT_EQUAL(pdPASS, xMpmcQueueReceive(ctx->queue, &item, portMAX_DELAY));
+        uint32_t producer = item >> 24;
+        uint32_t seq = item & 0xFFFFFF;
+        /* Values from the same producer must be seen in increasing order by any single consumer */
+        if (producer >= NUM_PRODUCERS || seq >= ITEMS_PER_PRODUCER ||
+                (ctx->received[producer] != 0 && seq < ctx->received[producer])) {
+            ctx->errors++;
+            continue;
+        }
+        ctx->received[producer] = seq;
+        /* A value received twice finds its bit already set */
+        uint8_t bit = 1 << (seq % 8);
+        if (__atomic_fetch_or(&items_seen[producer][seq / 8], bit, __ATOMIC_RELAXED) & bit) {
+            ctx->errors++;
+        }
+    }
+    xSemaphoreGive(ctx->done);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("MPMC queue: blocking producers and consumers", "[freertos]")
+{
+    mpmc_producer_ctx_t producers[NUM_PRODUCERS];
+    mpmc_consumer_ctx_t consumers[NUM_CONSUMERS];
+    MpmcQueueHandle_t queue = xMpmcQueueCreate(QUEUE_LEN, sizeof(uint32_t));
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(NUM_PRODUCERS + NUM_CONSUMERS, 0);
+    TEST_ASSERT_NOT_EQUAL(NULL, queue);
+    TEST_ASSERT_NOT_EQUAL(NULL, done);
+
+    /* Items are counted down before being received, so the counter must end at exactly -NUM_CONSUMERS */
+    items_remaining = NUM_PRODUCERS * ITEMS_PER_PRODUCER;
+    memset(items_seen, 0, sizeof(items_seen));
+
+    for (int i = 0; i < NUM_CONSUMERS; i++) {
+        memset(&consumers[i], 0, sizeof(consumers[i]));
+        consumers[i].queue = queue;
+        consumers[i].done = done;
+        xTaskCreatePinnedToCore(mpmc_consumer, "consumer", 2048, &consumers[i], UNITY_FREERTOS_PRIORITY - 1, NULL, i % configNUMBER_OF_CORES);
+    }
+    for (int i = 0; i < NUM_PRODUCERS; i++) {
+        producers[i].queue = queue;
+        producers[i].done = done;
+        producers[i].producer_id = i;
+        xTaskCreatePinnedToCore(mpmc_producer, "producer", 2048, &producers[i], UNITY_FREERTOS_PRIORITY - 1, NULL, i % configNUMBER_OF_CORES);
+    }
+
+    for (int i = 0; i < NUM_PRODUCERS + NUM_CONSUMERS; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(done, pdMS_TO_TICKS(10000)));
+    }
+    for (int i = 0; i < NUM_CONSUMERS; i++) {
+        TEST_ASSERT_EQUAL(0, consumers[i].errors);
+    }
+    TEST_ASSERT_EQUAL(0, uxMpmcQueueMessagesWaiting(queue));
+    /* No value was lost */
+    for (int p = 0; p < NUM_PRODUCERS; p++) {
+        for (uint32_t seq = 0; seq < ITEMS_PER_PRODUCER; seq++) {
+            TEST_ASSERT_TRUE(items_seen[p][seq / 8] & (1 << (seq % 8)));
+        }
+    }
+
+    vMpmcQueueDelete(queue);
+    vSemaphoreDelete(done);
+}
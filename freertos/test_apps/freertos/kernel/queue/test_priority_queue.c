@@ -0,0 +1,116 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sdkconfig.h"
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/priority_queue.h"
+#include "unity.h"
+#include "test_utils.h"
+
+#define QUEUE_LEN           16
+
+/*
+Test priority queue ordering
+
+Purpose:
+    - Test that a priority queue returns items highest priority first, and FIFO among equal priorities
+
+Procedure:
+    - Send QUEUE_LEN items with priorities cycling through 0..3, tagging each item with its send order
+    - Send one more item
+    - Receive every item
+
+Expected:
+    - The extra send fails with errQUEUE_FULL
+    - Items are received in decreasing priority, and in increasing send order within the same priority
+    - The receive after draining the queue fails with errQUEUE_EMPTY
+*/
+
+TEST_CASE("Priority queue: ordering", "[freertos]")
+{
+    PriorityQueueHandle_t queue = xPriorityQueueCreate(QUEUE_LEN, sizeof(uint32_t));
+    TEST_ASSERT_NOT_EQUAL(NULL, queue);
+
+    for (uint32_t i = 0; i < QUEUE_LEN; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xPriorityQueueSend(queue, &i, i % 4, 0));
+    }
+    uint32_t item = 0xFF;
+    TEST_ASSERT_EQUAL(errQUEUE_FULL, xPriorityQueueSend(queue, &item, 10, 0));
+    TEST_ASSERT_EQUAL(QUEUE_LEN, uxPriorityQueueMessagesWaiting(queue));
+
+    UBaseType_t prev_priority = UINT32_MAX;
+    uint32_t prev_item = 0;
+    for (uint32_t i = 0; i < QUEUE_LEN; i++) {
+        UBaseType_t priority;
+        TEST_ASSERT_EQUAL(pdPASS, xPriorityQueueReceive(queue, &item, &priority, 0));
+        TEST_ASSERT_EQUAL(item % 4, priority);
+        TEST_ASSERT_LESS_OR_EQUAL(prev_priority, priority);
+        if (priority == prev_priority) {
+            TEST_ASSERT_GREATER_THAN(prev_item, item);
+        }
+        prev_priority = priority;
+        prev_item = item;
+    }
+    TEST_ASSERT_EQUAL(errQUEUE_EMPTY, xPriorityQueueReceive(queue, &item, NULL, 0));
+
+    vPriorityQueueDelete(queue);
+}
+
+/*
+Test priority queue blocking
+
+Purpose:
+    - Test that a task blocked on an empty priority queue is unblocked by a send, and that a receive times out
+
+Procedure:
+    - Create a receiver task of higher priority than the test task that blocks on the empty queue
+    - From the test task, send an item
+    - Then receive on the empty queue with a short timeout
+
+Expected:
+    - The receiver task runs immediately and gets the item
+    - The timed receive returns errQUEUE_EMPTY after the timeout has elapsed
+*/
+
+typedef struct {
+    PriorityQueueHandle_t queue;
+    volatile uint32_t received;
+} prio_queue_test_ctx_t;
+
+static void receiver_task(void *arg)
+{
+    prio_queue_test_ctx_t *ctx = (prio_queue_test_ctx_t *)arg;
+    uint32_t item;
+
+    TEST_ASSERT_EQUAL(pdPASS, xPriorityQueueReceive(ctx->queue, &item, NULL, portMAX_DELAY));
+    ctx->received = item;
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("Priority queue: blocking receive", "[freertos]")
+{
+    prio_queue_test_ctx_t ctx = {
+        .queue = xPriorityQueueCreate(QUEUE_LEN, sizeof(uint32_t)),
+        .received = 0,
+    };
+    TEST_ASSERT_NOT_EQUAL(NULL, ctx.queue);
+
+    xTaskCreatePinnedToCore(receiver_task, "recv", 2048, &ctx, UNITY_FREERTOS_PRIORITY + 1, NULL, xPortGetCoreID());
+    uint32_t item = 0x1234;
+    TEST_ASSERT_EQUAL(pdPASS, xPriorityQueueSend(ctx.queue, &item, 0, 0));
+    /* The receiver is of higher priority on the same core, so it should already have run */
+    TEST_ASSERT_EQUAL(0x1234, ctx.received);
+
+    TickType_t start = xTaskGetTickCount();
+    TEST_ASSERT_EQUAL(errQUEUE_EMPTY, xPriorityQueueReceive(ctx.queue, &item, NULL, 10));
+    TEST_ASSERT_GREATER_OR_EQUAL(10, xTaskGetTickCount() - start);
+
+    vTaskDelay(2);  /* Let the idle task free the receiver */
+    vPriorityQueueDelete(ctx.queue);
+}
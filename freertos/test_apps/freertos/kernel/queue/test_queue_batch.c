@@ -0,0 +1,205 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sdkconfig.h"
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "unity.h"
+#include "test_utils.h"
+
+#if !CONFIG_FREERTOS_SMP
+
+#define QUEUE_LEN       8
+
+/*
+Test batched send/receive
+
+Purpose:
+    - Test that xQueueSendBatch() and xQueueReceiveBatch() move multiple items in FIFO order
+    - Test that both functions report a partial transfer when the queue fills up or runs dry
+
+Procedure:
+    - Send QUEUE_LEN + 4 items in one batch with no block time
+    - Receive in batches of 5 until the queue is empty
+
+Expected:
+    - Only QUEUE_LEN items are sent
+    - The received items are in order and the last receive returns 0
+*/
+
+TEST_CASE("Queue batch send and receive", "[freertos]")
+{
+    uint32_t tx[QUEUE_LEN + 4];
+    uint32_t rx[5];
+    QueueHandle_t queue = xQueueCreate(QUEUE_LEN, sizeof(uint32_t));
+    TEST_ASSERT_NOT_EQUAL(NULL, queue);
+
+    for (int i = 0; i < QUEUE_LEN + 4; i++) {
+        tx[i] = i;
+    }
+
+    TEST_ASSERT_EQUAL(QUEUE_LEN, xQueueSendBatch(queue, tx, QUEUE_LEN + 4, 0));
+    TEST_ASSERT_EQUAL(0, xQueueSendBatch(queue, &tx[QUEUE_LEN], 4, 0));
+    TEST_ASSERT_EQUAL(QUEUE_LEN, uxQueueMessagesWaiting(queue));
+
+    uint32_t expected = 0;
+    size_t received;
+    while ((received = xQueueReceiveBatch(queue, rx, 5, 0)) > 0) {
+        for (size_t i = 0; i < received; i++) {
+            TEST_ASSERT_EQUAL(expected, rx[i]);
+            expected++;
+        }
+    }
+    TEST_ASSERT_EQUAL(QUEUE_LEN, expected);
+
+    vQueueDelete(queue);
+}
+
+/*
+Test batched receive unblocking
+
+Purpose:
+    - Test that a task blocked in xQueueReceiveBatch() is unblocked by a single batch send
+
+Procedure:
+    - Create a higher priority receiver task that blocks in xQueueReceiveBatch()
+    - Send a batch of 4 items from the unity task
+
+Expected:
+    - The receiver runs immediately after the batch is sent and receives all 4 items in one call
+*/
+
+static volatile size_t rx_count;
+
+static void batch_receiver_task(void *arg)
+{
+    QueueHandle_t queue = (QueueHandle_t)arg;
+    uint32_t rx[QUEUE_LEN];
+
+    rx_count = xQueueReceiveBatch(queue, rx, QUEUE_LEN, portMAX_DELAY);
+    vTaskSuspend(NULL);
+}
+
+TEST_CASE("Queue batch send unblocks receiver once", "[freertos]")
+{
+    const uint32_t tx[4] = {1, 2, 3, 4};
+    TaskHandle_t receiver;
+    QueueHandle_t queue = xQueueCreate(QUEUE_LEN, sizeof(uint32_t));
+    TEST_ASSERT_NOT_EQUAL(NULL, queue);
+
+    rx_count = 0;
+    TEST_ASSERT_EQUAL(pdTRUE, xTaskCreatePinnedToCore(batch_receiver_task, "rx", 2048, queue, UNITY_FREERTOS_PRIORITY + 1, &receiver, xPortGetCoreID()));
+    TEST_ASSERT_EQUAL(4, xQueueSendBatch(queue, tx, 4, 0));
+    /* The receiver has a higher priority on the same core and should have preempted us already */
+    TEST_ASSERT_EQUAL(4, rx_count);
+
+    vTaskDelete(receiver);
+    vQueueDelete(queue);
+}
+
+/*
+Test batched send/receive wake every waiter they can serve
+
+Purpose:
+    - Test that a batch send unblocks one blocked receiver per item sent
+    - Test that a batch receive unblocks one blocked sender per item received
+
+Procedure:
+    - Create three higher priority receiver tasks that block in xQueueReceive() on an empty queue
+    - Send a batch of 2 items, then a batch of 4 items from the unity task
+    - Fill the queue, and create three higher priority sender tasks that block in xQueueSend()
+    - Receive a batch of 2 items, then a batch of 4 items from the unity task
+
+Expected:
+    - The first batch send serves two receivers, and the second one serves the last receiver and leaves 3 items queued
+    - The first batch receive lets two senders send, and the second one lets the last sender send, leaving 5 items queued
+*/
+
+#define WAITER_COUNT    3
+
+static volatile int waiter_done_count;
+
+static void single_receiver_task(void *arg)
+{
+    QueueHandle_t queue = (QueueHandle_t)arg;
+    uint32_t rx;
+
+    if (xQueueReceive(queue, &rx, portMAX_DELAY) == pdTRUE) {
+        waiter_done_count++;
+    }
+    vTaskSuspend(NULL);
+}
+
+static void single_sender_task(void *arg)
+{
+    QueueHandle_t queue = (QueueHandle_t)arg;
+    const uint32_t tx = 0;
+
+    if (xQueueSend(queue, &tx, portMAX_DELAY) == pdTRUE) {
+        waiter_done_count++;
+    }
+    vTaskSuspend(NULL);
+}
+
+static void create_waiters(TaskFunction_t waiter_func, QueueHandle_t queue, TaskHandle_t *waiters)
+{
+    waiter_done_count = 0;
+    for (int i = 0; i < WAITER_COUNT; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xTaskCreatePinnedToCore(waiter_func, "waiter", 2048, queue, UNITY_FREERTOS_PRIORITY + 1, &waiters[i], xPortGetCoreID()));
+    }
+    /* The waiters have a higher priority on the same core, so they are all blocked by now */
+    TEST_ASSERT_EQUAL(0, waiter_done_count);
+}
+
+static void delete_waiters(TaskHandle_t *waiters)
+{
+    for (int i = 0; i < WAITER_COUNT; i++) {
+        vTaskDelete(waiters[i]);
+    }
+}
+
+TEST_CASE("Queue batch send wakes every receiver it can serve", "[freertos]")
+{
+    const uint32_t tx[4] = {1, 2, 3, 4};
+    TaskHandle_t receivers[WAITER_COUNT];
+    QueueHandle_t queue = xQueueCreate(QUEUE_LEN, sizeof(uint32_t));
+    TEST_ASSERT_NOT_EQUAL(NULL, queue);
+
+    create_waiters(single_receiver_task, queue, receivers);
+    TEST_ASSERT_EQUAL(2, xQueueSendBatch(queue, tx, 2, 0));
+    TEST_ASSERT_EQUAL(2, waiter_done_count);
+    TEST_ASSERT_EQUAL(0, uxQueueMessagesWaiting(queue));
+    TEST_ASSERT_EQUAL(4, xQueueSendBatch(queue, tx, 4, 0));
+    TEST_ASSERT_EQUAL(WAITER_COUNT, waiter_done_count);
+    TEST_ASSERT_EQUAL(3, uxQueueMessagesWaiting(queue));
+
+    delete_waiters(receivers);
+    vQueueDelete(queue);
+}
+
+TEST_CASE("Queue batch receive wakes every sender it can serve", "[freertos]")
+{
+    uint32_t items[QUEUE_LEN] = {0};
+    TaskHandle_t senders[WAITER_COUNT];
+    QueueHandle_t queue = xQueueCreate(QUEUE_LEN, sizeof(uint32_t));
+    TEST_ASSERT_NOT_EQUAL(NULL, queue);
+
+    TEST_ASSERT_EQUAL(QUEUE_LEN, xQueueSendBatch(queue, items, QUEUE_LEN, 0));
+    create_waiters(single_sender_task, queue, senders);
+    TEST_ASSERT_EQUAL(2, xQueueReceiveBatch(queue, items, 2, 0));
+    TEST_ASSERT_EQUAL(2, waiter_done_count);
+    TEST_ASSERT_EQUAL(QUEUE_LEN, uxQueueMessagesWaiting(queue));
+    TEST_ASSERT_EQUAL(4, xQueueReceiveBatch(queue, items, 4, 0));
+    TEST_ASSERT_EQUAL(WAITER_COUNT, waiter_done_count);
+    TEST_ASSERT_EQUAL(QUEUE_LEN - 4 + 1, uxQueueMessagesWaiting(queue));
+
+    delete_waiters(senders);
+    vQueueDelete(queue);
+}
+
+#endif /* !CONFIG_FREERTOS_SMP */
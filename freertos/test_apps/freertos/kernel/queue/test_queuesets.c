@@ -186,3 +186,91 @@ TEST_CASE("Test queue sets multi-core", "[freertos]")
     done_sem = NULL;
 }
 #endif // CONFIG_FREERTOS_UNICORE
+
+#if !CONFIG_FREERTOS_SMP
+/*
+Test queue set member priority
+
+Purpose:
+    - Test that when multiple members of a queue set are ready, the member added to the set first is selected first,
+      regardless of the order in which the members received their items
+
+Procedure:
+    - Create NUM_QUEUES queues and add them to the same queue set
+    - Send one item to each queue in reverse order (i.e., the last queue added is sent to first)
+    - Select from the queue set until it is empty
+
+Expected:
+    - Members are selected in the order they were added to the queue set
+*/
+
+TEST_CASE("Test queue sets member priority", "[freertos]")
+{
+    QueueHandle_t queues[NUM_QUEUES];
+    QueueSetHandle_t queue_set;
+    allocate_resources(NUM_QUEUES, QUEUE_LEN, queues, &queue_set);
+
+    for (int i = NUM_QUEUES - 1; i >= 0; i--) {
+        BaseType_t item = i;
+        TEST_ASSERT_EQUAL(pdTRUE, xQueueSend(queues[i], &item, 0));
+    }
+
+    for (int i = 0; i < NUM_QUEUES; i++) {
+        QueueSetMemberHandle_t member = xQueueSelectFromSet(queue_set, 0);
+        TEST_ASSERT_EQUAL(queues[i], member);
+        BaseType_t item;
+        TEST_ASSERT_EQUAL(pdTRUE, xQueueReceive(member, &item, 0));
+        TEST_ASSERT_EQUAL(i, item);
+    }
+    TEST_ASSERT_EQUAL(NULL, xQueueSelectFromSet(queue_set, 0));
+
+    free_resources(NUM_QUEUES, queues, queue_set);
+}
+
+/*
+Test queue sets member limit
+
+Purpose:
+    - Test that a queue set rejects members beyond its limit of 32
+
+Procedure:
+    - Add 32 semaphores to a queue set, then try to add one more
+    - Remove one of the members, then add the extra semaphore again
+
+Expected:
+    - The 33rd member is rejected while the set is full
+    - The extra semaphore can be added once a slot has been freed, and is selected when given
+*/
+
+#define QUEUE_SET_MAX_MEMBERS   32
+
+TEST_CASE("Test queue sets member limit", "[freertos]")
+{
+    SemaphoreHandle_t sems[QUEUE_SET_MAX_MEMBERS + 1];
+    QueueSetHandle_t queue_set = xQueueCreateSet(QUEUE_SET_MAX_MEMBERS + 1);
+    TEST_ASSERT_NOT_EQUAL(NULL, queue_set);
+
+    for (int i = 0; i < QUEUE_SET_MAX_MEMBERS + 1; i++) {
+        sems[i] = xSemaphoreCreateBinary();
+        TEST_ASSERT_NOT_EQUAL(NULL, sems[i]);
+    }
+    for (int i = 0; i < QUEUE_SET_MAX_MEMBERS; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xQueueAddToSet(sems[i], queue_set));
+    }
+    TEST_ASSERT_EQUAL(pdFAIL, xQueueAddToSet(sems[QUEUE_SET_MAX_MEMBERS], queue_set));
+
+    TEST_ASSERT_EQUAL(pdPASS, xQueueRemoveFromSet(sems[0], queue_set));
+    TEST_ASSERT_EQUAL(pdPASS, xQueueAddToSet(sems[QUEUE_SET_MAX_MEMBERS], queue_set));
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreGive(sems[QUEUE_SET_MAX_MEMBERS]));
+    TEST_ASSERT_EQUAL(sems[QUEUE_SET_MAX_MEMBERS], xQueueSelectFromSet(queue_set, 0));
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(sems[QUEUE_SET_MAX_MEMBERS], 0));
+
+    for (int i = 1; i < QUEUE_SET_MAX_MEMBERS + 1; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xQueueRemoveFromSet(sems[i], queue_set));
+    }
+    for (int i = 0; i < QUEUE_SET_MAX_MEMBERS + 1; i++) {
+        vSemaphoreDelete(sems[i]);
+    }
+    vQueueDelete(queue_set);
+}
+#endif // !CONFIG_FREERTOS_SMP
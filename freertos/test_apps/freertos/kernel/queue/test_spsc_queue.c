@@ -0,0 +1,123 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sdkconfig.h"
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/spsc_queue.h"
+#include "unity.h"
+#include "test_utils.h"
+
+#define QUEUE_LEN           4
+#define NUM_ITEMS           10000
+
+/*
+Test SPSC queue non-blocking behavior
+
+Purpose:
+    - Test that an SPSC queue is FIFO and reports full/empty without blocking
+
+Procedure:
+    - Fill the queue, then send one more item
+    - Drain the queue, then receive one more item
+
+Expected:
+    - The extra send fails with errQUEUE_FULL, the extra receive fails with errQUEUE_EMPTY
+    - Items are received in the order they were sent
+*/
+
+TEST_CASE("SPSC queue: non-blocking send and receive", "[freertos]")
+{
+    SpscQueueHandle_t queue = xSpscQueueCreate(QUEUE_LEN, sizeof(uint32_t));
+    TEST_ASSERT_NOT_EQUAL(NULL, queue);
+
+    for (uint32_t i = 0; i < QUEUE_LEN; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xSpscQueueSend(queue, &i, 0));
+    }
+    uint32_t item = 0xFF;
+    TEST_ASSERT_EQUAL(errQUEUE_FULL, xSpscQueueSend(queue, &item, 0));
+    TEST_ASSERT_EQUAL(QUEUE_LEN, uxSpscQueueMessagesWaiting(queue));
+
+    for (uint32_t i = 0; i < QUEUE_LEN; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xSpscQueueReceive(queue, &item, 0));
+        TEST_ASSERT_EQUAL(i, item);
+    }
+    TEST_ASSERT_EQUAL(errQUEUE_EMPTY, xSpscQueueReceive(queue, &item, 0));
+    TEST_ASSERT_EQUAL(0, uxSpscQueueMessagesWaiting(queue));
+
+    vSpscQueueDelete(queue);
+}
+
+/*
+Test SPSC queue blocking behavior
+
+Purpose:
+    - Test that the producer and consumer correctly block and wake each other
+
+Procedure:
+    - Create a short queue, a producer task and a consumer task (on different cores if available)
+    - The producer sends NUM_ITEMS sequential values with portMAX_DELAY
+    - The consumer receives NUM_ITEMS values with portMAX_DELAY
+
+Expected:
+    - Both tasks complete (i.e., no lost wake-ups) and every value is received in order
+*/
+
+typedef struct {
+    SpscQueueHandle_t queue;
+    SemaphoreHandle_t done;
+    uint32_t errors;
+} spsc_test_ctx_t;
+
+static void spsc_producer(void *arg)
+{
+    spsc_test_ctx_t *ctx = (spsc_test_ctx_t *)arg;
+
+    for (uint32_t i = 0; i < NUM_ITEMS; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xSpscQueueSend(ctx->queue, &i, portMAX_DELAY));
+    }
+    xSemaphoreGive(ctx->done);
+    vTaskDelete(NULL);
+}
+
+static void spsc_consumer(void *arg)
+{
+    spsc_test_ctx_t *ctx = (spsc_test_ctx_t *)arg;
+    uint32_t item;
+
+    for (uint32_t i = 0; i < NUM_ITEMS; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xSpscQueueReceive(ctx->queue, &item, portMAX_DELAY));
+        if (item != i) {
+            ctx->errors++;
+        }
+    }
+    xSemaphoreGive(ctx->done);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("SPSC queue: blocking producer and consumer", "[freertos]")
+{
+    spsc_test_ctx_t ctx = {
+        .queue = xSpscQueueCreate(QUEUE_LEN, sizeof(uint32_t)),
+        .done = xSemaphoreCreateCounting(2, 0),
+        .errors = 0,
+    };
+    TEST_ASSERT_NOT_EQUAL(NULL, ctx.queue);
+    TEST_ASSERT_NOT_EQUAL(NULL, ctx.done);
+
+    xTaskCreatePinnedToCore(spsc_consumer, "consumer", 2048, &ctx, UNITY_FREERTOS_PRIORITY - 1, NULL, 0);
+    xTaskCreatePinnedToCore(spsc_producer, "producer", 2048, &ctx, UNITY_FREERTOS_PRIORITY - 1, NULL, configNUMBER_OF_CORES - 1);
+
+    for (int i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(ctx.done, pdMS_TO_TICKS(5000)));
+    }
+    TEST_ASSERT_EQUAL(0, ctx.errors);
+
+    vSpscQueueDelete(ctx.queue);
+    vSemaphoreDelete(ctx.done);
+}
@@ -25,6 +25,9 @@ Expected:
     - eTaskGetState() should return the correct state for each created task
 */
 
+// The running task busy loops, and ThreadSanitizer only lets the tick preempt it in intercepted calls
+#if !CONFIG_FREERTOS_LINUX_THREAD_SANITIZER
+
 static void blocked_task(void *arg)
 {
     vTaskDelay(portMAX_DELAY - 1);
@@ -91,3 +94,5 @@ TEST_CASE("Test eTaskGetState", "[freertos]")
     // Short delay to allow task memory to be cleaned
     vTaskDelay(10);
 }
+
+#endif // !CONFIG_FREERTOS_LINUX_THREAD_SANITIZER
@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include "sdkconfig.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "unity.h"
+#include "portTestMacro.h"
+
+#if CONFIG_FREERTOS_USE_EDF_SCHEDULING
+
+/*
+Test EDF scheduling against fixed priority scheduling
+
+Purpose:
+    - Test that a periodic task set with 90% utilization that misses deadlines under fixed (rate monotonic) priorities
+      meets all its deadlines under EDF scheduling
+Procedure:
+    - The task set consists of:
+        - Task A with a period of 20 ticks, a relative deadline of 20 ticks and 10 ticks of execution per job
+        - Task B with a period of 30 ticks, a relative deadline of 29 ticks and 12 ticks of execution per job
+    - Run the task set with fixed priorities, where task A (the shorter period) has the higher priority
+    - Run the task set again with both tasks at the same priority, so that they are scheduled by EDF
+    - Each task executes a fixed number of jobs, then reports its deadline misses
+Expected:
+    - With fixed priorities, task B is preempted by task A and misses deadlines
+    - With EDF, fewer (normally no) deadlines are missed
+*/
+
+#define TEST_EDF_NUM_TASKS      2
+#define TEST_EDF_DURATION       600     // Number of ticks each task set is run for
+
+typedef struct {
+    TickType_t period;
+    TickType_t deadline;
+    TickType_t exec_ticks;
+    UBaseType_t misses;
+    SemaphoreHandle_t done;
+} edf_task_ctx_t;
+
+static edf_task_ctx_t *volatile running_ctx;
+
+static void consume_ticks(edf_task_ctx_t *ctx)
+{
+    TickType_t last = xTaskGetTickCount();
+    TickType_t consumed = 0;
+
+    running_ctx = ctx;
+    while (consumed < ctx->exec_ticks) {
+        TickType_t now = xTaskGetTickCount();
+        if (running_ctx != ctx) {
+            /* Another task ran since the last check, so the ticks elapsed meanwhile were not executed by this one */
+            running_ctx = ctx;
+        } else {
+            /* Count every tick elapsed while running, as the Linux simulator may catch up several ticks at once */
+            consumed += now - last;
+        }
+        last = now;
+    }
+}
+
+static void edf_task(void *arg)
+{
+    edf_task_ctx_t *ctx = (edf_task_ctx_t *)arg;
+
+    /* The deadline is set by the test before the task first runs, so that all tasks are released on the same tick */
+    for (int i = 0; i < TEST_EDF_DURATION / ctx->period; i++) {
+        consume_ticks(ctx);
+        xTaskWaitForNextPeriod();
+    }
+
+    ctx->misses = uxTaskGetDeadlineMisses(NULL);
+    xSemaphoreGive(ctx->done);
+    vTaskSuspend(NULL);
+}
+
+static UBaseType_t run_task_set(bool use_edf)
+{
+    edf_task_ctx_t ctx[TEST_EDF_NUM_TASKS] = {
+        { .period = 20, .deadline = 20, .exec_ticks = 10 },
+        { .period = 30, .deadline = 29, .exec_ticks = 12 },
+    };
+    TaskHandle_t tasks[TEST_EDF_NUM_TASKS];
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(TEST_EDF_NUM_TASKS, 0);
+    TEST_ASSERT_NOT_EQUAL(NULL, done);
+
+    vTaskSuspendAll();
+    for (int i = 0; i < TEST_EDF_NUM_TASKS; i++) {
+        /* Under fixed priority, the task with the shorter period gets the higher priority (rate monotonic) */
+        UBaseType_t priority = configTEST_UNITY_TASK_PRIORITY + (use_edf ? 1 : TEST_EDF_NUM_TASKS - i);
+        ctx[i].done = done;
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(edf_task, "edf", configTEST_DEFAULT_STACK_SIZE, &ctx[i], priority, &tasks[i], 0));
+        vTaskSetDeadline(tasks[i], ctx[i].period, ctx[i].deadline);
+    }
+    xTaskResumeAll();
+
+    UBaseType_t misses = 0;
+    for (int i = 0; i < TEST_EDF_NUM_TASKS; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(done, 2 * TEST_EDF_DURATION));
+    }
+    for (int i = 0; i < TEST_EDF_NUM_TASKS; i++) {
+        misses += ctx[i].misses;
+        vTaskDelete(tasks[i]);
+    }
+
+    vSemaphoreDelete(done);
+    /* Let the idle task free the deleted tasks */
+    vTaskDelay(10);
+
+    return misses;
+}
+
+TEST_CASE("Tasks: Test EDF scheduling misses fewer deadlines than fixed priority at 90% load", "[freertos]")
+{
+    UBaseType_t fp_misses = run_task_set(false);
+    UBaseType_t edf_misses = run_task_set(true);
+
+    printf("Deadline misses: fixed priority %u, EDF %u\n", (unsigned)fp_misses, (unsigned)edf_misses);
+    TEST_ASSERT_GREATER_THAN(0, fp_misses);
+    TEST_ASSERT_LESS_THAN(fp_misses, edf_misses);
+}
+
+#endif /* CONFIG_FREERTOS_USE_EDF_SCHEDULING */
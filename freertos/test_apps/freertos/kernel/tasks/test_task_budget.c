@@ -0,0 +1,105 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sdkconfig.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "unity.h"
+#include "portTestMacro.h"
+
+#if ( CONFIG_FREERTOS_USE_TASK_BUDGETS && CONFIG_FREERTOS_USE_TRACE_FACILITY )
+
+/*
+Test task CPU budgets
+
+Purpose:
+    - Test that a task that never blocks is throttled once it exhausts its CPU budget, so that tasks of lower priority
+      on the same core can still run
+Procedure:
+    - Create a busy polling task of higher priority than the unity task on the same core, with a budget of
+      TEST_BUDGET_TICKS in every TEST_BUDGET_PERIOD ticks. The task counts the ticks it observes while running.
+    - The unity task delays for TEST_BUDGET_NUM_PERIODS budget periods
+    - Check the throttle count of the polling task, and the number of ticks it ran for
+Expected:
+    - The unity task's delay completes (i.e., it is not starved)
+    - The polling task was throttled once per budget period, and ran for its budget in each period (i.e., it got the
+      share of the CPU reserved by its budget, no more and no less)
+*/
+
+#define TEST_BUDGET_TICKS           5
+#define TEST_BUDGET_PERIOD          10
+#define TEST_BUDGET_NUM_PERIODS     10
+
+static void busy_poll_task(void *arg)
+{
+    volatile uint32_t *ticks_run = (volatile uint32_t *)arg;
+    TickType_t last = xTaskGetTickCount();
+
+    while (1) {
+        TickType_t now = xTaskGetTickCount();
+        if (now != last) {
+            (*ticks_run)++;
+            last = now;
+        }
+    }
+}
+
+TEST_CASE("Tasks: Test task CPU budget throttles a busy task", "[freertos]")
+{
+    volatile uint32_t ticks_run = 0;
+    TaskHandle_t task;
+    TaskStatus_t status;
+
+    /* Suspend the scheduler so that the budget is set before the polling task first runs */
+    vTaskSuspendAll();
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(busy_poll_task, "poll", configTEST_DEFAULT_STACK_SIZE, (void *)&ticks_run, configTEST_UNITY_TASK_PRIORITY + 1, &task, xPortGetCoreID()));
+    TEST_ASSERT_EQUAL(pdFAIL, xTaskSetBudget(task, TEST_BUDGET_PERIOD + 1, TEST_BUDGET_PERIOD));
+    TEST_ASSERT_EQUAL(pdPASS, xTaskSetBudget(task, TEST_BUDGET_TICKS, TEST_BUDGET_PERIOD));
+    xTaskResumeAll();
+
+    vTaskDelay(TEST_BUDGET_NUM_PERIODS * TEST_BUDGET_PERIOD);
+
+    vTaskGetInfo(task, &status, pdFALSE, eInvalid);
+    vTaskDelete(task);
+
+    /* Allow for one period of error, as the delay may not be aligned to the budget periods */
+    TEST_ASSERT_UINT32_WITHIN(1, TEST_BUDGET_NUM_PERIODS, status.uxThrottleCount);
+    TEST_ASSERT_EQUAL(TEST_BUDGET_TICKS, status.xBudget);
+    TEST_ASSERT_EQUAL(TEST_BUDGET_PERIOD, status.xBudgetPeriod);
+    /* The polling task may not observe every tick it is charged for (e.g., the tick during which it is woken may pass
+     * before it gets to run on the Linux simulator), so only check that it got at least half of its budget */
+    TEST_ASSERT_GREATER_OR_EQUAL((TEST_BUDGET_NUM_PERIODS - 1) * TEST_BUDGET_TICKS / 2, ticks_run);
+    TEST_ASSERT_LESS_OR_EQUAL((TEST_BUDGET_NUM_PERIODS + 1) * TEST_BUDGET_TICKS, ticks_run);
+}
+
+/*
+Test that ticks that are caught up are not charged to a task budget
+
+Purpose:
+    - Test that only the tick interrupts during which a task runs are charged to its budget, and not the ticks that
+      are pended and then replayed when the scheduler is resumed
+Procedure:
+    - Give the unity task a budget of TEST_BUDGET_TICKS in every TEST_BUDGET_PERIOD ticks
+    - Catch up TEST_BUDGET_PERIOD ticks, which are pended and replayed when the scheduler is resumed
+Expected:
+    - The unity task is not throttled
+*/
+
+TEST_CASE("Tasks: Test task CPU budget is not charged for caught up ticks", "[freertos]")
+{
+    TaskStatus_t status;
+
+    TEST_ASSERT_EQUAL(pdPASS, xTaskSetBudget(NULL, TEST_BUDGET_TICKS, TEST_BUDGET_PERIOD));
+
+    xTaskCatchUpTicks(TEST_BUDGET_PERIOD);
+
+    vTaskGetInfo(NULL, &status, pdFALSE, eInvalid);
+    TEST_ASSERT_EQUAL(pdPASS, xTaskSetBudget(NULL, 0, 0));
+
+    TEST_ASSERT_EQUAL(0, status.uxThrottleCount);
+}
+
+#endif /* ( CONFIG_FREERTOS_USE_TASK_BUDGETS && CONFIG_FREERTOS_USE_TRACE_FACILITY ) */
@@ -180,3 +180,167 @@ TEST_CASE("Tasks: Test vTaskDelayUntil", "[freertos]")
 
 #endif /* ( INCLUDE_xTaskDelayUntil == 1 ) */
 #endif //SOC_GPTIMER_SUPPORTED
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+/*
+Test many concurrently delayed tasks
+
+Purpose:
+    - Test that many tasks delayed at the same time, with delays both shorter and longer than a lap of the delayed task
+      wheel (if CONFIG_FREERTOS_USE_DELAYED_TASK_WHEEL is enabled), are each unblocked on the correct tick
+Procedure:
+    - Suspend the scheduler and create TEST_DELAYED_NUM_TASKS tasks, each delaying for a different number of ticks
+    - Resume the scheduler so that all tasks block at (roughly) the same tick
+    - Check that each task is reported as blocked while delayed
+    - Each task records the number of ticks it was actually delayed for
+Expected:
+    - Each task is delayed for the requested number of ticks
+*/
+
+#define TEST_DELAYED_NUM_TASKS          20
+#define TEST_DELAYED_TICKS_STEP         7
+
+typedef struct {
+    TickType_t delay;
+    volatile TickType_t elapsed;
+    SemaphoreHandle_t done;
+} delayed_task_ctx_t;
+
+static void test_delayed_task(void *arg)
+{
+    delayed_task_ctx_t *ctx = (delayed_task_ctx_t *)arg;
+
+    TickType_t tick_start = xTaskGetTickCount();
+    vTaskDelay(ctx->delay);
+    ctx->elapsed = xTaskGetTickCount() - tick_start;
+    xSemaphoreGive(ctx->done);
+    vTaskSuspend(NULL);
+}
+
+TEST_CASE("Tasks: Test many concurrently delayed tasks", "[freertos]")
+{
+    delayed_task_ctx_t ctx[TEST_DELAYED_NUM_TASKS];
+    TaskHandle_t tasks[TEST_DELAYED_NUM_TASKS];
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(TEST_DELAYED_NUM_TASKS, 0);
+    TEST_ASSERT_NOT_EQUAL(NULL, done);
+
+    vTaskSuspendAll();
+    for (int i = 0; i < TEST_DELAYED_NUM_TASKS; i++) {
+        /* Create the tasks in reverse order of delay, so that later wake times are blocked first */
+        ctx[i].delay = (TEST_DELAYED_NUM_TASKS - i) * TEST_DELAYED_TICKS_STEP;
+        ctx[i].elapsed = 0;
+        ctx[i].done = done;
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(test_delayed_task, "delayed", configTEST_DEFAULT_STACK_SIZE, &ctx[i], configTEST_UNITY_TASK_PRIORITY + 1, &tasks[i], i % configNUMBER_OF_CORES));
+    }
+    xTaskResumeAll();
+
+    /* Let every task block, then check their states */
+    vTaskDelay(1);
+    for (int i = 0; i < TEST_DELAYED_NUM_TASKS; i++) {
+        TEST_ASSERT_EQUAL(eBlocked, eTaskGetState(tasks[i]));
+    }
+
+    for (int i = 0; i < TEST_DELAYED_NUM_TASKS; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(done, (TEST_DELAYED_NUM_TASKS + 1) * TEST_DELAYED_TICKS_STEP));
+    }
+    for (int i = 0; i < TEST_DELAYED_NUM_TASKS; i++) {
+        /* Allow one tick of error in case a tick occurs between reading the start tick and blocking */
+        TEST_ASSERT_UINT32_WITHIN(1, ctx[i].delay, ctx[i].elapsed);
+        vTaskDelete(tasks[i]);
+    }
+
+    vSemaphoreDelete(done);
+    /* Let the idle task free the deleted tasks */
+    vTaskDelay(10);
+}
+
+/*
+Test many tasks blocked with long timeouts
+
+Purpose:
+    - Test that many tasks blocked at the same time with timeouts spanning many laps of the delayed task wheel (and, with
+      the wheel size of the freertos_options CI config, several rounds of its lap slots) each time out on the correct
+      tick, if CONFIG_FREERTOS_USE_DELAYED_TASK_WHEEL is enabled
+    - Test that the tasks woken before their timeout leave the wheel, and do not disturb the others
+Procedure:
+    - Suspend the scheduler and create TEST_LONG_TIMEOUT_NUM_TASKS tasks, each taking its own semaphore with a different
+      timeout
+    - Resume the scheduler so that all tasks block at (roughly) the same tick
+    - After TEST_LONG_TIMEOUT_WAKE_TICKS, give the semaphore of every fourth task
+    - Each task records the result of the take and the number of ticks it was blocked for
+Expected:
+    - The tasks whose semaphore was given take it before their timeout
+    - The other tasks time out after the requested number of ticks
+*/
+
+#define TEST_LONG_TIMEOUT_NUM_TASKS     32
+#define TEST_LONG_TIMEOUT_BASE_TICKS    50
+#define TEST_LONG_TIMEOUT_STEP_TICKS    37
+#define TEST_LONG_TIMEOUT_WAKE_TICKS    20
+
+typedef struct {
+    TickType_t timeout;
+    SemaphoreHandle_t sem;
+    volatile BaseType_t result;
+    volatile TickType_t elapsed;
+    SemaphoreHandle_t done;
+} long_timeout_task_ctx_t;
+
+static void test_long_timeout_task(void *arg)
+{
+    long_timeout_task_ctx_t *ctx = (long_timeout_task_ctx_t *)arg;
+
+    TickType_t tick_start = xTaskGetTickCount();
+    ctx->result = xSemaphoreTake(ctx->sem, ctx->timeout);
+    ctx->elapsed = xTaskGetTickCount() - tick_start;
+    xSemaphoreGive(ctx->done);
+    vTaskSuspend(NULL);
+}
+
+TEST_CASE("Tasks: Test many tasks blocked with long timeouts", "[freertos]")
+{
+    long_timeout_task_ctx_t ctx[TEST_LONG_TIMEOUT_NUM_TASKS];
+    TaskHandle_t tasks[TEST_LONG_TIMEOUT_NUM_TASKS];
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(TEST_LONG_TIMEOUT_NUM_TASKS, 0);
+    TEST_ASSERT_NOT_EQUAL(NULL, done);
+
+    vTaskSuspendAll();
+    for (int i = 0; i < TEST_LONG_TIMEOUT_NUM_TASKS; i++) {
+        /* Create the tasks in reverse order of timeout, so that later wake times are blocked first */
+        ctx[i].timeout = TEST_LONG_TIMEOUT_BASE_TICKS + (TEST_LONG_TIMEOUT_NUM_TASKS - i) * TEST_LONG_TIMEOUT_STEP_TICKS;
+        ctx[i].sem = xSemaphoreCreateBinary();
+        TEST_ASSERT_NOT_EQUAL(NULL, ctx[i].sem);
+        ctx[i].result = pdFAIL;
+        ctx[i].elapsed = 0;
+        ctx[i].done = done;
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(test_long_timeout_task, "long", 2048, &ctx[i], configTEST_UNITY_TASK_PRIORITY + 1, &tasks[i], i % configNUMBER_OF_CORES));
+    }
+    xTaskResumeAll();
+
+    vTaskDelay(TEST_LONG_TIMEOUT_WAKE_TICKS);
+    for (int i = 0; i < TEST_LONG_TIMEOUT_NUM_TASKS; i += 4) {
+        TEST_ASSERT_EQUAL(eBlocked, eTaskGetState(tasks[i]));
+        xSemaphoreGive(ctx[i].sem);
+    }
+
+    for (int i = 0; i < TEST_LONG_TIMEOUT_NUM_TASKS; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(done, TEST_LONG_TIMEOUT_BASE_TICKS + (TEST_LONG_TIMEOUT_NUM_TASKS + 1) * TEST_LONG_TIMEOUT_STEP_TICKS));
+    }
+    for (int i = 0; i < TEST_LONG_TIMEOUT_NUM_TASKS; i++) {
+        if (i % 4 == 0) {
+            TEST_ASSERT_EQUAL(pdTRUE, ctx[i].result);
+            TEST_ASSERT_LESS_THAN_UINT32(ctx[i].timeout, ctx[i].elapsed);
+        } else {
+            TEST_ASSERT_EQUAL(pdFALSE, ctx[i].result);
+            /* Allow one tick of error in case a tick occurs between reading the start tick and blocking */
+            TEST_ASSERT_UINT32_WITHIN(1, ctx[i].timeout, ctx[i].elapsed);
+        }
+        vTaskDelete(tasks[i]);
+        vSemaphoreDelete(ctx[i].sem);
+    }
+
+    vSemaphoreDelete(done);
+    /* Let the idle task free the deleted tasks */
+    vTaskDelay(10);
+}
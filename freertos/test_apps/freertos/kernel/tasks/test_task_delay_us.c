@@ -0,0 +1,148 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include "sdkconfig.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "unity.h"
+#include "portTestMacro.h"
+
+#if CONFIG_FREERTOS_USE_TASK_DELAY_US
+
+/*
+Test microsecond task delays
+
+Purpose:
+    - Test that vTaskDelayUs() and xTaskDelayUntilUs() delay for the requested number of microseconds, regardless of
+      the tick period, and that the calling task blocks (rather than busy-waits) during the delay
+Procedure:
+    - Create a lower priority task on the same core that counts how many times it runs
+    - The unity task calls vTaskDelayUs() with delays shorter than, and not a multiple of, a tick
+    - The unity task then calls xTaskDelayUntilUs() periodically
+Expected:
+    - Each delay lasts at least the requested time, and at most TEST_DELAY_US_TOLERANCE longer
+    - Periodic delays do not drift
+    - The lower priority task runs during the delays
+*/
+
+#define TEST_DELAY_US_TOLERANCE     100
+#define TEST_DELAY_US_ITERATIONS    10
+
+static volatile uint32_t s_counter;
+
+static void counter_task(void *arg)
+{
+    while (1) {
+        s_counter++;
+    }
+}
+
+TEST_CASE("Tasks: Test microsecond task delays", "[freertos]")
+{
+    const uint32_t delays_us[] = { 10, 300, 1700, 3 * portTICK_PERIOD_MS * 1000 + 123 };
+    TaskHandle_t counter_handle;
+
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(counter_task, "counter", configTEST_DEFAULT_STACK_SIZE, NULL, configTEST_UNITY_TASK_PRIORITY - 1, &counter_handle, xPortGetCoreID()));
+
+    for (int i = 0; i < sizeof(delays_us) / sizeof(delays_us[0]); i++) {
+        uint32_t counter_start = s_counter;
+        int64_t start = esp_timer_get_time();
+        vTaskDelayUs(delays_us[i]);
+        int64_t elapsed = esp_timer_get_time() - start;
+
+        printf("Delay of %u us took %lld us\n", (unsigned)delays_us[i], elapsed);
+        TEST_ASSERT_GREATER_OR_EQUAL(delays_us[i], elapsed);
+        TEST_ASSERT_LESS_OR_EQUAL(delays_us[i] + TEST_DELAY_US_TOLERANCE, elapsed);
+        if (delays_us[i] > 2 * TEST_DELAY_US_TOLERANCE) {
+            /* The unity task was blocked, so the counter task ran */
+            TEST_ASSERT_NOT_EQUAL(counter_start, s_counter);
+        }
+    }
+
+    int64_t start = esp_timer_get_time();
+    int64_t wake_time = start;
+    for (int i = 0; i < TEST_DELAY_US_ITERATIONS; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xTaskDelayUntilUs(&wake_time, 1500));
+        /* Consume part of the period */
+        esp_rom_delay_us(200);
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    TEST_ASSERT_INT_WITHIN(TEST_DELAY_US_TOLERANCE, TEST_DELAY_US_ITERATIONS * 1500 + 200, elapsed);
+
+    /* The wake time has passed, so no delay occurs */
+    esp_rom_delay_us(2000);
+    TEST_ASSERT_EQUAL(pdFALSE, xTaskDelayUntilUs(&wake_time, 1500));
+
+    vTaskDelete(counter_handle);
+    /* Let the idle task free the deleted task */
+    vTaskDelay(10);
+}
+
+/*
+Test that a microsecond delay does not unblock a task that left the Blocked state by other means
+
+Purpose:
+    - Test that the timer of a task delayed by vTaskDelayUs() is stopped when the task is suspended, deleted or its
+      delay is aborted, so that it does not later unblock the task (or access a freed task)
+Procedure:
+    - Create a higher priority task on the same core that calls vTaskDelayUs() in a loop, counting its delays
+    - Suspend the task during its delay, then wait past the end of the delay
+    - Resume the task, abort its next delay, then wait past the end of the delay
+    - Delete the task during its delay, then wait past the end of the delay
+Expected:
+    - The suspended task stays suspended past the end of its delay
+    - The aborted delay returns early, and the task then delays again as normal
+    - Deleting the task during its delay does not crash
+*/
+
+#define TEST_DELAY_US_LONG      (5 * portTICK_PERIOD_MS * 1000)
+
+static volatile uint32_t s_delays;
+
+static void delay_us_task(void *arg)
+{
+    while (1) {
+        vTaskDelayUs(TEST_DELAY_US_LONG);
+        s_delays++;
+    }
+}
+
+TEST_CASE("Tasks: Test microsecond task delay with suspend, abort and delete", "[freertos]")
+{
+    TaskHandle_t task;
+
+    s_delays = 0;
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(delay_us_task, "delay_us", configTEST_DEFAULT_STACK_SIZE, NULL, configTEST_UNITY_TASK_PRIORITY + 1, &task, xPortGetCoreID()));
+
+    /* The task is in its first delay */
+    vTaskSuspend(task);
+    esp_rom_delay_us(2 * TEST_DELAY_US_LONG);
+    vTaskDelay(1);
+    TEST_ASSERT_EQUAL(eSuspended, eTaskGetState(task));
+    TEST_ASSERT_EQUAL(0, s_delays);
+
+    /* The first delay completes once the task is resumed, and the task enters its second delay */
+    vTaskResume(task);
+    TEST_ASSERT_EQUAL(1, s_delays);
+    TEST_ASSERT_EQUAL(eBlocked, eTaskGetState(task));
+
+    /* Aborting the second delay only busy-waits for its remainder, then the task enters its third delay */
+    TEST_ASSERT_EQUAL(pdPASS, xTaskAbortDelay(task));
+    TEST_ASSERT_EQUAL(2, s_delays);
+    TEST_ASSERT_EQUAL(eBlocked, eTaskGetState(task));
+
+    /* The task is deleted during its third delay */
+    vTaskDelete(task);
+    esp_rom_delay_us(2 * TEST_DELAY_US_LONG);
+    /* Let the idle task free the deleted task */
+    vTaskDelay(10);
+    TEST_ASSERT_EQUAL(2, s_delays);
+}
+
+#endif /* CONFIG_FREERTOS_USE_TASK_DELAY_US */
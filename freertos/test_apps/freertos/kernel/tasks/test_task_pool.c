@@ -0,0 +1,146 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+#include "unity.h"
+#include "test_utils.h"
+
+#if CONFIG_FREERTOS_USE_TASK_POOLS
+#include "freertos/task_pool.h"
+
+#define POOL_NUM_TASKS      3
+#define POOL_STACK_SIZE     2048
+#define POOL_NUM_ROUNDS     20
+
+/*
+Test task pool occupancy and reuse
+
+Purpose:
+    - Test that tasks created from a pool take their TCB and stack from the pool, and give them back once deleted,
+      without allocating from the heap
+Procedure:
+    - Create a pool of POOL_NUM_TASKS tasks
+    - Repeatedly create POOL_NUM_TASKS tasks from the pool, which block on a semaphore, then try to create one more
+    - Release the tasks, which then delete themselves, and wait for them to be cleaned up
+    - Check the pool statistics and free heap, then delete the pool
+Expected:
+    - Creating a task from a full pool fails and is counted as an allocation failure
+    - Each round finds the pool empty again once the tasks have deleted themselves
+    - The free heap does not change between the first and the last round
+*/
+
+static void pool_task(void *arg)
+{
+    SemaphoreHandle_t release = (SemaphoreHandle_t)arg;
+
+    xSemaphoreTake(release, portMAX_DELAY);
+    vTaskDelete(NULL);
+}
+
+static void run_pool_round(TaskPoolHandle_t pool, SemaphoreHandle_t release)
+{
+    TaskPoolStats_t stats;
+
+    for (int i = 0; i < POOL_NUM_TASKS; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreateFromPool(pool, pool_task, "pool", release, UNITY_FREERTOS_PRIORITY + 1, NULL, tskNO_AFFINITY));
+    }
+    TEST_ASSERT_EQUAL(errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY, xTaskCreateFromPool(pool, pool_task, "pool", release, UNITY_FREERTOS_PRIORITY + 1, NULL, tskNO_AFFINITY));
+
+    vTaskPoolGetStats(pool, &stats);
+    TEST_ASSERT_EQUAL(POOL_NUM_TASKS, stats.uxInUse);
+
+    for (int i = 0; i < POOL_NUM_TASKS; i++) {
+        xSemaphoreGive(release);
+    }
+
+    /* Wait for the deleted tasks to be cleaned up */
+    vTaskDelay(10);
+    vTaskPoolGetStats(pool, &stats);
+    TEST_ASSERT_EQUAL(0, stats.uxInUse);
+}
+
+TEST_CASE("Tasks: Test task pool occupancy and reuse", "[freertos]")
+{
+    TaskPoolStats_t stats;
+    SemaphoreHandle_t release = xSemaphoreCreateCounting(POOL_NUM_TASKS, 0);
+    TEST_ASSERT_NOT_EQUAL(NULL, release);
+    TaskPoolHandle_t pool = xTaskPoolCreate(POOL_NUM_TASKS, POOL_STACK_SIZE);
+    TEST_ASSERT_NOT_EQUAL(NULL, pool);
+
+    run_pool_round(pool, release);
+    size_t heap_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    for (int i = 1; i < POOL_NUM_ROUNDS; i++) {
+        run_pool_round(pool, release);
+    }
+    size_t heap_after = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    vTaskPoolGetStats(pool, &stats);
+    TEST_ASSERT_EQUAL(POOL_NUM_TASKS, stats.uxCapacity);
+    TEST_ASSERT_EQUAL(POOL_NUM_TASKS, stats.uxPeakInUse);
+    TEST_ASSERT_EQUAL(POOL_NUM_ROUNDS, stats.uxAllocFailures);
+    TEST_ASSERT_EQUAL(heap_before, heap_after);
+
+    TEST_ASSERT_EQUAL(pdPASS, xTaskPoolDelete(pool));
+    vSemaphoreDelete(release);
+}
+
+/*
+Test task pools together with an application memory reclaim hook
+
+Purpose:
+    - Test that task pools keep getting their TCBs and stacks back when the application installs its own memory
+      reclaim hook, and that the application's hook is still called for other tasks
+Procedure:
+    - Create a pool, then install an application hook that counts its calls and does not take back any memory
+    - Run a round of tasks created from the pool
+    - Create a dynamically allocated task that deletes itself, and wait for it to be cleaned up
+    - Remove the application hook
+Expected:
+    - The pool is empty again after the round of tasks
+    - The application hook was only called for the dynamically allocated task
+*/
+
+static volatile UBaseType_t app_hook_calls;
+
+static BaseType_t app_reclaim_hook(TaskHandle_t xTask, StackType_t *pxStack)
+{
+    app_hook_calls++;
+    return pdFALSE;
+}
+
+static void self_delete_task(void *arg)
+{
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("Tasks: Test task pool with an application memory reclaim hook", "[freertos]")
+{
+    SemaphoreHandle_t release = xSemaphoreCreateCounting(POOL_NUM_TASKS, 0);
+    TEST_ASSERT_NOT_EQUAL(NULL, release);
+    TaskPoolHandle_t pool = xTaskPoolCreate(POOL_NUM_TASKS, POOL_STACK_SIZE);
+    TEST_ASSERT_NOT_EQUAL(NULL, pool);
+
+    app_hook_calls = 0;
+    vTaskSetMemoryReclaimHook(app_reclaim_hook);
+
+    run_pool_round(pool, release);
+    TEST_ASSERT_EQUAL(0, app_hook_calls);
+
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(self_delete_task, "dyn", POOL_STACK_SIZE, NULL, UNITY_FREERTOS_PRIORITY + 1, NULL, tskNO_AFFINITY));
+    /* Wait for the deleted task to be cleaned up */
+    vTaskDelay(10);
+    vTaskSetMemoryReclaimHook(NULL);
+    TEST_ASSERT_EQUAL(1, app_hook_calls);
+
+    TEST_ASSERT_EQUAL(pdPASS, xTaskPoolDelete(pool));
+    vSemaphoreDelete(release);
+}
+
+#endif /* CONFIG_FREERTOS_USE_TASK_POOLS */
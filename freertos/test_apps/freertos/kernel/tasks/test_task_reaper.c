@@ -0,0 +1,140 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include "sdkconfig.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "esp_heap_caps.h"
+#include "unity.h"
+#include "test_utils.h"
+#include "portTestMacro.h"
+
+#if CONFIG_FREERTOS_USE_TASK_REAPER
+
+/*
+Test that the task reaper frees self-deleted tasks while the idle task is starved
+
+Purpose:
+    - Test that the TCB and stack of tasks that delete themselves are freed by the reaper task, without relying on
+      the idle task getting CPU time
+Procedure:
+    - Create a busy task on each core, at the same priority as the reaper, that does not block until told to stop.
+      This starves the idle tasks, but lets the reaper run in its time slices.
+    - Create a number of tasks (more than one reaper batch) that delete themselves, then wait a few ticks
+    - Check the free heap and reaper statistics, then stop the busy tasks
+Expected:
+    - All self-deleted tasks are freed while the idle tasks are still starved
+    - The free heap returns to its value before the tasks were created
+*/
+
+#define TEST_REAPER_NUM_TASKS       (CONFIG_FREERTOS_TASK_REAPER_BATCH_SIZE * 2 + 1)
+
+static volatile bool busy_run;
+
+static void busy_task(void *arg)
+{
+    while (busy_run) {
+        ;
+    }
+    xTaskNotifyGive((TaskHandle_t)arg);
+    vTaskSuspend(NULL);
+}
+
+static void self_delete_task(void *arg)
+{
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("Tasks: Test task reaper frees self-deleted tasks while idle is starved", "[freertos]")
+{
+    TaskHandle_t busy_tasks[portNUM_PROCESSORS];
+    TaskReaperStats_t stats_before;
+    TaskReaperStats_t stats_after;
+
+    /* The busy tasks must have a priority above the idle tasks, and below this task */
+    TEST_ASSERT_GREATER_THAN(tskIDLE_PRIORITY, CONFIG_FREERTOS_TASK_REAPER_PRIORITY);
+    TEST_ASSERT_LESS_THAN(UNITY_FREERTOS_PRIORITY, CONFIG_FREERTOS_TASK_REAPER_PRIORITY);
+
+    busy_run = true;
+    for (int i = 0; i < portNUM_PROCESSORS; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(busy_task, "busy", configTEST_DEFAULT_STACK_SIZE, xTaskGetCurrentTaskHandle(), CONFIG_FREERTOS_TASK_REAPER_PRIORITY, &busy_tasks[i], i));
+    }
+
+    vTaskGetReaperStats(&stats_before);
+    size_t heap_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    for (int i = 0; i < TEST_REAPER_NUM_TASKS; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(self_delete_task, "del", configTEST_DEFAULT_STACK_SIZE, NULL, UNITY_FREERTOS_PRIORITY + 1, NULL, i % portNUM_PROCESSORS));
+    }
+
+    /* Let the reaper run, but not the idle tasks */
+    vTaskDelay(10);
+
+    vTaskGetReaperStats(&stats_after);
+    size_t heap_after = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    busy_run = false;
+    for (int i = 0; i < portNUM_PROCESSORS; i++) {
+        TEST_ASSERT_EQUAL(1, ulTaskNotifyTake(pdTRUE, portMAX_DELAY));
+        vTaskDelete(busy_tasks[i]);
+    }
+
+    printf("Reclaimed %u tasks, max latency %u ticks\n", (unsigned)(stats_after.uxTasksReclaimed - stats_before.uxTasksReclaimed), (unsigned)stats_after.xMaxReclaimLatency);
+    TEST_ASSERT_EQUAL(TEST_REAPER_NUM_TASKS, stats_after.uxTasksReclaimed - stats_before.uxTasksReclaimed);
+    TEST_ASSERT_LESS_OR_EQUAL(stats_after.xMaxReclaimLatency, stats_after.xLastReclaimLatency);
+    TEST_ASSERT_EQUAL(heap_before, heap_after);
+}
+
+/*
+Test that the memory reclaim hook is only called for dynamically allocated tasks
+
+Purpose:
+    - Test that the memory reclaim hook is offered the TCB and stack of a deleted task only if the kernel would
+      otherwise free them, and not those of a statically allocated task, which belong to the application
+Procedure:
+    - Install a reclaim hook that records the tasks it is called for, and does not take back their memory
+    - Create a dynamically allocated task and a statically allocated task, which both delete themselves
+    - Wait for the deleted tasks to be cleaned up, then remove the hook
+Expected:
+    - The hook was called for the dynamically allocated task only
+    - The free heap returns to its value before the tasks were created
+*/
+
+static volatile UBaseType_t hook_calls;
+static volatile TaskHandle_t hook_task;
+
+static BaseType_t record_reclaim_hook(TaskHandle_t xTask, StackType_t *pxStack)
+{
+    hook_calls++;
+    hook_task = xTask;
+    return pdFALSE;
+}
+
+TEST_CASE("Tasks: Test task memory reclaim hook is only called for dynamically allocated tasks", "[freertos]")
+{
+    static StaticTask_t static_tcb;
+    static StackType_t static_stack[configTEST_DEFAULT_STACK_SIZE];
+    TaskHandle_t dynamic_task;
+
+    hook_calls = 0;
+    hook_task = NULL;
+    vTaskSetMemoryReclaimHook(record_reclaim_hook);
+    size_t heap_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(self_delete_task, "dyn", configTEST_DEFAULT_STACK_SIZE, NULL, UNITY_FREERTOS_PRIORITY + 1, &dynamic_task, xPortGetCoreID()));
+    TEST_ASSERT_NOT_NULL(xTaskCreateStaticPinnedToCore(self_delete_task, "static", configTEST_DEFAULT_STACK_SIZE, NULL, UNITY_FREERTOS_PRIORITY + 1, static_stack, &static_tcb, xPortGetCoreID()));
+
+    /* Let the reaper and the idle task clean up the deleted tasks */
+    vTaskDelay(10);
+    vTaskSetMemoryReclaimHook(NULL);
+
+    TEST_ASSERT_EQUAL(1, hook_calls);
+    TEST_ASSERT_EQUAL_PTR(dynamic_task, hook_task);
+    TEST_ASSERT_EQUAL(heap_before, heap_caps_get_free_size(MALLOC_CAP_8BIT));
+}
+
+#endif /* CONFIG_FREERTOS_USE_TASK_REAPER */
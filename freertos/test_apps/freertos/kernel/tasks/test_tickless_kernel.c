@@ -0,0 +1,65 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include "sdkconfig.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "esp_freertos_hooks.h"
+#include "esp_timer.h"
+#include "unity.h"
+#include "portTestMacro.h"
+
+#if CONFIG_FREERTOS_USE_TICKLESS_KERNEL
+
+/*
+Test the tickless kernel
+
+Purpose:
+    - Test that when no task needs to run, the tick interrupt is only generated when the kernel next has work to do,
+      while the tick count and delays remain accurate
+Procedure:
+    - Register a tick hook that counts the number of tick interrupts
+    - The unity task delays for TEST_TICKLESS_DELAY_TICKS ticks, while the tick count and the elapsed time are measured
+Expected:
+    - Far fewer tick interrupts than ticks occur during the delay
+    - The tick count advances by the delay, and the elapsed time matches the delay to within a tick
+*/
+
+#define TEST_TICKLESS_DELAY_TICKS   100
+
+static volatile uint32_t s_tick_interrupts;
+
+static void tick_hook(void)
+{
+    s_tick_interrupts++;
+}
+
+TEST_CASE("Tasks: Test tickless kernel only interrupts on kernel events", "[freertos]")
+{
+    TEST_ASSERT_EQUAL(ESP_OK, esp_register_freertos_tick_hook(tick_hook));
+
+    /* Align to a tick boundary */
+    vTaskDelay(1);
+
+    s_tick_interrupts = 0;
+    TickType_t start_ticks = xTaskGetTickCount();
+    int64_t start_us = esp_timer_get_time();
+    vTaskDelay(TEST_TICKLESS_DELAY_TICKS);
+    int64_t elapsed_us = esp_timer_get_time() - start_us;
+    TickType_t elapsed_ticks = xTaskGetTickCount() - start_ticks;
+    uint32_t interrupts = s_tick_interrupts;
+
+    esp_deregister_freertos_tick_hook(tick_hook);
+
+    printf("%u tick interrupts over %u ticks\n", (unsigned)interrupts, (unsigned)elapsed_ticks);
+    /* Other tasks of the test app (e.g., the timer task) may still need a few ticks */
+    TEST_ASSERT_LESS_THAN(TEST_TICKLESS_DELAY_TICKS / 4, interrupts);
+    TEST_ASSERT_INT_WITHIN(1, TEST_TICKLESS_DELAY_TICKS, elapsed_ticks);
+    TEST_ASSERT_INT_WITHIN(portTICK_PERIOD_MS * 1000, TEST_TICKLESS_DELAY_TICKS * portTICK_PERIOD_MS * 1000, elapsed_us);
+}
+
+#endif /* CONFIG_FREERTOS_USE_TICKLESS_KERNEL */
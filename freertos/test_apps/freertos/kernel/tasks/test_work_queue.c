@@ -0,0 +1,158 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sdkconfig.h"
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/work_queue.h"
+#include "unity.h"
+#include "test_utils.h"
+
+#define NUM_WORKERS         (2 * portNUM_PROCESSORS)
+#define NUM_JOBS            64
+#define QUEUE_LEN           16
+
+/*
+Test work queue futures
+
+Purpose:
+    - Test that every job submitted to a work queue runs exactly once, and that its result is returned through its
+      future
+
+Procedure:
+    - Create a work queue with workers pinned to each core and two job priorities
+    - Submit NUM_JOBS jobs alternating between the job priorities, each with a future
+    - Wait on every future
+
+Expected:
+    - Every future completes with the result computed by its job
+    - Every job has run exactly once
+*/
+
+static volatile uint32_t job_runs[NUM_JOBS];
+
+static void *square_job(void *arg)
+{
+    uint32_t i = (uint32_t)(uintptr_t)arg;
+
+    job_runs[i]++;
+    return (void *)(uintptr_t)(i * i);
+}
+
+TEST_CASE("Work queue: futures", "[freertos]")
+{
+    const WorkQueueConfig_t config = {
+        .uxNumWorkers = NUM_WORKERS,
+        .uxWorkerPriority = UNITY_FREERTOS_PRIORITY - 1,
+        .ulWorkerStackSize = 2048,
+        .xPinWorkers = pdTRUE,
+        .uxNumJobPriorities = 2,
+        .uxQueueLength = QUEUE_LEN,
+        .uxNotifyIndex = 0,
+    };
+    static WorkFuture_t futures[NUM_JOBS];
+
+    WorkQueueHandle_t work_queue = xWorkQueueCreate(&config);
+    TEST_ASSERT_NOT_EQUAL(NULL, work_queue);
+
+    for (uint32_t i = 0; i < NUM_JOBS; i++) {
+        job_runs[i] = 0;
+        TEST_ASSERT_EQUAL(pdPASS, xWorkQueueSubmit(work_queue, square_job, (void *)(uintptr_t)i, i % 2, &futures[i], portMAX_DELAY));
+    }
+
+    for (uint32_t i = 0; i < NUM_JOBS; i++) {
+        void *result;
+        TEST_ASSERT_EQUAL(pdPASS, xWorkFutureWait(&futures[i], &result, pdMS_TO_TICKS(1000)));
+        TEST_ASSERT_EQUAL(i * i, (uint32_t)(uintptr_t)result);
+    }
+
+    for (uint32_t i = 0; i < NUM_JOBS; i++) {
+        TEST_ASSERT_EQUAL(1, job_runs[i]);
+    }
+
+    vWorkQueueDelete(work_queue);
+}
+
+/*
+Test work queue job priorities
+
+Purpose:
+    - Test that pending high priority jobs run before pending low priority jobs
+
+Procedure:
+    - Create a work queue with a single worker and two job priorities
+    - Submit a job that blocks the worker until released, so that the following jobs stay pending
+    - Submit low priority jobs, then high priority jobs, each recording the order in which it ran
+    - Release the worker and wait for all jobs
+
+Expected:
+    - All high priority jobs run before any low priority job
+*/
+
+#define NUM_PRIO_JOBS       4
+
+static volatile uint32_t run_order;
+static TaskHandle_t volatile gate_worker;
+
+static void *gate_job(void *arg)
+{
+    gate_worker = xTaskGetCurrentTaskHandle();
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    return NULL;
+}
+
+static void *order_job(void *arg)
+{
+    return (void *)(uintptr_t)(run_order++);
+}
+
+TEST_CASE("Work queue: job priorities", "[freertos]")
+{
+    const WorkQueueConfig_t config = {
+        .uxNumWorkers = 1,
+        .uxWorkerPriority = UNITY_FREERTOS_PRIORITY + 1,
+        .ulWorkerStackSize = 2048,
+        .xPinWorkers = pdTRUE,
+        .uxNumJobPriorities = 2,
+        .uxQueueLength = QUEUE_LEN,
+        .uxNotifyIndex = 0,
+    };
+    WorkFuture_t gate_future;
+    WorkFuture_t low_futures[NUM_PRIO_JOBS];
+    WorkFuture_t high_futures[NUM_PRIO_JOBS];
+    run_order = 0;
+    gate_worker = NULL;
+    WorkQueueHandle_t work_queue = xWorkQueueCreate(&config);
+    TEST_ASSERT_NOT_EQUAL(NULL, work_queue);
+
+    /* The worker has a higher priority, so it picks up the gate job right away */
+    TEST_ASSERT_EQUAL(pdPASS, xWorkQueueSubmit(work_queue, gate_job, NULL, 0, &gate_future, portMAX_DELAY));
+    for (int i = 0; i < NUM_PRIO_JOBS; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xWorkQueueSubmit(work_queue, order_job, NULL, 0, &low_futures[i], portMAX_DELAY));
+    }
+    for (int i = 0; i < NUM_PRIO_JOBS; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xWorkQueueSubmit(work_queue, order_job, NULL, 1, &high_futures[i], portMAX_DELAY));
+    }
+
+    /* Release the worker blocked in gate_job */
+    TEST_ASSERT_NOT_EQUAL(NULL, gate_worker);
+    xTaskNotifyGive(gate_worker);
+    TEST_ASSERT_EQUAL(pdPASS, xWorkFutureWait(&gate_future, NULL, pdMS_TO_TICKS(1000)));
+
+    for (int i = 0; i < NUM_PRIO_JOBS; i++) {
+        void *result;
+        TEST_ASSERT_EQUAL(pdPASS, xWorkFutureWait(&high_futures[i], &result, pdMS_TO_TICKS(1000)));
+        TEST_ASSERT_LESS_THAN(NUM_PRIO_JOBS, (uint32_t)(uintptr_t)result);
+    }
+    for (int i = 0; i < NUM_PRIO_JOBS; i++) {
+        void *result;
+        TEST_ASSERT_EQUAL(pdPASS, xWorkFutureWait(&low_futures[i], &result, pdMS_TO_TICKS(1000)));
+        TEST_ASSERT_GREATER_OR_EQUAL(NUM_PRIO_JOBS, (uint32_t)(uintptr_t)result);
+    }
+
+    vWorkQueueDelete(work_queue);
+}
@@ -94,3 +94,138 @@ TEST_CASE("scheduling time test", "[freertos]")
     /* Cleanup */
     vSemaphoreDelete(context.end_sema);
 }
+
+typedef struct {
+    SemaphoreHandle_t end_sema;
+    uint32_t before_sched;
+    uint32_t cycles_to_sched[NUMBER_OF_ITERATIONS];
+    TaskHandle_t high_prio_handle;
+} test_gap_context_t;
+
+static void test_high_prio_task(void *arg)
+{
+    test_gap_context_t *context = (test_gap_context_t *)arg;
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        context->before_sched = esp_cpu_get_cycle_count();
+    }
+}
+
+static void test_low_prio_task(void *arg)
+{
+    test_gap_context_t *context = (test_gap_context_t *)arg;
+
+    for (int i = 0; i < NUMBER_OF_ITERATIONS; i++) {
+        /* The high priority task preempts this task, then blocks again */
+        xTaskNotifyGive(context->high_prio_handle);
+        context->cycles_to_sched[i] = esp_cpu_get_cycle_count() - context->before_sched;
+    }
+
+    xSemaphoreGive(context->end_sema);
+    vTaskDelete(context->high_prio_handle);
+    vTaskDelete(NULL);
+}
+
+/*
+ * Measure the time it takes to switch from a task that blocks at a high priority to a ready task of a much lower
+ * priority. Without a ready priority bitmap (CONFIG_FREERTOS_USE_READY_PRIORITY_BITMAP) and port optimised task
+ * selection, the scheduler walks down the empty ready lists of every priority in between.
+ */
+TEST_CASE("scheduling time test with a large priority gap", "[freertos]")
+{
+    test_gap_context_t context;
+#if !CONFIG_FREERTOS_UNICORE
+    const BaseType_t core_id = 1;
+#else
+    const BaseType_t core_id = 0;
+#endif
+
+    context.end_sema = xSemaphoreCreateBinary();
+    TEST_ASSERT(context.end_sema != NULL);
+
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(test_high_prio_task, "test_high", 4096, &context, configMAX_PRIORITIES - 2, &context.high_prio_handle, core_id));
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(test_low_prio_task, "test_low", 4096, &context, tskIDLE_PRIORITY + 1, NULL, core_id));
+
+    BaseType_t result = xSemaphoreTake(context.end_sema, portMAX_DELAY);
+    TEST_ASSERT_EQUAL_HEX32(pdTRUE, result);
+
+    uint32_t median_cycles = calculate_median(context.cycles_to_sched, NUMBER_OF_ITERATIONS);
+    IDF_LOG_PERFORMANCE("scheduling_time_priority_gap", "%"PRIu32" cycles", median_cycles);
+
+    /* Cleanup */
+    vSemaphoreDelete(context.end_sema);
+    /* Let the idle task free the deleted tasks */
+    vTaskDelay(10);
+}
+
+#define NUMBER_OF_RING_TASKS 16
+
+typedef struct {
+    SemaphoreHandle_t end_sema;
+    volatile bool done;
+    uint32_t before_sched;
+    int iteration;
+    uint32_t cycles_to_sched[NUMBER_OF_ITERATIONS];
+} test_ring_context_t;
+
+static void test_ring_task(void *arg)
+{
+    test_ring_context_t *context = (test_ring_context_t *)arg;
+
+    while (!context->done) {
+        context->before_sched = esp_cpu_get_cycle_count();
+        taskYIELD();
+        /* Time taken to switch from the previous task of the ring to this one */
+        uint32_t cycles = esp_cpu_get_cycle_count() - context->before_sched;
+
+        if (!context->done) {
+            context->cycles_to_sched[context->iteration++] = cycles;
+            if (context->iteration == NUMBER_OF_ITERATIONS) {
+                context->done = true;
+            }
+        }
+    }
+
+    xSemaphoreGive(context->end_sema);
+    vTaskSuspend(NULL);
+}
+
+/*
+ * Measure the time it takes to switch between tasks of the same priority when each switch is to a different task
+ * among NUMBER_OF_RING_TASKS, rather than between the same two tasks. The TCBs of the tasks are separate allocations,
+ * so this shows the cost of the TCB fields used by the context switch not being in the cache, and thus how compactly
+ * TCB_t groups them.
+ */
+TEST_CASE("scheduling time test with many tasks", "[freertos]")
+{
+    static test_ring_context_t context;
+    TaskHandle_t handles[NUMBER_OF_RING_TASKS];
+
+    context.done = false;
+    context.iteration = 0;
+    context.end_sema = xSemaphoreCreateCounting(NUMBER_OF_RING_TASKS, 0);
+    TEST_ASSERT(context.end_sema != NULL);
+
+    /* Create all tasks before any of them runs, as they never block */
+    vTaskSuspendAll();
+    for (int i = 0; i < NUMBER_OF_RING_TASKS; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(test_ring_task, "ring", 4096, &context, CONFIG_UNITY_FREERTOS_PRIORITY + 1, &handles[i], 0));
+    }
+    xTaskResumeAll();
+
+    for (int i = 0; i < NUMBER_OF_RING_TASKS; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(context.end_sema, portMAX_DELAY));
+    }
+
+    uint32_t median_cycles = calculate_median(context.cycles_to_sched, NUMBER_OF_ITERATIONS);
+    IDF_LOG_PERFORMANCE("scheduling_time_many_tasks", "%"PRIu32" cycles", median_cycles);
+
+    /* Cleanup */
+    for (int i = 0; i < NUMBER_OF_RING_TASKS; i++) {
+        vTaskDelete(handles[i]);
+    }
+    vSemaphoreDelete(context.end_sema);
+    /* Let the idle task free the deleted tasks */
+    vTaskDelay(10);
+}
@@ -0,0 +1,88 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "unity.h"
+#include "test_utils.h"
+
+#define NUMBER_OF_ROUND_TRIPS 10000
+
+typedef struct {
+    SemaphoreHandle_t end_sema;
+    volatile bool done;
+    int64_t elapsed_ns;
+} test_round_trip_context_t;
+
+static int64_t monotonic_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((int64_t) ts.tv_sec * 1000000000LL) + ts.tv_nsec;
+}
+
+static void test_yield_peer_task(void *arg)
+{
+    test_round_trip_context_t *context = (test_round_trip_context_t *)arg;
+
+    while (!context->done) {
+        taskYIELD();
+    }
+
+    xSemaphoreGive(context->end_sema);
+    vTaskSuspend(NULL);
+}
+
+static void test_yield_timed_task(void *arg)
+{
+    test_round_trip_context_t *context = (test_round_trip_context_t *)arg;
+
+    /* Each yield switches to the peer task, which immediately yields back */
+    int64_t start = monotonic_time_ns();
+    for (int i = 0; i < NUMBER_OF_ROUND_TRIPS; i++) {
+        taskYIELD();
+    }
+    context->elapsed_ns = monotonic_time_ns() - start;
+
+    context->done = true;
+    xSemaphoreGive(context->end_sema);
+    vTaskSuspend(NULL);
+}
+
+/*
+ * Measure the round trip time of two tasks of the same priority yielding to each other. Unlike the cycle count based
+ * scheduling time tests, this only relies on the monotonic clock, so that it is also built for the Linux simulator,
+ * where it measures the handoff between the threads of the tasks.
+ */
+TEST_CASE("yield round trip time test", "[freertos]")
+{
+    test_round_trip_context_t context = { .done = false };
+    TaskHandle_t peer_handle;
+    TaskHandle_t timed_handle;
+
+    context.end_sema = xSemaphoreCreateCounting(2, 0);
+    TEST_ASSERT(context.end_sema != NULL);
+
+    /* Create both tasks before either runs, as the peer task never blocks */
+    vTaskSuspendAll();
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(test_yield_peer_task, "peer", 4096, &context, CONFIG_UNITY_FREERTOS_PRIORITY + 1, &peer_handle, 0));
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(test_yield_timed_task, "timed", 4096, &context, CONFIG_UNITY_FREERTOS_PRIORITY + 1, &timed_handle, 0));
+    xTaskResumeAll();
+
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(context.end_sema, portMAX_DELAY));
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(context.end_sema, portMAX_DELAY));
+
+    IDF_LOG_PERFORMANCE("yield_round_trip_time", "%"PRId64" ns", context.elapsed_ns / NUMBER_OF_ROUND_TRIPS);
+
+    /* Cleanup */
+    vTaskDelete(peer_handle);
+    vTaskDelete(timed_handle);
+    vSemaphoreDelete(context.end_sema);
+}
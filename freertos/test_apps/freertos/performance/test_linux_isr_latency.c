@@ -0,0 +1,100 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <time.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "unity.h"
+#include "test_utils.h"
+
+#if CONFIG_IDF_TARGET_LINUX && !CONFIG_FREERTOS_LINUX_COROUTINE_PORT
+
+#define ISR_LATENCY_ITERATIONS      1000
+#define ISR_LATENCY_LINE_PRIO       2
+
+/*
+ * ISR to task latency benchmark of the Linux simulator: a lower priority task triggers a simulated interrupt, whose ISR
+ * gives a semaphore to a higher priority task. The host time from the trigger to the entry of the ISR (from the line
+ * statistics) and to the return of the woken task from xSemaphoreTake() are averaged.
+ */
+
+static BaseType_t latency_line = -1;
+static SemaphoreHandle_t latency_sem;
+static SemaphoreHandle_t latency_done;
+static volatile int64_t trigger_ns;
+static int64_t total_wake_ns;
+static int64_t max_wake_ns;
+
+static int64_t host_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((int64_t) ts.tv_sec * 1000000000LL) + ts.tv_nsec;
+}
+
+static BaseType_t latency_isr(void *arg)
+{
+    BaseType_t task_woken = pdFALSE;
+
+    xSemaphoreGiveFromISR(latency_sem, &task_woken);
+    return task_woken;
+}
+
+static void woken_task(void *arg)
+{
+    for (int i = 0; i < ISR_LATENCY_ITERATIONS; i++) {
+        xSemaphoreTake(latency_sem, portMAX_DELAY);
+        int64_t wake_ns = host_time_ns() - trigger_ns;
+        total_wake_ns += wake_ns;
+        if (wake_ns > max_wake_ns) {
+            max_wake_ns = wake_ns;
+        }
+        xSemaphoreGive(latency_done);
+    }
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("Linux simulator: ISR to task latency", "[freertos]")
+{
+    PortSimulatedInterruptStats_t stats_before;
+    PortSimulatedInterruptStats_t stats_after;
+
+    latency_sem = xSemaphoreCreateBinary();
+    latency_done = xSemaphoreCreateBinary();
+    TEST_ASSERT_NOT_NULL(latency_sem);
+    TEST_ASSERT_NOT_NULL(latency_done);
+    // Lines cannot be freed, so the line is allocated by the first run only
+    if (latency_line < 0) {
+        latency_line = xPortAllocateSimulatedInterrupt(ISR_LATENCY_LINE_PRIO, latency_isr, NULL);
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(0, latency_line);
+    total_wake_ns = 0;
+    max_wake_ns = 0;
+
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(woken_task, "woken", 4096, NULL, UNITY_FREERTOS_PRIORITY + 1, NULL));
+    vPortGetSimulatedInterruptStats(latency_line, &stats_before);
+    for (int i = 0; i < ISR_LATENCY_ITERATIONS; i++) {
+        trigger_ns = host_time_ns();
+        vPortTriggerSimulatedInterrupt(latency_line);
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(latency_done, pdMS_TO_TICKS(1000)));
+    }
+    vPortGetSimulatedInterruptStats(latency_line, &stats_after);
+
+    uint64_t runs = stats_after.ullRuns - stats_before.ullRuns;
+    TEST_ASSERT_EQUAL(ISR_LATENCY_ITERATIONS, runs);
+    IDF_LOG_PERFORMANCE("linux_isr_entry_latency", "%"PRIu64" ns", (stats_after.ullTotalLatencyNs - stats_before.ullTotalLatencyNs) / runs);
+    IDF_LOG_PERFORMANCE("linux_isr_to_task_latency", "%"PRId64" ns", total_wake_ns / ISR_LATENCY_ITERATIONS);
+    IDF_LOG_PERFORMANCE("linux_isr_to_task_max_latency", "%"PRId64" ns", max_wake_ns);
+
+    vSemaphoreDelete(latency_done);
+    vSemaphoreDelete(latency_sem);
+}
+
+#endif // CONFIG_IDF_TARGET_LINUX && !CONFIG_FREERTOS_LINUX_COROUTINE_PORT
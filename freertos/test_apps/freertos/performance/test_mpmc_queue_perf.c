@@ -0,0 +1,117 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <esp_types.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/mpmc_queue.h"
+#include "esp_timer.h"
+#include "unity.h"
+#include "test_utils.h"
+
+#if !CONFIG_FREERTOS_UNICORE
+
+#define QUEUE_LEN               64
+#define ITEMS_PER_PRODUCER      20000
+#define TASKS_PER_SIDE          configNUMBER_OF_CORES   /* One producer and one consumer on each core */
+
+/*
+ * Scalability benchmark: one producer and one consumer per core hammer the same queue. The total time taken to move
+ * every item through a regular FreeRTOS queue (which serializes all cores on the queue's spinlock) is compared
+ * against an MPMC queue (where producers and consumers only contend on a CAS of their own position counter).
+ */
+
+typedef struct {
+    BaseType_t use_mpmc;
+    QueueHandle_t queue;
+    MpmcQueueHandle_t mpmc;
+    SemaphoreHandle_t done;
+} bench_ctx_t;
+
+static void bench_producer(void *arg)
+{
+    bench_ctx_t *ctx = (bench_ctx_t *)arg;
+
+    for (uint32_t i = 0; i < ITEMS_PER_PRODUCER; i++) {
+        if (ctx->use_mpmc) {
+            xMpmcQueueSend(ctx->mpmc, &i, portMAX_DELAY);
+        } else {
+            xQueueSend(ctx->queue, &i, portMAX_DELAY);
+        }
+    }
+    xSemaphoreGive(ctx->done);
+    vTaskDelete(NULL);
+}
+
+static void bench_consumer(void *arg)
+{
+    bench_ctx_t *ctx = (bench_ctx_t *)arg;
+    uint32_t item;
+
+    /* Each consumer receives as many items as one producer sends */
+    for (uint32_t i = 0; i < ITEMS_PER_PRODUCER; i++) {
+        if (ctx->use_mpmc) {
+            xMpmcQueueReceive(ctx->mpmc, &item, portMAX_DELAY);
+        } else {
+            xQueueReceive(ctx->queue, &item, portMAX_DELAY);
+        }
+    }
+    xSemaphoreGive(ctx->done);
+    vTaskDelete(NULL);
+}
+
+static int64_t run_bench(BaseType_t use_mpmc)
+{
+    bench_ctx_t ctx = {
+        .use_mpmc = use_mpmc,
+        .queue = xQueueCreate(QUEUE_LEN, sizeof(uint32_t)),
+        .mpmc = xMpmcQueueCreate(QUEUE_LEN, sizeof(uint32_t)),
+        .done = xSemaphoreCreateCounting(2 * TASKS_PER_SIDE, 0),
+    };
+    TEST_ASSERT_NOT_EQUAL(NULL, ctx.queue);
+    TEST_ASSERT_NOT_EQUAL(NULL, ctx.mpmc);
+    TEST_ASSERT_NOT_EQUAL(NULL, ctx.done);
+
+    /* Raise our own priority above the workers so that none of them run until all of them have been created */
+    vTaskPrioritySet(NULL, UNITY_FREERTOS_PRIORITY + 1);
+    int64_t start = esp_timer_get_time();
+    for (int core = 0; core < TASKS_PER_SIDE; core++) {
+        xTaskCreatePinnedToCore(bench_consumer, "cons", 2048, &ctx, UNITY_FREERTOS_PRIORITY, NULL, core);
+        xTaskCreatePinnedToCore(bench_producer, "prod", 2048, &ctx, UNITY_FREERTOS_PRIORITY, NULL, core);
+    }
+    vTaskPrioritySet(NULL, UNITY_FREERTOS_PRIORITY - 1);
+
+    for (int i = 0; i < 2 * TASKS_PER_SIDE; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(ctx.done, pdMS_TO_TICKS(20000)));
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    vTaskPrioritySet(NULL, UNITY_FREERTOS_PRIORITY);
+
+    vQueueDelete(ctx.queue);
+    vMpmcQueueDelete(ctx.mpmc);
+    vSemaphoreDelete(ctx.done);
+    /* Give the idle tasks a chance to clean up the deleted tasks */
+    vTaskDelay(2);
+
+    return elapsed;
+}
+
+TEST_CASE("MPMC queue multi-core throughput", "[freertos]")
+{
+    const uint32_t total_items = ITEMS_PER_PRODUCER * TASKS_PER_SIDE;
+    int64_t queue_us = run_bench(pdFALSE);
+    int64_t mpmc_us = run_bench(pdTRUE);
+
+    IDF_LOG_PERFORMANCE("queue_multicore_throughput", "%"PRIu32" items/s", (uint32_t)((int64_t)total_items * 1000000 / queue_us));
+    IDF_LOG_PERFORMANCE("mpmc_queue_multicore_throughput", "%"PRIu32" items/s", (uint32_t)((int64_t)total_items * 1000000 / mpmc_us));
+}
+
+#endif /* !CONFIG_FREERTOS_UNICORE */
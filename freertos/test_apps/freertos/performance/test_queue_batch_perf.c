@@ -0,0 +1,64 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <esp_types.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_cpu.h"
+#include "unity.h"
+#include "test_utils.h"
+
+#if !CONFIG_FREERTOS_SMP
+
+#define NUMBER_OF_ITERATIONS    256
+#define BATCH_LEN               16
+
+/*
+ * Compare the cost of moving a burst of BATCH_LEN items through a queue item by item (xQueueSend()/xQueueReceive())
+ * against doing the same with xQueueSendBatch()/xQueueReceiveBatch(). The same task sends and receives, so only the
+ * critical section and event list overhead is measured.
+ */
+TEST_CASE("queue batch send/receive performance", "[freertos]")
+{
+    uint32_t items[BATCH_LEN];
+    uint32_t per_item_cycles = 0;
+    uint32_t batch_cycles = 0;
+    QueueHandle_t queue = xQueueCreate(BATCH_LEN, sizeof(uint32_t));
+    TEST_ASSERT_NOT_EQUAL(NULL, queue);
+
+    for (int i = 0; i < BATCH_LEN; i++) {
+        items[i] = i;
+    }
+
+    for (int iter = 0; iter < NUMBER_OF_ITERATIONS; iter++) {
+        uint32_t start = esp_cpu_get_cycle_count();
+        for (int i = 0; i < BATCH_LEN; i++) {
+            xQueueSend(queue, &items[i], 0);
+        }
+        for (int i = 0; i < BATCH_LEN; i++) {
+            xQueueReceive(queue, &items[i], 0);
+        }
+        per_item_cycles += esp_cpu_get_cycle_count() - start;
+
+        start = esp_cpu_get_cycle_count();
+        TEST_ASSERT_EQUAL(BATCH_LEN, xQueueSendBatch(queue, items, BATCH_LEN, 0));
+        TEST_ASSERT_EQUAL(BATCH_LEN, xQueueReceiveBatch(queue, items, BATCH_LEN, 0));
+        batch_cycles += esp_cpu_get_cycle_count() - start;
+    }
+
+    per_item_cycles /= NUMBER_OF_ITERATIONS * BATCH_LEN;
+    batch_cycles /= NUMBER_OF_ITERATIONS * BATCH_LEN;
+    IDF_LOG_PERFORMANCE("queue_per_item_send_receive", "%"PRIu32" cycles/item", per_item_cycles);
+    IDF_LOG_PERFORMANCE("queue_batch_send_receive", "%"PRIu32" cycles/item", batch_cycles);
+
+    vQueueDelete(queue);
+}
+
+#endif /* !CONFIG_FREERTOS_SMP */
@@ -0,0 +1,123 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ Test the second core emulated by the Linux simulator
+
+ A task keeps the second core busy without ever blocking:
+    - A higher priority task unblocked from the first core must preempt it (cross-core yield)
+    - A task of the same priority must be time sliced with it (tick of the second core)
+*/
+
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "unity.h"
+#include "test_utils.h"
+
+#if CONFIG_IDF_TARGET_LINUX && !CONFIG_FREERTOS_UNICORE
+
+#define CROSS_CORE_TEST_ITERATIONS      50
+#define CROSS_CORE_SPIN_PRIO            (UNITY_FREERTOS_PRIORITY + 1)
+#define CROSS_CORE_WAITER_PRIO          (UNITY_FREERTOS_PRIORITY + 2)
+#define CROSS_CORE_SLICE_TICKS          50
+
+static volatile bool stop_spinning;
+static SemaphoreHandle_t done_sem;
+
+static void spin_task(void *arg)
+{
+    volatile uint32_t *count = (volatile uint32_t *) arg;
+
+    while (!stop_spinning) {
+        (*count)++;
+    }
+    xSemaphoreGive(done_sem);
+    vTaskDelete(NULL);
+}
+
+static void start_spinners(int num_spinners, volatile uint32_t *counts)
+{
+    stop_spinning = false;
+    done_sem = xSemaphoreCreateCounting(num_spinners, 0);
+    TEST_ASSERT_NOT_NULL(done_sem);
+
+    for (int i = 0; i < num_spinners; i++) {
+        counts[i] = 0;
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(spin_task, "spin", 4096, (void *) &counts[i], CROSS_CORE_SPIN_PRIO, NULL, 1));
+    }
+}
+
+static void stop_spinners(int num_spinners)
+{
+    stop_spinning = true;
+    for (int i = 0; i < num_spinners; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(done_sem, portMAX_DELAY));
+    }
+    vSemaphoreDelete(done_sem);
+}
+
+static SemaphoreHandle_t wake_sem;
+static SemaphoreHandle_t woken_sem;
+static volatile BaseType_t waiter_core;
+
+static void waiter_task(void *arg)
+{
+    for (int i = 0; i < CROSS_CORE_TEST_ITERATIONS; i++) {
+        xSemaphoreTake(wake_sem, portMAX_DELAY);
+        waiter_core = xPortGetCoreID();
+        xSemaphoreGive(woken_sem);
+    }
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("Linux simulator: task unblocked from the other core preempts a busy core", "[freertos]")
+{
+    volatile uint32_t spin_count;
+
+    wake_sem = xSemaphoreCreateBinary();
+    woken_sem = xSemaphoreCreateBinary();
+    TEST_ASSERT_NOT_NULL(wake_sem);
+    TEST_ASSERT_NOT_NULL(woken_sem);
+
+    start_spinners(1, &spin_count);
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(waiter_task, "waiter", 4096, NULL, CROSS_CORE_WAITER_PRIO, NULL, 1));
+
+    for (int i = 0; i < CROSS_CORE_TEST_ITERATIONS; i++) {
+        waiter_core = -1;
+        xSemaphoreGive(wake_sem);
+        // The waiter can only run on the second core, where the spinning task never blocks
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(woken_sem, pdMS_TO_TICKS(1000)));
+        TEST_ASSERT_EQUAL(1, waiter_core);
+    }
+
+    stop_spinners(1);
+    TEST_ASSERT_NOT_EQUAL(0, spin_count);
+    vSemaphoreDelete(woken_sem);
+    vSemaphoreDelete(wake_sem);
+}
+
+TEST_CASE("Linux simulator: tasks of the same priority are time sliced on the second core", "[freertos]")
+{
+    volatile uint32_t spin_counts[2];
+    uint32_t counts_before[2];
+
+    start_spinners(2, spin_counts);
+
+    // Both spinners must keep making progress, which requires the tick of the second core to switch between them
+    for (int i = 0; i < 5; i++) {
+        counts_before[0] = spin_counts[0];
+        counts_before[1] = spin_counts[1];
+        vTaskDelay(CROSS_CORE_SLICE_TICKS);
+        TEST_ASSERT_NOT_EQUAL(counts_before[0], spin_counts[0]);
+        TEST_ASSERT_NOT_EQUAL(counts_before[1], spin_counts[1]);
+    }
+
+    stop_spinners(2);
+}
+
+#endif // CONFIG_IDF_TARGET_LINUX && !CONFIG_FREERTOS_UNICORE
@@ -0,0 +1,244 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ Test the simulated interrupt controller of the Linux simulator
+
+ Simulated interrupt lines are prioritized and nest as on the chips:
+    - The ISR of a line must preempt the ISRs of lower priority lines, and run at the priority of its line
+    - A critical section must defer the lines up to configMAX_SYSCALL_INTERRUPT_PRIORITY, but not the lines above
+    - An ISR must be able to wake a task with a FromISR function
+    - An interrupt storm must be counted by the statistics of its line, with the triggers merged while pending
+ Lines cannot be freed, so each test allocates its lines only once.
+*/
+
+#include <time.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "unity.h"
+#include "test_utils.h"
+
+#if CONFIG_IDF_TARGET_LINUX && !CONFIG_FREERTOS_LINUX_COROUTINE_PORT
+
+#define INTR_LOW_PRIO               1
+#define INTR_HIGH_PRIO              2
+#define INTR_TOP_PRIO               (configMAX_SYSCALL_INTERRUPT_PRIORITY + 1)
+#define INTR_WAIT_NS                200000000LL     // Bound of the busy waits for an ISR, 200 ms
+#define INTR_CRITICAL_NS            20000000LL      // 20 ms
+#define INTR_WAKE_ITERATIONS        50
+#define INTR_STORM_TRIGGERS         2000
+#define INTR_STORM_PERIOD_US        50
+
+static int64_t host_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((int64_t) ts.tv_sec * 1000000000LL) + ts.tv_nsec;
+}
+
+static BaseType_t allocate_line(BaseType_t *line, UBaseType_t priority, PortSimulatedIsr_t isr)
+{
+    if (*line < 0) {
+        *line = xPortAllocateSimulatedInterrupt(priority, isr, NULL);
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(0, *line);
+    return *line;
+}
+
+static BaseType_t low_line = -1;
+static BaseType_t high_line = -1;
+static BaseType_t top_line = -1;
+static volatile int isr_order[4];
+static volatile int isr_order_len;
+static volatile UBaseType_t low_level;
+static volatile UBaseType_t high_level;
+static volatile UBaseType_t top_level;
+static volatile bool high_ran;
+static volatile bool top_ran;
+
+static BaseType_t low_isr(void *arg)
+{
+    low_level = uxPortGetInterruptLevel();
+    isr_order[isr_order_len++] = INTR_LOW_PRIO;
+    // The higher priority ISR must run before this one returns
+    vPortTriggerSimulatedInterrupt(high_line);
+    int64_t start = host_time_ns();
+    while (!high_ran && host_time_ns() - start < INTR_WAIT_NS) {
+        ;
+    }
+    isr_order[isr_order_len++] = -INTR_LOW_PRIO;
+    return pdFALSE;
+}
+
+static BaseType_t high_isr(void *arg)
+{
+    high_level = uxPortGetInterruptLevel();
+    isr_order[isr_order_len++] = INTR_HIGH_PRIO;
+    high_ran = true;
+    return pdFALSE;
+}
+
+static BaseType_t top_isr(void *arg)
+{
+    top_level = uxPortGetInterruptLevel();
+    top_ran = true;
+    return pdFALSE;
+}
+
+TEST_CASE("Linux simulator: higher priority simulated interrupts preempt lower priority ISRs", "[freertos]")
+{
+    allocate_line(&low_line, INTR_LOW_PRIO, low_isr);
+    allocate_line(&high_line, INTR_HIGH_PRIO, high_isr);
+
+    isr_order_len = 0;
+    high_ran = false;
+    vPortTriggerSimulatedInterrupt(low_line);
+    vTaskDelay(5);
+
+    TEST_ASSERT_EQUAL(3, isr_order_len);
+    TEST_ASSERT_EQUAL(INTR_LOW_PRIO, isr_order[0]);
+    TEST_ASSERT_EQUAL(INTR_HIGH_PRIO, isr_order[1]);
+    TEST_ASSERT_EQUAL(-INTR_LOW_PRIO, isr_order[2]);
+    TEST_ASSERT_EQUAL(INTR_LOW_PRIO, low_level);
+    TEST_ASSERT_EQUAL(INTR_HIGH_PRIO, high_level);
+    TEST_ASSERT_EQUAL(0, uxPortGetInterruptLevel());
+}
+
+static portMUX_TYPE intr_mux = portMUX_INITIALIZER_UNLOCKED;
+
+TEST_CASE("Linux simulator: critical sections only defer simulated interrupts up to the syscall priority", "[freertos]")
+{
+    allocate_line(&high_line, INTR_HIGH_PRIO, high_isr);
+    allocate_line(&top_line, INTR_TOP_PRIO, top_isr);
+
+    high_ran = false;
+    top_ran = false;
+    taskENTER_CRITICAL(&intr_mux);
+    TEST_ASSERT_EQUAL(configMAX_SYSCALL_INTERRUPT_PRIORITY, uxPortGetInterruptLevel());
+    vPortTriggerSimulatedInterrupt(high_line);
+    vPortTriggerSimulatedInterrupt(top_line);
+    int64_t start = host_time_ns();
+    while (host_time_ns() - start < INTR_CRITICAL_NS) {
+        ;
+    }
+    bool high_ran_in_critical = high_ran;
+    bool top_ran_in_critical = top_ran;
+    taskEXIT_CRITICAL(&intr_mux);
+
+    // With two cores, the other core may take the deferred line
+#if CONFIG_FREERTOS_UNICORE
+    TEST_ASSERT_FALSE(high_ran_in_critical);
+#endif
+    TEST_ASSERT_TRUE(top_ran_in_critical);
+    TEST_ASSERT_EQUAL(INTR_TOP_PRIO, top_level);
+    // The deferred line runs once the level is lowered
+    TEST_ASSERT_TRUE(high_ran);
+    TEST_ASSERT_EQUAL(0, uxPortGetInterruptLevel());
+}
+
+static BaseType_t wake_line = -1;
+static SemaphoreHandle_t wake_sem;
+static SemaphoreHandle_t wake_done_sem;
+
+static BaseType_t wake_isr(void *arg)
+{
+    BaseType_t task_woken = pdFALSE;
+
+    xSemaphoreGiveFromISR(wake_sem, &task_woken);
+    return task_woken;
+}
+
+static void wake_task(void *arg)
+{
+    for (int i = 0; i < INTR_WAKE_ITERATIONS; i++) {
+        xSemaphoreTake(wake_sem, portMAX_DELAY);
+    }
+    xSemaphoreGive(wake_done_sem);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("Linux simulator: simulated interrupt wakes a task", "[freertos]")
+{
+    PortSimulatedInterruptStats_t stats_before;
+    PortSimulatedInterruptStats_t stats_after;
+
+    wake_sem = xSemaphoreCreateBinary();
+    wake_done_sem = xSemaphoreCreateBinary();
+    TEST_ASSERT_NOT_NULL(wake_sem);
+    TEST_ASSERT_NOT_NULL(wake_done_sem);
+    allocate_line(&wake_line, INTR_HIGH_PRIO, wake_isr);
+    vPortGetSimulatedInterruptStats(wake_line, &stats_before);
+
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(wake_task, "wake", 4096, NULL, UNITY_FREERTOS_PRIORITY + 1, NULL));
+    for (int i = 0; i < INTR_WAKE_ITERATIONS; i++) {
+        vPortTriggerSimulatedInterrupt(wake_line);
+        vTaskDelay(2);
+    }
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(wake_done_sem, pdMS_TO_TICKS(1000)));
+
+    // Each trigger was taken before the next one, so none were merged
+    vPortGetSimulatedInterruptStats(wake_line, &stats_after);
+    TEST_ASSERT_EQUAL(INTR_WAKE_ITERATIONS, stats_after.ullTriggers - stats_before.ullTriggers);
+    TEST_ASSERT_EQUAL(INTR_WAKE_ITERATIONS, stats_after.ullRuns - stats_before.ullRuns);
+    vSemaphoreDelete(wake_done_sem);
+    vSemaphoreDelete(wake_sem);
+}
+
+static BaseType_t storm_line = -1;
+static volatile uint32_t storm_runs;
+
+static BaseType_t storm_isr(void *arg)
+{
+    storm_runs++;
+    return pdFALSE;
+}
+
+TEST_CASE("Linux simulator: interrupt storm is counted by the line statistics", "[freertos]")
+{
+    PortSimulatedInterruptStats_t stats_before;
+    PortSimulatedInterruptStats_t stats;
+
+    allocate_line(&storm_line, INTR_HIGH_PRIO + 1, storm_isr);
+    vPortGetSimulatedInterruptStats(storm_line, &stats_before);
+    storm_runs = 0;
+
+    TEST_ASSERT_EQUAL(pdPASS, xPortInjectInterruptStorm(storm_line, INTR_STORM_TRIGGERS, INTR_STORM_PERIOD_US));
+    // Only one storm at a time on a line
+    TEST_ASSERT_EQUAL(pdFAIL, xPortInjectInterruptStorm(storm_line, 1, 0));
+
+    // Mask the line for part of the storm, so that triggers are merged
+    int64_t storm_end = host_time_ns() + 2 * (int64_t) INTR_STORM_TRIGGERS * INTR_STORM_PERIOD_US * 1000;
+    while (host_time_ns() < storm_end) {
+        taskENTER_CRITICAL(&intr_mux);
+        int64_t start = host_time_ns();
+        while (host_time_ns() - start < INTR_STORM_PERIOD_US * 2000) {
+            ;
+        }
+        taskEXIT_CRITICAL(&intr_mux);
+        vTaskDelay(1);
+    }
+
+    vPortGetSimulatedInterruptStats(storm_line, &stats);
+    uint64_t triggers = stats.ullTriggers - stats_before.ullTriggers;
+    uint64_t runs = stats.ullRuns - stats_before.ullRuns;
+    uint64_t total_latency_ns = stats.ullTotalLatencyNs - stats_before.ullTotalLatencyNs;
+    printf("Storm: %llu triggers, %llu runs, mean latency %llu ns, max latency %llu ns\n",
+           (unsigned long long) triggers, (unsigned long long) runs,
+           (unsigned long long)(runs ? total_latency_ns / runs : 0), (unsigned long long) stats.ullMaxLatencyNs);
+    TEST_ASSERT_EQUAL(INTR_STORM_TRIGGERS, triggers);
+    TEST_ASSERT_GREATER_THAN(0, runs);
+    TEST_ASSERT_TRUE(runs <= triggers);
+    TEST_ASSERT_EQUAL(storm_runs, runs);
+    TEST_ASSERT_TRUE(total_latency_ns <= stats.ullMaxLatencyNs * runs);
+
+    // The storm is over, so another one can be started
+    TEST_ASSERT_EQUAL(pdPASS, xPortInjectInterruptStorm(storm_line, 1, 0));
+    vTaskDelay(2);
+}
+
+#endif // CONFIG_IDF_TARGET_LINUX && !CONFIG_FREERTOS_LINUX_COROUTINE_PORT
@@ -0,0 +1,161 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ Test the host I/O bridge of the Linux simulator
+
+ A task waits for an empty pipe, while a task of lower priority counts:
+    - The waiting task must be blocked, letting the lower priority task run
+    - Writing to the pipe must wake the waiting task, with the data written (read) or the fd reported ready (poll)
+ nanosleep must let lower priority tasks run too, and must not return early.
+*/
+
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "unity.h"
+#include "test_utils.h"
+
+#if CONFIG_FREERTOS_LINUX_IO_BRIDGE
+
+#define IO_BRIDGE_WAITER_PRIO       (UNITY_FREERTOS_PRIORITY + 2)
+#define IO_BRIDGE_LOW_PRIO          (UNITY_FREERTOS_PRIORITY - 1)
+#define IO_BRIDGE_WAIT_TICKS        10
+#define IO_BRIDGE_POLL_TIMEOUT_MS   20
+#define IO_BRIDGE_SLEEP_NS          10500000    // 10.5 ms, not a whole number of ticks
+
+static int pipe_fds[2];
+static volatile uint32_t low_count;
+static volatile int waiter_result;
+static volatile char waiter_data;
+
+static void low_prio_task(void *arg)
+{
+    while (1) {
+        low_count++;
+    }
+}
+
+static void read_task(void *arg)
+{
+    char c = 0;
+
+    waiter_result = read(pipe_fds[0], &c, 1);
+    waiter_data = c;
+    xTaskNotifyGive((TaskHandle_t) arg);
+    vTaskSuspend(NULL);
+}
+
+static void poll_task(void *arg)
+{
+    struct pollfd pfd = {
+        .fd = pipe_fds[0],
+        .events = POLLIN,
+    };
+
+    waiter_result = poll(&pfd, 1, -1);
+    if (waiter_result == 1 && (pfd.revents & POLLIN)) {
+        char c = 0;
+        read(pipe_fds[0], &c, 1);
+        waiter_data = c;
+    }
+    xTaskNotifyGive((TaskHandle_t) arg);
+    vTaskSuspend(NULL);
+}
+
+static void test_wait_for_pipe(TaskFunction_t waiter_func)
+{
+    TaskHandle_t low_task;
+    TaskHandle_t waiter_task;
+
+    TEST_ASSERT_EQUAL(0, pipe(pipe_fds));
+    waiter_result = -2;
+    waiter_data = 0;
+
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(low_prio_task, "low", 4096, NULL, IO_BRIDGE_LOW_PRIO, &low_task));
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(waiter_func, "waiter", 4096, xTaskGetCurrentTaskHandle(), IO_BRIDGE_WAITER_PRIO, &waiter_task));
+
+    // The waiter is parked, so the lower priority task runs whenever this task is blocked
+    uint32_t count_before = low_count;
+    vTaskDelay(IO_BRIDGE_WAIT_TICKS);
+    TEST_ASSERT_EQUAL(eBlocked, eTaskGetState(waiter_task));
+    TEST_ASSERT_NOT_EQUAL(count_before, low_count);
+
+    TEST_ASSERT_EQUAL(1, write(pipe_fds[1], "x", 1));
+    TEST_ASSERT_EQUAL(1, ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000)));
+    TEST_ASSERT_EQUAL(1, waiter_result);
+    TEST_ASSERT_EQUAL('x', waiter_data);
+
+    vTaskDelete(waiter_task);
+    vTaskDelete(low_task);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
+
+TEST_CASE("Linux simulator: read on a pipe blocks the task until data is written", "[freertos]")
+{
+    test_wait_for_pipe(read_task);
+}
+
+TEST_CASE("Linux simulator: poll on a pipe blocks the task until data is written", "[freertos]")
+{
+    test_wait_for_pipe(poll_task);
+}
+
+TEST_CASE("Linux simulator: poll on a pipe times out", "[freertos]")
+{
+    TEST_ASSERT_EQUAL(0, pipe(pipe_fds));
+    struct pollfd pfd = {
+        .fd = pipe_fds[0],
+        .events = POLLIN,
+    };
+
+    TickType_t tick_start = xTaskGetTickCount();
+    TEST_ASSERT_EQUAL(0, poll(&pfd, 1, IO_BRIDGE_POLL_TIMEOUT_MS));
+    TEST_ASSERT_GREATER_OR_EQUAL(pdMS_TO_TICKS(IO_BRIDGE_POLL_TIMEOUT_MS), xTaskGetTickCount() - tick_start);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
+
+static int64_t host_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((int64_t) ts.tv_sec * 1000000000LL) + ts.tv_nsec;
+}
+
+TEST_CASE("Linux simulator: nanosleep lets lower priority tasks run and does not return early", "[freertos]")
+{
+    const struct timespec req = {
+        .tv_sec = 0,
+        .tv_nsec = IO_BRIDGE_SLEEP_NS,
+    };
+    TaskHandle_t low_task;
+
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(low_prio_task, "low", 4096, NULL, IO_BRIDGE_LOW_PRIO, &low_task));
+
+    uint32_t count_before = low_count;
+    int64_t start = host_time_ns();
+    TEST_ASSERT_EQUAL(0, nanosleep(&req, NULL));
+    TEST_ASSERT_GREATER_OR_EQUAL(IO_BRIDGE_SLEEP_NS, host_time_ns() - start);
+    TEST_ASSERT_NOT_EQUAL(count_before, low_count);
+
+    // The task must not block with the scheduler suspended, so the host sleeps instead
+    start = host_time_ns();
+    vTaskSuspendAll();
+    int ret = nanosleep(&req, NULL);
+    xTaskResumeAll();
+    TEST_ASSERT_EQUAL(0, ret);
+    TEST_ASSERT_GREATER_OR_EQUAL(IO_BRIDGE_SLEEP_NS, host_time_ns() - start);
+
+    vTaskDelete(low_task);
+}
+
+#endif // CONFIG_FREERTOS_LINUX_IO_BRIDGE
@@ -0,0 +1,242 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ Test the record and replay of the Linux simulator
+
+ The recording and the replay are selected when the simulator starts, so the test runs this test app twice more, with
+ FREERTOS_LINUX_RECORD and then with FREERTOS_LINUX_REPLAY naming the same file. Both runs select this test case from the
+ menu, run a workload and exit. In the workload, tasks of the same priority are time sliced by the tick, and a higher
+ priority task is woken by an interrupt storm, so their interleaving depends on the timing of the host. Each task logs
+ the tick count in a critical section, so that it is only preempted between preemption points. The digest of the log
+ is computed before the last interrupt recorded:
+    - The recorded run must complete
+    - The replay must not diverge from the recording, and must log the same interleaving of the tasks
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "unity.h"
+#include "test_utils.h"
+
+#if CONFIG_FREERTOS_LINUX_RECORD_REPLAY
+
+#define RECORD_REPLAY_TEST_NAME         "Linux simulator: replay follows the recorded interleaving of tasks"
+#define RECORD_REPLAY_WORKER_PRIO       (UNITY_FREERTOS_PRIORITY + 1)
+#define RECORD_REPLAY_WOKEN_PRIO        (UNITY_FREERTOS_PRIORITY + 2)
+#define RECORD_REPLAY_DELAYER_PRIO      (UNITY_FREERTOS_PRIORITY + 3)
+#define RECORD_REPLAY_ITERATIONS        300
+#define RECORD_REPLAY_SPIN              30000
+#define RECORD_REPLAY_DELAYS            50
+#define RECORD_REPLAY_STORM_TRIGGERS    100
+#define RECORD_REPLAY_STORM_PERIOD_US   3000
+#define RECORD_REPLAY_LOG_LEN           (2 * RECORD_REPLAY_ITERATIONS + RECORD_REPLAY_DELAYS + RECORD_REPLAY_STORM_TRIGGERS)
+
+extern char **environ;
+
+static portMUX_TYPE log_mux = portMUX_INITIALIZER_UNLOCKED;
+static struct {
+    char task;
+    TickType_t tick;
+} event_log[RECORD_REPLAY_LOG_LEN];
+static int event_log_len;
+static SemaphoreHandle_t storm_sem;
+static TaskHandle_t workload_task;
+
+static void log_event(char task)
+{
+    taskENTER_CRITICAL(&log_mux);
+    if (event_log_len < RECORD_REPLAY_LOG_LEN) {
+        event_log[event_log_len].task = task;
+        event_log[event_log_len].tick = xTaskGetTickCount();
+        event_log_len++;
+    }
+    taskEXIT_CRITICAL(&log_mux);
+}
+
+static BaseType_t storm_isr(void *arg)
+{
+    BaseType_t task_woken = pdFALSE;
+
+    xSemaphoreGiveFromISR(storm_sem, &task_woken);
+    return task_woken;
+}
+
+static void worker_task(void *arg)
+{
+    for (int i = 0; i < RECORD_REPLAY_ITERATIONS; i++) {
+        for (volatile int spin = 0; spin < RECORD_REPLAY_SPIN; spin++) {
+            ;
+        }
+        log_event((char)(intptr_t) arg);
+    }
+    xTaskNotifyGive(workload_task);
+    vTaskSuspend(NULL);
+}
+
+static void woken_task(void *arg)
+{
+    while (1) {
+        xSemaphoreTake(storm_sem, portMAX_DELAY);
+        log_event('I');
+    }
+}
+
+static void delayer_task(void *arg)
+{
+    for (int i = 0; i < RECORD_REPLAY_DELAYS; i++) {
+        vTaskDelay(2);
+        log_event('D');
+    }
+    vTaskSuspend(NULL);
+}
+
+/* Runs in the recorded and in the replayed app, and exits with the digest of the interleaving logged */
+static void run_workload(void)
+{
+    workload_task = xTaskGetCurrentTaskHandle();
+    storm_sem = xSemaphoreCreateBinary();
+    BaseType_t line = xPortAllocateSimulatedInterrupt(1, storm_isr, NULL);
+    BaseType_t replaying = xPortIsReplaying();
+
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(woken_task, "woken", 4096, NULL, RECORD_REPLAY_WOKEN_PRIO, NULL));
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(delayer_task, "delayer", 4096, NULL, RECORD_REPLAY_DELAYER_PRIO, NULL));
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(worker_task, "worker_a", 4096, (void *) 'A', RECORD_REPLAY_WORKER_PRIO, NULL));
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(worker_task, "worker_b", 4096, (void *) 'B', RECORD_REPLAY_WORKER_PRIO, NULL));
+    TEST_ASSERT_EQUAL(pdPASS, xPortInjectInterruptStorm(line, RECORD_REPLAY_STORM_TRIGGERS, RECORD_REPLAY_STORM_PERIOD_US));
+    for (int i = 0; i < 2; i++) {
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+    }
+
+    uint64_t digest = 1469598103934665603ULL;   // FNV-1a
+    taskENTER_CRITICAL(&log_mux);
+    for (int i = 0; i < event_log_len; i++) {
+        digest = (digest ^ (uint8_t) event_log[i].task) * 1099511628211ULL;
+        digest = (digest ^ event_log[i].tick) * 1099511628211ULL;
+    }
+    int len = event_log_len;
+    taskEXIT_CRITICAL(&log_mux);
+    // After the end of the recording, the replay continues in real time. The tick ending this delay is recorded, so
+    // the digest is computed before the replay ends.
+    vTaskDelay(1);
+
+    printf("Record/replay digest: %d %d %llx\n", (int) replaying, len, (unsigned long long) digest);
+    fflush(stdout);
+    exit(0);
+}
+
+typedef struct {
+    int replaying;
+    int events;
+    unsigned long long digest;
+} workload_result_t;
+
+/* Runs this test app with an environment variable naming the recording, and returns the digest it printed */
+static void run_app(const char *variable, const char *recording, const char *input_path, workload_result_t *result)
+{
+    char output_path[] = "/tmp/record_replay_outputXXXXXX";
+    int output_fd = mkstemp(output_path);
+    TEST_ASSERT_GREATER_OR_EQUAL(0, output_fd);
+
+    // The environment of this app, with the variable added
+    int env_len = 0;
+    while (environ[env_len] != NULL) {
+        env_len++;
+    }
+    char **envp = calloc(env_len + 2, sizeof(char *));
+    TEST_ASSERT_NOT_NULL(envp);
+    memcpy(envp, environ, env_len * sizeof(char *));
+    char env_entry[256];
+    snprintf(env_entry, sizeof(env_entry), "%s=%s", variable, recording);
+    envp[env_len] = env_entry;
+
+    // The app would inherit the signal mask of this task thread
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    sigset_t no_signals;
+    sigemptyset(&no_signals);
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, input_path, O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, output_fd, STDOUT_FILENO);
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setsigmask(&attr, &no_signals);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK);
+
+    char *const argv[] = { "/proc/self/exe", NULL };
+    pid_t pid;
+    int ret = posix_spawn(&pid, "/proc/self/exe", &actions, &attr, argv, envp);
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+    free(envp);
+    TEST_ASSERT_EQUAL(0, ret);
+
+    // The signals of the simulator interrupt waitpid()
+    int status;
+    while (waitpid(pid, &status, 0) < 0) {
+        TEST_ASSERT_EQUAL(EINTR, errno);
+    }
+    TEST_ASSERT_TRUE(WIFEXITED(status));
+    TEST_ASSERT_EQUAL(0, WEXITSTATUS(status));
+
+    FILE *output_file = fdopen(output_fd, "r");
+    TEST_ASSERT_NOT_NULL(output_file);
+    rewind(output_file);
+    int fields = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), output_file) != NULL && fields != 3) {
+        fields = sscanf(line, "Record/replay digest: %d %d %llx", &result->replaying, &result->events, &result->digest);
+    }
+    fclose(output_file);
+    unlink(output_path);
+    TEST_ASSERT_EQUAL(3, fields);
+}
+
+TEST_CASE(RECORD_REPLAY_TEST_NAME, "[freertos]")
+{
+    if (getenv("FREERTOS_LINUX_RECORD") != NULL || getenv("FREERTOS_LINUX_REPLAY") != NULL) {
+        run_workload();
+    }
+
+    char recording[] = "/tmp/record_replay_recordingXXXXXX";
+    char input_path[] = "/tmp/record_replay_inputXXXXXX";
+    int recording_fd = mkstemp(recording);
+    int input_fd = mkstemp(input_path);
+    TEST_ASSERT_GREATER_OR_EQUAL(0, recording_fd);
+    TEST_ASSERT_GREATER_OR_EQUAL(0, input_fd);
+    close(recording_fd);
+    // Select this test case from the menu of the test app
+    const char input[] = "\"" RECORD_REPLAY_TEST_NAME "\"\n";
+    TEST_ASSERT_EQUAL(strlen(input), write(input_fd, input, strlen(input)));
+    close(input_fd);
+
+    workload_result_t recorded;
+    workload_result_t replayed;
+    run_app("FREERTOS_LINUX_RECORD", recording, input_path, &recorded);
+    run_app("FREERTOS_LINUX_REPLAY", recording, input_path, &replayed);
+    unlink(recording);
+    unlink(input_path);
+
+    printf("Recorded %d events, digest %016llx. Replayed %d events, digest %016llx\n",
+           recorded.events, recorded.digest, replayed.events, replayed.digest);
+    TEST_ASSERT_EQUAL(pdFALSE, recorded.replaying);
+    TEST_ASSERT_EQUAL(pdTRUE, replayed.replaying);
+    TEST_ASSERT_GREATER_OR_EQUAL(2 * RECORD_REPLAY_ITERATIONS, recorded.events);
+    TEST_ASSERT_EQUAL(recorded.events, replayed.events);
+    TEST_ASSERT_TRUE(recorded.digest == replayed.digest);
+}
+
+#endif // CONFIG_FREERTOS_LINUX_RECORD_REPLAY
@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ Test the tick generation of the Linux simulator
+
+ The test task stays in a critical section for many tick periods, so the host merges the tick signals (with a single
+ core, no other task thread can take them meanwhile):
+    - The missed ticks must be reported as lost, and caught up at most CONFIG_FREERTOS_LINUX_TICK_MAX_CATCH_UP at a time
+    - Once caught up, the tick count must not have drifted from the host clock
+*/
+
+#include <time.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "unity.h"
+#include "test_utils.h"
+
+#if CONFIG_IDF_TARGET_LINUX && CONFIG_FREERTOS_UNICORE && !CONFIG_FREERTOS_LINUX_COROUTINE_PORT && !CONFIG_FREERTOS_LINUX_VIRTUAL_TIME
+
+#define TICK_STATS_CRITICAL_MS      50
+#define TICK_STATS_CATCH_UP_MS      100     // Enough for the tick interrupts to catch up the ticks missed
+#define TICK_STATS_MAX_DRIFT_TICKS  5
+
+static portMUX_TYPE tick_stats_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static int64_t host_time_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((int64_t) ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+}
+
+TEST_CASE("Linux simulator: ticks missed in a critical section are caught up in bounded bursts", "[freertos]")
+{
+    PortTickStats_t stats;
+
+    // Start on a tick boundary
+    vTaskDelay(1);
+    int64_t host_start = host_time_ms();
+    TickType_t tick_start = xTaskGetTickCount();
+    vPortResetTickStats();
+
+    portENTER_CRITICAL(&tick_stats_mux);
+    while (host_time_ms() - host_start < TICK_STATS_CRITICAL_MS) {
+        ;
+    }
+    portEXIT_CRITICAL(&tick_stats_mux);
+
+    vTaskDelay(pdMS_TO_TICKS(TICK_STATS_CATCH_UP_MS));
+
+    vPortGetTickStats(&stats);
+    int64_t host_elapsed_ms = host_time_ms() - host_start;
+    TickType_t ticks_elapsed = xTaskGetTickCount() - tick_start;
+
+    printf("Lost %llu ticks, at most %u ticks per interrupt, backlog %u\n",
+           (unsigned long long) stats.ullLostTicks, (unsigned) stats.ulMaxTicksPerInterrupt, (unsigned) stats.ulBacklog);
+    TEST_ASSERT_GREATER_THAN(0, stats.ullLostTicks);
+    TEST_ASSERT_GREATER_THAN(1, stats.ulMaxTicksPerInterrupt);
+    TEST_ASSERT_LESS_OR_EQUAL(CONFIG_FREERTOS_LINUX_TICK_MAX_CATCH_UP, stats.ulMaxTicksPerInterrupt);
+    TEST_ASSERT_LESS_OR_EQUAL(TICK_STATS_MAX_DRIFT_TICKS, stats.ulBacklog);
+    TEST_ASSERT_INT_WITHIN(TICK_STATS_MAX_DRIFT_TICKS, pdMS_TO_TICKS(host_elapsed_ms), ticks_elapsed);
+}
+
+#endif // CONFIG_IDF_TARGET_LINUX && CONFIG_FREERTOS_UNICORE && !CONFIG_FREERTOS_LINUX_COROUTINE_PORT && !CONFIG_FREERTOS_LINUX_VIRTUAL_TIME
@@ -0,0 +1,92 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ Test the virtual time mode of the Linux simulator
+
+ While all tasks are blocked, the idle task steps the tick count straight to the next expiry:
+    - A long delay must last the number of ticks requested, but take far less host time
+    - Periodic tasks and software timers must still wake up on the exact tick they are due
+*/
+
+#include <time.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/timers.h"
+#include "unity.h"
+#include "test_utils.h"
+
+#if CONFIG_FREERTOS_LINUX_VIRTUAL_TIME
+
+#define VIRTUAL_TIME_LONG_DELAY_TICKS       pdMS_TO_TICKS(10000)
+#define VIRTUAL_TIME_MAX_HOST_MS            1000    // Host time allowed for 10 s of ticks, mostly spent while tasks run
+#define VIRTUAL_TIME_PERIOD_TICKS           pdMS_TO_TICKS(1000)
+#define VIRTUAL_TIME_PERIODS                100
+#define VIRTUAL_TIME_TIMER_TICKS            pdMS_TO_TICKS(500)
+
+static int64_t host_time_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((int64_t) ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+}
+
+TEST_CASE("Linux simulator: long delay skips the idle ticks", "[freertos]")
+{
+    int64_t host_start = host_time_ms();
+    TickType_t tick_start = xTaskGetTickCount();
+
+    vTaskDelay(VIRTUAL_TIME_LONG_DELAY_TICKS);
+
+    TEST_ASSERT_EQUAL(VIRTUAL_TIME_LONG_DELAY_TICKS, xTaskGetTickCount() - tick_start);
+    TEST_ASSERT_LESS_THAN(VIRTUAL_TIME_MAX_HOST_MS, host_time_ms() - host_start);
+}
+
+static volatile int timer_expiries;
+
+static void timer_callback(TimerHandle_t timer)
+{
+    timer_expiries++;
+}
+
+static void periodic_task(void *arg)
+{
+    TickType_t last_wake = xTaskGetTickCount();
+    int late_wakes = 0;
+
+    for (int i = 0; i < VIRTUAL_TIME_PERIODS; i++) {
+        vTaskDelayUntil(&last_wake, VIRTUAL_TIME_PERIOD_TICKS);
+        if (xTaskGetTickCount() != last_wake) {
+            late_wakes++;
+        }
+    }
+
+    xTaskNotify((TaskHandle_t) arg, late_wakes, eSetValueWithOverwrite);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("Linux simulator: periodic wake ups are on time with skipped idle ticks", "[freertos]")
+{
+    uint32_t late_wakes;
+    TimerHandle_t timer = xTimerCreate("vt_timer", VIRTUAL_TIME_TIMER_TICKS, pdTRUE, NULL, timer_callback);
+    TEST_ASSERT_NOT_NULL(timer);
+
+    timer_expiries = 0;
+    TEST_ASSERT_EQUAL(pdPASS, xTimerStart(timer, portMAX_DELAY));
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(periodic_task, "vt_periodic", 4096, xTaskGetCurrentTaskHandle(), UNITY_FREERTOS_PRIORITY + 1, NULL));
+    TEST_ASSERT_EQUAL(pdTRUE, xTaskNotifyWait(0, 0, &late_wakes, portMAX_DELAY));
+    TEST_ASSERT_EQUAL(pdPASS, xTimerStop(timer, portMAX_DELAY));
+
+    // Every period of the task is two periods of the timer, which may not have been processed for the last one yet
+    TEST_ASSERT_EQUAL(0, late_wakes);
+    TEST_ASSERT_INT_WITHIN(1, 2 * VIRTUAL_TIME_PERIODS, timer_expiries);
+
+    TEST_ASSERT_EQUAL(pdPASS, xTimerDelete(timer, portMAX_DELAY));
+    vTaskDelay(1);  // Let the timer task delete the timer
+}
+
+#endif // CONFIG_FREERTOS_LINUX_VIRTUAL_TIME
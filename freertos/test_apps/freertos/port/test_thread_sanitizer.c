@@ -0,0 +1,96 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ Test the ThreadSanitizer annotations of the Linux simulator
+
+ Two tasks of the same priority update a shared counter, and are preempted by the tick in between:
+    - Without kernel calls around the updates, ThreadSanitizer must report a data race
+    - With the updates guarded by a mutex, ThreadSanitizer must not report anything
+*/
+
+#include <unistd.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "unity.h"
+#include "test_utils.h"
+
+#if CONFIG_FREERTOS_LINUX_THREAD_SANITIZER
+
+#define TSAN_TEST_ITERATIONS    200
+#define TSAN_TEST_TASK_PRIO     (UNITY_FREERTOS_PRIORITY + 1)
+
+static volatile int tsan_reports;
+static volatile int shared_counter;
+static SemaphoreHandle_t counter_mutex;
+static SemaphoreHandle_t done_sem;
+
+/* Called by ThreadSanitizer for each report, overriding its weak definition */
+void __tsan_on_report(void *report)
+{
+    tsan_reports++;
+}
+
+static void racy_task(void *arg)
+{
+    for (int i = 0; i < TSAN_TEST_ITERATIONS; i++) {
+        // The tick is only taken in intercepted calls, so let it preempt the task here
+        usleep(100);
+        shared_counter++;
+    }
+    xSemaphoreGive(done_sem);
+    vTaskDelete(NULL);
+}
+
+static void guarded_task(void *arg)
+{
+    for (int i = 0; i < TSAN_TEST_ITERATIONS; i++) {
+        usleep(100);
+        xSemaphoreTake(counter_mutex, portMAX_DELAY);
+        shared_counter++;
+        xSemaphoreGive(counter_mutex);
+    }
+    xSemaphoreGive(done_sem);
+    vTaskDelete(NULL);
+}
+
+static int run_tasks(TaskFunction_t task_func)
+{
+    int reports = tsan_reports;
+
+    counter_mutex = xSemaphoreCreateMutex();
+    done_sem = xSemaphoreCreateCounting(2, 0);
+    TEST_ASSERT_NOT_NULL(counter_mutex);
+    TEST_ASSERT_NOT_NULL(done_sem);
+
+    // Both tasks are created before either of them runs
+    vTaskSuspendAll();
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(task_func, "tsan0", 4096, NULL, TSAN_TEST_TASK_PRIO, NULL));
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(task_func, "tsan1", 4096, NULL, TSAN_TEST_TASK_PRIO, NULL));
+    xTaskResumeAll();
+
+    for (int i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(done_sem, portMAX_DELAY));
+    }
+
+    vSemaphoreDelete(done_sem);
+    vSemaphoreDelete(counter_mutex);
+    return tsan_reports - reports;
+}
+
+TEST_CASE("Thread sanitizer: data race between preempted tasks is reported", "[freertos]")
+{
+    TEST_ASSERT_GREATER_THAN(0, run_tasks(racy_task));
+}
+
+TEST_CASE("Thread sanitizer: data guarded by a mutex is not reported", "[freertos]")
+{
+    TEST_ASSERT_EQUAL(0, run_tasks(guarded_task));
+}
+
+#endif // CONFIG_FREERTOS_LINUX_THREAD_SANITIZER
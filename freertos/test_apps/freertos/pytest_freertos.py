@@ -26,6 +26,7 @@ CONFIGS = [
         ],
     ),
     pytest.param('tickless_idle', marks=[pytest.mark.supported_targets]),
+    pytest.param('tickless_kernel', marks=[pytest.mark.esp32c3, pytest.mark.esp32c6]),
 ]
 
 
@@ -36,6 +37,8 @@ CONFIGS = [
         ('default', 'supported_targets'),
         ('freertos_options', 'supported_targets'),
         ('tickless_idle', 'supported_targets'),
+        ('tickless_kernel', 'esp32c3'),
+        ('tickless_kernel', 'esp32c6'),
         ('psram', 'esp32'),
         ('psram', 'esp32c5'),
         ('psram', 'esp32p4'),
@@ -58,6 +61,23 @@ def test_freertos(dut: Dut) -> None:
     dut.run_all_single_board_cases()
 
 
+@pytest.mark.host_test
+@idf_parametrize(
+    'config,target',
+    [
+        ('linux', 'linux'),
+        ('linux_coroutine', 'linux'),
+        ('linux_dual_core', 'linux'),
+        ('linux_virtual_time', 'linux'),
+        ('linux_record_replay', 'linux'),
+        ('linux_tsan', 'linux'),
+    ],
+    indirect=['config', 'target'],
+)
+def test_freertos_linux(dut: Dut) -> None:
+    dut.run_all_single_board_cases()
+
+
 @pytest.mark.generic
 @pytest.mark.flash_suspend
 @idf_parametrize(
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+
+#include "gfxfont.h"
+
+/* Drawing API of the Adafruit GFX library. The simulated display has no
+ * pixels, so drawing only moves the text cursor. */
+class Adafruit_GFX {
+public:
+  Adafruit_GFX(int16_t w, int16_t h) : _width(w), _height(h) {}
+  virtual ~Adafruit_GFX() {}
+
+  virtual void fillScreen(uint16_t color) {}
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                        uint16_t color) {}
+  virtual void fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                             int16_t r, uint16_t color) {}
+  virtual void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                          int16_t w, int16_t h, uint16_t color) {}
+
+  void setFont(const GFXfont *f = nullptr) { gfxFont = f; }
+  void setTextColor(uint16_t c) { textcolor = c; }
+  void setCursor(int16_t x, int16_t y) {
+    cursor_x = x;
+    cursor_y = y;
+  }
+  int16_t getCursorX() const { return cursor_x; }
+  int16_t getCursorY() const { return cursor_y; }
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+
+  size_t print(const char *str) {
+    size_t n = 0;
+    while (str[n] != '\0') {
+      write(str[n++]);
+    }
+    return n;
+  }
+  size_t print(long value) {
+    char buffer[24];
+    snprintf(buffer, sizeof(buffer), "%ld", value);
+    return print(buffer);
+  }
+  size_t print(int value) { return print((long)value); }
+  size_t printf(const char *format, ...)
+      __attribute__((format(printf, 2, 3))) {
+    char buffer[128];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    return print(buffer);
+  }
+
+protected:
+  size_t write(char c) {
+    if (c == '\n') {
+      cursor_x = 0;
+      cursor_y += gfxFont != nullptr ? gfxFont->yAdvance : 8;
+    } else {
+      cursor_x += gfxFont != nullptr ? gfxFont->yAdvance / 2 : 6;
+    }
+    return 1;
+  }
+
+  int16_t _width;
+  int16_t _height;
+  int16_t cursor_x = 0;
+  int16_t cursor_y = 0;
+  uint16_t textcolor = 0;
+  const GFXfont *gfxFont = nullptr;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+/* E-paper panel of the Watchy. A refresh takes as long as on the real
+ * panel, so that tasks drawing to it keep their timing. */
+class WatchyDisplay {
+public:
+  static const uint16_t WIDTH = 200;
+  static const uint16_t HEIGHT = 200;
+
+  void initWatchy() {}
+  void refresh(bool partial_update_mode);
+  void hibernate() {}
+};
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "gfxfont.h"
+
+/* Nothing is drawn by the simulator, so the font has no glyphs */
+const GFXfont FreeMonoBold9pt7b = {nullptr, nullptr, 0x20, 0x7E, 18};
@@ -0,0 +1,4 @@
+#pragma once
+
+#define GxEPD_BLACK 0x0000
+#define GxEPD_WHITE 0xFFFF
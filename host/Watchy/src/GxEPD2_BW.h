@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Adafruit_GFX.h"
+#include "GxEPD2.h"
+
+/* Paged display of the GxEPD2 library, on top of the simulated panel */
+template <typename GxEPD2_Type, const uint16_t page_height>
+class GxEPD2_BW : public Adafruit_GFX {
+public:
+  GxEPD2_Type epd2;
+
+  GxEPD2_BW(GxEPD2_Type epd2_instance)
+      : Adafruit_GFX(GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT),
+        epd2(epd2_instance) {}
+
+  void init(uint32_t serial_diag_bitrate = 0) { epd2.initWatchy(); }
+  void setFullWindow() {}
+  void setPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {}
+  void display(bool partial_update_mode = false) {
+    epd2.refresh(partial_update_mode);
+  }
+  void hibernate() { epd2.hibernate(); }
+};
@@ -0,0 +1,3 @@
+#pragma once
+
+/* Not used by the simulated Watchy */
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <Fonts/FreeMonoBold9pt7b.h>
+
+#include "Arduino.h"
+#include "Display.h"
+#include "GxEPD2_BW.h"
+
+/* Defined by Arduino_JSON, which the Watchy library includes */
+#ifndef null
+#define null nullptr
+#endif
@@ -0,0 +1,51 @@
+#include <cstdint>
+#include <ctime>
+
+#include "Arduino.h"
+#include "Display.h"
+#include "esp_cpu.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/* Enough for the GPIOs of the ESP32 */
+#define GPIO_PIN_COUNT 40
+
+/* Duration of a refresh of the Watchy's e-paper panel */
+#define FULL_REFRESH_MS 2000
+#define PARTIAL_REFRESH_MS 300
+
+static volatile uint8_t gpio_levels[GPIO_PIN_COUNT];
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin < GPIO_PIN_COUNT) {
+    gpio_levels[pin] = val;
+  }
+}
+
+int digitalRead(uint8_t pin) {
+  return pin < GPIO_PIN_COUNT ? gpio_levels[pin] : LOW;
+}
+
+void WatchyDisplay::refresh(bool partial_update_mode) {
+  /* The real driver waits for the busy pin of the panel */
+  vTaskDelay(pdMS_TO_TICKS(partial_update_mode ? PARTIAL_REFRESH_MS
+                                               : FULL_REFRESH_MS));
+}
+
+static uint64_t get_time_ns() {
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+
+  return (uint64_t)t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void) {
+  /* Also called by the trace macros before main() */
+  static const uint64_t start_time_ns = get_time_ns();
+
+  return (esp_cpu_cycle_count_t)((get_time_ns() - start_time_ns) *
+                                 WATCHY_SIM_CPU_FREQ_MHZ / 1000);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* CPU frequency of the Watchy, which the simulated cycle counter runs at */
+#define WATCHY_SIM_CPU_FREQ_MHZ 240
+
+typedef uint32_t esp_cpu_cycle_count_t;
+
+/**
+ * @brief Get the cycle count of the simulated CPU
+ *
+ * Counts from the start of the simulator, at the rate of the Watchy's CPU, and wraps as its CCOUNT register does.
+ */
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void);
+
+#ifdef __cplusplus
+}
+#endif
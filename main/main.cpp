@@ -4,6 +4,7 @@
 #include <GxEPD2_BW.h>
 #include <Watchy.h>
 #include <cstddef>
+#include <cinttypes>
 #include <cstdint>
 #include <cstring>
 #include <ctime>
@@ -86,6 +87,12 @@ uint32_t getCurrentSystemTimeFromWatchy() {
   return (uint32_t)esp_cpu_get_cycle_count();
 }
 
+/* Handles are logged as 64-bit values, as the tracing scripts parse them, so
+ * that the whole pointer is kept on the Linux simulator. */
+uint64_t getTraceIdFromHandle(const void *handle) {
+  return (uint64_t)(uintptr_t)handle;
+}
+
 char *getAndIncrementCurrentQueueMessageBuffer() {
   if (GLOBAL_QUEUE_MESSAGE_BUFFER == 0) {
     GLOBAL_QUEUE_MESSAGE_ELEMENT_SIZE = sizeof(TaskTraceData_Fix);
@@ -224,7 +231,7 @@ void clockCounter(void *pvParameters) {
     display.fillRoundRect(100, 140, 100, 10, 0, GxEPD_BLACK);
     display.setFont(&FreeMonoBold9pt7b);
     display.setCursor(100, 150);
-    display.printf("%2u", xCounterFabi);
+    display.printf("%2u", (unsigned)xCounterFabi);
 
     xCounterFabi += 1;
 
@@ -287,7 +294,8 @@ void debugPrintTask(void *pvParameters) {
 
   // Kill all created tasks
   for (BaseType_t i = 0; i < TASK_COUNT; i++) {
-    ESP_LOGI("TASK_NAME", "%d;%s", taskList[i], pcTaskGetName(taskList[i]));
+    ESP_LOGI("TASK_NAME", "%" PRIu64 ";%s", getTraceIdFromHandle(taskList[i]),
+             pcTaskGetName(taskList[i]));
     if (taskList[i] != xTaskGetCurrentTaskHandle() && taskList[i] != NULL)
       vTaskDelete(taskList[i]);
   }
@@ -301,10 +309,12 @@ void debugPrintTask(void *pvParameters) {
         (QueueTraceData_Fix *)(GLOBAL_QUEUE_MESSAGE_BUFFER +
                                uiMessageIndex *
                                    GLOBAL_QUEUE_MESSAGE_ELEMENT_SIZE);
-    ESP_LOGI("QUEUE_DEBUG", "%d;%d;%d;%d;%d;%d;%s", currentMessage->messageType,
-             currentMessage->xQueue, currentMessage->c_time,
-             currentMessage->timeStamp, currentMessage->taskIdentifier,
-             currentMessage->xTicksToWait,
+    ESP_LOGI("QUEUE_DEBUG", "%d;%" PRIu64 ";%d;%d;%" PRIu64 ";%u;%s",
+             (int)currentMessage->messageType,
+             getTraceIdFromHandle(currentMessage->xQueue),
+             (int)currentMessage->c_time, (int)currentMessage->timeStamp,
+             getTraceIdFromHandle(currentMessage->taskIdentifier),
+             (unsigned)currentMessage->xTicksToWait,
              pcTaskGetName(currentMessage->taskIdentifier));
     uiMessageIndex++;
   }
@@ -316,32 +326,37 @@ void debugPrintTask(void *pvParameters) {
         (TickTraceData_Fix *)(GLOBAL_TICK_MESSAGE_BUFFER +
                               uiMessageIndex *
                                   GLOBAL_TICK_MESSAGE_ELEMENT_SIZE);
-    ESP_LOGI("TICK_DEBUG", "%d;%d;%d;%d;%s", currentMessage->c_time,
-             currentMessage->timeStamp, currentMessage->newTickTime,
-             currentMessage->taskIdentifier,
+    ESP_LOGI("TICK_DEBUG", "%d;%d;%d;%" PRIu64 ";%s", (int)currentMessage->c_time,
+             (int)currentMessage->timeStamp, (int)currentMessage->newTickTime,
+             getTraceIdFromHandle(currentMessage->taskIdentifier),
              pcTaskGetName(currentMessage->taskIdentifier));
     uiMessageIndex++;
   }
 
   ESP_LOGI(
       "TASK_DEBUG",
-      "Message Type;C Time;Timestamp;Task ID;Affected Task ID;Delay;Task Name",
-      GLOBAL_TASK_MESSAGE_INDEX);
+      "Message Type;C Time;Timestamp;Task ID;Affected Task ID;Delay;Task Name");
   uiMessageIndex = 0;
   while (uiMessageIndex < GLOBAL_TASK_MESSAGE_INDEX) {
     TaskTraceData_Fix *currentMessage =
         (TaskTraceData_Fix *)(GLOBAL_TASK_MESSAGE_BUFFER +
                               uiMessageIndex *
                                   GLOBAL_TASK_MESSAGE_ELEMENT_SIZE);
-    ESP_LOGI("TASK_DEBUG", "%d;%d;%d;%d;%d;%d;%s", currentMessage->messageType,
-             currentMessage->c_time, currentMessage->timeStamp,
-             currentMessage->taskIdentifier, currentMessage->affectedTask,
-             currentMessage->delay,
+    ESP_LOGI("TASK_DEBUG", "%d;%d;%d;%" PRIu64 ";%" PRIu64 ";%u;%s",
+             (int)currentMessage->messageType, (int)currentMessage->c_time,
+             (int)currentMessage->timeStamp,
+             getTraceIdFromHandle(currentMessage->taskIdentifier),
+             getTraceIdFromHandle(currentMessage->affectedTask),
+             (unsigned)currentMessage->delay,
              pcTaskGetName(currentMessage->taskIdentifier));
     uiMessageIndex++;
   }
 
   ESP_LOGI("FINISH_FLAG", "%x", ERROR_FLAG);
+#if CONFIG_IDF_TARGET_LINUX
+  /* Nothing is left to trace, so end the simulation with the result */
+  exit(ERROR_FLAG);
+#endif
   vTaskDelete(NULL);
   while (true) {
   }
@@ -362,7 +377,7 @@ void high_prio_task(void *pvParameters) {
     for (BaseType_t t = 0; t < 50; t++) {
       x *= 2;
       if (x == 0) {
-        ESP_LOGI("Lalalala", "Ich kann schreiben! %d", x);
+        ESP_LOGI("Lalalala", "Ich kann schreiben! %d", (int)x);
         x = 1;
       }
     }
@@ -378,7 +393,7 @@ void high_prio_task(void *pvParameters) {
     for (BaseType_t t = 0; t < 50; t++) {
       x *= 2;
       if (x == 0) {
-        ESP_LOGI("Lalalala", "Ich kann schreiben! %d", x);
+        ESP_LOGI("Lalalala", "Ich kann schreiben! %d", (int)x);
         x = 1;
       }
     }
@@ -398,7 +413,7 @@ void medium_prio_task(void *pvParameters) {
     for (BaseType_t t = 0; t < 200; t++) {
       x *= 2;
       if (x == 0) {
-        ESP_LOGI("Lalalala", "Ich kann schreiben! %d", x);
+        ESP_LOGI("Lalalala", "Ich kann schreiben! %d", (int)x);
         x = 1;
       }
     }
@@ -421,12 +436,12 @@ void low_prio_task(void *pvParameters) {
     for (BaseType_t t = 0; t < 100; t++) {
       xy *= 2;
       if (xy == 0) {
-        ESP_LOGI("Lalalala", "Ich kann schreiben! %d", xy);
+        ESP_LOGI("Lalalala", "Ich kann schreiben! %d", (int)xy);
         xy = 1;
       }
     }
 
-    ESP_LOGI("User should check", "%d : %d", xy, xy);
+    ESP_LOGI("User should check", "%d : %d", (int)xy, (int)xy);
     BaseType_t y = xy;
 
     xSemaphoreGive(high_low_semaphore);
@@ -436,12 +451,12 @@ void low_prio_task(void *pvParameters) {
     for (BaseType_t i = 0; i < 200; i++) {
       x *= 2;
       if (x == 0) {
-        ESP_LOGI("Lalalala", "Ich kann schreiben! %d", x);
+        ESP_LOGI("Lalalala", "Ich kann schreiben! %d", (int)x);
         x = 1;
       }
     }
 
-    ESP_LOGI("User should check", "%d : %d", x, y);
+    ESP_LOGI("User should check", "%d : %d", (int)x, (int)y);
     vTaskDelayUntil(&xLastWakeTime, xFrequency);
   }
 }
@@ -451,21 +466,21 @@ extern "C" void app_main() {
     GLOBAL_TASK_MESSAGE_ELEMENT_SIZE = sizeof(TaskTraceData_Fix);
     GLOBAL_TASK_MESSAGE_BUFFER =
         (char *)malloc(TASK_MESSAGE_BUFFER_SIZE * sizeof(TaskTraceData_Fix));
-    ESP_LOGI("MAIN", "Buffer created %d", GLOBAL_TASK_MESSAGE_BUFFER);
+    ESP_LOGI("MAIN", "Buffer created %p", GLOBAL_TASK_MESSAGE_BUFFER);
   }
 
   while (GLOBAL_QUEUE_MESSAGE_BUFFER == 0) {
     GLOBAL_QUEUE_MESSAGE_ELEMENT_SIZE = sizeof(QueueTraceData_Fix);
     GLOBAL_QUEUE_MESSAGE_BUFFER =
         (char *)malloc(QUEUE_MESSAGE_BUFFER_SIZE * sizeof(QueueTraceData_Fix));
-    ESP_LOGI("MAIN", "Buffer created %d", GLOBAL_QUEUE_MESSAGE_BUFFER);
+    ESP_LOGI("MAIN", "Buffer created %p", GLOBAL_QUEUE_MESSAGE_BUFFER);
   }
 
   while (GLOBAL_TICK_MESSAGE_BUFFER == 0) {
     GLOBAL_TICK_MESSAGE_ELEMENT_SIZE = sizeof(TickTraceData_Fix);
     GLOBAL_TICK_MESSAGE_BUFFER =
         (char *)malloc(TICK_MESSAGE_BUFFER_SIZE * sizeof(TickTraceData_Fix));
-    ESP_LOGI("MAIN", "Buffer created %d", GLOBAL_TICK_MESSAGE_BUFFER);
+    ESP_LOGI("MAIN", "Buffer created %p", GLOBAL_TICK_MESSAGE_BUFFER);
   }
 
   xQueueHandle = xQueueCreate(10, sizeof(void *));
@@ -517,6 +532,11 @@ extern "C" void app_main() {
   // xTaskCreate(buttonWatch, "watch", 8192, NULL, 1, NULL);
   // xTaskCreate(clockCounter, "clock", 16384, NULL, 1, NULL);
 
+#if CONFIG_IDF_TARGET_LINUX
+  /* The simulator runs app_main() in a task of the running scheduler, which
+   * must not be started again. */
+  return;
+#endif
   ESP_LOGI("app_main", "Starting scheduler from app_main()");
   vTaskStartScheduler();
   /* vTaskStartScheduler is blocking - this should never be reached */
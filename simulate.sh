@@ -0,0 +1,6 @@
+#!/bin/bash
+# Runs main/main.cpp in the Linux simulator and exports its tracing data, as monitor.sh does with the Watchy.
+# Arguments are passed to the export script (see tracing_scripts/README.md).
+. esp/esp-idf/export.sh
+idf.py -B build_linux -D IDF_TARGET=linux -D SDKCONFIG=build_linux/sdkconfig -D SDKCONFIG_DEFAULTS=sdkconfig.defaults.linux build && \
+    cd tracing_scripts && cargo run --bin extract -- -s ../build_linux/main.elf "$@"
@@ -1,12 +1,12 @@
 use std::fmt::Display;
 use std::fs::File;
-use std::io::Write;
-use std::process::exit;
+use std::io::{BufReader, Read, Write};
+use std::process::{Command, Stdio, exit};
 use std::thread::sleep;
 use std::time::Duration;
 
 use csv::Writer;
-use types::parse::SerialEventDataIterator;
+use types::parse::{EventDataIterator, SerialEventDataIterator};
 
 #[derive(Debug, Clone)]
 struct Config {
@@ -14,6 +14,7 @@ struct Config {
     baud_rate: u32,
     output_file: String,
     task_mapping_file: String,
+    simulator: Option<String>,
 }
 
 enum ArgState {
@@ -22,6 +23,7 @@ enum ArgState {
     ReadByteRate,
     ReadOutput,
     ReadMapping,
+    ReadSimulator,
 }
 
 impl Default for Config {
@@ -39,6 +41,7 @@ impl Default for Config {
             baud_rate: 115200,
             output_file: "./log_entries.csv".to_string(),
             task_mapping_file: "./mapping.csv".to_string(),
+            simulator: None,
         }
     }
 }
@@ -46,8 +49,12 @@ impl Default for Config {
 impl Display for Config {
     fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
         f.write_str(&format!(
-            "Config {{ port: {}, baud_rate: {}, output: {}, task_mapping_file: {} }}",
-            self.port, self.baud_rate, self.output_file, self.task_mapping_file
+            "Config {{ port: {}, baud_rate: {}, output: {}, task_mapping_file: {}, simulator: {} }}",
+            self.port,
+            self.baud_rate,
+            self.output_file,
+            self.task_mapping_file,
+            self.simulator.as_deref().unwrap_or("none")
         ))
     }
 }
@@ -69,6 +76,8 @@ fn main() {
                     ArgState::ReadOutput
                 } else if arg == "-m" {
                     ArgState::ReadMapping
+                } else if arg == "-s" {
+                    ArgState::ReadSimulator
                 } else {
                     ArgState::Ready
                 },
@@ -90,13 +99,38 @@ fn main() {
                 config.task_mapping_file = arg.to_string();
                 (ArgState::Ready, config)
             }
+            ArgState::ReadSimulator => {
+                config.simulator = Some(arg.to_string());
+                (ArgState::Ready, config)
+            }
         },
     );
 
     println!("[App] Using this config for export: {}", config);
+
+    if let Some(simulator) = &config.simulator {
+        println!("[App] Starting simulator!");
+
+        let mut child = Command::new(simulator)
+            .stdout(Stdio::piped())
+            .spawn()
+            .expect("[App] Failed to start the simulator! Did you build it with simulate.sh?");
+
+        println!("[App] Start reading from simulator:");
+
+        let stdout = BufReader::new(child.stdout.take().unwrap());
+        let return_value = export(EventDataIterator::new(stdout), &config);
+
+        // The simulator exits after logging its result, unless it failed
+        let _ = child.kill();
+        let _ = child.wait();
+
+        finish(return_value);
+    }
+
     println!("[App] Opening serial port!");
 
-    let mut port = match tokio_serial::new(config.port, config.baud_rate).open() {
+    let mut port = match tokio_serial::new(&config.port, config.baud_rate).open() {
         Ok(port) => port,
         Err(_) => panic!("[App] Failed to open serial port! Are you sure a device is connected?"),
     };
@@ -114,15 +148,22 @@ fn main() {
 
     println!("[App] Start reading from device:");
 
-    let mut writer = Writer::from_path(config.output_file)
+    let return_value = export(SerialEventDataIterator::new(port), &config);
+
+    finish(return_value);
+}
+
+/// Writes the tracing data and the task names to the output files, and
+/// returns the result of the application.
+fn export<R: Read>(mut iterator: EventDataIterator<R>, config: &Config) -> Option<i32> {
+    let mut writer = Writer::from_path(&config.output_file)
         .expect("[App] Could not create output file! Do you have the right permissions?");
 
-    let mut iterator = SerialEventDataIterator::new(port);
     (&mut iterator).for_each(|data| writer.serialize(data).unwrap());
 
     writer.flush().unwrap();
 
-    let mut mapping_file = File::create(config.task_mapping_file)
+    let mut mapping_file = File::create(&config.task_mapping_file)
         .expect("[App] Could not create task mapping file! Do you have the right permissions?");
     writeln!(&mut mapping_file, "taskid,task_name").unwrap();
     iterator
@@ -130,7 +171,11 @@ fn main() {
         .iter()
         .for_each(|data| writeln!(&mut mapping_file, "{}", data).unwrap());
 
-    if let Some(value) = iterator.return_value() {
+    iterator.return_value()
+}
+
+fn finish(return_value: Option<i32>) -> ! {
+    if let Some(value) = return_value {
         exit(value);
     } else {
         eprintln!("No return value found!");
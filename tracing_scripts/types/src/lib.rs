@@ -42,8 +42,8 @@ pub struct TaskData {
     pub eventtype: TaskEventType,
     pub tick: u32,
     pub timestamp: u32,
-    pub taskid: u32,
-    pub affected_task_id: u32,
+    pub taskid: u64,
+    pub affected_task_id: u64,
     pub delay: u32,
     pub task_name: String,
 }
@@ -92,10 +92,10 @@ impl TryFrom<u32> for QueueEventType {
 #[derive(Serialize, Deserialize, Debug, Clone)]
 pub struct QueueData {
     pub eventtype: QueueEventType,
-    pub queue: u32,
+    pub queue: u64,
     pub tick: u32,
     pub timestamp: u32,
-    pub taskid: u32,
+    pub taskid: u64,
     pub ticks_to_wait: u32,
     pub task_name: String,
 }
@@ -112,7 +112,7 @@ pub struct TickData {
     pub tick: u32,
     pub timestamp: u32,
     pub new_tick_time: u32,
-    pub taskid: u32,
+    pub taskid: u64,
     pub task_name: String,
 }
 
@@ -121,8 +121,8 @@ pub struct GeneralEventData {
     pub eventtype: String,
     pub tick: u32,
     pub timestamp: u32,
-    pub taskid: u32,
-    pub affected_object: u32,
+    pub taskid: u64,
+    pub affected_object: u64,
     pub delay: u32,
     pub task_name: String,
 }
@@ -152,7 +152,7 @@ impl From<TickData> for GeneralEventData {
             tick: value.tick,
             timestamp: value.timestamp,
             taskid: value.taskid,
-            affected_object: value.new_tick_time,
+            affected_object: value.new_tick_time.into(),
             delay: value.new_tick_time - value.tick,
             task_name: value.task_name,
         }
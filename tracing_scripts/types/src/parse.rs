@@ -1,18 +1,24 @@
+use std::io::{ErrorKind, Read};
+
 use tokio_serial::SerialPort;
 
 use crate::{
     GeneralEventData, QueueData, QueueEventType, TaskData, TaskEventType, TickData, TickEventType,
 };
 
-pub struct SerialEventDataIterator {
+/// Reads the tracing data logged by the application, from the serial port of
+/// the Watchy or from the output of the Linux simulator.
+pub struct EventDataIterator<R: Read> {
     return_value: Option<i32>,
     task_names: Vec<String>,
-    port: Box<dyn SerialPort>,
+    port: R,
 }
 
-impl SerialEventDataIterator {
-    pub fn new(port: Box<dyn SerialPort>) -> SerialEventDataIterator {
-        SerialEventDataIterator {
+pub type SerialEventDataIterator = EventDataIterator<Box<dyn SerialPort>>;
+
+impl<R: Read> EventDataIterator<R> {
+    pub fn new(port: R) -> EventDataIterator<R> {
+        EventDataIterator {
             return_value: None,
             task_names: vec![],
             port,
@@ -28,7 +34,7 @@ impl SerialEventDataIterator {
     }
 }
 
-impl Iterator for SerialEventDataIterator {
+impl<R: Read> Iterator for EventDataIterator<R> {
     type Item = GeneralEventData;
 
     fn next(&mut self) -> Option<Self::Item> {
@@ -39,7 +45,15 @@ impl Iterator for SerialEventDataIterator {
         let mut buffer: Vec<char> = vec![];
         loop {
             let mut buf = [0u8; 1];
-            while self.port.read_exact(&mut buf).is_err() {}
+            loop {
+                match self.port.read_exact(&mut buf) {
+                    Ok(()) => break,
+                    // The simulator exited before logging its result
+                    Err(err) if err.kind() == ErrorKind::UnexpectedEof => return None,
+                    // Serial port timeout, wait for more data
+                    Err(_) => {}
+                }
+            }
 
             if buf[0] as char == '\n' {
                 // Handle line
@@ -201,3 +215,31 @@ pub fn parse_task_line(line: &str) -> Result<GeneralEventData, String> {
 
     Ok(GeneralEventData::from(task_data))
 }
+
+#[test]
+pub fn test_reading_simulator_output() {
+    // Handles of the simulator are 64-bit pointers, which may only differ in their upper half
+    let output = "I (1010) TASK_NAME: 1307;High prio task\n\
+                  I (1011) TASK_DEBUG: Message Type;C Time;Timestamp;Task ID;Affected Task ID;Delay;Task Name\n\
+                  I (1012) TASK_DEBUG: 5;100;24000000;1307;0;0;High prio task\n\
+                  I (1013) TASK_DEBUG: 5;101;24000100;4294968603;1307;0;Low prio task\n\
+                  I (1014) FINISH_FLAG: 0\n\
+                  I (1015) TASK_DEBUG: 6;100;24000000;1307;0;0;High prio task\n";
+
+    let mut iterator = EventDataIterator::new(output.as_bytes());
+    let events = (&mut iterator).collect::<Vec<GeneralEventData>>();
+
+    assert_eq!(events.len(), 2);
+    assert_eq!(events[0].eventtype, "traceTASK_SWITCHED_IN");
+    assert_eq!(events[0].taskid, 1307);
+    assert_eq!(events[1].taskid, (1 << 32) + 1307);
+    assert_eq!(events[1].affected_object, 1307);
+    assert_eq!(iterator.task_names(), ["1307,High prio task".to_string()]);
+    assert_eq!(iterator.return_value(), Some(0));
+
+    let mut truncated =
+        EventDataIterator::new("I (1010) TASK_NAME: 1307;High prio task\n".as_bytes());
+
+    assert!(truncated.next().is_none());
+    assert_eq!(truncated.return_value(), None);
+}
@@ -57,16 +57,16 @@ fn read_events(csv_path: &PathBuf) -> io::Result<Vec<GeneralEventData>> {
 }
 
 type TaskSegmentData = (
-    HashMap<u32, Vec<GeneralEventData>>,
-    Vec<(u32, String)>,
-    Vec<u32>,
+    HashMap<u64, Vec<GeneralEventData>>,
+    Vec<(u64, String)>,
+    Vec<u64>,
 );
 
 fn get_task_segments(data: &[GeneralEventData]) -> TaskSegmentData {
-    let mut queue_ids: Vec<u32> = vec![];
+    let mut queue_ids: Vec<u64> = vec![];
     let task_events: Vec<&GeneralEventData> = data.iter().collect();
 
-    let mut map: HashMap<u32, Vec<GeneralEventData>> = HashMap::new();
+    let mut map: HashMap<u64, Vec<GeneralEventData>> = HashMap::new();
 
     task_events.into_iter().for_each(|entry| {
         let event_data = map.entry(entry.taskid).or_default();
@@ -79,7 +79,7 @@ fn get_task_segments(data: &[GeneralEventData]) -> TaskSegmentData {
     map.iter_mut()
         .for_each(|(_, vec)| vec.sort_by_key(|t| t.timestamp));
 
-    let mut task_ids: Vec<(u32, String)> = vec![];
+    let mut task_ids: Vec<(u64, String)> = vec![];
 
     map.iter().for_each(|(task_id, data)| {
         task_ids.push((